@@ -0,0 +1,324 @@
+#ifndef MJOLNIR_BENCH_BENCH_UTILITY_HPP
+#define MJOLNIR_BENCH_BENCH_UTILITY_HPP
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/System.hpp>
+#include <mjolnir/core/Unit.hpp>
+#include <mjolnir/math/math.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <numeric>
+#include <utility>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+namespace mjolnir
+{
+namespace bench
+{
+
+// ---------------------------------------------------------------------------
+// result of a benchmark case.
+//
+// `samples` contains the wall-clock time of each repetition in seconds.
+// Additional quantities that help interpreting the timing (e.g. the number of
+// neighbor pairs) are stored in `metrics`.
+
+struct BenchmarkResult
+{
+    std::string suite;     // "pair", "partition", "local", "integrator"
+    std::string name;      // name of the interaction, partition or integrator
+    std::string task;      // what is timed, e.g. "calc_force", "make", "step"
+    std::string traits;    // "serial" or "openmp"
+    std::string boundary;  // "Unlimited" or "CuboidalPeriodic"
+    std::string partition; // spatial partition used (if any)
+    std::size_t num_particles;
+    double      density;
+    std::size_t threads;
+    std::vector<double> samples;
+    std::vector<std::pair<std::string, double>> metrics;
+};
+
+struct Statistics
+{
+    double min, max, mean, median, stddev;
+};
+
+inline Statistics make_statistics(std::vector<double> samples)
+{
+    Statistics stat{0.0, 0.0, 0.0, 0.0, 0.0};
+    if(samples.empty()) {return stat;}
+
+    std::sort(samples.begin(), samples.end());
+    const auto n = samples.size();
+
+    stat.min    = samples.front();
+    stat.max    = samples.back();
+    stat.mean   = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+    stat.median = (n % 2 == 1) ? samples[n / 2] :
+                  (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+    double var = 0.0;
+    for(const auto s : samples)
+    {
+        var += (s - stat.mean) * (s - stat.mean);
+    }
+    stat.stddev = (n > 1) ? std::sqrt(var / (n - 1)) : 0.0;
+    return stat;
+}
+
+// ---------------------------------------------------------------------------
+// run `prepare` and `run` (1 + repeat) times, and returns the wall-clock time
+// of each `run` except the first one (warm-up). `prepare` is not timed.
+
+template<typename Prepare, typename Run>
+std::vector<double> measure(const std::size_t repeat, Prepare&& prepare, Run&& run)
+{
+    using clock_type = std::chrono::steady_clock;
+
+    prepare();
+    run(); // warm-up. allocate buffers, fill caches, etc.
+
+    std::vector<double> samples;
+    samples.reserve(repeat);
+    for(std::size_t i=0; i<repeat; ++i)
+    {
+        prepare();
+        const auto start = clock_type::now();
+        run();
+        const auto stop  = clock_type::now();
+        samples.push_back(std::chrono::duration<double>(stop - start).count());
+    }
+    return samples;
+}
+
+// ---------------------------------------------------------------------------
+// The same as `[units] energy = "kcal/mol", length = "angstrom"` in an input
+// file. DebyeHuckel needs them to calculate the debye length.
+
+template<typename realT>
+void set_kcalmol_angstrom_units()
+{
+    using phys_type = physics::constants<realT>;
+    using unit_type = unit::constants<realT>;
+
+    phys_type::reset();
+    phys_type::set_kB(phys_type::kB() * (unit_type::J_to_cal() / 1000.0) *
+                      unit_type::avogadro_constant());
+    phys_type::set_eps0(phys_type::eps0() * (1000.0 / unit_type::J_to_cal()) /
+                        unit_type::avogadro_constant());
+    phys_type::set_energy_unit("kcal/mol");
+
+    phys_type::set_eps0(phys_type::eps0() / unit_type::m_to_angstrom());
+    phys_type::set_m_to_length(unit_type::m_to_angstrom());
+    phys_type::set_length_to_m(unit_type::angstrom_to_m());
+    phys_type::set_L_to_volume(1e-3 * std::pow(unit_type::m_to_angstrom(), 3));
+    phys_type::set_volume_to_L(1e+3 * std::pow(unit_type::angstrom_to_m(), 3));
+    phys_type::set_length_unit("angstrom");
+    return;
+}
+
+// ---------------------------------------------------------------------------
+// reproducible synthetic systems.
+//
+// `N` particles are put on a simple cubic lattice in a cubic box that has
+// the number density `density` (in particles per unit volume, the length unit
+// is the same as the one used in sigma of the potentials, i.e. 1.0). The
+// lattice sites are visited in a "snake" order, so that the consecutive
+// particles are always adjacent and can be connected by bonds. The positions
+// are slightly perturbed by a Mersenne Twister with a fixed seed.
+//
+// Since std::uniform_real_distribution is implementation-defined, the raw
+// output of std::mt19937 is converted to real numbers here. So the same seed
+// gives the same system everywhere.
+
+template<typename boundaryT>
+struct boundary_maker;
+
+template<typename realT, typename coordT>
+struct boundary_maker<UnlimitedBoundary<realT, coordT>>
+{
+    static UnlimitedBoundary<realT, coordT> invoke(const realT) noexcept
+    {
+        return UnlimitedBoundary<realT, coordT>{};
+    }
+    static const char* name() noexcept {return "Unlimited";}
+};
+
+template<typename realT, typename coordT>
+struct boundary_maker<CuboidalPeriodicBoundary<realT, coordT>>
+{
+    static CuboidalPeriodicBoundary<realT, coordT> invoke(const realT width) noexcept
+    {
+        return CuboidalPeriodicBoundary<realT, coordT>(
+            math::make_coordinate<coordT>(0, 0, 0),
+            math::make_coordinate<coordT>(width, width, width));
+    }
+    static const char* name() noexcept {return "CuboidalPeriodic";}
+};
+
+inline double uniform_real(std::mt19937& mt, const double lower, const double upper)
+{
+    constexpr double r2_32 = 2.3283064365386962890625e-10; // 2^-32
+    return lower + (upper - lower) * (static_cast<double>(mt()) * r2_32);
+}
+
+template<typename traitsT>
+System<traitsT> make_lattice_system(const std::size_t N, const double density,
+                                    const std::uint32_t seed)
+{
+    using real_type       = typename traitsT::real_type;
+    using coordinate_type = typename traitsT::coordinate_type;
+    using boundary_type   = typename traitsT::boundary_type;
+
+    const double width   = std::cbrt(N / density);
+    const auto   per_dim = static_cast<std::size_t>(std::ceil(std::cbrt(N) - 1e-8));
+    const double spacing = width / per_dim;
+
+    System<traitsT> sys(N, boundary_maker<boundary_type>::invoke(width));
+
+    std::mt19937 mt(seed);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        // snake order. the direction of x (y) flips in each row (layer).
+        const std::size_t iz  = i / (per_dim * per_dim);
+        const std::size_t row = i / per_dim; // number of rows visited so far
+        std::size_t       iy  = row % per_dim;
+        std::size_t       ix  = i   % per_dim;
+        if(iz  % 2 == 1) {iy = per_dim - 1 - iy;}
+        if(row % 2 == 1) {ix = per_dim - 1 - ix;}
+
+        const double jx = uniform_real(mt, -0.05, 0.05) * spacing;
+        const double jy = uniform_real(mt, -0.05, 0.05) * spacing;
+        const double jz = uniform_real(mt, -0.05, 0.05) * spacing;
+
+        sys.mass    (i) = real_type(1.0);
+        sys.rmass   (i) = real_type(1.0);
+        sys.position(i) = math::make_coordinate<coordinate_type>(
+                (ix + 0.5) * spacing + jx,
+                (iy + 0.5) * spacing + jy,
+                (iz + 0.5) * spacing + jz);
+        sys.velocity(i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys.force   (i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys.name    (i) = "X";
+        sys.group   (i) = "NONE";
+    }
+    sys.attribute("temperature")    = real_type(300.0);
+    sys.attribute("ionic_strength") = real_type(1.0);
+    return sys;
+}
+
+template<typename traitsT>
+void clear_forces(System<traitsT>& sys) noexcept
+{
+    using coordinate_type = typename traitsT::coordinate_type;
+    using matrix33_type   = typename traitsT::matrix33_type;
+    for(std::size_t i=0; i<sys.size(); ++i)
+    {
+        sys.force(i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+    }
+    sys.virial() = matrix33_type(0,0,0, 0,0,0, 0,0,0);
+    return;
+}
+
+// ---------------------------------------------------------------------------
+// JSON output. It is small enough to be written by hand.
+
+inline std::string json_escape(const std::string& str)
+{
+    std::string retval;
+    retval.reserve(str.size() + 2);
+    retval += '"';
+    for(const char c : str)
+    {
+        switch(c)
+        {
+            case '"' : {retval += "\\\""; break;}
+            case '\\': {retval += "\\\\"; break;}
+            case '\n': {retval += "\\n";  break;}
+            case '\t': {retval += "\\t";  break;}
+            default:
+            {
+                if(static_cast<unsigned char>(c) < 0x20)
+                {
+                    std::ostringstream oss;
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(c);
+                    retval += oss.str();
+                }
+                else
+                {
+                    retval += c;
+                }
+                break;
+            }
+        }
+    }
+    retval += '"';
+    return retval;
+}
+
+inline std::string json_number(const double v)
+{
+    if(!std::isfinite(v)) {return "null";}
+    std::ostringstream oss;
+    oss << std::setprecision(9) << v;
+    return oss.str();
+}
+
+inline void write_json(std::ostream& os,
+        const std::vector<std::pair<std::string, std::string>>& context,
+        const std::vector<BenchmarkResult>& results)
+{
+    os << "{\n";
+    os << "  \"context\": {\n";
+    for(std::size_t i=0; i<context.size(); ++i)
+    {
+        os << "    " << json_escape(context[i].first) << ": "
+           << json_escape(context[i].second)
+           << (i+1 == context.size() ? "\n" : ",\n");
+    }
+    os << "  },\n";
+    os << "  \"results\": [\n";
+    for(std::size_t i=0; i<results.size(); ++i)
+    {
+        const auto& r    = results[i];
+        const auto  stat = make_statistics(r.samples);
+
+        os << "    {";
+        os <<   "\"suite\": "         << json_escape(r.suite);
+        os << ", \"name\": "          << json_escape(r.name);
+        os << ", \"task\": "          << json_escape(r.task);
+        os << ", \"traits\": "        << json_escape(r.traits);
+        os << ", \"boundary\": "      << json_escape(r.boundary);
+        os << ", \"partition\": "     << json_escape(r.partition);
+        os << ", \"num_particles\": " << r.num_particles;
+        os << ", \"density\": "       << json_number(r.density);
+        os << ", \"threads\": "       << r.threads;
+        os << ", \"repeat\": "        << r.samples.size();
+        os << ", \"time_min\": "      << json_number(stat.min);
+        os << ", \"time_median\": "   << json_number(stat.median);
+        os << ", \"time_mean\": "     << json_number(stat.mean);
+        os << ", \"time_max\": "      << json_number(stat.max);
+        os << ", \"time_stddev\": "   << json_number(stat.stddev);
+        os << ", \"metrics\": {";
+        for(std::size_t j=0; j<r.metrics.size(); ++j)
+        {
+            os << (j == 0 ? "" : ", ") << json_escape(r.metrics[j].first)
+               << ": " << json_number(r.metrics[j].second);
+        }
+        os << "}}" << (i+1 == results.size() ? "\n" : ",\n");
+    }
+    os << "  ]\n";
+    os << "}\n";
+    return;
+}
+
+} // bench
+} // mjolnir
+#endif // MJOLNIR_BENCH_BENCH_UTILITY_HPP
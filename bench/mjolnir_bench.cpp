@@ -0,0 +1,828 @@
+#include <bench/bench_utility.hpp>
+
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/ForceField.hpp>
+#include <mjolnir/core/Topology.hpp>
+#include <mjolnir/core/RandomNumberGenerator.hpp>
+#include <mjolnir/core/NaivePairCalculation.hpp>
+#include <mjolnir/core/VerletList.hpp>
+#include <mjolnir/core/UnlimitedGridCellList.hpp>
+#include <mjolnir/core/PeriodicGridCellList.hpp>
+#include <mjolnir/core/ZorderRTree.hpp>
+#include <mjolnir/core/VelocityVerletIntegrator.hpp>
+#include <mjolnir/core/UnderdampedLangevinIntegrator.hpp>
+#include <mjolnir/core/BAOABLangevinIntegrator.hpp>
+#include <mjolnir/core/GJFNVTLangevinIntegrator.hpp>
+
+#include <mjolnir/forcefield/global/GlobalPairInteraction.hpp>
+#include <mjolnir/forcefield/global/GlobalPairLennardJonesInteraction.hpp>
+#include <mjolnir/forcefield/global/GlobalPairUniformLennardJonesInteraction.hpp>
+#include <mjolnir/forcefield/global/GlobalPairExcludedVolumeInteraction.hpp>
+#include <mjolnir/forcefield/global/DebyeHuckelPotential.hpp>
+#include <mjolnir/forcefield/global/ExcludedVolumePotential.hpp>
+#include <mjolnir/forcefield/global/HardCoreExcludedVolumePotential.hpp>
+#include <mjolnir/forcefield/global/InversePowerPotential.hpp>
+#include <mjolnir/forcefield/global/LennardJonesPotential.hpp>
+#include <mjolnir/forcefield/global/LennardJonesAttractivePotential.hpp>
+#include <mjolnir/forcefield/global/UniformLennardJonesPotential.hpp>
+#include <mjolnir/forcefield/global/WCAPotential.hpp>
+#include <mjolnir/forcefield/global/TabulatedWCAPotential.hpp>
+#include <mjolnir/forcefield/global/TabulatedLennardJonesAttractivePotential.hpp>
+
+#include <mjolnir/forcefield/local/BondLengthInteraction.hpp>
+#include <mjolnir/forcefield/local/BondAngleInteraction.hpp>
+#include <mjolnir/forcefield/local/DihedralAngleInteraction.hpp>
+#include <mjolnir/forcefield/local/HarmonicPotential.hpp>
+#include <mjolnir/forcefield/local/ClementiDihedralPotential.hpp>
+
+#include <mjolnir/util/make_unique.hpp>
+#include <mjolnir/util/logger.hpp>
+
+#ifdef MJOLNIR_WITH_OPENMP
+#include <mjolnir/omp/omp.hpp>
+#endif
+
+#include <fstream>
+#include <iostream>
+
+#ifndef MJOLNIR_VERSION
+#define MJOLNIR_VERSION "unknown"
+#endif
+#ifndef MJOLNIR_COMPILER_VERSION
+#define MJOLNIR_COMPILER_VERSION "unknown"
+#endif
+
+// mjolnir_bench: a benchmark suite that runs the kernels of mjolnir on
+// synthetic systems and writes the timings in JSON.
+//
+// - pair       : calc_force and calc_force_and_energy of GlobalPairInteraction
+//                with each pair potential (neighbor list is not rebuilt).
+// - partition  : the time to (re)build a neighbor list with each spatial
+//                partition for the Lennard-Jones potential.
+// - local      : calc_force of bond-length, bond-angle and dihedral-angle
+//                interactions along a chain that goes through all the particles.
+// - integrator : one MD step including the force calculation and the neighbor
+//                list updates, for a chain polymer with Lennard-Jones.
+//
+// Each of them runs with the serial and the OpenMP traits (if enabled), under
+// the unlimited and periodic boundary conditions, with all the combinations of
+// the number of particles and the density.
+
+namespace mjolnir
+{
+namespace bench
+{
+
+struct BenchmarkConfig
+{
+    std::vector<std::string> suites;
+    std::vector<std::string> traits;
+    std::vector<std::string> boundaries;
+    std::vector<std::size_t> sizes;
+    std::vector<double>      densities;
+    std::size_t   repeat;
+    std::size_t   steps;              // MD steps per sample in integrator suite
+    std::size_t   max_quadratic_size; // upper limit of N for Naive and VerletList
+    std::uint32_t seed;
+    std::string   filter;
+    std::string   output;
+};
+
+template<typename T>
+bool contains(const std::vector<T>& vec, const T& value)
+{
+    return std::find(vec.begin(), vec.end(), value) != vec.end();
+}
+
+template<typename traitsT>
+struct traits_name
+{
+    static const char* invoke() noexcept {return "serial";}
+};
+template<typename traitsT>
+struct is_openmp_traits : std::false_type {};
+template<typename traitsT>
+struct number_of_threads
+{
+    static std::size_t invoke() noexcept {return 1;}
+};
+
+#ifdef MJOLNIR_WITH_OPENMP
+template<typename realT, template<typename, typename> class boundaryT>
+struct traits_name<OpenMPSimulatorTraits<realT, boundaryT>>
+{
+    static const char* invoke() noexcept {return "openmp";}
+};
+template<typename realT, template<typename, typename> class boundaryT>
+struct is_openmp_traits<OpenMPSimulatorTraits<realT, boundaryT>> : std::true_type {};
+template<typename realT, template<typename, typename> class boundaryT>
+struct number_of_threads<OpenMPSimulatorTraits<realT, boundaryT>>
+{
+    static std::size_t invoke() noexcept {return omp_get_max_threads();}
+};
+#endif
+
+// grid cell list that fits to the boundary condition.
+template<typename traitsT, typename potentialT, typename boundaryT>
+struct celllist_of;
+
+template<typename traitsT, typename potentialT, typename realT, typename coordT>
+struct celllist_of<traitsT, potentialT, UnlimitedBoundary<realT, coordT>>
+{
+    using type = UnlimitedGridCellList<traitsT, potentialT>;
+};
+template<typename traitsT, typename potentialT, typename realT, typename coordT>
+struct celllist_of<traitsT, potentialT, CuboidalPeriodicBoundary<realT, coordT>>
+{
+    using type = PeriodicGridCellList<traitsT, potentialT>;
+};
+
+template<typename traitsT>
+class BenchmarkRunner
+{
+  public:
+    using traits_type     = traitsT;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using system_type     = System<traits_type>;
+    using topology_type   = Topology;
+    using rng_type        = RandomNumberGenerator<traits_type>;
+    using remover_type    = SystemMotionRemover<traits_type>;
+    using forcefield_type = std::unique_ptr<ForceFieldBase<traits_type>>;
+
+    template<typename potentialT>
+    using partition_ptr = std::unique_ptr<SpatialPartitionBase<traits_type, potentialT>>;
+
+  public:
+
+    BenchmarkRunner(const BenchmarkConfig& config,
+                    std::vector<BenchmarkResult>& results)
+        : config_(config), results_(results)
+    {}
+
+    void run()
+    {
+        if(!contains<std::string>(config_.traits, traits_name<traits_type>::invoke()) ||
+           !contains<std::string>(config_.boundaries, boundary_maker<boundary_type>::name()))
+        {
+            return;
+        }
+        for(const auto N : config_.sizes)
+        {
+            for(const auto rho : config_.densities)
+            {
+                if(contains<std::string>(config_.suites, "pair"))       {this->run_pair(N, rho);}
+                if(contains<std::string>(config_.suites, "partition"))  {this->run_partition(N, rho);}
+                if(contains<std::string>(config_.suites, "local"))      {this->run_local(N, rho);}
+                if(contains<std::string>(config_.suites, "integrator")) {this->run_integrator(N, rho);}
+            }
+        }
+        return;
+    }
+
+  private:
+
+    // -----------------------------------------------------------------------
+    // pair suite
+
+    void run_pair(const std::size_t N, const double rho)
+    {
+        using ignore_molecule_type = IgnoreMolecule<typename topology_type::molecule_id_type>;
+        using ignore_group_type    = IgnoreGroup   <typename topology_type::group_id_type>;
+        using exclusions_type = std::map<typename topology_type::connection_kind_type, std::size_t>;
+
+        const exclusions_type no_exclusions;
+
+        {
+            using potential_type = LennardJonesPotential<traits_type>;
+            this->bench_pair(N, rho, "LennardJones",
+                potential_type(potential_type::default_cutoff(),
+                uniform_parameters(N, typename potential_type::parameter_type(1.0, 1.0)),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            using potential_type = UniformLennardJonesPotential<traits_type>;
+            this->bench_pair(N, rho, "UniformLennardJones",
+                potential_type(1.0, 1.0, potential_type::default_cutoff(),
+                uniform_parameters(N, typename potential_type::parameter_type{}),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            using potential_type = LennardJonesAttractivePotential<traits_type>;
+            this->bench_pair(N, rho, "LennardJonesAttractive",
+                potential_type(potential_type::default_cutoff(),
+                uniform_parameters(N, typename potential_type::parameter_type(1.0, 1.0)),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            using potential_type = WCAPotential<traits_type>;
+            this->bench_pair(N, rho, "WCA",
+                potential_type(potential_type::default_cutoff(),
+                uniform_parameters(N, typename potential_type::parameter_type(1.0, 1.0)),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            using potential_type = ExcludedVolumePotential<traits_type>;
+            this->bench_pair(N, rho, "ExcludedVolume",
+                potential_type(0.6, potential_type::default_cutoff(),
+                uniform_parameters(N, typename potential_type::parameter_type(0.5)),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            using potential_type = HardCoreExcludedVolumePotential<traits_type>;
+            this->bench_pair(N, rho, "HardCoreExcludedVolume",
+                potential_type(0.6, potential_type::default_cutoff(),
+                uniform_parameters(N, typename potential_type::parameter_type(0.45, 0.05)),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            using potential_type = InversePowerPotential<traits_type>;
+            this->bench_pair(N, rho, "InversePower",
+                potential_type(0.6, 12, potential_type::default_cutoff(12),
+                uniform_parameters(N, typename potential_type::parameter_type(0.5)),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            // With the default cutoff (5.5 x debye length), the number of
+            // neighbors becomes too large for a dense system and the box
+            // becomes smaller than the cutoff. Here 1.0 x debye length is used
+            // with 1 M ionic strength. It is about 3 angstrom at 300 K.
+            using potential_type = DebyeHuckelPotential<traits_type>;
+            std::vector<std::pair<std::size_t, typename potential_type::parameter_type>> params;
+            for(std::size_t i=0; i<N; ++i)
+            {
+                params.emplace_back(i, (i % 2 == 0) ? 1.0 : -1.0);
+            }
+            this->bench_pair(N, rho, "DebyeHuckel",
+                potential_type(1.0, params,
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            using potential_type = TabulatedWCAPotential<traits_type>;
+            this->bench_pair(N, rho, "TabulatedWCA",
+                potential_type(potential_type::default_cutoff(),
+                make_table<potential_type>(), two_types(N),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        {
+            using potential_type = TabulatedLennardJonesAttractivePotential<traits_type>;
+            this->bench_pair(N, rho, "TabulatedLennardJonesAttractive",
+                potential_type(potential_type::default_cutoff(),
+                make_table<potential_type>(), two_types(N),
+                no_exclusions, ignore_molecule_type("Nothing"), ignore_group_type({})));
+        }
+        return;
+    }
+
+    template<typename potentialT>
+    void bench_pair(const std::size_t N, const double rho,
+                    const std::string& potential_name, potentialT&& pot)
+    {
+        using potential_type   = typename std::decay<potentialT>::type;
+        using interaction_type = GlobalPairInteraction<traits_type, potential_type>;
+        using celllist_type    = typename celllist_of<traits_type, potential_type, boundary_type>::type;
+
+        // some potentials share the same name(), e.g. LennardJones and
+        // UniformLennardJones. so the name is passed from the caller.
+        const std::string name = "Pair:" + potential_name;
+        if(!this->selected("pair", name, "CellList")) {return;}
+
+        auto sys = make_lattice_system<traits_type>(N, rho, config_.seed);
+        topology_type topol(N);
+        topol.construct_molecules();
+
+        interaction_type interaction(std::forward<potentialT>(pot),
+            SpatialPartition<traits_type, potential_type>(
+                make_unique<celllist_type>(0.5, CellListStencil::Full)));
+        interaction.initialize(sys, topol);
+
+        auto r1 = this->make_result("pair", name, "calc_force", "CellList", N, rho);
+        r1.samples = measure(config_.repeat,
+            [&sys] {clear_forces(sys);},
+            [&sys, &interaction] {
+                sys.preprocess_forces();
+                interaction.calc_force(sys);
+                sys.postprocess_forces();
+            });
+        this->push(std::move(r1));
+
+        auto r2 = this->make_result("pair", name, "calc_force_and_energy", "CellList", N, rho);
+        real_type energy(0);
+        r2.samples = measure(config_.repeat,
+            [&sys] {clear_forces(sys);},
+            [&sys, &interaction, &energy] {
+                sys.preprocess_forces();
+                energy = interaction.calc_force_and_energy(sys);
+                sys.postprocess_forces();
+            });
+        r2.metrics.emplace_back("energy", static_cast<double>(energy));
+        this->push(std::move(r2));
+        return;
+    }
+
+    template<typename parameterT>
+    static std::vector<std::pair<std::size_t, parameterT>>
+    uniform_parameters(const std::size_t N, const parameterT& p)
+    {
+        std::vector<std::pair<std::size_t, parameterT>> params;
+        params.reserve(N);
+        for(std::size_t i=0; i<N; ++i)
+        {
+            params.emplace_back(i, p);
+        }
+        return params;
+    }
+
+    // for tabulated potentials. two kinds of particles appear alternately.
+    static std::vector<std::pair<std::size_t, std::string>>
+    two_types(const std::size_t N)
+    {
+        std::vector<std::pair<std::size_t, std::string>> params;
+        params.reserve(N);
+        for(std::size_t i=0; i<N; ++i)
+        {
+            params.emplace_back(i, (i % 2 == 0) ? "A" : "B");
+        }
+        return params;
+    }
+    template<typename potentialT>
+    static typename potentialT::table_type make_table()
+    {
+        typename potentialT::table_type table;
+        table["A:A"] = typename potentialT::table_value_type(1.0, 1.0);
+        table["A:B"] = typename potentialT::table_value_type(1.1, 0.8);
+        table["B:A"] = typename potentialT::table_value_type(1.1, 0.8);
+        table["B:B"] = typename potentialT::table_value_type(1.2, 0.6);
+        return table;
+    }
+
+    // -----------------------------------------------------------------------
+    // partition suite
+
+    void run_partition(const std::size_t N, const double rho)
+    {
+        using potential_type = LennardJonesPotential<traits_type>;
+        using celllist_type  = typename celllist_of<traits_type, potential_type, boundary_type>::type;
+
+        const bool quadratic_ok = (N <= config_.max_quadratic_size);
+        if(quadratic_ok)
+        {
+            this->bench_partition(N, rho, "Naive",
+                partition_ptr<potential_type>(
+                    make_unique<NaivePairCalculation<traits_type, potential_type>>()));
+            this->bench_partition(N, rho, "VerletList",
+                partition_ptr<potential_type>(
+                    make_unique<VerletList<traits_type, potential_type>>(0.5)));
+        }
+        this->bench_partition(N, rho, "CellList",
+            partition_ptr<potential_type>(
+                make_unique<celllist_type>(0.5, CellListStencil::Full)));
+        this->bench_partition(N, rho, "CellList:Half",
+            partition_ptr<potential_type>(
+                make_unique<celllist_type>(0.5, CellListStencil::Half)));
+        this->bench_partition(N, rho, "ZorderRTree",
+            partition_ptr<potential_type>(
+                make_unique<ZorderRTree<traits_type, potential_type>>(0.5)));
+        return;
+    }
+
+    void bench_partition(const std::size_t N, const double rho,
+            const std::string& name,
+            partition_ptr<LennardJonesPotential<traits_type>>&& ptr)
+    {
+        using potential_type = LennardJonesPotential<traits_type>;
+        if(!this->selected("partition", name, name)) {return;}
+
+        auto sys = make_lattice_system<traits_type>(N, rho, config_.seed);
+        topology_type topol(N);
+        topol.construct_molecules();
+
+        potential_type pot(potential_type::default_cutoff(),
+            uniform_parameters(N, typename potential_type::parameter_type(1.0, 1.0)),
+            {}, typename potential_type::ignore_molecule_type("Nothing"),
+            typename potential_type::ignore_group_type({}));
+        pot.initialize(sys, topol);
+
+        SpatialPartition<traits_type, potential_type> partition(std::move(ptr));
+        partition.initialize(sys, pot);
+
+        auto r = this->make_result("partition", name, "make", name, N, rho);
+        r.samples = measure(config_.repeat, [] {},
+            [&sys, &pot, &partition] {partition.make(sys, pot);});
+        r.metrics.emplace_back("neighbors",
+            static_cast<double>(partition.neighbors().num_neighbors()));
+        this->push(std::move(r));
+        return;
+    }
+
+    // -----------------------------------------------------------------------
+    // local suite
+
+    void run_local(const std::size_t N, const double rho)
+    {
+        using harmonic_type = HarmonicPotential<real_type>;
+        using clementi_type = ClementiDihedralPotential<real_type>;
+
+        const auto sys = make_lattice_system<traits_type>(N, rho, config_.seed);
+
+        if(N >= 2)
+        {
+            using interaction_type = BondLengthInteraction<traits_type, harmonic_type>;
+            interaction_type interaction("bond", make_chain<2>(sys,
+                [](const system_type& s, const std::array<std::size_t, 2>& idx) {
+                    const auto dr = s.adjust_direction(s.position(idx[0]), s.position(idx[1]));
+                    return harmonic_type(10.0, math::length(dr));
+                }));
+            this->bench_local(N, rho, sys, interaction);
+        }
+        if(N >= 3)
+        {
+            using interaction_type = BondAngleInteraction<traits_type, harmonic_type>;
+            interaction_type interaction("none", make_chain<3>(sys,
+                [](const system_type&, const std::array<std::size_t, 3>&) {
+                    return harmonic_type(10.0, 2.0);
+                }));
+            this->bench_local(N, rho, sys, interaction);
+        }
+        if(N >= 4)
+        {
+            using interaction_type = DihedralAngleInteraction<traits_type, clementi_type>;
+            interaction_type interaction("none", make_chain<4>(sys,
+                [](const system_type&, const std::array<std::size_t, 4>&) {
+                    return clementi_type(1.0, 0.5, 3.0);
+                }));
+            this->bench_local(N, rho, sys, interaction);
+        }
+        return;
+    }
+
+    template<typename interactionT>
+    void bench_local(const std::size_t N, const double rho,
+                     const system_type& sys0, interactionT& interaction)
+    {
+        const auto name = interaction.name();
+        if(!this->selected("local", name, "")) {return;}
+
+        auto sys = sys0;
+        interaction.initialize(sys);
+
+        auto r = this->make_result("local", name, "calc_force", "", N, rho);
+        r.samples = measure(config_.repeat,
+            [&sys] {clear_forces(sys);},
+            [&sys, &interaction] {
+                sys.preprocess_forces();
+                interaction.calc_force(sys);
+                sys.postprocess_forces();
+            });
+        this->push(std::move(r));
+        return;
+    }
+
+    // {i, i+1, ..., i+M-1} along the chain that goes through all the particles
+    template<std::size_t M, typename F>
+    static std::vector<std::pair<std::array<std::size_t, M>,
+                                 typename std::result_of<F(const system_type&,
+                                     const std::array<std::size_t, M>&)>::type>>
+    make_chain(const system_type& sys, F&& make_potential)
+    {
+        using potential_type = typename std::result_of<F(const system_type&,
+                const std::array<std::size_t, M>&)>::type;
+
+        std::vector<std::pair<std::array<std::size_t, M>, potential_type>> retval;
+        retval.reserve(sys.size());
+        for(std::size_t i=0; i+M<=sys.size(); ++i)
+        {
+            std::array<std::size_t, M> idx;
+            for(std::size_t j=0; j<M; ++j) {idx[j] = i + j;}
+            retval.emplace_back(idx, make_potential(sys, idx));
+        }
+        return retval;
+    }
+
+    // -----------------------------------------------------------------------
+    // integrator suite
+
+    void run_integrator(const std::size_t N, const double rho)
+    {
+        const real_type dt = 0.01;
+        {
+            using integrator_type = UnderdampedLangevinIntegrator<traits_type>;
+            this->bench_integrator(N, rho, "UnderdampedLangevin", integrator_type(dt,
+                std::vector<real_type>(N, 0.1), remover_type(false, false, false)));
+        }
+        {
+            using integrator_type = BAOABLangevinIntegrator<traits_type>;
+            this->bench_integrator(N, rho, "BAOABLangevin", integrator_type(dt,
+                std::vector<real_type>(N, 0.1), remover_type(false, false, false)));
+        }
+        {
+            using integrator_type = GJFNVTLangevinIntegrator<traits_type>;
+            this->bench_integrator(N, rho, "G-JFLangevin", integrator_type(dt,
+                std::vector<real_type>(N, 0.1), remover_type(false, false, false)));
+        }
+        this->run_velocity_verlet(N, rho, dt, is_openmp_traits<traits_type>{});
+        return;
+    }
+
+    // There is no OpenMP implementation of VelocityVerletIntegrator.
+    void run_velocity_verlet(const std::size_t N, const double rho,
+                             const real_type dt, std::false_type)
+    {
+        using integrator_type = VelocityVerletIntegrator<traits_type>;
+        this->bench_integrator(N, rho, "VelocityVerlet",
+            integrator_type(dt, remover_type(false, false, false)));
+        return;
+    }
+    void run_velocity_verlet(const std::size_t, const double,
+                             const real_type, std::true_type)
+    {
+        return;
+    }
+
+    template<typename integratorT>
+    void bench_integrator(const std::size_t N, const double rho,
+                          const std::string& name, integratorT&& integrator)
+    {
+        using celllist_type = typename celllist_of<traits_type,
+              LennardJonesPotential<traits_type>, boundary_type>::type;
+
+        if(!this->selected("integrator", name, "CellList")) {return;}
+
+        auto sys = make_lattice_system<traits_type>(N, rho, config_.seed);
+        auto ff  = make_chain_forcefield<celllist_type>(sys);
+        rng_type rng(config_.seed);
+
+        sys.initialize(rng); // generate velocities
+        ff->initialize(sys);
+        integrator.initialize(sys, ff, rng);
+
+        const auto steps = std::max<std::size_t>(1, config_.steps);
+        real_type  time(0);
+
+        auto r = this->make_result("integrator", name, "step", "CellList", N, rho);
+        r.samples = measure(config_.repeat, [] {},
+            [&] {
+                for(std::size_t i=0; i<steps; ++i)
+                {
+                    time = integrator.step(time, sys, ff, rng);
+                }
+            });
+        for(auto& s : r.samples) {s /= steps;} // time per step
+        r.metrics.emplace_back("steps_per_sample", static_cast<double>(steps));
+        this->push(std::move(r));
+        return;
+    }
+
+    // a chain polymer with bonds, angles, and Lennard-Jones between all the
+    // particles except the bonded ones.
+    template<typename celllistT>
+    static forcefield_type make_chain_forcefield(const system_type& sys)
+    {
+        using harmonic_type     = HarmonicPotential<real_type>;
+        using lennard_jones     = LennardJonesPotential<traits_type>;
+        using bond_type         = BondLengthInteraction<traits_type, harmonic_type>;
+        using angle_type        = BondAngleInteraction<traits_type, harmonic_type>;
+        using pair_type         = GlobalPairInteraction<traits_type, lennard_jones>;
+
+        LocalForceField<traits_type>      loc;
+        GlobalForceField<traits_type>     glo;
+        ExternalForceField<traits_type>   ext;
+        ConstraintForceField<traits_type> con;
+
+        loc.emplace(make_unique<bond_type>("bond", make_chain<2>(sys,
+            [](const system_type& s, const std::array<std::size_t, 2>& idx) {
+                const auto dr = s.adjust_direction(s.position(idx[0]), s.position(idx[1]));
+                return harmonic_type(10.0, math::length(dr));
+            })));
+        loc.emplace(make_unique<angle_type>("none", make_chain<3>(sys,
+            [](const system_type&, const std::array<std::size_t, 3>&) {
+                return harmonic_type(10.0, 2.0);
+            })));
+
+        std::map<typename Topology::connection_kind_type, std::size_t> exclusions;
+        exclusions["bond"] = 3;
+        glo.emplace(make_unique<pair_type>(
+            lennard_jones(lennard_jones::default_cutoff(),
+                uniform_parameters(sys.size(), typename lennard_jones::parameter_type(1.0, 1.0)),
+                exclusions, typename lennard_jones::ignore_molecule_type("Nothing"),
+                typename lennard_jones::ignore_group_type({})),
+            SpatialPartition<traits_type, lennard_jones>(
+                make_unique<celllistT>(0.5, CellListStencil::Full))));
+
+        return make_unique<ForceField<traits_type>>(std::move(loc),
+                std::move(glo), std::move(ext), std::move(con));
+    }
+
+    // -----------------------------------------------------------------------
+    // utility
+
+    bool selected(const std::string& suite, const std::string& name,
+                  const std::string& partition) const
+    {
+        if(config_.filter.empty()) {return true;}
+        const std::string key = suite + "/" + name + "/" + partition + "/" +
+            traits_name<traits_type>::invoke() + "/" +
+            boundary_maker<boundary_type>::name();
+        return key.find(config_.filter) != std::string::npos;
+    }
+
+    BenchmarkResult make_result(const std::string& suite, const std::string& name,
+            const std::string& task, const std::string& partition,
+            const std::size_t N, const double rho) const
+    {
+        BenchmarkResult r;
+        r.suite         = suite;
+        r.name          = name;
+        r.task          = task;
+        r.traits        = traits_name<traits_type>::invoke();
+        r.boundary      = boundary_maker<boundary_type>::name();
+        r.partition     = partition;
+        r.num_particles = N;
+        r.density       = rho;
+        r.threads       = number_of_threads<traits_type>::invoke();
+        return r;
+    }
+
+    void push(BenchmarkResult&& r)
+    {
+        const auto stat = make_statistics(r.samples);
+        std::cerr << r.suite << '/' << r.name << '/' << r.task << ' '
+                  << r.traits << ' ' << r.boundary << " N=" << r.num_particles
+                  << " density=" << r.density << ": median = "
+                  << stat.median * 1e3 << " [ms]\n";
+        results_.push_back(std::move(r));
+        return;
+    }
+
+  private:
+
+    BenchmarkConfig const&        config_;
+    std::vector<BenchmarkResult>& results_;
+};
+
+// ---------------------------------------------------------------------------
+// command line options
+
+template<typename T>
+std::vector<T> split_list(const std::string& str)
+{
+    std::vector<T> retval;
+    std::istringstream iss(str);
+    std::string token;
+    while(std::getline(iss, token, ','))
+    {
+        if(token.empty()) {continue;}
+        std::istringstream tss(token);
+        T value;
+        tss >> value;
+        if(tss.fail())
+        {
+            throw std::invalid_argument("mjolnir_bench: invalid value: " + token);
+        }
+        retval.push_back(value);
+    }
+    return retval;
+}
+
+inline void print_usage(std::ostream& os, const char* exe)
+{
+    os << "Usage: " << exe << " [options]\n"
+       << "  --suite=pair,partition,local,integrator  suites to run\n"
+       << "  --traits=serial,openmp                   implementations to run\n"
+       << "  --boundary=Unlimited,CuboidalPeriodic    boundary conditions\n"
+       << "  --sizes=1000,8000                        number of particles\n"
+       << "  --densities=0.1,0.8                      number densities\n"
+       << "  --repeat=10                              number of samples\n"
+       << "  --steps=10                               MD steps per sample\n"
+       << "  --max-quadratic-size=10000               largest N for Naive/VerletList\n"
+       << "  --seed=123456789                         seed to generate systems\n"
+       << "  --threads=N                              number of OpenMP threads\n"
+       << "  --filter=substring                       run cases whose key\n"
+       << "                                           (suite/name/partition/traits/boundary)\n"
+       << "                                           contains the substring\n"
+       << "  --output=file.json                       output file (default: stdout)\n";
+    return;
+}
+
+inline BenchmarkConfig parse_arguments(int argc, char** argv)
+{
+    BenchmarkConfig config;
+    config.suites     = {"pair", "partition", "local", "integrator"};
+    config.traits     = {"serial", "openmp"};
+    config.boundaries = {"Unlimited", "CuboidalPeriodic"};
+    config.sizes      = {1000, 8000};
+    config.densities  = {0.1, 0.8};
+    config.repeat     = 10;
+    config.steps      = 10;
+    config.max_quadratic_size = 10000;
+    config.seed       = 123456789;
+
+    for(int i=1; i<argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if(arg == "-h" || arg == "--help")
+        {
+            print_usage(std::cout, argv[0]);
+            std::exit(EXIT_SUCCESS);
+        }
+        const auto eq = arg.find('=');
+        if(arg.substr(0, 2) != "--" || eq == std::string::npos)
+        {
+            print_usage(std::cerr, argv[0]);
+            throw std::invalid_argument("mjolnir_bench: unknown argument: " + arg);
+        }
+        const auto key   = arg.substr(2, eq - 2);
+        const auto value = arg.substr(eq + 1);
+
+        if     (key == "suite")     {config.suites     = split_list<std::string>(value);}
+        else if(key == "traits")    {config.traits     = split_list<std::string>(value);}
+        else if(key == "boundary")  {config.boundaries = split_list<std::string>(value);}
+        else if(key == "sizes")     {config.sizes      = split_list<std::size_t>(value);}
+        else if(key == "densities") {config.densities  = split_list<double>(value);}
+        else if(key == "repeat")    {config.repeat     = split_list<std::size_t>(value).at(0);}
+        else if(key == "steps")     {config.steps      = split_list<std::size_t>(value).at(0);}
+        else if(key == "seed")      {config.seed       = split_list<std::uint32_t>(value).at(0);}
+        else if(key == "filter")    {config.filter     = value;}
+        else if(key == "output")    {config.output     = value;}
+        else if(key == "max-quadratic-size")
+        {
+            config.max_quadratic_size = split_list<std::size_t>(value).at(0);
+        }
+        else if(key == "threads")
+        {
+#ifdef MJOLNIR_WITH_OPENMP
+            omp_set_num_threads(static_cast<int>(split_list<std::size_t>(value).at(0)));
+#else
+            std::cerr << "mjolnir_bench: built without OpenMP, --threads is ignored\n";
+#endif
+        }
+        else
+        {
+            print_usage(std::cerr, argv[0]);
+            throw std::invalid_argument("mjolnir_bench: unknown option: " + key);
+        }
+    }
+    return config;
+}
+
+} // bench
+} // mjolnir
+
+int main(int argc, char** argv)
+{
+    using namespace mjolnir;
+    using namespace mjolnir::bench;
+
+    LoggerManager::set_default_logger("mjolnir_bench.log");
+
+    BenchmarkConfig config;
+    try
+    {
+        config = parse_arguments(argc, argv);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    set_kcalmol_angstrom_units<double>();
+
+    std::vector<BenchmarkResult> results;
+
+    BenchmarkRunner<SimulatorTraits<double, UnlimitedBoundary>       >(config, results).run();
+    BenchmarkRunner<SimulatorTraits<double, CuboidalPeriodicBoundary>>(config, results).run();
+#ifdef MJOLNIR_WITH_OPENMP
+    BenchmarkRunner<OpenMPSimulatorTraits<double, UnlimitedBoundary>       >(config, results).run();
+    BenchmarkRunner<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>>(config, results).run();
+#endif
+
+    std::vector<std::pair<std::string, std::string>> context;
+    context.emplace_back("version",  MJOLNIR_VERSION);
+    context.emplace_back("compiler", MJOLNIR_COMPILER_VERSION);
+#ifdef MJOLNIR_WITH_OPENMP
+    context.emplace_back("openmp_threads", std::to_string(omp_get_max_threads()));
+#else
+    context.emplace_back("openmp_threads", "0");
+#endif
+    context.emplace_back("seed", std::to_string(config.seed));
+    context.emplace_back("repeat", std::to_string(config.repeat));
+
+    if(config.output.empty())
+    {
+        write_json(std::cout, context, results);
+    }
+    else
+    {
+        std::ofstream ofs(config.output);
+        if(!ofs.good())
+        {
+            std::cerr << "mjolnir_bench: file open error: " << config.output << std::endl;
+            return EXIT_FAILURE;
+        }
+        write_json(ofs, context, results);
+    }
+    return EXIT_SUCCESS;
+}
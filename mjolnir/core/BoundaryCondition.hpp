@@ -1,6 +1,7 @@
 #ifndef MJOLNIR_CORE_BOUNDARY_CONDITION_HPP
 #define MJOLNIR_CORE_BOUNDARY_CONDITION_HPP
 #include <mjolnir/math/math.hpp>
+#include <limits>
 #include <cstddef>
 #include <cassert>
 
@@ -0,0 +1,113 @@
+#ifndef MJOLNIR_CORE_CELL_LIST_STENCIL_HPP
+#define MJOLNIR_CORE_CELL_LIST_STENCIL_HPP
+#include <mjolnir/math/math.hpp>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+namespace mjolnir
+{
+
+// The way to traverse adjacent cells while searching neighbors.
+//
+// - Full: for each particle, search all the 27 cells around its cell.
+//         All the pairs are checked twice, in i-j and j-i order.
+// - Half: for each cell, search pairs in the cell itself and pairs with 13
+//         of the adjacent cells ("half shell"). Since the other 13 cells see
+//         this cell in their half shell, each pair of cells is visited
+//         exactly once and each pair of particles is checked only once.
+//
+// Both give the same neighbor list.
+enum class CellListStencil : std::uint8_t
+{
+    Full,
+    Half,
+};
+
+template<typename charT, typename traitsT>
+std::basic_ostream<charT, traitsT>&
+operator<<(std::basic_ostream<charT, traitsT>& os, const CellListStencil s)
+{
+    switch(s)
+    {
+        case CellListStencil::Full: {os << "Full"; return os;}
+        case CellListStencil::Half: {os << "Half"; return os;}
+        default:                    {os << "Unknown"; return os;}
+    }
+}
+
+// In a grid cell list, the k-th adjacent cell has an offset of
+// (k % 3 - 1, k / 3 % 3 - 1, k / 9 - 1). The 13th is the cell itself and the
+// cells after that have a "positive" offset, i.e. (dz > 0) or (dz == 0 and
+// dy > 0) or (dz == 0 and dy == 0 and dx > 0). They form a half shell.
+constexpr std::size_t half_shell_self_index()  noexcept {return 13;}
+constexpr std::size_t half_shell_first_index() noexcept {return 14;}
+constexpr std::size_t half_shell_last_index()  noexcept {return 27;}
+
+// It checks all the pairs in the half shell of the cells in [first, last),
+// and appends {i, neighbor_of_i} to `pairs`, where i is a leading participant
+// (is_leading[i] != 0) that has an interaction with the neighbor.
+//
+// Since `has_interaction(i, j)` might not be symmetric, both i-j and j-i are
+// checked. The result is the same as the full traversal that looks all the
+// 27 cells around each leading participant.
+template<typename systemT, typename potentialT, typename cellListT,
+         typename neighborT>
+void find_half_shell_pairs(const systemT& sys, const potentialT& pot,
+        const cellListT& cell_list, const std::vector<char>& is_leading,
+        const std::size_t first, const std::size_t last,
+        const typename systemT::real_type r_c2,
+        std::vector<std::pair<std::size_t, neighborT>>& pairs)
+{
+    const auto check_pair = [&](const std::size_t i, const std::size_t j)
+    {
+        const bool ij = (is_leading[i] != 0) && pot.has_interaction(i, j);
+        const bool ji = (is_leading[j] != 0) && pot.has_interaction(j, i);
+        if(!ij && !ji)
+        {
+            return;
+        }
+        const auto& ri = sys.position(i);
+        const auto& rj = sys.position(j);
+        if(r_c2 <= math::length_sq(sys.adjust_direction(ri, rj)))
+        {
+            return;
+        }
+        if(ij) {pairs.emplace_back(i, neighborT(j, pot.prepare_params(i, j)));}
+        if(ji) {pairs.emplace_back(j, neighborT(i, pot.prepare_params(j, i)));}
+        return;
+    };
+
+    for(std::size_t cell_idx=first; cell_idx<last; ++cell_idx)
+    {
+        const auto& cell = cell_list[cell_idx];
+        assert(cell.second[half_shell_self_index()] == cell_idx);
+
+        const auto& self = cell.first;
+        for(auto iter = self.begin(); iter != self.end(); ++iter)
+        {
+            for(auto jter = iter + 1; jter != self.end(); ++jter)
+            {
+                check_pair(iter->first, jter->first);
+            }
+        }
+        for(std::size_t k =  half_shell_first_index();
+                        k != half_shell_last_index(); ++k)
+        {
+            const auto& other = cell_list[cell.second[k]].first;
+            for(const auto& pici : self)
+            {
+                for(const auto& pjcj : other)
+                {
+                    check_pair(pici.first, pjcj.first);
+                }
+            }
+        }
+    }
+    return;
+}
+
+} // mjolnir
+#endif // MJOLNIR_CORE_CELL_LIST_STENCIL_HPP
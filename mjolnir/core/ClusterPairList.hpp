@@ -0,0 +1,192 @@
+#ifndef MJOLNIR_CORE_CLUSTER_PAIR_LIST_HPP
+#define MJOLNIR_CORE_CLUSTER_PAIR_LIST_HPP
+#include <mjolnir/core/NeighborList.hpp>
+#include <mjolnir/util/range.hpp>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace mjolnir
+{
+
+// ClusterPairList is another representation of NeighborList.
+//
+// Particles are grouped into clusters of `ClusterSize` particles that are
+// close in space. For each pair of clusters (I, J) that has at least one
+// interacting pair, it stores a block of ClusterSize x ClusterSize lanes.
+// The bit `a * ClusterSize + b` of the mask is set if the pair of a-th particle
+// in I and b-th particle in J is in the NeighborList. Excluded pairs, pairs
+// beyond the cutoff + margin, and the padding in the last cluster are masked.
+//
+// Since the positions of a cluster are loaded once and reused for all the
+// lanes in a block, the inner loop over a block maps directly onto SIMD lanes
+// without the per-pair gather of the normal NeighborList.
+//
+//    J:  j0  j1  j2  j3
+//   I: +---+---+---+---+
+//   i0 | 1 | 1 | 0 | 1 |   mask = 0b...1011
+//   i1 | 0 | 1 | 1 | 0 |   params[a * ClusterSize + b] = {param of (ia, jb)}
+//   ...
+//
+// Each pair in the NeighborList appears exactly once in the blocks, so the
+// forces are calculated in the same way as the normal (half) list.
+template<typename parameterT, std::size_t ClusterSize>
+class ClusterPairList
+{
+  public:
+    static constexpr std::size_t cluster_size = ClusterSize;
+    static constexpr std::size_t block_size   = ClusterSize * ClusterSize;
+    static_assert(block_size <= 64, "mask of a block should fit in 64 bits");
+
+    using parameter_type     = parameterT;
+    using neighbor_list_type = NeighborList<parameter_type>;
+    using index_type         = std::uint32_t;
+    using mask_type          = std::uint64_t;
+
+    struct block_type
+    {
+        index_type j_cluster;
+        mask_type  mask;
+    };
+    using container_type = std::vector<block_type>;
+    using range_type     = range<typename container_type::const_iterator>;
+
+  public:
+
+    ClusterPairList()  = default;
+    ~ClusterPairList() = default;
+    ClusterPairList(const ClusterPairList&) = default;
+    ClusterPairList(ClusterPairList&&)      = default;
+    ClusterPairList& operator=(const ClusterPairList&) = default;
+    ClusterPairList& operator=(ClusterPairList&&)      = default;
+
+    // `ordered` is the participants sorted so that successive particles are
+    // close in space (e.g. along the z-order curve). They are grouped in
+    // this order. `leading` is the particles that have partners in `nlist`.
+    template<typename leadingRangeT>
+    void make(const std::vector<std::size_t>& ordered,
+              const leadingRangeT& leading, const neighbor_list_type& nlist,
+              const std::size_t num_particles)
+    {
+        constexpr index_type nil = std::numeric_limits<index_type>::max();
+
+        const std::size_t num_clusters =
+            (ordered.size() + cluster_size - 1) / cluster_size;
+
+        // the last cluster is padded with its first particle. padded lanes
+        // are always masked.
+        this->members_.resize(num_clusters * cluster_size);
+        this->sizes_  .resize(num_clusters);
+        this->cluster_of_.assign(num_particles, nil);
+        this->slot_of_   .assign(num_particles, nil);
+        for(std::size_t idx=0; idx<members_.size(); ++idx)
+        {
+            const std::size_t c = idx / cluster_size;
+            const std::size_t s = idx % cluster_size;
+            if(idx < ordered.size())
+            {
+                const auto i = ordered[idx];
+                members_[idx]  = static_cast<index_type>(i);
+                cluster_of_[i] = static_cast<index_type>(c);
+                slot_of_   [i] = static_cast<index_type>(s);
+                sizes_[c]      = static_cast<index_type>(s + 1);
+            }
+            else
+            {
+                members_[idx] = members_[c * cluster_size];
+            }
+        }
+
+        this->is_leading_.assign(num_particles, false);
+        for(const auto i : leading)
+        {
+            is_leading_[i] = true;
+        }
+
+        this->blocks_.clear();
+        this->params_.clear();
+        this->ranges_.assign(num_clusters + 1, 0);
+        this->block_of_.assign(num_clusters, nil);
+        for(std::size_t c=0; c<num_clusters; ++c)
+        {
+            const std::size_t first = blocks_.size();
+            for(std::size_t a=0; a<sizes_[c]; ++a)
+            {
+                const auto i = members_[c * cluster_size + a];
+                if(!is_leading_[i]) {continue;}
+
+                for(const auto& ptnr : nlist[i])
+                {
+                    const auto J = cluster_of_[ptnr.index];
+                    const auto b = slot_of_   [ptnr.index];
+                    assert(J != nil);
+                    if(block_of_[J] == nil)
+                    {
+                        block_of_[J] = static_cast<index_type>(blocks_.size());
+                        blocks_.push_back(block_type{J, 0});
+                        // unused lanes have a valid parameter so that the
+                        // kernels do not produce NaN there.
+                        params_.resize(params_.size() + block_size,
+                                       ptnr.parameter());
+                    }
+                    const std::size_t k = block_of_[J];
+                    const std::size_t lane = a * cluster_size + b;
+                    blocks_[k].mask |= (mask_type(1) << lane);
+                    params_[k * block_size + lane] = ptnr.parameter();
+                }
+            }
+            for(std::size_t k=first; k<blocks_.size(); ++k)
+            {
+                block_of_[blocks_[k].j_cluster] = nil;
+            }
+            ranges_[c+1] = blocks_.size();
+        }
+        return;
+    }
+
+    std::size_t num_clusters() const noexcept {return sizes_.size();}
+    std::size_t num_blocks()   const noexcept {return blocks_.size();}
+
+    // indices of particles in a cluster, padded to cluster_size.
+    index_type const* members(const std::size_t c) const noexcept
+    {
+        return members_.data() + c * cluster_size;
+    }
+    // number of actual particles in a cluster.
+    std::size_t size(const std::size_t c) const noexcept {return sizes_[c];}
+
+    // blocks in which cluster `c` is the i-cluster.
+    range_type blocks(const std::size_t c) const noexcept
+    {
+        return range_type{blocks_.begin() + ranges_[c],
+                          blocks_.begin() + ranges_[c+1]};
+    }
+    // parameters of the lanes in a block.
+    parameter_type const* parameters(const block_type& blk) const noexcept
+    {
+        return params_.data() + (&blk - blocks_.data()) * block_size;
+    }
+
+  private:
+
+    std::vector<index_type>     members_; // cluster_size * num_clusters
+    std::vector<index_type>     sizes_;
+    container_type              blocks_;
+    std::vector<parameter_type> params_;  // block_size * num_blocks
+    std::vector<std::size_t>    ranges_;  // num_clusters + 1
+
+    // buffers used in `make`
+    std::vector<index_type>     cluster_of_;
+    std::vector<index_type>     slot_of_;
+    std::vector<index_type>     block_of_;
+    std::vector<bool>           is_leading_;
+};
+
+template<typename parameterT, std::size_t N>
+constexpr std::size_t ClusterPairList<parameterT, N>::cluster_size;
+template<typename parameterT, std::size_t N>
+constexpr std::size_t ClusterPairList<parameterT, N>::block_size;
+
+} // mjolnir
+#endif// MJOLNIR_CORE_CLUSTER_PAIR_LIST_HPP
@@ -3,8 +3,10 @@
 #include <mjolnir/core/ObserverBase.hpp>
 #include <mjolnir/core/BoundaryCondition.hpp>
 #include <mjolnir/core/System.hpp>
+#include <mjolnir/core/SnapshotBuffer.hpp>
+#include <mjolnir/util/buffered_file_writer.hpp>
+#include <mjolnir/util/background_worker.hpp>
 #include <iostream>
-#include <fstream>
 #include <iomanip>
 #include <cassert>
 
@@ -21,32 +23,44 @@ class DCDObserver final : public ObserverBase<traitsT>
     using coordinate_type   = typename base_type::coordinate_type;
     using system_type       = typename base_type::system_type;
     using forcefield_type   = typename base_type::forcefield_type;
+    using boundary_type     = typename traits_type::boundary_type;
+    using worker_type       = std::shared_ptr<BackgroundWorker>;
+    using snapshot_type     = typename SnapshotBuffer<traitsT>::snapshot_type;
 
   public:
 
-    explicit DCDObserver(const std::string& filename_prefix)
+    // files are kept open until the observer is destructed. `flush_interval`
+    // and `fsync_interval` are passed to BufferedFileWriter. If `worker` is
+    // given, frames are written in the background.
+    explicit DCDObserver(const std::string& filename_prefix,
+                         const std::size_t  flush_interval = 1,
+                         const std::size_t  fsync_interval = 0,
+                         worker_type        worker = nullptr)
       : base_type(), prefix_(filename_prefix),
         pos_name_(filename_prefix + std::string("_position.dcd")),
         vel_name_(filename_prefix + std::string("_velocity.dcd")),
-        number_of_frames_(0)
+        number_of_particles_(0), number_of_frames_(0),
+        // it throws an error if the files cannot be opened.
+        pos_file_(pos_name_, flush_interval, fsync_interval),
+        vel_file_(vel_name_, flush_interval, fsync_interval),
+        worker_(std::move(worker))
+    {}
+    ~DCDObserver() override
     {
-        // clear files and throw an error if the files cannot be opened.
-        this->clear_file(this->pos_name_);
-        this->clear_file(this->vel_name_);
+        // tasks in the worker refer this.
+        if(this->worker_) {this->worker_->drain();}
     }
-    ~DCDObserver() override {}
 
     void initialize(const std::size_t total_step,
                     const std::size_t save_interval, const real_type dt,
                     const system_type& sys, const forcefield_type& ff) override
     {
-        this->write_header(this->pos_name_, total_step, save_interval, dt, sys, ff);
-        this->write_header(this->vel_name_, total_step, save_interval, dt, sys, ff);
+        this->write_header(this->pos_file_, total_step, save_interval, dt, sys, ff);
+        this->write_header(this->vel_file_, total_step, save_interval, dt, sys, ff);
+        this->pos_file_.flush();
+        this->vel_file_.flush();
 
-        // buffer to convert sys and dcd format
-        this->buffer_x_.resize(sys.size());
-        this->buffer_y_.resize(sys.size());
-        this->buffer_z_.resize(sys.size());
+        this->number_of_particles_ = sys.size();
         return;
     }
 
@@ -55,15 +69,13 @@ class DCDObserver final : public ObserverBase<traitsT>
     {
         MJOLNIR_GET_DEFAULT_LOGGER();
         MJOLNIR_LOG_FUNCTION();
-        if(sys.size() != this->buffer_x_.size())
+        if(sys.size() != this->number_of_particles_)
         {
             MJOLNIR_LOG_NOTICE("the number of particles changed.");
             MJOLNIR_LOG_NOTICE("Most of dcd file readers assumes it is a constant.");
             MJOLNIR_LOG_NOTICE("It may cause some problems.");
 
-            this->buffer_x_.resize(sys.size());
-            this->buffer_y_.resize(sys.size());
-            this->buffer_z_.resize(sys.size());
+            this->number_of_particles_ = sys.size();
         }
         return;
     }
@@ -74,126 +86,131 @@ class DCDObserver final : public ObserverBase<traitsT>
     void finalize(const std::size_t, const real_type,
                   const system_type&, const forcefield_type&) override
     {
-        // update # of frames in the header region
-        {
-            // both `in` and `out` flags are needed to keep the other parts of
-            // file. otherwise, we will lost almost everything by overwriting.
-            // Also `ate` should be used instead of `app`, because `app` moves
-            // the position automatically at the end when we call `write`.
-
-            std::ofstream ofs(this->pos_name_,
-                std::ios::binary | std::ios::ate | std::ios::in | std::ios::out);
-            // skip the first block size and the signature "CORD"
-            ofs.seekp(2 * sizeof(std::int32_t), std::ios::beg);
-
-            const std::int32_t number_of_frames(this->number_of_frames_);
-            detail::write_as_bytes(ofs, number_of_frames);
-        }
-        {
-            std::ofstream ofs(this->vel_name_,
-                std::ios::binary | std::ios::ate | std::ios::in | std::ios::out);
-            // skip the first block size and the signature "CORD"
-            ofs.seekp(2 * sizeof(std::int32_t), std::ios::beg);
-
-            const std::int32_t number_of_frames(this->number_of_frames_);
-            detail::write_as_bytes(ofs, number_of_frames);
-        }
+        // write the remaining frames and update # of frames in the header
+        run_in_background(this->worker_, [this] {
+                this->pos_file_.apply_patch();
+                this->vel_file_.apply_patch();
+            });
+        if(this->worker_) {this->worker_->wait();}
         return;
     }
 
     std::string const& prefix() const noexcept override {return prefix_;}
+    std::string        name()   const          override {return "dcd";}
 
   private:
 
-    void clear_file(const std::string& fname) const
+    // `frameT` is either system_type or snapshot_type.
+    template<typename frameT>
+    void write_frame(const frameT& frame, const std::size_t number_of_frames);
+
+    // the number of frames in the header is written when the file is synced
+    // or finalized, not in every frame. see BufferedFileWriter::patch.
+    void update_number_of_frames(BufferedFileWriter& ofs,
+                                 const std::size_t number_of_frames) const
     {
-        std::ofstream ofs(fname);
-        if(not ofs.good())
+        // skip the first block size and the signature "CORD"
+        const std::int32_t number_of_frames_i32(number_of_frames);
+        ofs.patch_as_bytes(2 * sizeof(std::int32_t), number_of_frames_i32);
+        return;
+    }
+
+    // write buffer_{x,y,z}_ as 3 blocks.
+    void write_coordinates(BufferedFileWriter& ofs) const
+    {
+        const std::int32_t block_size(sizeof(float) * this->buffer_x_.size());
+        {
+            ofs.write_as_bytes(block_size);
+            ofs.write(reinterpret_cast<const char*>(this->buffer_x_.data()),
+                      block_size);
+            ofs.write_as_bytes(block_size);
+        }
+        {
+            ofs.write_as_bytes(block_size);
+            ofs.write(reinterpret_cast<const char*>(this->buffer_y_.data()),
+                      block_size);
+            ofs.write_as_bytes(block_size);
+        }
         {
-            throw_exception<std::runtime_error>("[error] mjolnir::DCDObserver: "
-                    "file open error: ", fname);
+            ofs.write_as_bytes(block_size);
+            ofs.write(reinterpret_cast<const char*>(this->buffer_z_.data()),
+                      block_size);
+            ofs.write_as_bytes(block_size);
         }
         return;
     }
 
-    void write_header(const std::string& fname, const std::size_t total_step,
+    void write_header(BufferedFileWriter& ofs, const std::size_t total_step,
                       const std::size_t  save_interval, const real_type dt,
                       const system_type& sys, const forcefield_type& ff) const
     {
-        std::ofstream ofs(fname, std::ios::binary | std::ios::app);
-        if(not ofs.good())
-        {
-            throw_exception<std::runtime_error>(
-                    "[error] mjolnir::DCDObserver: file open error: ", fname);
-        }
-
         /* the first block */
         {
             const std::int32_t block_size(84);
-            detail::write_as_bytes(ofs, block_size);
+            ofs.write_as_bytes(block_size);
 
             ofs.write("CORD", 4);
 
             // Later, in the finalize(), this value will be updated
             const std::int32_t number_of_frames(0);
-            detail::write_as_bytes(ofs, number_of_frames);
+            ofs.write_as_bytes(number_of_frames);
 
             const std::int32_t index_of_first(0);
-            detail::write_as_bytes(ofs, index_of_first);
+            ofs.write_as_bytes(index_of_first);
 
             const std::int32_t save_interval_i32(save_interval);
-            detail::write_as_bytes(ofs, save_interval_i32);
+            ofs.write_as_bytes(save_interval_i32);
 
             const std::int32_t total_step_i32(total_step);
-            detail::write_as_bytes(ofs, total_step_i32);
+            ofs.write_as_bytes(total_step_i32);
 
             const std::int32_t total_chains(ff->topology().number_of_molecules());
-            detail::write_as_bytes(ofs, total_chains);
+            ofs.write_as_bytes(total_chains);
 
             const std::int32_t zero(0);
             // 4 * integers with null flag
-            for(std::size_t i=0; i<4; ++i) {detail::write_as_bytes(ofs, zero);}
+            for(std::size_t i=0; i<4; ++i) {ofs.write_as_bytes(zero);}
 
             const float delta_t(dt);
-            detail::write_as_bytes(ofs, delta_t);
+            ofs.write_as_bytes(delta_t);
 
             const std::int32_t has_unitcell =
                 DCDObserver<traitsT>::unitcell_flag(sys.boundary());
-            detail::write_as_bytes(ofs, has_unitcell);
+            ofs.write_as_bytes(has_unitcell);
 
             // 8 * integers with null flag
-            for(std::size_t i=0; i<8; ++i) {detail::write_as_bytes(ofs, zero);}
+            for(std::size_t i=0; i<8; ++i) {ofs.write_as_bytes(zero);}
 
             const std::int32_t version(24);
-            detail::write_as_bytes(ofs, version);
+            ofs.write_as_bytes(version);
 
-            detail::write_as_bytes(ofs, block_size);
+            ofs.write_as_bytes(block_size);
         }
 
         /* the second block */
         {
             const std::int32_t block_size(84);
-            detail::write_as_bytes(ofs, block_size);
+            ofs.write_as_bytes(block_size);
 
             const std::int32_t number_of_lines(1);
-            detail::write_as_bytes(ofs, number_of_lines);
+            ofs.write_as_bytes(number_of_lines);
 
             const char comment[80] = "Mjolnir -- copyright (c) Toru Niina 2016"
                                      "-now distributed under the MIT License.";
             ofs.write(comment, 80);
 
-            detail::write_as_bytes(ofs, block_size);
+            ofs.write_as_bytes(block_size);
         }
 
         /* the third block */
         {
             const std::int32_t block_size(4);
-            detail::write_as_bytes(ofs, block_size);
+            ofs.write_as_bytes(block_size);
 
             const std::int32_t number_of_particles(sys.size());
-            detail::write_as_bytes(ofs, number_of_particles);
+            ofs.write_as_bytes(number_of_particles);
 
-            detail::write_as_bytes(ofs, block_size);
+            ofs.write_as_bytes(block_size);
         }
         return;
     }
@@ -216,14 +233,14 @@ class DCDObserver final : public ObserverBase<traitsT>
 
     // it is a helper function to write unitcell block if needed.
     // for UnlimitedBoundary, do nothing.
-    static void write_unitcell_if_needed(std::ostream&,
+    static void write_unitcell_if_needed(BufferedFileWriter&,
         const UnlimitedBoundary<real_type, coordinate_type>&) noexcept
     {
         return ; // do nothing. boundary does not exists.
     }
     // for CuboidalPeriodicBoundary, writes the boundary width and angles
-    static void write_unitcell_if_needed(std::ostream& os,
-        const CuboidalPeriodicBoundary<real_type, coordinate_type>& boundary) noexcept
+    static void write_unitcell_if_needed(BufferedFileWriter& os,
+        const CuboidalPeriodicBoundary<real_type, coordinate_type>& boundary)
     {
         // unit cell length
         const double A = math::X(boundary.width());
@@ -238,17 +255,17 @@ class DCDObserver final : public ObserverBase<traitsT>
         const double gamma = 90.0;
 
         const std::int32_t block_size = sizeof(double) * 6;
-        detail::write_as_bytes(os, block_size);
+        os.write_as_bytes(block_size);
 
         // I'm serious. the order is correct.
-        detail::write_as_bytes(os, A    );
-        detail::write_as_bytes(os, gamma);
-        detail::write_as_bytes(os, B    );
-        detail::write_as_bytes(os, beta );
-        detail::write_as_bytes(os, alpha);
-        detail::write_as_bytes(os, C    );
-
-        detail::write_as_bytes(os, block_size);
+        os.write_as_bytes(A    );
+        os.write_as_bytes(gamma);
+        os.write_as_bytes(B    );
+        os.write_as_bytes(beta );
+        os.write_as_bytes(alpha);
+        os.write_as_bytes(C    );
+
+        os.write_as_bytes(block_size);
         return ;
     }
 
@@ -257,7 +274,14 @@ class DCDObserver final : public ObserverBase<traitsT>
     std::string prefix_;
     std::string pos_name_;
     std::string vel_name_;
+    std::size_t number_of_particles_;
     std::size_t number_of_frames_;
+    BufferedFileWriter pos_file_;
+    BufferedFileWriter vel_file_;
+    worker_type        worker_;
+    SnapshotBuffer<traitsT> snapshots_;
+
+    // buffer to convert sys and dcd format. used only in write_frame.
     std::vector<float> buffer_x_;
     std::vector<float> buffer_y_;
     std::vector<float> buffer_z_;
@@ -269,73 +293,63 @@ inline void DCDObserver<traitsT>::output(
     const system_type& sys, const forcefield_type&)
 {
     number_of_frames_ += 1;
-    assert(this->buffer_x_.size() == sys.size());
-    assert(this->buffer_y_.size() == sys.size());
-    assert(this->buffer_z_.size() == sys.size());
+    if(!this->worker_)
+    {
+        this->write_frame(sys, this->number_of_frames_);
+        return ;
+    }
+
+    // take a snapshot. it is written in the background while the simulation
+    // continues.
+    auto& snapshot = this->snapshots_.acquire(*this->worker_);
+    snapshot.take(sys, /*forces = */ false);
+
+    const std::size_t number_of_frames = this->number_of_frames_;
+    this->worker_->push([this, &snapshot, number_of_frames] {
+            this->write_frame(snapshot, number_of_frames);
+            snapshot.release();
+        });
+    return ;
+}
+
+template<typename traitsT>
+template<typename frameT>
+inline void DCDObserver<traitsT>::write_frame(const frameT& frame,
+                                              const std::size_t number_of_frames)
+{
+    const std::size_t N = frame.size();
+    this->buffer_x_.resize(N);
+    this->buffer_y_.resize(N);
+    this->buffer_z_.resize(N);
 
     // ------------------------------------------------------------------------
     // write position
     {
-        std::ofstream ofs(this->pos_name_, std::ios::app | std::ios::binary);
+        DCDObserver<traitsT>::write_unitcell_if_needed(pos_file_, frame.boundary());
 
-        DCDObserver<traitsT>::write_unitcell_if_needed(ofs, sys.boundary());
-
-        for(std::size_t i=0; i<sys.size(); ++i)
+        for(std::size_t i=0; i<N; ++i)
         {
-            this->buffer_x_[i] = static_cast<float>(math::X(sys.position(i)));
-            this->buffer_y_[i] = static_cast<float>(math::Y(sys.position(i)));
-            this->buffer_z_[i] = static_cast<float>(math::Z(sys.position(i)));
-        }
-        const std::int32_t block_size(sizeof(float) * sys.size());
-        {
-            detail::write_as_bytes(ofs, block_size);
-            ofs.write(reinterpret_cast<const char*>(this->buffer_x_.data()),
-                      block_size);
-            detail::write_as_bytes(ofs, block_size);
-        }
-        {
-            detail::write_as_bytes(ofs, block_size);
-            ofs.write(reinterpret_cast<const char*>(this->buffer_y_.data()),
-                      block_size);
-            detail::write_as_bytes(ofs, block_size);
-        }
-        {
-            detail::write_as_bytes(ofs, block_size);
-            ofs.write(reinterpret_cast<const char*>(this->buffer_z_.data()),
-                      block_size);
-            detail::write_as_bytes(ofs, block_size);
+            this->buffer_x_[i] = static_cast<float>(math::X(frame.position(i)));
+            this->buffer_y_[i] = static_cast<float>(math::Y(frame.position(i)));
+            this->buffer_z_[i] = static_cast<float>(math::Z(frame.position(i)));
         }
+        this->write_coordinates(this->pos_file_);
+        this->update_number_of_frames(this->pos_file_, number_of_frames);
+        this->pos_file_.end_frame();
     }
 
     // ------------------------------------------------------------------------
     // write velocity
     {
-        std::ofstream ofs(this->vel_name_, std::ios::app | std::ios::binary);
-        for(std::size_t i=0; i<sys.size(); ++i)
-        {
-            this->buffer_x_[i] = static_cast<float>(math::X(sys.velocity(i)));
-            this->buffer_y_[i] = static_cast<float>(math::Y(sys.velocity(i)));
-            this->buffer_z_[i] = static_cast<float>(math::Z(sys.velocity(i)));
-        }
-        const std::int32_t block_size(sizeof(float) * sys.size());
-        {
-            detail::write_as_bytes(ofs, block_size);
-            ofs.write(reinterpret_cast<const char*>(this->buffer_x_.data()),
-                      block_size);
-            detail::write_as_bytes(ofs, block_size);
-        }
+        for(std::size_t i=0; i<N; ++i)
         {
-            detail::write_as_bytes(ofs, block_size);
-            ofs.write(reinterpret_cast<const char*>(this->buffer_y_.data()),
-                      block_size);
-            detail::write_as_bytes(ofs, block_size);
-        }
-        {
-            detail::write_as_bytes(ofs, block_size);
-            ofs.write(reinterpret_cast<const char*>(this->buffer_z_.data()),
-                      block_size);
-            detail::write_as_bytes(ofs, block_size);
+            this->buffer_x_[i] = static_cast<float>(math::X(frame.velocity(i)));
+            this->buffer_y_[i] = static_cast<float>(math::Y(frame.velocity(i)));
+            this->buffer_z_[i] = static_cast<float>(math::Z(frame.velocity(i)));
         }
+        this->write_coordinates(this->vel_file_);
+        this->update_number_of_frames(this->vel_file_, number_of_frames);
+        this->vel_file_.end_frame();
     }
     return ;
 }
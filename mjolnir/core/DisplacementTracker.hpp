@@ -0,0 +1,85 @@
+#ifndef MJOLNIR_CORE_DISPLACEMENT_TRACKER_HPP
+#define MJOLNIR_CORE_DISPLACEMENT_TRACKER_HPP
+#include <mjolnir/core/System.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <cmath>
+
+namespace mjolnir
+{
+
+// DisplacementTracker keeps the positions of particles at the time when the
+// neighbor list was constructed. A neighbor list that was built with a buffer
+// (margin) of length `skin` is still valid as long as no pair of particles
+// approaches each other by more than `skin`. Since a pair can approach by at
+// most the sum of their displacements, it is enough to check the two largest
+// displacements since the last construction.
+//
+// Unlike the sum of the largest displacement in each step, it does not grow
+// when particles just diffuse back and forth, so the list is re-constructed
+// less frequently.
+template<typename traitsT>
+class DisplacementTracker
+{
+  public:
+    using traits_type     = traitsT;
+    using system_type     = System<traits_type>;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+
+  public:
+
+    DisplacementTracker()  = default;
+    ~DisplacementTracker() = default;
+    DisplacementTracker(DisplacementTracker const&) = default;
+    DisplacementTracker(DisplacementTracker &&)     = default;
+    DisplacementTracker& operator=(DisplacementTracker const&) = default;
+    DisplacementTracker& operator=(DisplacementTracker &&)     = default;
+
+    // store the current positions of the participants.
+    void record(const system_type& sys, const std::vector<std::size_t>& ps)
+    {
+        this->participants_ = ps;
+        this->references_.resize(ps.size());
+        for(std::size_t idx=0; idx<ps.size(); ++idx)
+        {
+            this->references_[idx] = sys.position(ps[idx]);
+        }
+        return;
+    }
+
+    // returns the sum of the two largest displacements after the last record.
+    real_type largest_displacements(const system_type& sys) const noexcept
+    {
+        real_type max1 = 0; // largest
+        real_type max2 = 0; // second largest
+        for(std::size_t idx=0; idx<participants_.size(); ++idx)
+        {
+            const auto dr = sys.adjust_direction(references_[idx],
+                                                 sys.position(participants_[idx]));
+            const auto d2 = math::length_sq(dr);
+            if(max1 < d2)
+            {
+                max2 = max1;
+                max1 = d2;
+            }
+            else if(max2 < d2)
+            {
+                max2 = d2;
+            }
+        }
+        return std::sqrt(max1) + std::sqrt(max2);
+    }
+
+    std::vector<std::size_t> const& participants() const noexcept {return participants_;}
+    std::vector<coordinate_type> const& references() const noexcept {return references_;}
+
+  private:
+
+    std::vector<std::size_t>     participants_;
+    std::vector<coordinate_type> references_;
+};
+
+} // mjolnir
+#endif// MJOLNIR_CORE_DISPLACEMENT_TRACKER_HPP
@@ -3,8 +3,11 @@
 #include <mjolnir/util/is_finite.hpp>
 #include <mjolnir/core/ObserverBase.hpp>
 #include <mjolnir/core/Unit.hpp>
+#include <mjolnir/util/buffered_file_writer.hpp>
+#include <mjolnir/util/background_worker.hpp>
+#include <mjolnir/util/profiler.hpp>
 #include <iostream>
-#include <fstream>
+#include <sstream>
 #include <iomanip>
 
 namespace mjolnir
@@ -21,22 +24,39 @@ class EnergyObserver final : public ObserverBase<traitsT>
     using system_type       = typename base_type::system_type;
     using forcefield_type   = typename base_type::forcefield_type;
     using boundary_type     = typename traits_type::boundary_type;
+    using worker_type       = std::shared_ptr<BackgroundWorker>;
 
   public:
 
-    explicit EnergyObserver(const std::string& filename_prefix)
-      : prefix_(filename_prefix), file_name_(filename_prefix + ".ene")
+    // the file is kept open until the observer is destructed.
+    // `flush_interval` and `fsync_interval` are passed to BufferedFileWriter.
+    // If `worker` is given, lines are written in the background. Energies are
+    // always calculated in the caller thread.
+    // If `output_profile` is true, the time spent in each profiled part since
+    // the last output is written in milliseconds after the other columns. It
+    // requires MJOLNIR_WITH_PROFILER.
+    explicit EnergyObserver(const std::string& filename_prefix,
+                            const std::size_t  flush_interval = 1,
+                            const std::size_t  fsync_interval = 0,
+                            worker_type        worker = nullptr,
+                            const bool         output_profile = false)
+      : output_profile_(output_profile),
+        prefix_(filename_prefix), file_name_(filename_prefix + ".ene"),
+        // it throws an error if the file cannot be opened.
+        file_(file_name_, flush_interval, fsync_interval),
+        worker_(std::move(worker))
+    {}
+    ~EnergyObserver() override
     {
-        // clear files and throw an error if the files cannot be opened.
-        this->clear_file(this->file_name_);
+        // tasks in the worker refer this.
+        if(this->worker_) {this->worker_->drain();}
     }
-    ~EnergyObserver() override {}
 
     void initialize(const std::size_t, const std::size_t, const real_type,
                     const system_type& sys, const forcefield_type& ff) override
     {
         using phys_constants = physics::constants<real_type>;
-        std::ofstream ofs(this->file_name_, std::ios::app);
+        std::ostringstream ofs;
         ofs << "# unit of length : " << phys_constants::length_unit()
             << ", unit of energy : " << phys_constants::energy_unit() << '\n';
         ofs << "# timestep  ";
@@ -50,7 +70,9 @@ class EnergyObserver final : public ObserverBase<traitsT>
         {
             ofs << " attribute:" << attr.first;
         }
+        this->format_profile_name(ofs);
         ofs << '\n';
+        this->write_line(ofs.str(), /*end_of_frame = */false);
         return;
     }
 
@@ -58,7 +80,7 @@ class EnergyObserver final : public ObserverBase<traitsT>
     void update(const std::size_t,  const real_type,
                 const system_type& sys, const forcefield_type& ff) override
     {
-        std::ofstream ofs(this->file_name_, std::ios::app);
+        std::ostringstream ofs;
         ofs << "# timestep  ";
 
         std::string names;
@@ -70,7 +92,9 @@ class EnergyObserver final : public ObserverBase<traitsT>
         {
             ofs << " attribute:" << attr.first;
         }
+        this->format_profile_name(ofs);
         ofs << '\n';
+        this->write_line(ofs.str(), /*end_of_frame = */false);
         return;
     }
 
@@ -78,12 +102,14 @@ class EnergyObserver final : public ObserverBase<traitsT>
                 const system_type& sys, const forcefield_type& ff) override
     {
         bool is_ok = true;
-        std::ofstream ofs(this->file_name_, std::ios::app);
+        std::ostringstream ofs;
 
         // if the width exceeds, operator<<(std::ostream, std::string) ignores
         // ostream::width and outputs whole string.
         ofs << std::setw(11) << std::left << std::to_string(step) << ' ';
 
+        // if the forcefield calculated energies together with forces in the
+        // last step, it formats them without calculating energies again.
         std::string energies;
         const auto potential_energy = ff->format_energy(sys, energies);
         ofs << energies;
@@ -119,23 +145,88 @@ class EnergyObserver final : public ObserverBase<traitsT>
             ofs << ' ' << std::setw(10 + attr.first.size()) << std::right
                 << std::fixed << attr.second;
         }
-        ofs << std::endl; // flush before throwing an exception
+        this->format_profile(ofs);
+        ofs << '\n';
 
         if(!is_ok)
         {
+            this->write_line(ofs.str(), /*end_of_frame = */false);
+            this->flush(); // flush before throwing an exception
             throw std::runtime_error("Energy value becomes NaN");
         }
+        this->write_line(ofs.str(), /*end_of_frame = */true);
         return;
     }
 
     void finalize(const std::size_t, const real_type,
                   const system_type&, const forcefield_type&) override
-    {/* do nothing. */}
+    {
+        this->flush();
+        return;
+    }
 
     std::string const& prefix() const noexcept override {return this->prefix_;}
+    std::string        name()   const          override {return "ene";}
 
   private:
 
+#ifdef MJOLNIR_WITH_PROFILER
+    // counters registered after this are not written until the next update.
+    void format_profile_name(std::ostream& os)
+    {
+        if(!this->output_profile_) {return;}
+
+        this->profile_counters_ = ProfileManager::counters();
+        this->profile_ticks_.clear();
+        for(const auto* counter : this->profile_counters_)
+        {
+            os << " profile:" << counter->name;
+            this->profile_ticks_.push_back(counter->ticks);
+        }
+        return;
+    }
+    // milliseconds spent since the last output
+    void format_profile(std::ostream& os)
+    {
+        if(!this->output_profile_) {return;}
+
+        const double ms_per_tick = ProfileManager::seconds_per_tick() * 1e3;
+        for(std::size_t i=0; i<this->profile_counters_.size(); ++i)
+        {
+            const auto* counter = this->profile_counters_[i];
+            const auto  dt = counter->ticks - this->profile_ticks_[i];
+            this->profile_ticks_[i] = counter->ticks;
+
+            os << ' ' << std::setw(8 + counter->name.size()) << std::right
+               << std::fixed << std::setprecision(3) << dt * ms_per_tick;
+        }
+        return;
+    }
+#else
+    // no counter is registered without the profiler.
+    void format_profile_name(std::ostream&) {return;}
+    void format_profile     (std::ostream&) {return;}
+#endif
+
+    // header lines are not counted as frames.
+    void write_line(std::string line, const bool end_of_frame)
+    {
+        // C++11 lambda cannot capture by move.
+        const auto str = std::make_shared<std::string>(std::move(line));
+        run_in_background(this->worker_, [this, str, end_of_frame] {
+                this->file_.write(*str);
+                if(end_of_frame) {this->file_.end_frame();}
+            });
+        return;
+    }
+    // write all the lines and wait for it.
+    void flush()
+    {
+        run_in_background(this->worker_, [this] {this->file_.flush();});
+        if(this->worker_) {this->worker_->wait();}
+        return;
+    }
+
     std::tuple<real_type, real_type, real_type, real_type>
     calc_energy_and_pressure(const system_type& sys)
     {
@@ -165,21 +256,18 @@ class EnergyObserver final : public ObserverBase<traitsT>
         return std::make_tuple(Ek, Px, Py, Pz);
     }
 
-    void clear_file(const std::string& fname) const
-    {
-        std::ofstream ofs(fname);
-        if(not ofs.good())
-        {
-            throw_exception<std::runtime_error>(
-                "[error] mjolnir::EnergyObserver: file open error: ", fname);
-        }
-        return;
-    }
-
   private:
 
+    bool        output_profile_;
+#ifdef MJOLNIR_WITH_PROFILER
+    std::vector<ProfileCounter*> profile_counters_;
+    std::vector<std::uint64_t>   profile_ticks_; // ticks at the last output
+#endif
+
     std::string prefix_;
     std::string file_name_;
+    BufferedFileWriter file_;
+    worker_type        worker_;
     std::vector<std::size_t> widths_; // column width to format energy values
 };
 
@@ -3,12 +3,15 @@
 #include <mjolnir/core/IgnoreMolecule.hpp>
 #include <mjolnir/core/IgnoreGroup.hpp>
 #include <mjolnir/core/System.hpp>
-#include <mjolnir/util/range.hpp>
+#include <mjolnir/util/throw_exception.hpp>
 #include <mjolnir/util/logger.hpp>
+#include <unordered_map>
 #include <algorithm>
-#include <iterator>
+#include <stdexcept>
 #include <utility>
+#include <limits>
 #include <vector>
+#include <cstdint>
 
 namespace mjolnir
 {
@@ -18,6 +21,16 @@ namespace mjolnir
 // from interacting pairs.
 // This class constructs a list that contains a list of pairs that are excluded
 // from interacting pairs using information in a topology.
+//
+// Since is_excluded is called for all the candidate pairs in every neighbor
+// list construction, it is designed to be branch-light and not to depend on
+// the number of molecules.
+// - molecule rule (Nothing/Self/Others) is resolved into two flags that
+//   depend only on whether the two particles belong to the same molecule.
+// - group names are hashed into successive integer ids once in `make`, and
+//   the rule is expanded into a small Ngroups x Ngroups flag matrix.
+// - topology-based exclusions are stored in a compact CSR array of sorted
+//   32-bit indices.
 template<typename traitsT>
 class ExclusionList
 {
@@ -34,15 +47,29 @@ class ExclusionList
     using ignore_topology_type = // convert from map to vector to make loop fast
         std::vector<std::pair<connection_kind_type, std::size_t>>;
 
+    using index_type = std::uint32_t;
+
+    struct particle_info
+    {
+        index_type molecule; // index of the molecule
+        index_type group;    // index of the group, assigned in `make`
+    };
+
   public:
 
     ExclusionList(
         const std::map<connection_kind_type, std::size_t>& ignore_top,
         ignore_molecule_type ignore_mol, ignore_group_type ignore_grp)
-        : ignore_molecule_(std::move(ignore_mol)),
+        : ignore_self_(false), ignore_others_(false), num_groups_(0),
+          ignore_molecule_(std::move(ignore_mol)),
           ignore_group_   (std::move(ignore_grp)),
           ignore_topology_(ignore_top.begin(), ignore_top.end())
-    {}
+    {
+        // all the rules (Nothing, Self, Others) depend only on whether the
+        // molecules are the same or not.
+        this->ignore_self_   = this->ignore_molecule_.is_ignored(0, 0);
+        this->ignore_others_ = this->ignore_molecule_.is_ignored(0, 1);
+    }
     ~ExclusionList() = default;
     ExclusionList(const ExclusionList&) = default;
     ExclusionList(ExclusionList&&)      = default;
@@ -50,35 +77,28 @@ class ExclusionList
     ExclusionList& operator=(ExclusionList&&)      = default;
 
     // check an interaction exists between i-th and j-th particles.
-    //
-    // It searches a small list of indices and check j is found in a exclusion-
-    // list of i-th particle.
-    bool is_excluded(const std::size_t i, const std::size_t j) const
+    bool is_excluded(const std::size_t i, const std::size_t j) const noexcept
     {
-        // assuming all the lists are enough small (< 20 or so)
-        {
-            const auto ign_grps = this->ignored_grp_of(this->grp_ids_[i]);
-            const auto grp_of_j = this->grp_ids_[j];
-            if(std::binary_search(ign_grps.begin(), ign_grps.end(), grp_of_j))
-            {
-                // if found, the pair is ignored. return true.
-                return true;
-            }
-        }
+        const particle_info pi = this->particles_[i];
+        const particle_info pj = this->particles_[j];
+
+        const bool ignored_mol = (pi.molecule == pj.molecule) ?
+                                 this->ignore_self_ : this->ignore_others_;
+        const bool ignored_grp =
+            this->ignored_grps_[pi.group * this->num_groups_ + pj.group];
 
-        // check molecule ids...
-        const auto mol_of_j = this->mol_ids_[j];
-        for(const auto& ignoring_mol : this->ignored_mol_of(this->mol_ids_[i]))
+        if((i == j) | ignored_mol | ignored_grp)
         {
-            // already sorted like ignoring_mol = [4,5,6]
-            if     (mol_of_j <  ignoring_mol) {break;}
-            else if(mol_of_j == ignoring_mol) {return true;}
+            return true;
         }
-        // check distance on topology...
-        for(const auto& ignoring_idx : this->ignored_idx_of(i))
+
+        // check distance on topology. the list is sorted and small (< 20).
+        const auto last = this->ignored_idxs_.begin() + this->idx_offsets_[i+1];
+        for(auto iter =   this->ignored_idxs_.begin() + this->idx_offsets_[i];
+                 iter != last; ++iter)
         {
-            if     (ignoring_idx >  j) {break;}
-            else if(ignoring_idx == j) {return true;}
+            if     (*iter >  j) {break;}
+            else if(*iter == j) {return true;}
         }
         return false;
     }
@@ -89,146 +109,108 @@ class ExclusionList
         MJOLNIR_LOG_FUNCTION();
 
         const std::size_t N = sys.size();
+        if(std::numeric_limits<index_type>::max() < N)
         {
-            // all groups defined in `ignore.group` table. check mistakes
-            auto groups_defined = this->ignore_group_.all_groups();
+            throw_exception<std::out_of_range>("mjolnir::ExclusionList: too "
+                "many particles (", N, ") to be indexed by 32-bit integer");
+        }
 
-            // count groups and assign indices
-            this->grp_list_.clear();
+        // assign group ids in the order of appearance
+        this->particles_.resize(N);
+        std::vector<group_id_type> grp_list; // list of group names
+        {
+            std::unordered_map<group_id_type, index_type> grp_ids;
             for(std::size_t i=0; i<N; ++i)
             {
-                if(std::find(this->grp_list_.begin(), this->grp_list_.end(),
-                             sys.group(i)) == this->grp_list_.end())
-                {
-                    // if not found, push it to the list
-                    this->grp_list_.push_back(sys.group(i));
-                    MJOLNIR_LOG_INFO("group ", sys.group(i), " found. ",
-                                     this->grp_list_.size(), "-th group is ",
-                                     sys.group(i));
-                }
-
-                const auto found = std::find(groups_defined.begin(),
-                        groups_defined.end(), sys.group(i));
-                if(found != groups_defined.end())
+                const auto found = grp_ids.find(sys.group(i));
+                if(found != grp_ids.end())
                 {
-                    groups_defined.erase(found);
+                    this->particles_[i].group = found->second;
+                    continue;
                 }
+                const auto id = static_cast<index_type>(grp_list.size());
+                grp_ids.emplace(sys.group(i), id);
+                grp_list.push_back(sys.group(i));
+                this->particles_[i].group = id;
+                MJOLNIR_LOG_INFO("group ", sys.group(i), " found. ",
+                                 grp_list.size(), "-th group is ", sys.group(i));
             }
-            MJOLNIR_LOG_INFO("all groups are found {", this->grp_list_, "}.");
-            if(!groups_defined.empty())
+            MJOLNIR_LOG_INFO("all groups are found {", grp_list, "}.");
+
+            // all groups defined in `ignore.group` table. check mistakes
+            bool unknown_found = false;
+            for(const auto& g : this->ignore_group_.all_groups())
             {
-                MJOLNIR_LOG_WARN("unknown group is specified in `ignore.group`");
-                for(const auto& g : groups_defined)
+                if(grp_ids.count(g) == 0)
                 {
+                    if(!unknown_found)
+                    {
+                        MJOLNIR_LOG_WARN("unknown group is specified in `ignore.group`");
+                        unknown_found = true;
+                    }
                     MJOLNIR_LOG_WARN("- ", g);
                 }
             }
         }
 
-        // Here, the list of all groups is constructed.
-        // Next, construct grp_ids_. assign corresponding group-ids
-        this->grp_ids_.resize(N);
-        for(std::size_t i=0; i<N; ++i)
-        {
-            const auto found = std::find(grp_list_.begin(), grp_list_.end(),
-                                         sys.group(i));
-            assert(found != grp_list_.end()); // should be found.
-            this->grp_ids_.at(i) = std::distance(grp_list_.begin(), found);
-            MJOLNIR_LOG_DEBUG("particle ", i, " belongs to ", *found, " and "
-                              "the corresponding group_idx is ", grp_ids_.at(i),
-                              " and the value is ", grp_list_.at(grp_ids_.at(i)));
-        }
-
-        // Next, construct exclusion list for group.
+        // Next, construct exclusion matrix for group. Ngrps is small.
+        this->num_groups_ = static_cast<index_type>(grp_list.size());
+        this->ignored_grps_.assign(grp_list.size() * grp_list.size(), false);
+        for(std::size_t i=0; i<grp_list.size(); ++i)
         {
-            const std::size_t Ngrps = this->grp_list_.size();
-
-            std::size_t idx = 0; // the current index in the exclusion list
-            for(std::size_t i=0; i<Ngrps; ++i)
+            for(std::size_t j=0; j<grp_list.size(); ++j)
             {
-                const std::size_t first = idx; // first index of the sub-list
-
-                const auto& grp_name_i = this->grp_list_.at(i);
-                for(std::size_t j=0; j<Ngrps; ++j)
+                if(this->is_ignored_group(grp_list[i], grp_list[j]))
                 {
-                    const auto& grp_name_j = this->grp_list_.at(j);
-                    if(this->is_ignored_group(grp_name_i, grp_name_j))
-                    {
-                        MJOLNIR_LOG_INFO("group ", grp_name_i, " and ",
-                                         grp_name_j, " ignores each other");
-                        this->ignored_grps_.push_back(j);
-                        ++idx;
-                    }
+                    MJOLNIR_LOG_INFO("group ", grp_list[i], " and ",
+                                     grp_list[j], " ignores each other");
+                    this->ignored_grps_[i * grp_list.size() + j] = true;
                 }
-                const auto beg = ignored_grps_.begin();
-                // sort this sub-range [first, idx)
-                std::sort(beg + first, beg + idx);
-                this->grp_ranges_.emplace_back(first, idx);
             }
         }
 
         // copy molecule_ids from topol to this
-        this->mol_ids_.resize(N);
         for(std::size_t i=0; i<N; ++i)
         {
-            this->mol_ids_[i] = topol.molecule_of(i);
+            this->particles_[i].molecule =
+                static_cast<index_type>(topol.molecule_of(i));
             MJOLNIR_LOG_DEBUG("particle ", i, " is belonging molecule ",
                               topol.molecule_of(i));
         }
+        MJOLNIR_LOG_INFO("molecule self  ignored: ", this->ignore_self_);
+        MJOLNIR_LOG_INFO("molecule other ignored: ", this->ignore_others_);
 
-        // make ignored_molecule_idxs
-        {
-            const std::size_t Nmols = topol.number_of_molecules();
-            std::size_t idx = 0;
-            for(std::size_t i=0; i<Nmols; ++i)
-            {
-                const std::size_t first = idx;
-                for(std::size_t j=0; j<Nmols; ++j)
-                {
-                    if(this->is_ignored_molecule(i, j))
-                    {
-                        MJOLNIR_LOG_INFO("molecule ", i, " and molecule ", j,
-                                         " will ignore each other");
-                        this->ignored_mols_.push_back(j);
-                        ++idx;
-                    }
-                }
-                const auto beg = ignored_mols_.begin();
-                std::sort(beg + first, beg + idx);
-                this->mol_ranges_.emplace_back(first, idx);
-            }
-        }
-
-        // make ignored_particle_idxs
+        // make ignored_particle_idxs. itself is checked in is_excluded.
         // excluded_connection := pair{connection kind, distance}
+        this->ignored_idxs_.clear();
+        this->idx_offsets_.assign(1, 0);
+        this->idx_offsets_.reserve(N+1);
+        std::vector<index_type> ignored_particles;
+        for(std::size_t i=0; i<N; ++i)
         {
-            std::size_t idx = 0;
-            for(std::size_t i=0; i<N; ++i)
+            ignored_particles.clear();
+            for(const auto& connection : this->ignore_topology_)
             {
-                const std::size_t first = idx;
-                std::vector<std::size_t> ignored_particles{i}; // ignore itself
-                for(const auto& connection : this->ignore_topology_)
+                const std::size_t dist = connection.second;
+                for(const auto j :
+                    topol.list_adjacent_within(i, dist, connection.first))
                 {
-                    const std::size_t dist = connection.second;
-                    for(const auto j :
-                        topol.list_adjacent_within(i, dist, connection.first))
+                    if(j != i)
                     {
-                        ignored_particles.push_back(j);
+                        ignored_particles.push_back(static_cast<index_type>(j));
                     }
                 }
-                std::sort(ignored_particles.begin(), ignored_particles.end());
-                const auto last = std::unique(ignored_particles.begin(),
-                                              ignored_particles.end());
-                ignored_particles.erase(last, ignored_particles.end());
-                MJOLNIR_LOG_INFO("particle ", i, " ignores ", ignored_particles);
-
-                for(const auto j : ignored_particles)
-                {
-                    this->ignored_idxs_.push_back(j);
-                    ++idx;
-                }
-                this->idx_ranges_.emplace_back(first, idx);
             }
+            std::sort(ignored_particles.begin(), ignored_particles.end());
+            const auto last = std::unique(ignored_particles.begin(),
+                                          ignored_particles.end());
+            ignored_particles.erase(last, ignored_particles.end());
+            MJOLNIR_LOG_INFO("particle ", i, " ignores ", ignored_particles);
+
+            this->ignored_idxs_.insert(this->ignored_idxs_.end(),
+                    ignored_particles.begin(), ignored_particles.end());
+            this->idx_offsets_.push_back(
+                    static_cast<std::size_t>(this->ignored_idxs_.size()));
         }
         return;
     }
@@ -263,58 +245,26 @@ class ExclusionList
 
   private:
 
-    range<typename std::vector<std::size_t>::const_iterator>
-    ignored_idx_of(const std::size_t i) const noexcept
-    {
-        return range<typename std::vector<std::size_t>::const_iterator>{
-            this->ignored_idxs_.begin() + this->idx_ranges_[i].first,
-            this->ignored_idxs_.begin() + this->idx_ranges_[i].second
-        };
-    }
-    range<typename std::vector<std::size_t>::const_iterator>
-    ignored_mol_of(const std::size_t i) const noexcept
-    {
-        return range<typename std::vector<std::size_t>::const_iterator>{
-            this->ignored_mols_.begin() + this->mol_ranges_[i].first,
-            this->ignored_mols_.begin() + this->mol_ranges_[i].second
-        };
-    }
-    range<typename std::vector<std::size_t>::const_iterator>
-    ignored_grp_of(const std::size_t i) const noexcept
-    {
-        return range<typename std::vector<std::size_t>::const_iterator>{
-            this->ignored_grps_.begin() + this->grp_ranges_[i].first,
-            this->ignored_grps_.begin() + this->grp_ranges_[i].second
-        };
-    }
+    // result of the molecule rule for {same, different} molecules
+    bool ignore_self_;
+    bool ignore_others_;
 
-  private:
+    // Ngroups. Groups are indexed by successive integers in `make`.
+    index_type num_groups_;
 
     ignore_molecule_type ignore_molecule_;
     ignore_group_type    ignore_group_;
     ignore_topology_type ignore_topology_;
 
-    // It contains the same infromation as {topol.nodes_.molecule_id};
-    std::vector<molecule_id_type> mol_ids_;
-
-    // Here, ExclusionList counts a number of groups and assign a unique index
-    // for each group. `grp_ids` contains the index, not std::string itself.
-    // It would be changed by calling ExclusionList::make() because it counts
-    // groups and and assigns IDs.
-    std::vector<group_id_type>    grp_list_; // list of the group names
-    std::vector<std::size_t>      grp_ids_;  // the index of the above list
-
-    // ignored mol_id...
-    std::vector<std::size_t> ignored_mols_;
-    std::vector<std::pair<std::size_t, std::size_t>> mol_ranges_;
+    // {molecule index, group index} of each particle
+    std::vector<particle_info> particles_;
 
-    // grp_idx...
-    std::vector<std::size_t> ignored_grps_;
-    std::vector<std::pair<std::size_t, std::size_t>> grp_ranges_;
+    // Ngroups x Ngroups matrix. true if the pair of groups are ignored.
+    std::vector<bool> ignored_grps_;
 
-    // normal particle idx
-    std::vector<std::size_t> ignored_idxs_;
-    std::vector<std::pair<std::size_t, std::size_t>> idx_ranges_;
+    // ignored particle indices of i are in [offsets[i], offsets[i+1]).
+    std::vector<index_type>  ignored_idxs_;
+    std::vector<std::size_t> idx_offsets_;
 };
 
 #ifdef MJOLNIR_SEPARATE_BUILD
@@ -3,10 +3,12 @@
 #include <mjolnir/core/ExternalForceInteractionBase.hpp>
 #include <mjolnir/util/logger.hpp>
 #include <mjolnir/util/is_finite.hpp>
+#include <mjolnir/util/profiler.hpp>
 #include <utility>
 #include <vector>
 #include <array>
 #include <memory>
+#include <cassert>
 
 namespace mjolnir
 {
@@ -35,6 +37,9 @@ class ExternalForceField
     ExternalForceField(ExternalForceField const& other)
         : fmt_widths_(other.fmt_widths_), interactions_(other.size())
     {
+#ifdef MJOLNIR_WITH_PROFILER
+        this->profile_counters_ = other.profile_counters_;
+#endif
         std::transform(other.begin(), other.end(), this->interactions_.begin(),
             [](const interaction_ptr& interaction) -> interaction_ptr {
                 return interaction_ptr(interaction->clone());
@@ -44,6 +49,9 @@ class ExternalForceField
     {
         this->fmt_widths_.clear();
         this->interactions_.clear();
+#ifdef MJOLNIR_WITH_PROFILER
+        this->profile_counters_.clear();
+#endif
         this->interactions_.reserve(other.size());
         for(const auto& interaction : other)
         {
@@ -55,6 +63,10 @@ class ExternalForceField
     void emplace(interaction_ptr interaction)
     {
         fmt_widths_  .push_back(std::max<std::size_t>(interaction->name().size(), 10));
+#ifdef MJOLNIR_WITH_PROFILER
+        profile_counters_.push_back(
+            ProfileManager::get_counter("External:" + interaction->name()));
+#endif
         interactions_.push_back(std::move(interaction));
         return;
     }
@@ -101,9 +113,10 @@ class ExternalForceField
 
     void calc_force(system_type& sys) const noexcept
     {
-        for(const auto& item : this->interactions_)
+        for(std::size_t i=0; i<this->interactions_.size(); ++i)
         {
-            item->calc_force(sys);
+            MJOLNIR_PROFILE_SCOPE(this->profile_counters_[i]);
+            this->interactions_[i]->calc_force(sys);
         }
         return;
     }
@@ -119,9 +132,27 @@ class ExternalForceField
     real_type calc_force_and_energy(system_type& sys) const noexcept
     {
         real_type energy = 0.0;
-        for(const auto& item : this->interactions_)
+        for(std::size_t i=0; i<this->interactions_.size(); ++i)
+        {
+            MJOLNIR_PROFILE_SCOPE(this->profile_counters_[i]);
+            energy += this->interactions_[i]->calc_force_and_energy(sys);
+        }
+        return energy;
+    }
+    // calculates force and energy at once. The energy of each interaction is
+    // written into `energies` so that it can be formatted later without
+    // calculating energy again.
+    real_type calc_force_and_energy(system_type& sys,
+                                    std::vector<real_type>& energies) const noexcept
+    {
+        energies.resize(this->interactions_.size());
+
+        real_type energy = 0.0;
+        for(std::size_t i=0; i<this->interactions_.size(); ++i)
         {
-            energy += item->calc_force_and_energy(sys);
+            MJOLNIR_PROFILE_SCOPE(this->profile_counters_[i]);
+            energies[i] = this->interactions_[i]->calc_force_and_energy(sys);
+            energy += energies[i];
         }
         return energy;
     }
@@ -140,13 +171,47 @@ class ExternalForceField
     }
 
     real_type format_energy(const system_type& sys, std::string& fmt) const
+    {
+        return this->format_energy_impl(fmt,
+            [&sys](const interaction_type& interaction, const std::size_t) {
+                return interaction.calc_energy(sys);
+            });
+    }
+    // format energies that are calculated by `calc_force_and_energy`.
+    real_type format_energy(const std::vector<real_type>& energies,
+                            std::string& fmt) const
+    {
+        assert(energies.size() == this->interactions_.size());
+        return this->format_energy_impl(fmt,
+            [&energies](const interaction_type&, const std::size_t i) {
+                return energies[i];
+            });
+    }
+
+    // ------------------------------------------------------------------------
+
+    bool           empty()  const noexcept {return interactions_.empty();}
+    std::size_t    size()   const noexcept {return interactions_.size();}
+
+    iterator       begin()        noexcept {return interactions_.begin();}
+    iterator       end()          noexcept {return interactions_.end();}
+    const_iterator begin()  const noexcept {return interactions_.begin();}
+    const_iterator end()    const noexcept {return interactions_.end();}
+    const_iterator cbegin() const noexcept {return interactions_.begin();}
+    const_iterator cend()   const noexcept {return interactions_.end();}
+
+  private:
+
+    // energy_of(interaction, index) returns the energy of the interaction.
+    template<typename EnergyFunc>
+    real_type format_energy_impl(std::string& fmt, EnergyFunc&& energy_of) const
     {
         real_type total_energy = 0;
         std::ostringstream oss;
         for(std::size_t i=0; i<interactions_.size(); ++i)
         {
             const auto& interaction = interactions_[i];
-            const auto energy = interaction->calc_energy(sys);
+            const auto energy = energy_of(*interaction, i);
             oss << std::setw(this->fmt_widths_.at(i)) << std::fixed
                 << std::right << energy << ' ';
 
@@ -162,22 +227,13 @@ class ExternalForceField
         return total_energy;
     }
 
-    // ------------------------------------------------------------------------
-
-    bool           empty()  const noexcept {return interactions_.empty();}
-    std::size_t    size()   const noexcept {return interactions_.size();}
-
-    iterator       begin()        noexcept {return interactions_.begin();}
-    iterator       end()          noexcept {return interactions_.end();}
-    const_iterator begin()  const noexcept {return interactions_.begin();}
-    const_iterator end()    const noexcept {return interactions_.end();}
-    const_iterator cbegin() const noexcept {return interactions_.begin();}
-    const_iterator cend()   const noexcept {return interactions_.end();}
-
   private:
 
     std::vector<std::size_t> fmt_widths_;
     container_type interactions_;
+#ifdef MJOLNIR_WITH_PROFILER
+    std::vector<ProfileCounter*> profile_counters_; // shared by name
+#endif
 };
 
 #ifdef MJOLNIR_SEPARATE_BUILD
@@ -0,0 +1,13 @@
+#include <mjolnir/core/FIRESimulator.hpp>
+
+#ifndef MJOLNIR_SEPARATE_BUILD
+#error "MJOLNIR_SEPARATE_BUILD flag is required"
+#endif
+
+namespace mjolnir
+{
+template class FIRESimulator<SimulatorTraits<double, UnlimitedBoundary>       >;
+template class FIRESimulator<SimulatorTraits<float,  UnlimitedBoundary>       >;
+template class FIRESimulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>;
+template class FIRESimulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>;
+} // mjolnir
@@ -0,0 +1,238 @@
+#ifndef MJOLNIR_CORE_FIRE_SIMULATOR_HPP
+#define MJOLNIR_CORE_FIRE_SIMULATOR_HPP
+#include <mjolnir/core/SimulatorBase.hpp>
+#include <mjolnir/core/ObserverContainer.hpp>
+#include <mjolnir/core/System.hpp>
+#include <mjolnir/core/ForceFieldBase.hpp>
+#include <mjolnir/core/MsgPackSaver.hpp>
+#include <mjolnir/math/math.hpp>
+#include <limits>
+
+namespace mjolnir
+{
+
+// Fast Inertial Relaxation Engine (FIRE) for energy minimization.
+// - E. Bitzek, P. Koskinen, F. Gahler, M. Moseler, and P. Gumbsch,
+//   Phys. Rev. Lett. (2006)
+// - J. Guenole, W. G. Noehring, A. Vaid, F. Houlle, Z. Xie, A. Prakash, and
+//   E. Bitzek, Comput. Mater. Sci. (2020)
+//
+// It runs MD with a semi-implicit Euler integrator while mixing the velocity
+// with the direction of the force. Time step is increased while the system
+// goes downhill (P = F.v > 0), and the velocity is reset when it goes uphill.
+// Masses of particles are taken into account as in normal MD.
+template<typename traitsT>
+class FIRESimulator final : public SimulatorBase
+{
+  public:
+    using traits_type     = traitsT;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using system_type     = System<traits_type>;
+    using forcefield_type = std::unique_ptr<ForceFieldBase<traits_type>>;
+    using observer_type   = ObserverContainer<traits_type>;
+    using saver_type      = MsgPackSaver<traits_type>;
+
+    struct parameter_type
+    {
+        real_type   dt_max;      // the maximum time step
+        real_type   max_disp;    // the maximum displacement in a step
+        std::size_t N_min;       // steps required before accelerating
+        real_type   f_inc;       // dt *= f_inc      if P > 0
+        real_type   f_dec;       // dt *= f_dec      if P <= 0
+        real_type   alpha_start; // initial mixing coefficient
+        real_type   f_alpha;     // alpha *= f_alpha if P > 0
+    };
+
+    static parameter_type default_parameters(const real_type dt) noexcept
+    {
+        return parameter_type{10 * dt, std::numeric_limits<real_type>::infinity(),
+            5, real_type(1.1), real_type(0.5), real_type(0.1), real_type(0.99)};
+    }
+
+  public:
+
+    FIRESimulator(const real_type dt, const real_type threshold,
+        const parameter_type& params,
+        const std::size_t step_limit, const std::size_t save_step,
+        const std::size_t checkpoint_step,
+        system_type&& sys, forcefield_type&& ff, observer_type&& obs)
+    : dt_init_(dt), dt_(dt), alpha_(params.alpha_start), threshold_(threshold),
+      params_(params), step_limit_(step_limit), step_count_(0),
+      save_step_(save_step), checkpoint_(checkpoint_step), num_positive_(0),
+      system_(std::move(sys)), ff_(std::move(ff)), observers_(std::move(obs)),
+      saver_(observers_.prefix())
+    {}
+    ~FIRESimulator() override {}
+
+    void initialize() override;
+    bool step()       override;
+    void run()        override;
+    void finalize()   override;
+
+    real_type delta_t() const noexcept {return dt_;}
+    real_type alpha()   const noexcept {return alpha_;}
+    parameter_type const& parameters() const noexcept {return params_;}
+
+    system_type&       system()       noexcept {return system_;}
+    system_type const& system() const noexcept {return system_;}
+
+    forcefield_type&       forcefields()       noexcept {return ff_;}
+    forcefield_type const& forcefields() const noexcept {return ff_;}
+
+  protected:
+    real_type       dt_init_;
+    real_type       dt_;
+    real_type       alpha_;
+    real_type       threshold_;
+    parameter_type  params_;
+    std::size_t     step_limit_;
+    std::size_t     step_count_;
+    std::size_t     save_step_;
+    std::size_t     checkpoint_;
+    std::size_t     num_positive_; // number of steps since P was negative
+    system_type     system_;
+    forcefield_type ff_;
+    observer_type   observers_;
+    saver_type      saver_;
+};
+
+template<typename traitsT>
+inline void FIRESimulator<traitsT>::initialize()
+{
+    // The velocities are used only as a part of the minimization algorithm.
+    // It starts from the rest.
+    for(std::size_t i=0; i<this->system_.size(); ++i)
+    {
+        this->system_.velocity(i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+        this->system_.force(i)    = math::make_coordinate<coordinate_type>(0, 0, 0);
+    }
+    this->ff_->initialize(this->system_);
+    this->ff_->calc_force(this->system_);
+
+    // like SteepestDescent, it has no physical `time`.
+    this->observers_.initialize(this->step_limit_, this->save_step_,
+                                this->dt_init_, this->system_, this->ff_);
+    return;
+}
+
+template<typename traitsT>
+inline bool FIRESimulator<traitsT>::step()
+{
+    if(step_count_ % save_step_ == 0)
+    {
+        this->observers_.output(this->step_count_, /* dt */ real_type(0.0),
+                                this->system_, this->ff_);
+    }
+    if(step_count_ % checkpoint_ == 0)
+    {
+        saver_.save(this->system_);
+    }
+
+    auto& sys = this->system_;
+
+    // check convergence and calculate P = F.v, |F|, and |v|.
+    real_type max_diff = 0.0;
+    real_type P        = 0.0;
+    real_type F2       = 0.0;
+    real_type v2       = 0.0;
+    for(std::size_t i=0; i<sys.size(); ++i)
+    {
+        const auto& f = sys.force(i);
+        const auto& v = sys.velocity(i);
+        max_diff = std::max(max_diff, std::abs(math::X(f)));
+        max_diff = std::max(max_diff, std::abs(math::Y(f)));
+        max_diff = std::max(max_diff, std::abs(math::Z(f)));
+
+        P  += math::dot_product(f, v);
+        F2 += math::length_sq(f);
+        v2 += math::length_sq(v);
+    }
+    if(max_diff < this->threshold_)
+    {
+        return false; // converged. stop the simulation!
+    }
+
+    if(P > 0)
+    {
+        // v <- (1 - alpha) v + alpha |v| F/|F|
+        const real_type coef = (F2 == real_type(0)) ? real_type(0) :
+                               this->alpha_ * std::sqrt(v2 / F2);
+        for(std::size_t i=0; i<sys.size(); ++i)
+        {
+            sys.velocity(i) = (1 - this->alpha_) * sys.velocity(i) +
+                              coef * sys.force(i);
+        }
+        this->num_positive_ += 1;
+        if(this->num_positive_ > this->params_.N_min)
+        {
+            this->dt_    = std::min(this->dt_ * this->params_.f_inc,
+                                    this->params_.dt_max);
+            this->alpha_ *= this->params_.f_alpha;
+        }
+    }
+    else
+    {
+        // going uphill. stop and restart from the current position.
+        this->dt_           *= this->params_.f_dec;
+        this->alpha_         = this->params_.alpha_start;
+        this->num_positive_  = 0;
+        for(std::size_t i=0; i<sys.size(); ++i)
+        {
+            sys.velocity(i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+        }
+    }
+
+    // semi-implicit Euler integration.
+    real_type max_disp2 = 0.0;
+    for(std::size_t i=0; i<sys.size(); ++i)
+    {
+        sys.velocity(i) += (this->dt_ * sys.rmass(i)) * sys.force(i);
+        max_disp2 = std::max(max_disp2, math::length_sq(this->dt_ * sys.velocity(i)));
+    }
+    // limit the displacement to avoid breaking stiff networks
+    const real_type max_disp = std::sqrt(max_disp2);
+    const real_type scale    = (this->params_.max_disp < max_disp) ?
+                               this->params_.max_disp / max_disp : real_type(1);
+    for(std::size_t i=0; i<sys.size(); ++i)
+    {
+        const coordinate_type disp = (scale * this->dt_) * sys.velocity(i);
+        sys.position(i) = sys.adjust_position(sys.position(i) + disp);
+        sys.force   (i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+    }
+
+    // update neighbor list; reduce margin, reconstruct the list if needed
+    this->ff_->reduce_margin(2 * scale * max_disp, sys);
+    this->ff_->calc_force(sys);
+
+    ++step_count_;
+    return this->step_count_ < this->step_limit_;
+}
+
+template<typename traitsT>
+inline void FIRESimulator<traitsT>::run()
+{
+    while(this->step()){/* do nothing */;}
+    return;
+}
+
+template<typename traitsT>
+inline void FIRESimulator<traitsT>::finalize()
+{
+    this->observers_.output  (this->step_count_, /* dt */ real_type(0.0),
+                              this->system_, this->ff_);
+    this->observers_.finalize(this->step_limit_, /* dt */ real_type(0.0),
+                              this->system_, this->ff_);
+    this->saver_.save(this->system_);
+    return;
+}
+
+#ifdef MJOLNIR_SEPARATE_BUILD
+extern template class FIRESimulator<SimulatorTraits<double, UnlimitedBoundary>       >;
+extern template class FIRESimulator<SimulatorTraits<float,  UnlimitedBoundary>       >;
+extern template class FIRESimulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>;
+extern template class FIRESimulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>;
+#endif // SEPARATE_BUILD
+
+} // mjolnir
+#endif /* MJOLNIR_CORE_FIRE_SIMULATOR_HPP */
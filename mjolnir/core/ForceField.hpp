@@ -7,6 +7,7 @@
 #include <mjolnir/core/GlobalForceField.hpp>
 #include <mjolnir/core/ExternalForceField.hpp>
 #include <mjolnir/core/ConstraintForceField.hpp>
+#include <mjolnir/util/profiler.hpp>
 
 namespace mjolnir
 {
@@ -33,11 +34,24 @@ class ForceField final : public ForceFieldBase<traitsT>
                global_forcefield_type&&     global,
                external_forcefield_type&&   external,
                constraint_forcefield_type&& constraint)
-        : local_(std::move(local)), global_(std::move(global)),
+        : energy_cache_enabled_(false), energy_cached_(false),
+          local_(std::move(local)), global_(std::move(global)),
           external_(std::move(external)), constraint_(std::move(constraint))
-    {}
+    {
+#ifdef MJOLNIR_WITH_PROFILER
+        this->postprocess_counter_ =
+            ProfileManager::get_counter("ForceField:postprocess");
+#endif
+    }
 
-    ForceField()  = default;
+    ForceField()
+        : energy_cache_enabled_(false), energy_cached_(false)
+    {
+#ifdef MJOLNIR_WITH_PROFILER
+        this->postprocess_counter_ =
+            ProfileManager::get_counter("ForceField:postprocess");
+#endif
+    }
     ~ForceField() override = default;
     ForceField(const ForceField&) = default;
     ForceField(ForceField&&)      = default;
@@ -56,6 +70,7 @@ class ForceField final : public ForceFieldBase<traitsT>
         topology_.construct_molecules();
 
         MJOLNIR_LOG_INFO("initializing forcefields");
+        this->energy_cached_ = false;
         local_     .initialize(sys);
         global_    .initialize(sys, topology_);
         external_  .initialize(sys);
@@ -65,6 +80,7 @@ class ForceField final : public ForceFieldBase<traitsT>
     // update parameters like temperature, ionic concentration, etc...
     void update(const system_type& sys) override
     {
+        this->energy_cached_ = false;
         local_   .update(sys);
         global_  .update(sys, this->topology_);
         external_.update(sys);
@@ -85,6 +101,7 @@ class ForceField final : public ForceFieldBase<traitsT>
         // forcefields). In most cases, the most time-consuming part is global
         // forcefields, so I implemented in this way for now. If some idea that
         // works more efficiently is came up, this part would be re-implemented.
+        this->energy_cached_ = false;
         local_   .reduce_margin(dmargin, sys);
         global_  .reduce_margin(dmargin, sys);
         external_.reduce_margin(dmargin, sys);
@@ -92,6 +109,7 @@ class ForceField final : public ForceFieldBase<traitsT>
     }
     void scale_margin(const real_type scale, const system_type& sys) override
     {
+        this->energy_cached_ = false;
         local_   .scale_margin(scale, sys);
         global_  .scale_margin(scale, sys);
         external_.scale_margin(scale, sys);
@@ -99,14 +117,55 @@ class ForceField final : public ForceFieldBase<traitsT>
     }
 
     void calc_force(system_type& sys) const noexcept override
+    {
+        sys.preprocess_forces();
+        if(this->energy_cache_enabled_)
+        {
+            local_   .calc_force_and_energy(sys, this->local_energies_);
+            global_  .calc_force_and_energy(sys, this->global_energies_);
+            external_.calc_force_and_energy(sys, this->external_energies_);
+        }
+        else
+        {
+            local_   .calc_force(sys);
+            global_  .calc_force(sys);
+            external_.calc_force(sys);
+        }
+        {
+            // with OpenMP, it includes the reduction of thread-local forces
+            MJOLNIR_PROFILE_SCOPE(this->postprocess_counter_);
+            sys.postprocess_forces();
+        }
+        this->energy_cached_ = this->energy_cache_enabled_;
+        return;
+    }
+
+    // local and external forcefields are the fast part, and global forcefields
+    // are the slow part. Energies are not cached in the split evaluation.
+    void calc_fast_force(system_type& sys) const noexcept override
     {
         sys.preprocess_forces();
         local_   .calc_force(sys);
-        global_  .calc_force(sys);
         external_.calc_force(sys);
-        sys.postprocess_forces();
+        {
+            MJOLNIR_PROFILE_SCOPE(this->postprocess_counter_);
+            sys.postprocess_forces();
+        }
+        this->energy_cached_ = false;
         return;
     }
+    void calc_slow_force(system_type& sys) const noexcept override
+    {
+        sys.preprocess_forces();
+        global_.calc_force(sys);
+        {
+            MJOLNIR_PROFILE_SCOPE(this->postprocess_counter_);
+            sys.postprocess_forces();
+        }
+        this->energy_cached_ = false;
+        return;
+    }
+
     real_type calc_energy(const system_type& sys) const noexcept override
     {
         return local_.calc_energy(sys) + global_.calc_energy(sys) +
@@ -123,12 +182,28 @@ class ForceField final : public ForceFieldBase<traitsT>
     real_type format_energy(const system_type& sys, std::string& fmt) const override
     {
         real_type total = 0.0;
+        if(this->energy_cached_)
+        {
+            // energies at the current configuration are already calculated
+            // in the last `calc_force`. use them only once.
+            this->energy_cached_ = false;
+            total += local_   .format_energy(this->local_energies_,    fmt);
+            total += global_  .format_energy(this->global_energies_,   fmt);
+            total += external_.format_energy(this->external_energies_, fmt);
+            return total;
+        }
         total += local_   .format_energy(sys, fmt);
         total += global_  .format_energy(sys, fmt);
         total += external_.format_energy(sys, fmt);
         return total;
     }
 
+    void enable_energy_cache(const bool enable) noexcept override
+    {
+        this->energy_cache_enabled_ = enable;
+        return;
+    }
+
     topology_type const& topology() const noexcept override {return topology_;}
 
     local_forcefield_type      const& local()      const noexcept {return local_;}
@@ -142,6 +217,17 @@ class ForceField final : public ForceFieldBase<traitsT>
 
   private:
 
+    // energies of each term calculated in `calc_force`.
+    bool                           energy_cache_enabled_;
+    mutable bool                   energy_cached_;
+    mutable std::vector<real_type> local_energies_;
+    mutable std::vector<real_type> global_energies_;
+    mutable std::vector<real_type> external_energies_;
+
+#ifdef MJOLNIR_WITH_PROFILER
+    ProfileCounter* postprocess_counter_;
+#endif
+
     topology_type               topology_;
     local_forcefield_type       local_;
     global_forcefield_type      global_;
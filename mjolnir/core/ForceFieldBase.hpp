@@ -33,6 +33,23 @@ class ForceFieldBase
     virtual void calc_force(system_type& sys) const noexcept = 0;
     virtual real_type calc_energy(const system_type& sys) const noexcept = 0;
 
+    // For multiple time step integration (r-RESPA). The forces are split into
+    // the fast part that is integrated with the inner time step and the slow
+    // part that is evaluated only at the outer time step. Both add forces to
+    // the system like `calc_force`, and the sum of them equals `calc_force`.
+    // By default, all the forces are treated as the fast part.
+    virtual void calc_fast_force(system_type& sys) const noexcept
+    {
+        this->calc_force(sys);
+    }
+    virtual void calc_slow_force(system_type&) const noexcept {}
+
+    // If enabled, `calc_force` also calculates energies of all the terms in
+    // the same sweep and keeps them until the next `format_energy`. It is used
+    // to avoid calculating energies twice on output steps. A forcefield may
+    // ignore this and calculate energies in `format_energy` as usual.
+    virtual void enable_energy_cache(const bool enable) noexcept = 0;
+
     // format names of all the interactions for .ene file. must not contain '\n'.
     virtual void format_energy_name(std::string&) const = 0;
     // format all energies and related stuff for .ene file. must not contain '\n'.
@@ -0,0 +1,13 @@
+#include <mjolnir/core/LBFGSSimulator.hpp>
+
+#ifndef MJOLNIR_SEPARATE_BUILD
+#error "MJOLNIR_SEPARATE_BUILD flag is required"
+#endif
+
+namespace mjolnir
+{
+template class LBFGSSimulator<SimulatorTraits<double, UnlimitedBoundary>       >;
+template class LBFGSSimulator<SimulatorTraits<float,  UnlimitedBoundary>       >;
+template class LBFGSSimulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>;
+template class LBFGSSimulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>;
+} // mjolnir
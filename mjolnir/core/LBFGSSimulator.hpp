@@ -0,0 +1,302 @@
+#ifndef MJOLNIR_CORE_LBFGS_SIMULATOR_HPP
+#define MJOLNIR_CORE_LBFGS_SIMULATOR_HPP
+#include <mjolnir/core/SimulatorBase.hpp>
+#include <mjolnir/core/ObserverContainer.hpp>
+#include <mjolnir/core/System.hpp>
+#include <mjolnir/core/ForceFieldBase.hpp>
+#include <mjolnir/core/MsgPackSaver.hpp>
+#include <mjolnir/math/math.hpp>
+#include <vector>
+#include <limits>
+
+namespace mjolnir
+{
+
+// Limited-memory BFGS for energy minimization.
+// - J. Nocedal, Math. Comp. (1980)
+// - D. C. Liu and J. Nocedal, Math. Program. (1989)
+//
+// It approximates the inverse Hessian by the last `memory` pairs of the
+// displacement s_k = x_{k+1} - x_k and the change in the gradient
+// y_k = g_{k+1} - g_k, and calculates the search direction by the two-loop
+// recursion. Instead of a line search that requires additional energy
+// calculations, the step is scaled so that the largest displacement of a
+// particle does not exceed `max_step`. s_k is the displacement actually
+// applied, so it works with periodic boundaries.
+template<typename traitsT>
+class LBFGSSimulator final : public SimulatorBase
+{
+  public:
+    using traits_type     = traitsT;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using system_type     = System<traits_type>;
+    using forcefield_type = std::unique_ptr<ForceFieldBase<traits_type>>;
+    using observer_type   = ObserverContainer<traits_type>;
+    using saver_type      = MsgPackSaver<traits_type>;
+
+  public:
+
+    LBFGSSimulator(const std::size_t memory, const real_type max_step,
+        const real_type threshold,
+        const std::size_t step_limit, const std::size_t save_step,
+        const std::size_t checkpoint_step,
+        system_type&& sys, forcefield_type&& ff, observer_type&& obs)
+    : memory_(memory), head_(0), stored_(0), max_step_(max_step),
+      threshold_(threshold), step_limit_(step_limit), step_count_(0),
+      save_step_(save_step), checkpoint_(checkpoint_step),
+      system_(std::move(sys)), ff_(std::move(ff)), observers_(std::move(obs)),
+      saver_(observers_.prefix())
+    {}
+    ~LBFGSSimulator() override {}
+
+    void initialize() override;
+    bool step()       override;
+    void run()        override;
+    void finalize()   override;
+
+    std::size_t memory()   const noexcept {return memory_;}
+    std::size_t stored()   const noexcept {return stored_;}
+    real_type   max_step() const noexcept {return max_step_;}
+
+    system_type&       system()       noexcept {return system_;}
+    system_type const& system() const noexcept {return system_;}
+
+    forcefield_type&       forcefields()       noexcept {return ff_;}
+    forcefield_type const& forcefields() const noexcept {return ff_;}
+
+  private:
+
+    // d = H F, where H is the approximated inverse Hessian
+    void calc_direction();
+
+    real_type dot(const std::vector<coordinate_type>& lhs,
+                  const std::vector<coordinate_type>& rhs) const noexcept
+    {
+        real_type retval(0);
+        for(std::size_t i=0; i<lhs.size(); ++i)
+        {
+            retval += math::dot_product(lhs[i], rhs[i]);
+        }
+        return retval;
+    }
+
+  protected:
+    std::size_t     memory_;
+    std::size_t     head_;   // the next slot to be written
+    std::size_t     stored_; // number of (s, y) pairs stored
+    real_type       max_step_;
+    real_type       threshold_;
+    std::size_t     step_limit_;
+    std::size_t     step_count_;
+    std::size_t     save_step_;
+    std::size_t     checkpoint_;
+    system_type     system_;
+    forcefield_type ff_;
+    observer_type   observers_;
+    saver_type      saver_;
+
+    std::vector<std::vector<coordinate_type>> s_;   // ring buffer of s_k
+    std::vector<std::vector<coordinate_type>> y_;   // ring buffer of y_k
+    std::vector<real_type>                    rho_; // 1 / (y_k . s_k)
+    std::vector<real_type>                    alpha_;
+    std::vector<coordinate_type>              direction_;
+    std::vector<coordinate_type>              prev_force_;
+};
+
+template<typename traitsT>
+inline void LBFGSSimulator<traitsT>::initialize()
+{
+    const std::size_t N = this->system_.size();
+    const auto zero = math::make_coordinate<coordinate_type>(0, 0, 0);
+
+    this->s_    .assign(memory_, std::vector<coordinate_type>(N, zero));
+    this->y_    .assign(memory_, std::vector<coordinate_type>(N, zero));
+    this->rho_  .assign(memory_, real_type(0));
+    this->alpha_.assign(memory_, real_type(0));
+    this->direction_ .assign(N, zero);
+    this->prev_force_.assign(N, zero);
+    this->head_   = 0;
+    this->stored_ = 0;
+
+    // XXX: Because this simulator does not use velocity,
+    //      it does not initialize System.
+    for(std::size_t i=0; i<N; ++i)
+    {
+        this->system_.force(i) = zero;
+    }
+    this->ff_->initialize(this->system_);
+    this->ff_->calc_force(this->system_);
+
+    // like SteepestDescent, it has no physical `time`.
+    this->observers_.initialize(this->step_limit_, this->save_step_,
+                                this->max_step_, this->system_, this->ff_);
+    return;
+}
+
+template<typename traitsT>
+inline void LBFGSSimulator<traitsT>::calc_direction()
+{
+    const std::size_t N = this->system_.size();
+
+    // the gradient is -F. here, q and r are calculated with F so that the
+    // resulting direction goes downhill.
+    for(std::size_t i=0; i<N; ++i)
+    {
+        direction_[i] = this->system_.force(i);
+    }
+
+    // from the newest to the oldest
+    for(std::size_t n=0; n<stored_; ++n)
+    {
+        const std::size_t k = (head_ + memory_ - 1 - n) % memory_;
+        alpha_[k] = rho_[k] * this->dot(s_[k], direction_);
+        for(std::size_t i=0; i<N; ++i)
+        {
+            direction_[i] -= alpha_[k] * y_[k][i];
+        }
+    }
+
+    // initial inverse Hessian, gamma * I
+    if(stored_ != 0)
+    {
+        const std::size_t newest = (head_ + memory_ - 1) % memory_;
+        const real_type gamma = real_type(1) /
+            (rho_[newest] * this->dot(y_[newest], y_[newest]));
+        for(std::size_t i=0; i<N; ++i)
+        {
+            direction_[i] *= gamma;
+        }
+    }
+
+    // from the oldest to the newest
+    for(std::size_t n=0; n<stored_; ++n)
+    {
+        const std::size_t k = (head_ + memory_ - stored_ + n) % memory_;
+        const real_type beta = rho_[k] * this->dot(y_[k], direction_);
+        for(std::size_t i=0; i<N; ++i)
+        {
+            direction_[i] += (alpha_[k] - beta) * s_[k][i];
+        }
+    }
+    return;
+}
+
+template<typename traitsT>
+inline bool LBFGSSimulator<traitsT>::step()
+{
+    if(step_count_ % save_step_ == 0)
+    {
+        this->observers_.output(this->step_count_, /* dt */ real_type(0.0),
+                                this->system_, this->ff_);
+    }
+    if(step_count_ % checkpoint_ == 0)
+    {
+        saver_.save(this->system_);
+    }
+
+    auto& sys = this->system_;
+    const std::size_t N = sys.size();
+
+    real_type max_diff = 0.0; // to check the convergence
+    for(std::size_t i=0; i<N; ++i)
+    {
+        max_diff = std::max(max_diff, std::abs(math::X(sys.force(i))));
+        max_diff = std::max(max_diff, std::abs(math::Y(sys.force(i))));
+        max_diff = std::max(max_diff, std::abs(math::Z(sys.force(i))));
+    }
+    if(max_diff < this->threshold_)
+    {
+        return false; // converged. stop the simulation!
+    }
+
+    this->calc_direction();
+
+    // if the approximated Hessian is broken, restart from steepest descent.
+    real_type slope = 0.0;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        slope += math::dot_product(direction_[i], sys.force(i));
+    }
+    if(!(slope > real_type(0)))
+    {
+        stored_ = 0;
+        for(std::size_t i=0; i<N; ++i)
+        {
+            direction_[i] = sys.force(i);
+        }
+    }
+
+    // limit the largest displacement
+    real_type max_len2 = 0.0;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        max_len2 = std::max(max_len2, math::length_sq(direction_[i]));
+    }
+    const real_type max_len = std::sqrt(max_len2);
+    const real_type scale   = (max_step_ < max_len) ? max_step_ / max_len :
+                                                      real_type(1);
+
+    auto& s = s_[head_];
+    auto& y = y_[head_];
+    for(std::size_t i=0; i<N; ++i)
+    {
+        s[i] = scale * direction_[i];
+        prev_force_[i] = sys.force(i);
+
+        sys.position(i) = sys.adjust_position(sys.position(i) + s[i]);
+        sys.force   (i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+    }
+
+    // update neighbor list; reduce margin, reconstruct the list if needed
+    this->ff_->reduce_margin(2 * scale * max_len, sys);
+    this->ff_->calc_force(sys);
+
+    // y = g_new - g_old = F_old - F_new
+    for(std::size_t i=0; i<N; ++i)
+    {
+        y[i] = prev_force_[i] - sys.force(i);
+    }
+    const real_type sy = this->dot(s, y);
+    const real_type yy = this->dot(y, y);
+
+    // keep the pair only if it satisfies the curvature condition. Otherwise,
+    // the approximated inverse Hessian would not be positive definite.
+    if(sy > std::numeric_limits<real_type>::epsilon() * yy && yy > real_type(0))
+    {
+        rho_[head_] = real_type(1) / sy;
+        head_   = (head_ + 1) % memory_;
+        stored_ = std::min(stored_ + 1, memory_);
+    }
+
+    ++step_count_;
+    return this->step_count_ < this->step_limit_;
+}
+
+template<typename traitsT>
+inline void LBFGSSimulator<traitsT>::run()
+{
+    while(this->step()){/* do nothing */;}
+    return;
+}
+
+template<typename traitsT>
+inline void LBFGSSimulator<traitsT>::finalize()
+{
+    this->observers_.output  (this->step_count_, /* dt */ real_type(0.0),
+                              this->system_, this->ff_);
+    this->observers_.finalize(this->step_limit_, /* dt */ real_type(0.0),
+                              this->system_, this->ff_);
+    this->saver_.save(this->system_);
+    return;
+}
+
+#ifdef MJOLNIR_SEPARATE_BUILD
+extern template class LBFGSSimulator<SimulatorTraits<double, UnlimitedBoundary>       >;
+extern template class LBFGSSimulator<SimulatorTraits<float,  UnlimitedBoundary>       >;
+extern template class LBFGSSimulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>;
+extern template class LBFGSSimulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>;
+#endif // SEPARATE_BUILD
+
+} // mjolnir
+#endif /* MJOLNIR_CORE_LBFGS_SIMULATOR_HPP */
@@ -6,6 +6,7 @@
 #include <mjolnir/core/ForceFieldBase.hpp>
 #include <mjolnir/core/RandomNumberGenerator.hpp>
 #include <mjolnir/core/MsgPackSaver.hpp>
+#include <mjolnir/util/profiler.hpp>
 
 namespace mjolnir
 {
@@ -34,7 +35,12 @@ class MolecularDynamicsSimulator final : public SimulatorBase
           system_(std::move(sys)), ff_(std::move(ff)),
           integrator_(std::move(integr)), observers_(std::move(obs)),
           saver_(observers_.prefix()), rng_(std::move(rng))
-    {}
+    {
+#ifdef MJOLNIR_WITH_PROFILER
+        // includes the time to calculate forces
+        this->profile_counter_ = ProfileManager::get_counter("Integrator:step");
+#endif
+    }
     ~MolecularDynamicsSimulator() override {}
 
     void initialize() override;
@@ -66,6 +72,9 @@ class MolecularDynamicsSimulator final : public SimulatorBase
     observer_type   observers_;
     saver_type      saver_;
     rng_type        rng_;
+#ifdef MJOLNIR_WITH_PROFILER
+    ProfileCounter* profile_counter_;
+#endif
 };
 
 template<typename traitsT, typename integratorT>
@@ -73,6 +82,9 @@ void MolecularDynamicsSimulator<traitsT, integratorT>::initialize()
 {
     this->system_.initialize(this->rng_);
     this->ff_->initialize(this->system_);
+
+    // the first step is an output step.
+    this->ff_->enable_energy_cache(true);
     this->integrator_.initialize(this->system_, this->ff_, this->rng_);
 
     observers_.initialize(this->total_step_, this->save_step_,
@@ -94,7 +106,15 @@ bool MolecularDynamicsSimulator<traitsT, integratorT>::step()
         saver_.save(this->rng_);
     }
 
-    integrator_.step(this->time_, system_, ff_, this->rng_);
+    // If the next step outputs energies, calculate them together with forces
+    // in this step. EnergyObserver uses them instead of calculating again.
+    const std::size_t next_step = step_count_ + 1;
+    ff_->enable_energy_cache(next_step % save_step_ == 0 || next_step == total_step_);
+
+    {
+        MJOLNIR_PROFILE_SCOPE(this->profile_counter_);
+        integrator_.step(this->time_, system_, ff_, this->rng_);
+    }
     ++step_count_;
     this->time_ = this->step_count_ * integrator_.delta_t();
 
@@ -7,6 +7,7 @@
 #include <iterator>
 #include <utility>
 #include <vector>
+#include <cstdint>
 
 //! a container for verlet-list, cell-list, and other spatial indexing methods.
 //! the objectives are
@@ -14,14 +15,20 @@
 //! - store pre-calculated parameters. e.g. epsilon_ij = sqrt(eps_i * eps_j)
 //!   for Lennard-Jones takes relatively large computational cost to obtain.
 //!   calculate it for all the possible pairs to make force calculation fast.
+//! - keep each element small. The force loop reads the whole list every step,
+//!   so the size of an element directly affects the memory bandwidth.
+//!   Partner indices are stored in 32 bits, and potentials with only a few
+//!   kinds of particles store a 32-bit type-pair id instead of the expanded
+//!   parameter (see TypePairParameterMatrix). In that case, an element takes
+//!   only 8 bytes.
 
 namespace mjolnir
 {
 
 // google with "empty base optimization(EBO)".
 // By using EBO, we can compress the object size when `paramT` is a empty class.
-// without this, empty parameter type consumes 8 byte (on x86_64) because
-// std::size_t requires 8-byte alignment.
+// without this, empty parameter type consumes 4 byte because std::uint32_t
+// requires 4-byte alignment.
 
 namespace detail
 {
@@ -81,12 +88,13 @@ struct neighbor_element
     using base_type =
         detail::neighbor_element_impl<paramT, std::is_empty<paramT>::value>;
     using parameter_type = typename base_type::parameter_type;
+    using index_type     = std::uint32_t; // up to 2^32 - 1 particles
 
     neighbor_element(std::size_t idx, const paramT& p)
-        : base_type(p), index(idx)
+        : base_type(p), index(static_cast<index_type>(idx))
     {}
     neighbor_element(std::size_t idx, paramT&& p)
-        : base_type(std::move(p)), index(idx)
+        : base_type(std::move(p)), index(static_cast<index_type>(idx))
     {}
 
     neighbor_element()  = default;
@@ -100,13 +108,16 @@ struct neighbor_element
     parameter_type const& parameter() const noexcept {return base_type::parameter();}
 
     // paramT param; // derived from neighbor_element_impl
-    std::size_t index;
+    index_type index;
 };
 
 // Check the EBO works and the size of neighbor_element with empty class
-// is equal to the size of `std::size_t index;`.
-static_assert(sizeof(std::size_t) == sizeof(neighbor_element<empty_t>),
+// is equal to the size of `std::uint32_t index;`.
+static_assert(sizeof(std::uint32_t) == sizeof(neighbor_element<empty_t>),
               "checking neighbor_element reduces size of empty object");
+// a pair of 32-bit index and 32-bit type-pair id fits in 8 bytes.
+static_assert(sizeof(std::uint64_t) == sizeof(neighbor_element<std::uint32_t>),
+              "checking neighbor_element with type-pair id is compact");
 
 template<typename paramT>
 inline bool operator==(
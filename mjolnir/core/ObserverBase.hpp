@@ -38,6 +38,9 @@ class ObserverBase
 
     // for testing purpose.
     virtual std::string const& prefix() const noexcept = 0;
+
+    // name of the format, e.g. "xyz". used to show profiling results.
+    virtual std::string name() const = 0;
 };
 
 #ifdef MJOLNIR_SEPARATE_BUILD
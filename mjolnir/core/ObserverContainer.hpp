@@ -2,6 +2,8 @@
 #define MJOLNIR_CORE_OBSERVER_CONTAINER_HPP
 #include <mjolnir/util/io.hpp>
 #include <mjolnir/util/progress_bar.hpp>
+#include <mjolnir/util/profiler.hpp>
+#include <mjolnir/util/logger.hpp>
 #include <mjolnir/core/ObserverBase.hpp>
 #include <vector>
 
@@ -62,9 +64,10 @@ class ObserverContainer
     void output(const std::size_t step, const real_type dt,
                 const system_type& sys, const forcefield_type& ff)
     {
-        for(const auto& obs : this->observers_)
+        for(std::size_t i=0; i<this->observers_.size(); ++i)
         {
-            obs->output(step, dt, sys, ff);
+            MJOLNIR_PROFILE_SCOPE(this->profile_counters_[i]);
+            this->observers_[i]->output(step, dt, sys, ff);
         }
 
         // this branching might be wiped out by introducing another parameter
@@ -91,6 +94,10 @@ class ObserverContainer
             // can `finalize` the progress bar.
             std::cerr << std::endl;
         }
+#ifdef MJOLNIR_WITH_PROFILER
+        MJOLNIR_GET_DEFAULT_LOGGER();
+        MJOLNIR_LOG_NOTICE("profiling result:\n", ProfileManager::summary());
+#endif
     }
 
     std::string prefix() const
@@ -101,6 +108,10 @@ class ObserverContainer
     // assign one another XXXObserver
     void push_back(observer_base_ptr&& obs)
     {
+#ifdef MJOLNIR_WITH_PROFILER
+        this->profile_counters_.push_back(
+            ProfileManager::get_counter("Observer:" + obs->name()));
+#endif
         this->observers_.push_back(std::move(obs));
     }
 
@@ -112,6 +123,9 @@ class ObserverContainer
 
   private:
     std::vector<observer_base_ptr> observers_;
+#ifdef MJOLNIR_WITH_PROFILER
+    std::vector<ProfileCounter*>   profile_counters_;
+#endif
     progress_bar_type              progress_bar_;
     bool                           output_progress_;
 };
@@ -2,6 +2,8 @@
 #define MJOLNIR_CORE_PERIODIC_GRID_CELL_LIST_HPP
 #include <mjolnir/core/SimulatorTraits.hpp>
 #include <mjolnir/core/SpatialPartitionBase.hpp>
+#include <mjolnir/core/CellListStencil.hpp>
+#include <mjolnir/util/counting_sort.hpp>
 #include <mjolnir/util/range.hpp>
 #include <mjolnir/util/logger.hpp>
 #include <iostream>
@@ -39,11 +41,13 @@ class PeriodicGridCellList final : public SpatialPartitionBase<traitsT, Potentia
     using adjacent_cell_idx         = std::array<std::size_t, 27>;
     using cell_type                 = std::pair<range<cell_index_const_iterator>, adjacent_cell_idx>;
     using cell_list_type            = std::vector<cell_type>;
+    using particle_neighbor_pair    = std::pair<std::size_t, neighbor_type>;
 
   public:
 
     PeriodicGridCellList()
         : cutoff_(0), margin_(1), current_margin_(-1),
+          stencil_(CellListStencil::Full),
           r_x_(-1), r_y_(-1), r_z_(-1), dim_x_(0), dim_y_(0), dim_z_(0)
     {}
     ~PeriodicGridCellList() override {}
@@ -52,8 +56,9 @@ class PeriodicGridCellList final : public SpatialPartitionBase<traitsT, Potentia
     PeriodicGridCellList& operator=(PeriodicGridCellList const&) = default;
     PeriodicGridCellList& operator=(PeriodicGridCellList &&)     = default;
 
-    explicit PeriodicGridCellList(const real_type margin)
-        : cutoff_(0), margin_(margin), current_margin_(-1),
+    explicit PeriodicGridCellList(const real_type margin,
+            const CellListStencil stencil = CellListStencil::Full)
+        : cutoff_(0), margin_(margin), current_margin_(-1), stencil_(stencil),
           r_x_(-1), r_y_(-1), r_z_(-1), dim_x_(0), dim_y_(0), dim_z_(0)
     {}
 
@@ -88,6 +93,9 @@ class PeriodicGridCellList final : public SpatialPartitionBase<traitsT, Potentia
         this->r_y_ = real_type(1) / (math::Y(this->system_size_) / this->dim_y_);
         this->r_z_ = real_type(1) / (math::Z(this->system_size_) / this->dim_z_);
 
+        // participants might be changed. forget the last ordering.
+        this->index_by_cell_.clear();
+
         // construct neighbor list using cells
         this->make(neighbors, sys, pot);
         return;
@@ -123,9 +131,11 @@ class PeriodicGridCellList final : public SpatialPartitionBase<traitsT, Potentia
 
     base_type* clone() const override
     {
-        return new PeriodicGridCellList(margin_);
+        return new PeriodicGridCellList(margin_, stencil_);
     }
 
+    CellListStencil stencil() const noexcept {return this->stencil_;}
+
   private:
 
     std::size_t calc_index(const coordinate_type& pos) const noexcept
@@ -147,6 +157,10 @@ class PeriodicGridCellList final : public SpatialPartitionBase<traitsT, Potentia
     void construct_cells(
         const std::size_t dim_x, const std::size_t dim_y, const std::size_t dim_z);
 
+    // construct neighbor list by traversing the half shell of each cell.
+    void make_half_shell(neighbor_list_type& neighbors, const system_type& sys,
+                         const potential_type& pot, const real_type r_c2);
+
     void set_cutoff(const real_type c) noexcept
     {
         constexpr real_type me = mesh_epsilon();
@@ -171,6 +185,7 @@ class PeriodicGridCellList final : public SpatialPartitionBase<traitsT, Potentia
     real_type   cutoff_;
     real_type   margin_;
     real_type   current_margin_;
+    CellListStencil stencil_;
     real_type   r_x_;
     real_type   r_y_;
     real_type   r_z_;
@@ -182,8 +197,17 @@ class PeriodicGridCellList final : public SpatialPartitionBase<traitsT, Potentia
     coordinate_type     system_size_; // size of the boundary condition. in NPT, we need to check it
     cell_list_type      cell_list_;
     cell_index_container_type index_by_cell_;
+    cell_index_container_type index_by_cell_buf_; // buffer for sort
+    std::vector<std::size_t>  cell_offsets_;
     // index_by_cell_ has {particle idx, cell idx} and sorted by cell idx
     // first term of cell list contains first and last idx of index_by_cell
+    // cell_offsets_[i] is the first idx of cell i in index_by_cell_
+
+    // used in the half shell traversal. pairs_ has {particle idx, neighbor}.
+    std::vector<char>                   is_leading_;
+    std::vector<particle_neighbor_pair> pairs_;
+    std::vector<particle_neighbor_pair> pairs_buf_;
+    std::vector<std::size_t>            pair_offsets_;
 
 #ifdef MJOLNIR_WITH_OPENMP
     // OpenMP implementation uses its own specialization to run it in parallel.
@@ -255,38 +279,51 @@ void PeriodicGridCellList<traitsT, potentialT>::make(neighbor_list_type& neighbo
     const auto& participants = pot.participants();
 
     neighbors.clear();
-    index_by_cell_.resize(participants.size());
 
-    for(std::size_t i=0; i<participants.size(); ++i)
+    // If the participants are the same as the last time, update the cell
+    // indices in the current (sorted) order. Usually only a few particles
+    // move to another cell between two updates, so we can skip sorting
+    // when none of them moves.
+    bool cell_changed = (cell_offsets_.size() != cell_list_.size() + 1);
+    if(index_by_cell_.size() != participants.size())
     {
-        const auto idx = participants[i];
-        index_by_cell_[i] =
-            std::make_pair(idx, this->calc_index(sys.position(idx)));
-    }
-    std::sort(this->index_by_cell_.begin(), this->index_by_cell_.end(),
-        [](const std::pair<std::size_t, std::size_t>& lhs,
-           const std::pair<std::size_t, std::size_t>& rhs) noexcept -> bool
+        index_by_cell_.resize(participants.size());
+        for(std::size_t i=0; i<participants.size(); ++i)
         {
-            return lhs.second < rhs.second;
-        });
-
-    { // assign first and last iterator for each cells
-        auto iter = index_by_cell_.cbegin();
-        for(std::size_t i=0; i<cell_list_.size(); ++i)
+            const auto idx = participants[i];
+            index_by_cell_[i] =
+                std::make_pair(idx, this->calc_index(sys.position(idx)));
+        }
+        cell_changed = true;
+    }
+    else
+    {
+        for(auto& item : index_by_cell_)
         {
-            if(iter == index_by_cell_.cend() || i != iter->second)
-            {
-                cell_list_[i].first = make_range(iter, iter);
-                continue;
-            }
-            const auto first = iter;
-            while(iter != index_by_cell_.cend() && i == iter->second)
+            const auto cell_idx = this->calc_index(sys.position(item.first));
+            if(cell_idx != item.second)
             {
-                ++iter;
+                item.second  = cell_idx;
+                cell_changed = true;
             }
-            cell_list_[i].first = make_range(first, iter);
         }
     }
+    if(cell_changed)
+    {
+        counting_sort(this->index_by_cell_, this->index_by_cell_buf_,
+            this->cell_offsets_, this->cell_list_.size(),
+            [](const particle_cell_idx_pair& item) noexcept -> std::size_t {
+                return item.second;
+            });
+    }
+
+    // assign first and last iterator for each cells
+    for(std::size_t i=0; i<cell_list_.size(); ++i)
+    {
+        cell_list_[i].first = make_range(
+            index_by_cell_.cbegin() + cell_offsets_[i],
+            index_by_cell_.cbegin() + cell_offsets_[i+1]);
+    }
 
     MJOLNIR_LOG_DEBUG("cell list is updated");
 
@@ -295,6 +332,13 @@ void PeriodicGridCellList<traitsT, potentialT>::make(neighbor_list_type& neighbo
 
     const auto leading_participants = pot.leading_participants();
 
+    if(this->stencil_ == CellListStencil::Half)
+    {
+        this->make_half_shell(neighbors, sys, pot, r_c2);
+        this->current_margin_ = cutoff_ * margin_;
+        return;
+    }
+
     std::vector<neighbor_type> partner;
     for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
     {
@@ -347,6 +391,46 @@ void PeriodicGridCellList<traitsT, potentialT>::make(neighbor_list_type& neighbo
     return ;
 }
 
+template<typename traitsT, typename potentialT>
+void PeriodicGridCellList<traitsT, potentialT>::make_half_shell(
+        neighbor_list_type& neighbors, const system_type& sys,
+        const potential_type& pot, const real_type r_c2)
+{
+    const auto leading_participants = pot.leading_participants();
+
+    this->is_leading_.assign(sys.size(), 0);
+    for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+    {
+        this->is_leading_[leading_participants[idx]] = 1;
+    }
+
+    this->pairs_.clear();
+    find_half_shell_pairs(sys, pot, this->cell_list_, this->is_leading_,
+                          0, this->cell_list_.size(), r_c2, this->pairs_);
+
+    // collect pairs by the leading participant
+    counting_sort(this->pairs_, this->pairs_buf_, this->pair_offsets_, sys.size(),
+        [](const particle_neighbor_pair& p) noexcept -> std::size_t {
+            return p.first;
+        });
+
+    std::vector<neighbor_type> partner;
+    for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+    {
+        const auto i = leading_participants[idx];
+
+        partner.clear();
+        for(std::size_t k=pair_offsets_[i]; k<pair_offsets_[i+1]; ++k)
+        {
+            partner.push_back(this->pairs_[k].second);
+        }
+        // make the result consistent with NaivePairCalculation...
+        std::sort(partner.begin(), partner.end());
+        neighbors.add_list_for(i, partner.begin(), partner.end());
+    }
+    return;
+}
+
 // allocate list of cells and set connectivity between them
 template<typename traitsT, typename potentialT>
 void PeriodicGridCellList<traitsT, potentialT>::construct_cells(
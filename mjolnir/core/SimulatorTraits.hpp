@@ -1,6 +1,7 @@
 #ifndef MJOLNIR_CORE_SIMULATOR_TRAITS_HPP
 #define MJOLNIR_CORE_SIMULATOR_TRAITS_HPP
 #include <mjolnir/math/Vector.hpp>
+#include <type_traits>
 
 #ifdef MJOLNIR_WITH_OPENMP
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
@@ -27,5 +28,16 @@ struct is_simulator_traits : std::false_type{};
 template<typename realT, template<typename, typename> class boundaryT>
 struct is_simulator_traits<SimulatorTraits<realT, boundaryT>>: std::true_type{};
 
+// If true, System keeps a structure-of-arrays copy of positions
+// (see util/packed_coordinates.hpp) that the batched pair kernels read. By default it follows the `MJOLNIR_WITH_PACKED_COORDINATES`
+// flag. It can also be specialized for a specific traits.
+template<typename traitsT>
+struct uses_packed_coordinates
+#ifdef MJOLNIR_WITH_PACKED_COORDINATES
+    : std::true_type{};
+#else
+    : std::false_type{};
+#endif
+
 } // mjolnir
 #endif /* MJOLNIR_DEFAULT_TRAITS */
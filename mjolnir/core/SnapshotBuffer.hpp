@@ -0,0 +1,106 @@
+#ifndef MJOLNIR_CORE_SNAPSHOT_BUFFER_HPP
+#define MJOLNIR_CORE_SNAPSHOT_BUFFER_HPP
+#include <mjolnir/util/background_worker.hpp>
+#include <atomic>
+#include <array>
+#include <vector>
+
+namespace mjolnir
+{
+
+// Two snapshots of a system used alternately by an observer that writes
+// frames in the background.
+//
+// While the worker writes a frame from one snapshot, the next output fills the
+// other one. The buffers are allocated once and reused, so an output does not
+// allocate memory unless the number of particles changes. If the worker has
+// not finished the snapshot that is to be reused, i.e. it falls behind by 2
+// frames, `acquire` waits for it.
+//
+// A snapshot has the same accessors as System (`size()`, `position(i)`, ...)
+// so that the same function writes a frame from either of them.
+template<typename traitsT>
+class SnapshotBuffer
+{
+  public:
+    using traits_type     = traitsT;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using boundary_type   = typename traits_type::boundary_type;
+
+    class snapshot_type
+    {
+      public:
+
+        snapshot_type(): in_use_(false) {}
+
+        template<typename systemT>
+        void take(const systemT& sys, const bool with_forces)
+        {
+            this->boundary_ = sys.boundary();
+            this->positions_ .resize(sys.size());
+            this->velocities_.resize(sys.size());
+            this->forces_    .resize(with_forces ? sys.size() : 0);
+            for(std::size_t i=0; i<sys.size(); ++i)
+            {
+                this->positions_ [i] = sys.position(i);
+                this->velocities_[i] = sys.velocity(i);
+            }
+            for(std::size_t i=0; i<this->forces_.size(); ++i)
+            {
+                this->forces_[i] = sys.force(i);
+            }
+            return;
+        }
+
+        // it should be called when the frame has been written.
+        void release() noexcept
+        {
+            this->in_use_.store(false, std::memory_order_release);
+            return;
+        }
+
+        std::size_t            size()                  const noexcept {return positions_.size();}
+        boundary_type   const& boundary()              const noexcept {return boundary_;}
+        coordinate_type const& position(std::size_t i) const noexcept {return positions_[i];}
+        coordinate_type const& velocity(std::size_t i) const noexcept {return velocities_[i];}
+        coordinate_type const& force   (std::size_t i) const noexcept {return forces_[i];}
+
+      private:
+        friend class SnapshotBuffer<traitsT>;
+
+        std::atomic<bool>            in_use_;
+        boundary_type                boundary_;
+        std::vector<coordinate_type> positions_;
+        std::vector<coordinate_type> velocities_;
+        std::vector<coordinate_type> forces_;
+    };
+
+  public:
+
+    SnapshotBuffer(): next_(0) {}
+    ~SnapshotBuffer() = default;
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    // returns a snapshot that is not used by the worker.
+    snapshot_type& acquire(BackgroundWorker& worker)
+    {
+        auto& snapshot = this->snapshots_[this->next_];
+        this->next_ ^= 1;
+        if(snapshot.in_use_.load(std::memory_order_acquire))
+        {
+            worker.wait(); // it re-throws if writing a frame failed
+        }
+        snapshot.in_use_.store(true, std::memory_order_relaxed);
+        return snapshot;
+    }
+
+  private:
+
+    std::size_t                  next_;
+    std::array<snapshot_type, 2> snapshots_;
+};
+
+} // mjolnir
+#endif // MJOLNIR_CORE_SNAPSHOT_BUFFER_HPP
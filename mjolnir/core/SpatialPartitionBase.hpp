@@ -2,7 +2,17 @@
 #define MJOLNIR_CORE_SPATIAL_PARTITON_BASE_HPP
 #include <mjolnir/core/System.hpp>
 #include <mjolnir/core/NeighborList.hpp>
+#include <mjolnir/core/ClusterPairList.hpp>
+#include <mjolnir/core/DisplacementTracker.hpp>
+#include <mjolnir/core/SpatialPartitionTuner.hpp>
 #include <mjolnir/util/make_unique.hpp>
+#include <mjolnir/util/profiler.hpp>
+#include <mjolnir/util/throw_exception.hpp>
+#include <mjolnir/util/zorder.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <limits>
 #include <memory>
 
 namespace mjolnir
@@ -60,6 +70,30 @@ class SpatialPartitionBase
     virtual SpatialPartitionBase* clone() const = 0;
 };
 
+// SpatialPartition wraps SpatialPartitionBase and owns the NeighborList.
+//
+// It also keeps the order in which GlobalInteractions visit the leading
+// participants. By default, it is the same as `potential.leading_participants()`.
+// If `reorder` is true, the leading participants are sorted along the z-order
+// (Morton) curve every time the list is re-constructed. Particles that are
+// visited successively are then close in space and share most of their
+// partners, so the positions and forces of the partners stay in cache.
+// The indices of particles are not changed. Only the traversal order is.
+//
+// It also decides when the list should be re-constructed. Instead of reducing
+// the margin by the largest displacement at every step, it remembers the
+// positions of the participants when the list was constructed and checks
+// the actual displacements from there (see DisplacementTracker). The list is
+// re-constructed only if the two largest displacements exceed the margin.
+//
+// If it is constructed with a SpatialPartitionTuner, it tries the candidates
+// in the first steps and switches to the fastest one (see the tuner). The time
+// of the list update and of the force calculation in the interaction (through
+// `tuning_timer()`) is compared.
+//
+// If `cluster` is true, it also converts the list into a ClusterPairList of
+// spatially close particles every time the list is re-constructed. The
+// interactions that have a batched kernel use it instead of NeighborList.
 template<typename traitsT, typename PotentialT>
 class SpatialPartition
 {
@@ -79,23 +113,65 @@ class SpatialPartition
 
     using partition_base_type = SpatialPartitionBase<traits_type, potential_type>;
     using partition_type      = std::unique_ptr<partition_base_type>;
+    using tracker_type        = DisplacementTracker<traits_type>;
+    using tuner_type          = SpatialPartitionTuner<partition_base_type>;
+    using tuning_timer_type   = typename tuner_type::scoped_timer;
+
+    // 4x4 lanes in a block. It fills a 512-bit register in float.
+    static constexpr std::size_t cluster_size = 4;
+    using cluster_pair_list_type = ClusterPairList<pair_parameter_type, cluster_size>;
 
   public:
 
-    explicit SpatialPartition(partition_type&& part)
-        : partition_(std::move(part))
-    {}
+    explicit SpatialPartition(partition_type&& part, const bool reorder = false,
+                              const bool cluster = false)
+        : reorder_(reorder), cluster_(cluster), skin_(0),
+          partition_(std::move(part))
+    {
+#ifdef MJOLNIR_WITH_PROFILER
+        this->profile_counter_ = ProfileManager::get_counter("NeighborList");
+#endif
+    }
+    explicit SpatialPartition(std::unique_ptr<tuner_type>&& tuner,
+                              const bool reorder = false,
+                              const bool cluster = false)
+        : reorder_(reorder), cluster_(cluster), skin_(0),
+          partition_(tuner->start()), tuner_(std::move(tuner))
+    {
+#ifdef MJOLNIR_WITH_PROFILER
+        this->profile_counter_ = ProfileManager::get_counter("NeighborList");
+#endif
+    }
     ~SpatialPartition() = default;
     SpatialPartition(SpatialPartition&&)            = default;
     SpatialPartition& operator=(SpatialPartition&&) = default;
 
     SpatialPartition(SpatialPartition const& other)
-        : partition_(other.base().clone()), neighbors_(other.neighbors())
-    {}
+        : reorder_(other.reorder_), cluster_(other.cluster_), skin_(other.skin_),
+          partition_(other.base().clone()),
+          tuner_(other.tuner_ ? make_unique<tuner_type>(*other.tuner_) : nullptr),
+          tracker_(other.tracker_),
+          neighbors_(other.neighbors()), order_(other.order_),
+          clusters_(other.clusters_)
+    {
+#ifdef MJOLNIR_WITH_PROFILER
+        this->profile_counter_ = other.profile_counter_;
+#endif
+    }
     SpatialPartition& operator=(SpatialPartition const& other)
     {
+        this->reorder_ = other.reorder_;
+        this->cluster_ = other.cluster_;
+        this->skin_    = other.skin_;
         this->partition_.reset(other.base().clone());
+        this->tuner_ = other.tuner_ ? make_unique<tuner_type>(*other.tuner_) : nullptr;
+        this->tracker_   = other.tracker_;
         this->neighbors_ = other.neighbors();
+        this->order_     = other.order_;
+        this->clusters_  = other.clusters_;
+#ifdef MJOLNIR_WITH_PROFILER
+        this->profile_counter_ = other.profile_counter_;
+#endif
         return *this;
     }
 
@@ -103,26 +179,87 @@ class SpatialPartition
 
     void initialize(const system_type& sys, const potential_type& pot)
     {
+        using index_type = typename neighbor_type::index_type;
+        if(sys.size() > std::numeric_limits<index_type>::max())
+        {
+            throw_exception<std::out_of_range>("mjolnir::SpatialPartition: "
+                "neighbor list stores 32-bit indices, but the system has ",
+                sys.size(), " particles");
+        }
+#ifdef MJOLNIR_WITH_PROFILER
+        this->profile_counter_ = ProfileManager::get_counter(
+                std::string("NeighborList:") + pot.name());
+#endif
         partition_->initialize(neighbors_, sys, pot);
+        this->make_order(sys, pot);
+        this->make_clusters(sys, pot);
+        this->record(sys, pot);
         return;
     }
 
     void make  (const system_type& sys, const potential_type& pot)
     {
+        MJOLNIR_PROFILE_SCOPE(this->profile_counter_);
         partition_->make(neighbors_, sys, pot);
+        this->make_order(sys, pot);
+        this->make_clusters(sys, pot);
+        this->record(sys, pot);
         return ;
     }
 
-    // reduce_margin return true if neighbour list is updated
-    bool reduce_margin(const real_type dmargin, const system_type& sys,
+    // reduce_margin return true if neighbour list is updated.
+    // only the calls that re-construct the list are counted by the profiler.
+    //
+    // `dmargin` is the largest displacement in the last step. It is not used
+    // because the displacements from the reference positions are tracked.
+    bool reduce_margin(const real_type /*dmargin*/, const system_type& sys,
                        const potential_type& pot)
     {
-        return partition_->reduce_margin(neighbors_, dmargin, sys, pot);
+        if(this->tuner_)
+        {
+            if(auto next = tuner_->step())
+            {
+                MJOLNIR_PROFILE_SCOPE(this->profile_counter_);
+                this->partition_ = std::move(next);
+                this->partition_->initialize(neighbors_, sys, pot);
+                this->make_order(sys, pot);
+                this->make_clusters(sys, pot);
+                this->record(sys, pot);
+                return true;
+            }
+        }
+        const auto timer = this->tuning_timer();
+        if(!this->tracks_displacement())
+        {
+            return false; // e.g. NaivePairCalculation never updates the list
+        }
+        if(tracker_.largest_displacements(sys) <= this->skin_)
+        {
+            return false;
+        }
+        this->make(sys, pot);
+        return true;
     }
+
+    // The distances between particles are scaled. The margin that is left is
+    // scaled accordingly and the current positions become the references.
     bool scale_margin(const real_type scale, const system_type& sys,
                       const potential_type& pot)
     {
-        return partition_->scale_margin(neighbors_, scale, sys, pot);
+        if(!this->tracks_displacement())
+        {
+            return false;
+        }
+        const auto rc   = partition_->cutoff();
+        const auto left = this->skin_ - tracker_.largest_displacements(sys);
+        this->skin_ = (rc + left) * scale - rc;
+        if(this->skin_ < 0)
+        {
+            this->make(sys, pot);
+            return true;
+        }
+        tracker_.record(sys, pot.participants());
+        return false;
     }
 
     real_type cutoff() const noexcept {return partition_->cutoff();}
@@ -130,6 +267,31 @@ class SpatialPartition
 
     range_type partners(std::size_t i) const noexcept {return neighbors_[i];}
 
+    // the leading participants in the order of traversal.
+    std::vector<std::size_t> const& leading_participants() const noexcept
+    {
+        return order_;
+    }
+
+    bool reorder() const noexcept {return reorder_;}
+
+    // if true, `cluster_pairs()` contains the same pairs as `partners()`.
+    bool has_cluster_pairs() const noexcept {return cluster_;}
+    cluster_pair_list_type const& cluster_pairs() const noexcept {return clusters_;}
+
+    // the length of the buffer that is left after the last construction.
+    real_type skin() const noexcept {return skin_;}
+
+    // nullptr if the partition is not automatically chosen.
+    tuner_type const* tuner() const noexcept {return tuner_.get();}
+
+    // While the partition is being tuned, the interaction that owns it keeps
+    // this timer alive during its force calculation. Otherwise it does nothing.
+    tuning_timer_type tuning_timer() const noexcept
+    {
+        return tuning_timer_type(this->tuner_.get());
+    }
+
     // for testing
     partition_base_type const& base() const noexcept {return *partition_;}
     partition_base_type &      base()       noexcept {return *partition_;}
@@ -139,9 +301,133 @@ class SpatialPartition
 
   private:
 
+    // NaivePairCalculation has infinite cutoff and margin. It never needs
+    // to be re-constructed, so it does not track the displacements.
+    bool tracks_displacement() const noexcept
+    {
+        return std::isfinite(this->skin_);
+    }
+
+    void record(const system_type& sys, const potential_type& pot)
+    {
+        this->skin_ = partition_->cutoff() * partition_->margin();
+        if(this->tracks_displacement())
+        {
+            tracker_.record(sys, pot.participants());
+        }
+        return;
+    }
+
+    void make_order(const system_type& sys, const potential_type& pot)
+    {
+        const auto leading = pot.leading_participants();
+        this->order_.assign(leading.begin(), leading.end());
+        if(this->reorder_)
+        {
+            this->sort_along_zorder(sys, this->order_);
+        }
+        return;
+    }
+
+    // clusters are always made along the z-order curve, regardless of
+    // `reorder`, to make them compact.
+    void make_clusters(const system_type& sys, const potential_type& pot)
+    {
+        if(!this->cluster_)
+        {
+            return;
+        }
+        this->cluster_order_ = pot.participants();
+        this->sort_along_zorder(sys, this->cluster_order_);
+        this->clusters_.make(cluster_order_, pot.leading_participants(),
+                             neighbors_, sys.size());
+        return;
+    }
+
+    void sort_along_zorder(const system_type& sys, std::vector<std::size_t>& ps)
+    {
+        if(ps.size() < 2)
+        {
+            return;
+        }
+        const auto  scale  = scaling(sys, sys.boundary(), ps);
+        const auto& lower  = scale.first;
+        const auto& rwidth = scale.second;
+
+        zindices_.resize(ps.size());
+        for(std::size_t idx=0; idx<ps.size(); ++idx)
+        {
+            const auto i = ps[idx];
+            auto pos = sys.position(i) - lower;
+            math::X(pos) *= math::X(rwidth);
+            math::Y(pos) *= math::Y(rwidth);
+            math::Z(pos) *= math::Z(rwidth);
+            zindices_[idx] = std::make_pair(
+                detail::zorder_index<real_type>(pos), i);
+        }
+        std::sort(zindices_.begin(), zindices_.end());
+
+        for(std::size_t idx=0; idx<ps.size(); ++idx)
+        {
+            ps[idx] = zindices_[idx].second;
+        }
+        return;
+    }
+
+    // returns {lower bound, 1 / width} of the region to be sorted
+    std::pair<coordinate_type, coordinate_type> scaling(const system_type& sys,
+        const UnlimitedBoundary<real_type, coordinate_type>&,
+        const std::vector<std::size_t>& ps) const noexcept
+    {
+        coordinate_type lower = sys.position(ps.front());
+        coordinate_type upper = sys.position(ps.front());
+        for(const auto i : ps)
+        {
+            const auto& r = sys.position(i);
+            math::X(lower) = std::min(math::X(lower), math::X(r));
+            math::Y(lower) = std::min(math::Y(lower), math::Y(r));
+            math::Z(lower) = std::min(math::Z(lower), math::Z(r));
+            math::X(upper) = std::max(math::X(upper), math::X(r));
+            math::Y(upper) = std::max(math::Y(upper), math::Y(r));
+            math::Z(upper) = std::max(math::Z(upper), math::Z(r));
+        }
+        // if all the particles are on a plane, the width becomes zero.
+        const auto rw = [](const real_type w) noexcept -> real_type {
+            return (w > real_type(0)) ? real_type(1) / w : real_type(0);
+        };
+        const coordinate_type width = upper - lower;
+        return std::make_pair(lower, math::make_coordinate<coordinate_type>(
+                rw(math::X(width)), rw(math::Y(width)), rw(math::Z(width))));
+    }
+    std::pair<coordinate_type, coordinate_type> scaling(const system_type&,
+        const CuboidalPeriodicBoundary<real_type, coordinate_type>& boundary,
+        const std::vector<std::size_t>&) const noexcept
+    {
+        const auto& width = boundary.width();
+        return std::make_pair(boundary.lower_bound(),
+            math::make_coordinate<coordinate_type>(real_type(1) / math::X(width),
+                real_type(1) / math::Y(width), real_type(1) / math::Z(width)));
+    }
+
+  private:
+
+    bool               reorder_;
+    bool               cluster_;
+    real_type          skin_;
     partition_type     partition_;
+    std::unique_ptr<tuner_type> tuner_;
+    tracker_type       tracker_;
     neighbor_list_type neighbors_;
+    std::vector<std::size_t> order_;
+    cluster_pair_list_type   clusters_;
+    std::vector<std::size_t> cluster_order_; // buffer
+    std::vector<std::pair<std::uint32_t, std::size_t>> zindices_; // buffer
+#ifdef MJOLNIR_WITH_PROFILER
+    ProfileCounter*    profile_counter_; // shared by the name of potential
+#endif
 };
+template<typename traitsT, typename PotentialT>
+constexpr std::size_t SpatialPartition<traitsT, PotentialT>::cluster_size;
 
 } // mjolnir
 #endif// MJOLNIR_CORE_SPATIAL_PARTITON_BASE_HPP
@@ -0,0 +1,211 @@
+#ifndef MJOLNIR_CORE_SPATIAL_PARTITION_TUNER_HPP
+#define MJOLNIR_CORE_SPATIAL_PARTITION_TUNER_HPP
+#include <mjolnir/util/logger.hpp>
+#include <mjolnir/util/throw_exception.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mjolnir
+{
+
+// SpatialPartitionTuner chooses the fastest spatial partition from candidates
+// at the beginning of a simulation (`spatial_partition.type = "Auto"`).
+//
+// Each candidate is used for `trial_steps` steps. While it is being tried,
+// only the time spent by this partition and the interaction that owns it is
+// measured through `timer()`, i.e. the re-construction of the list and the
+// force (and energy) calculation of the interaction. Other interactions,
+// including other tuners running at the same time, do not affect the result.
+// The first construction after switching is not counted because it happens
+// only once in an actual run. After all the candidates are tested, the
+// fastest one is locked in. If `retune_interval` is not zero, the candidates
+// are tested again after the interval.
+//
+// `partitionT` is SpatialPartitionBase. It must have `clone()`.
+// `clockT` can be replaced to test it without depending on the actual time.
+template<typename partitionT, typename clockT = std::chrono::steady_clock>
+class SpatialPartitionTuner
+{
+  public:
+    using partition_base_type = partitionT;
+    using partition_type      = std::unique_ptr<partition_base_type>;
+    using candidate_type      = std::pair<std::string, partition_type>;
+    using clock_type          = clockT;
+
+    // It adds the elapsed time in its lifetime to the tuner. If the tuner is
+    // null or not tuning, it does nothing.
+    class scoped_timer
+    {
+      public:
+        explicit scoped_timer(SpatialPartitionTuner* tuner) noexcept
+            : tuner_((tuner && tuner->tuning()) ? tuner : nullptr)
+        {
+            if(tuner_) {start_ = clock_type::now();}
+        }
+        ~scoped_timer() noexcept
+        {
+            if(tuner_)
+            {
+                const std::chrono::duration<double> dt = clock_type::now() - start_;
+                tuner_->add_elapsed(dt.count());
+            }
+        }
+        scoped_timer(scoped_timer&& other) noexcept
+            : tuner_(other.tuner_), start_(other.start_)
+        {
+            other.tuner_ = nullptr;
+        }
+        scoped_timer(scoped_timer const&)            = delete;
+        scoped_timer& operator=(scoped_timer const&) = delete;
+        scoped_timer& operator=(scoped_timer&&)      = delete;
+
+      private:
+        SpatialPartitionTuner*          tuner_;
+        typename clock_type::time_point start_;
+    };
+
+  public:
+
+    SpatialPartitionTuner(std::vector<candidate_type> candidates,
+                          const std::size_t trial_steps,
+                          const std::size_t retune_interval)
+        : tuning_(false), current_(0), step_(0), trial_steps_(trial_steps),
+          retune_interval_(retune_interval), accumulated_(0.0),
+          candidates_(std::move(candidates)),
+          elapsed_(candidates_.size(), std::numeric_limits<double>::infinity())
+    {
+        if(candidates_.empty())
+        {
+            throw_exception<std::invalid_argument>("mjolnir::"
+                "SpatialPartitionTuner: no candidate is given");
+        }
+        if(trial_steps_ == 0)
+        {
+            throw_exception<std::invalid_argument>("mjolnir::"
+                "SpatialPartitionTuner: trial_steps should be positive");
+        }
+    }
+    ~SpatialPartitionTuner() = default;
+    SpatialPartitionTuner(SpatialPartitionTuner&&)            = default;
+    SpatialPartitionTuner& operator=(SpatialPartitionTuner&&) = default;
+
+    SpatialPartitionTuner(SpatialPartitionTuner const& other)
+        : tuning_(other.tuning_), current_(other.current_), step_(other.step_),
+          trial_steps_(other.trial_steps_),
+          retune_interval_(other.retune_interval_),
+          accumulated_(other.accumulated_), elapsed_(other.elapsed_)
+    {
+        this->candidates_.reserve(other.candidates_.size());
+        for(const auto& cand : other.candidates_)
+        {
+            this->candidates_.emplace_back(cand.first,
+                    partition_type(cand.second->clone()));
+        }
+    }
+    SpatialPartitionTuner& operator=(SpatialPartitionTuner const& other)
+    {
+        SpatialPartitionTuner tmp(other);
+        *this = std::move(tmp);
+        return *this;
+    }
+
+    // (re)starts tuning and returns the first candidate.
+    partition_type start()
+    {
+        this->tuning_      = true;
+        this->current_     = 0;
+        this->step_        = 0;
+        this->accumulated_ = 0.0;
+        std::fill(elapsed_.begin(), elapsed_.end(),
+                  std::numeric_limits<double>::infinity());
+        return partition_type(candidates_.front().second->clone());
+    }
+
+    scoped_timer timer() noexcept {return scoped_timer(this);}
+
+    void add_elapsed(const double sec) noexcept
+    {
+        this->accumulated_ += sec;
+        return;
+    }
+
+    // It should be called once per step, before the list is updated. If the
+    // partition should be switched, it returns the next one. Otherwise, it
+    // returns nullptr.
+    partition_type step()
+    {
+        MJOLNIR_GET_DEFAULT_LOGGER();
+
+        if(!this->tuning_)
+        {
+            this->step_ += 1;
+            if(this->retune_interval_ != 0 && retune_interval_ <= step_)
+            {
+                MJOLNIR_LOG_NOTICE("spatial partition tuner: re-tuning");
+                return this->start();
+            }
+            return nullptr;
+        }
+
+        if(this->step_ == 0)
+        {
+            // discard the time spent in the first construction
+            this->accumulated_ = 0.0;
+        }
+        if(this->step_++ < this->trial_steps_)
+        {
+            return nullptr;
+        }
+
+        this->elapsed_.at(current_) = accumulated_ / trial_steps_;
+        MJOLNIR_LOG_INFO("spatial partition tuner: ", candidates_.at(current_).first,
+                         " takes ", elapsed_.at(current_), " sec/step");
+
+        this->step_        = 0;
+        this->accumulated_ = 0.0;
+        this->current_    += 1;
+        if(this->current_ < this->candidates_.size())
+        {
+            return partition_type(candidates_.at(current_).second->clone());
+        }
+
+        // all the candidates are tested.
+        this->tuning_  = false;
+        this->current_ = std::distance(elapsed_.begin(),
+                std::min_element(elapsed_.begin(), elapsed_.end()));
+        MJOLNIR_LOG_NOTICE("spatial partition tuner: ",
+            candidates_.at(current_).first, " is chosen (",
+            elapsed_.at(current_), " sec/step)");
+
+        return partition_type(candidates_.at(current_).second->clone());
+    }
+
+    bool tuning() const noexcept {return tuning_;}
+    std::size_t trial_steps()     const noexcept {return trial_steps_;}
+    std::size_t retune_interval() const noexcept {return retune_interval_;}
+
+    // the one being tested, or the one chosen.
+    std::string const& current() const noexcept {return candidates_[current_].first;}
+    std::vector<candidate_type> const& candidates() const noexcept {return candidates_;}
+    std::vector<double>         const& elapsed()    const noexcept {return elapsed_;}
+
+  private:
+
+    bool        tuning_;
+    std::size_t current_;
+    std::size_t step_;
+    std::size_t trial_steps_;
+    std::size_t retune_interval_;
+    double      accumulated_; // [sec] in the current trial
+    std::vector<candidate_type> candidates_;
+    std::vector<double>         elapsed_; // [sec/step]
+};
+
+} // mjolnir
+#endif// MJOLNIR_CORE_SPATIAL_PARTITION_TUNER_HPP
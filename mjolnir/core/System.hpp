@@ -7,6 +7,7 @@
 #include <mjolnir/core/BoundaryCondition.hpp>
 #include <mjolnir/core/RandomNumberGenerator.hpp>
 #include <mjolnir/util/logger.hpp>
+#include <mjolnir/util/packed_coordinates.hpp>
 #include <vector>
 #include <map>
 #include <cassert>
@@ -35,16 +36,22 @@ class System
     using real_container_type          = std::vector<real_type>;
     using coordinate_container_type    = std::vector<coordinate_type>;
     using string_container_type        = std::vector<std::string>;
+    using packed_coordinate_type       = packed_coordinates<real_type, coordinate_type>;
+
+    static constexpr bool packed_coordinates_enabled =
+        uses_packed_coordinates<traits_type>::value;
 
   public:
 
     System(const std::size_t num_particles, const boundary_type& bound)
         : velocity_initialized_(false), force_initialized_(false),
+          mixed_precision_(false),
           boundary_(bound), attributes_(), virial_(0,0,0, 0,0,0, 0,0,0),
           num_particles_(num_particles), masses_   (num_particles),
           rmasses_      (num_particles), positions_(num_particles),
           velocities_   (num_particles), forces_   (num_particles),
-          names_        (num_particles), groups_   (num_particles)
+          names_        (num_particles), groups_   (num_particles),
+          packed_positions_(packed_coordinates_enabled ? num_particles : 0)
     {}
     ~System() = default;
     System(const System&) = default;
@@ -153,7 +160,17 @@ class System
     // represents the "force" of a particle at that time point. I mean, we can
     // consider the "force" is equivalent to the force that is calculated by
     // single core.
-    void preprocess_forces()  noexcept {/* do nothing */}
+    //     If packed coordinates are enabled, `preprocess_forces()` copies the
+    // current positions into `packed_positions()`. So the packed array is
+    // valid only while forces are being calculated.
+    void preprocess_forces() noexcept
+    {
+        if(packed_coordinates_enabled)
+        {
+            packed_positions_.pack(positions_);
+        }
+        return;
+    }
     void postprocess_forces() noexcept {/* do nothing */}
 
     real_type  mass (std::size_t i) const noexcept {return masses_[i];}
@@ -191,12 +208,25 @@ class System
     bool  force_initialized()    const noexcept {return force_initialized_;}
     bool& force_initialized()          noexcept {return force_initialized_;}
 
+    // If true, pair kernels that support it (see BatchedPairKernel.hpp) are
+    // evaluated in single precision while forces, virial, and energies are
+    // accumulated in real_type. It is set by `precision = "mixed"`.
+    bool  mixed_precision()      const noexcept {return mixed_precision_;}
+    bool& mixed_precision()            noexcept {return mixed_precision_;}
+
     coordinate_container_type const& forces() const noexcept {return forces_;}
     coordinate_container_type&       forces()       noexcept {return forces_;}
 
+    // structure-of-arrays copy of positions that the batched pair kernels read
+    // (see forcefield/global/BatchedPairKernel.hpp). It is empty if
+    // `packed_coordinates_enabled` is false. Forces are scattered to partners
+    // by index, so they are written directly to `force(i)`.
+    packed_coordinate_type const& packed_positions() const noexcept {return packed_positions_;}
+
   private:
 
     bool           velocity_initialized_, force_initialized_;
+    bool           mixed_precision_;
     boundary_type  boundary_;
     attribute_type attributes_;
     matrix33_type  virial_;
@@ -209,6 +239,7 @@ class System
     coordinate_container_type    forces_;
     string_container_type        names_;
     string_container_type        groups_;
+    packed_coordinate_type       packed_positions_;
 
 #ifdef MJOLNIR_WITH_OPENMP
     // OpenMP implementation uses its own System<OpenMP> to avoid data race.
@@ -218,6 +249,9 @@ class System
 #endif
 };
 
+template<typename traitsT>
+constexpr bool System<traitsT>::packed_coordinates_enabled;
+
 #ifdef MJOLNIR_SEPARATE_BUILD
 extern template class System<SimulatorTraits<double, UnlimitedBoundary>>;
 extern template class System<SimulatorTraits<float,  UnlimitedBoundary>>;
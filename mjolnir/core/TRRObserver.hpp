@@ -4,8 +4,10 @@
 #include <mjolnir/core/BoundaryCondition.hpp>
 #include <mjolnir/core/System.hpp>
 #include <mjolnir/core/Unit.hpp>
+#include <mjolnir/core/SnapshotBuffer.hpp>
+#include <mjolnir/util/buffered_file_writer.hpp>
+#include <mjolnir/util/background_worker.hpp>
 #include <iostream>
-#include <fstream>
 #include <iomanip>
 
 // It is an observer class that observes the current state of system and outputs
@@ -28,17 +30,30 @@ class TRRObserver final : public ObserverBase<traitsT>
     using coordinate_type   = typename base_type::coordinate_type;
     using system_type       = typename base_type::system_type;
     using forcefield_type   = typename base_type::forcefield_type;
+    using boundary_type     = typename traits_type::boundary_type;
+    using worker_type       = std::shared_ptr<BackgroundWorker>;
+    using snapshot_type     = typename SnapshotBuffer<traitsT>::snapshot_type;
 
   public:
 
-    explicit TRRObserver(const std::string& filename_prefix)
+    // the file is kept open until the observer is destructed.
+    // `flush_interval` and `fsync_interval` are passed to BufferedFileWriter.
+    // If `worker` is given, frames are written in the background.
+    explicit TRRObserver(const std::string& filename_prefix,
+                         const std::size_t  flush_interval = 1,
+                         const std::size_t  fsync_interval = 0,
+                         worker_type        worker = nullptr)
       : base_type(), prefix_(filename_prefix),
-        trr_name_(filename_prefix + std::string(".trr"))
+        trr_name_(filename_prefix + std::string(".trr")),
+        // it throws an error if the file cannot be opened.
+        trr_file_(trr_name_, flush_interval, fsync_interval),
+        worker_(std::move(worker))
+    {}
+    ~TRRObserver() override
     {
-        // clear files and throw an error if the files cannot be opened.
-        this->clear_file(this->trr_name_);
+        // tasks in the worker refer this.
+        if(this->worker_) {this->worker_->drain();}
     }
-    ~TRRObserver() override {}
 
     void initialize(const std::size_t,  const std::size_t, const real_type,
                     const system_type&, const forcefield_type&) override
@@ -68,23 +83,20 @@ class TRRObserver final : public ObserverBase<traitsT>
     void finalize(const std::size_t, const real_type,
                   const system_type&, const forcefield_type&) override
     {
-        return; // do nothing.
+        run_in_background(this->worker_, [this] {this->trr_file_.flush();});
+        if(this->worker_) {this->worker_->wait();}
+        return;
     }
 
     std::string const& prefix() const noexcept override {return prefix_;}
+    std::string        name()   const          override {return "trr";}
 
   private:
 
-    void clear_file(const std::string& fname) const
-    {
-        std::ofstream ofs(fname);
-        if(not ofs.good())
-        {
-            throw_exception<std::runtime_error>("[error] mjolnir::TRRObserver: "
-                    "file open error: ", fname);
-        }
-        return;
-    }
+    // `frameT` is either system_type or snapshot_type.
+    template<typename frameT>
+    void write_frame(const frameT& frame, const std::size_t step,
+                     const real_type dt);
 
     // it is a helper function to write unitcell region size.
     // for UnlimitedBoundary, returns zero.
@@ -105,32 +117,32 @@ class TRRObserver final : public ObserverBase<traitsT>
 
     // it is a helper function to write unitcell region size.
     // for UnlimitedBoundary, returns zero.
-    static void write_boxinfo(std::ostream&,
+    static void write_boxinfo(BufferedFileWriter&,
         const UnlimitedBoundary<real_type, coordinate_type>&) noexcept
     {
         // no unitcell information needed. block size is none.
         return ;
     }
     // for CuboidalPeriodicBoundary, returns .
-    static void write_boxinfo(std::ostream& os,
-        const CuboidalPeriodicBoundary<real_type, coordinate_type>& bdry) noexcept
+    static void write_boxinfo(BufferedFileWriter& os,
+        const CuboidalPeriodicBoundary<real_type, coordinate_type>& bdry)
     {
         const coordinate_type& width = bdry.width();
 
         // vector for x direction
-        detail::write_as_bytes(os, real_type(math::X(width)));
-        detail::write_as_bytes(os, real_type(0));
-        detail::write_as_bytes(os, real_type(0));
+        os.write_as_bytes(real_type(math::X(width)));
+        os.write_as_bytes(real_type(0));
+        os.write_as_bytes(real_type(0));
 
         // vector for y direction
-        detail::write_as_bytes(os, real_type(0));
-        detail::write_as_bytes(os, real_type(math::Y(width)));
-        detail::write_as_bytes(os, real_type(0));
+        os.write_as_bytes(real_type(0));
+        os.write_as_bytes(real_type(math::Y(width)));
+        os.write_as_bytes(real_type(0));
 
         // vector for z direction
-        detail::write_as_bytes(os, real_type(0));
-        detail::write_as_bytes(os, real_type(0));
-        detail::write_as_bytes(os, real_type(math::Z(width)));
+        os.write_as_bytes(real_type(0));
+        os.write_as_bytes(real_type(0));
+        os.write_as_bytes(real_type(math::Z(width)));
         return ;
     }
 
@@ -138,78 +150,104 @@ class TRRObserver final : public ObserverBase<traitsT>
 
     std::string prefix_;
     std::string trr_name_;
-    std::size_t number_of_frames_;
+    BufferedFileWriter trr_file_;
+    worker_type        worker_;
+    SnapshotBuffer<traitsT> snapshots_;
 };
 
 template<typename traitsT>
 inline void TRRObserver<traitsT>::output(
     const std::size_t step, const real_type dt,
     const system_type& sys, const forcefield_type&)
+{
+    if(!this->worker_)
+    {
+        this->write_frame(sys, step, dt);
+        return ;
+    }
+
+    // take a snapshot. it is written in the background while the simulation
+    // continues.
+    auto& snapshot = this->snapshots_.acquire(*this->worker_);
+    snapshot.take(sys, /*forces = */ true);
+
+    this->worker_->push([this, &snapshot, step, dt] {
+            this->write_frame(snapshot, step, dt);
+            snapshot.release();
+        });
+    return ;
+}
+
+template<typename traitsT>
+template<typename frameT>
+inline void TRRObserver<traitsT>::write_frame(const frameT& frame,
+        const std::size_t step, const real_type dt)
 {
     using self_type = TRRObserver<traitsT>;
-    std::ofstream ofs(this->trr_name_, std::ios::app | std::ios::binary);
+    auto& ofs = this->trr_file_;
 
     // ------------------------------------------------------------------------
     // write frame header
-    detail::write_as_bytes(ofs, std::int32_t(1993)); // magic number for trr
-    detail::write_as_bytes(ofs, std::int32_t(  13));
+    ofs.write_as_bytes(std::int32_t(1993)); // magic number for trr
+    ofs.write_as_bytes(std::int32_t(  13));
 
-    detail::write_as_bytes(ofs, std::int32_t(this->prefix_.size()));
+    ofs.write_as_bytes(std::int32_t(this->prefix_.size()));
     ofs.write(this->prefix_.data(), this->prefix_.size()); // title
 
-    const std::int32_t sys_size = sys.size(); // number of particles
+    const std::int32_t sys_size = frame.size(); // number of particles
     const std::int32_t crd_size = sizeof(real_type) * 3 * sys_size;
 
-    detail::write_as_bytes(ofs, std::int32_t(0));
-    detail::write_as_bytes(ofs, std::int32_t(0));
-    detail::write_as_bytes(ofs, self_type::boxinfo_size(sys.boundary()));
-    detail::write_as_bytes(ofs, std::int32_t(0));
-    detail::write_as_bytes(ofs, std::int32_t(0));
-    detail::write_as_bytes(ofs, std::int32_t(0));
-    detail::write_as_bytes(ofs, std::int32_t(0));
-    detail::write_as_bytes(ofs, crd_size       );    // xyz size
-    detail::write_as_bytes(ofs, crd_size       );    // vel size
-    detail::write_as_bytes(ofs, crd_size       );    // force size
-    detail::write_as_bytes(ofs, sys_size       );    // natoms
-    detail::write_as_bytes(ofs, std::int32_t(step)); // step
-    detail::write_as_bytes(ofs, std::int32_t(0));
-
-    detail::write_as_bytes(ofs,             dt); // tstep
-    detail::write_as_bytes(ofs, real_type(0.0));
+    ofs.write_as_bytes(std::int32_t(0));
+    ofs.write_as_bytes(std::int32_t(0));
+    ofs.write_as_bytes(self_type::boxinfo_size(frame.boundary()));
+    ofs.write_as_bytes(std::int32_t(0));
+    ofs.write_as_bytes(std::int32_t(0));
+    ofs.write_as_bytes(std::int32_t(0));
+    ofs.write_as_bytes(std::int32_t(0));
+    ofs.write_as_bytes(crd_size       );    // xyz size
+    ofs.write_as_bytes(crd_size       );    // vel size
+    ofs.write_as_bytes(crd_size       );    // force size
+    ofs.write_as_bytes(sys_size       );    // natoms
+    ofs.write_as_bytes(std::int32_t(step)); // step
+    ofs.write_as_bytes(std::int32_t(0));
+
+    ofs.write_as_bytes(            dt); // tstep
+    ofs.write_as_bytes(real_type(0.0));
 
     // ------------------------------------------------------------------------
     // write box size
 
-    self_type::write_boxinfo(ofs, sys.boundary());
+    self_type::write_boxinfo(ofs, frame.boundary());
 
     // ------------------------------------------------------------------------
     // write positions
 
-    for(std::size_t i=0; i<sys.size(); ++i)
+    for(std::size_t i=0; i<frame.size(); ++i)
     {
-        detail::write_as_bytes(ofs, math::X(sys.position(i)));
-        detail::write_as_bytes(ofs, math::Y(sys.position(i)));
-        detail::write_as_bytes(ofs, math::Z(sys.position(i)));
+        ofs.write_as_bytes(math::X(frame.position(i)));
+        ofs.write_as_bytes(math::Y(frame.position(i)));
+        ofs.write_as_bytes(math::Z(frame.position(i)));
     }
 
     // ------------------------------------------------------------------------
     // write velocities
-    for(std::size_t i=0; i<sys.size(); ++i)
+    for(std::size_t i=0; i<frame.size(); ++i)
     {
-        detail::write_as_bytes(ofs, math::X(sys.velocity(i)));
-        detail::write_as_bytes(ofs, math::Y(sys.velocity(i)));
-        detail::write_as_bytes(ofs, math::Z(sys.velocity(i)));
+        ofs.write_as_bytes(math::X(frame.velocity(i)));
+        ofs.write_as_bytes(math::Y(frame.velocity(i)));
+        ofs.write_as_bytes(math::Z(frame.velocity(i)));
     }
 
     // ------------------------------------------------------------------------
     // write forces
-    for(std::size_t i=0; i<sys.size(); ++i)
+    for(std::size_t i=0; i<frame.size(); ++i)
     {
-        detail::write_as_bytes(ofs, math::X(sys.force(i)));
-        detail::write_as_bytes(ofs, math::Y(sys.force(i)));
-        detail::write_as_bytes(ofs, math::Z(sys.force(i)));
+        ofs.write_as_bytes(math::X(frame.force(i)));
+        ofs.write_as_bytes(math::Y(frame.force(i)));
+        ofs.write_as_bytes(math::Z(frame.force(i)));
     }
 
+    ofs.end_frame();
     return ;
 }
 
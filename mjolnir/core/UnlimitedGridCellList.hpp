@@ -2,16 +2,29 @@
 #define MJOLNIR_CORE_UNLIMITED_GRID_CELL_LIST_HPP
 #include <mjolnir/core/SimulatorTraits.hpp>
 #include <mjolnir/core/SpatialPartitionBase.hpp>
+#include <mjolnir/core/CellListStencil.hpp>
+#include <mjolnir/util/counting_sort.hpp>
+#include <mjolnir/util/range.hpp>
 #include <mjolnir/util/logger.hpp>
 #include <functional>
 #include <algorithm>
 #include <limits>
 #include <array>
 #include <cmath>
+#include <cassert>
+#include <cstdint>
 
 namespace mjolnir
 {
 
+// Cell list for systems without periodic boundary.
+//
+// Since the system has no boundary, the space is divided into an infinite grid
+// and only the cells that contain at least one participant are allocated.
+// A cell is identified by a key that packs its integer coordinates, so the
+// cells that are far apart are never merged into the same cell and the memory
+// usage depends only on the number of occupied cells, not on the size of the
+// region that the participants span.
 template<typename traitsT, typename PotentialT>
 class UnlimitedGridCellList final : public SpatialPartitionBase<traitsT, PotentialT>
 {
@@ -29,22 +42,27 @@ class UnlimitedGridCellList final : public SpatialPartitionBase<traitsT, Potenti
     using neighbor_type      = typename base_type::neighbor_type;
     using range_type         = typename base_type::range_type;
 
-    static constexpr std::size_t  dim_size()     {return 8u;}
-    static constexpr std::int64_t dim()          {return 8; }
-    static constexpr std::size_t  total_size()   {return 512u;}
-    static constexpr real_type    mesh_epsilon() {return 1e-6;}
+    using cell_key_type = std::uint64_t;
 
-    using particle_cell_idx_pair    = std::pair<std::size_t, std::size_t>;
+    // number of bits to store a cell coordinate in a key
+    static constexpr std::size_t   key_bits()     {return 21u;}
+    // cell coordinates are clamped into [-key_limit(), key_limit()]
+    static constexpr std::int64_t  key_limit()    {return (std::int64_t(1) << 20) - 2;}
+    static constexpr real_type     mesh_epsilon() {return 1e-6;}
+
+    using particle_cell_idx_pair    = std::pair<std::size_t, cell_key_type>;
     using cell_index_container_type = std::vector<particle_cell_idx_pair>;
     using cell_index_const_iterator = typename cell_index_container_type::const_iterator;
     using adjacent_cell_idx         = std::array<std::size_t, 27>;
     using cell_type                 = std::pair<range<cell_index_const_iterator>, adjacent_cell_idx>;
-    using cell_list_type            = std::array<cell_type, dim() * dim() * dim()>;
+    using cell_list_type            = std::vector<cell_type>;
+    using particle_neighbor_pair    = std::pair<std::size_t, neighbor_type>;
 
   public:
 
     UnlimitedGridCellList()
-        : margin_(0.5), current_margin_(-1.0), r_cell_size_(-1.0)
+        : margin_(0.5), current_margin_(-1.0), stencil_(CellListStencil::Full),
+          r_cell_size_(-1.0)
     {}
 
     ~UnlimitedGridCellList() override {}
@@ -53,8 +71,10 @@ class UnlimitedGridCellList final : public SpatialPartitionBase<traitsT, Potenti
     UnlimitedGridCellList& operator=(UnlimitedGridCellList const&) = default;
     UnlimitedGridCellList& operator=(UnlimitedGridCellList &&)     = default;
 
-    explicit UnlimitedGridCellList(const real_type margin)
-        : margin_(margin), current_margin_(-1.0), r_cell_size_(-1.0)
+    explicit UnlimitedGridCellList(const real_type margin,
+            const CellListStencil stencil = CellListStencil::Full)
+        : margin_(margin), current_margin_(-1.0), stencil_(stencil),
+          r_cell_size_(-1.0)
     {}
 
     bool valid() const noexcept override
@@ -95,28 +115,58 @@ class UnlimitedGridCellList final : public SpatialPartitionBase<traitsT, Potenti
 
     base_type* clone() const override
     {
-        return new UnlimitedGridCellList(this->margin_);
+        return new UnlimitedGridCellList(this->margin_, this->stencil_);
     }
 
+    CellListStencil stencil() const noexcept {return this->stencil_;}
+
+    // the number of cells that contain at least one participant
+    std::size_t num_cells() const noexcept {return this->cell_keys_.size();}
+
   private:
 
-    // calc cell index of the position
-    std::size_t calc_index(const coordinate_type& pos) const noexcept
+    // calc cell key of the position.
+    // A coordinate is clamped so that a particle that is extremely far away
+    // is put into the outermost cell. Clamping never separates adjacent cells,
+    // so it does not miss any pair.
+    cell_key_type calc_key(const coordinate_type& pos) const noexcept
+    {
+        return this->calc_key(this->calc_coord(math::X(pos)),
+                              this->calc_coord(math::Y(pos)),
+                              this->calc_coord(math::Z(pos)));
+    }
+    cell_key_type calc_coord(const real_type x) const noexcept
     {
-        constexpr std::int64_t d = dim();
-        const auto x = std::int64_t(std::floor(math::X(pos) * r_cell_size_)) % d;
-        const auto y = std::int64_t(std::floor(math::Y(pos) * r_cell_size_)) % d;
-        const auto z = std::int64_t(std::floor(math::Z(pos) * r_cell_size_)) % d;
-        return this->calc_index((x<0) ? x+d : x, (y<0) ? y+d : y, (z<0) ? z+d : z);
+        constexpr real_type lim = key_limit();
+        const real_type c = std::min(std::max(std::floor(x * r_cell_size_), -lim), lim);
+        return static_cast<cell_key_type>(static_cast<std::int64_t>(c) + key_limit() + 2);
+    }
+    cell_key_type calc_key(const cell_key_type x, const cell_key_type y,
+                           const cell_key_type z) const noexcept
+    {
+        return x | (y << key_bits()) | (z << (2 * key_bits()));
     }
 
-    std::size_t calc_index(const std::size_t x, const std::size_t y,
-                           const std::size_t z) const noexcept
+    // find the index of the cell that has the key. returns num_cells() if
+    // there is no such cell.
+    std::size_t find_cell(const cell_key_type key) const noexcept
     {
-        constexpr std::size_t ds = dim_size();
-        return x + ds * y + ds * ds * z;
+        const auto found = std::lower_bound(
+                this->cell_keys_.begin(), this->cell_keys_.end(), key);
+        if(found == this->cell_keys_.end() || *found != key)
+        {
+            return this->cell_keys_.size();
+        }
+        return std::distance(this->cell_keys_.begin(), found);
     }
 
+    // collect occupied cells from sorted index_by_cell_ and find adjacent cells
+    void construct_cells();
+
+    // construct neighbor list by traversing the half shell of each cell.
+    void make_half_shell(neighbor_list_type& neighbors, const system_type& sys,
+                         const potential_type& pot, const real_type r_c2);
+
     void set_cutoff(const real_type c) noexcept
     {
         this->cutoff_ = c;
@@ -133,12 +183,23 @@ class UnlimitedGridCellList final : public SpatialPartitionBase<traitsT, Potenti
     real_type cutoff_;
     real_type margin_;
     real_type current_margin_;
+    CellListStencil stencil_;
     real_type r_cell_size_;
 
-    cell_list_type            cell_list_;
-    cell_index_container_type index_by_cell_;
-    // index_by_cell_ has {particle idx, cell idx} and sorted by cell idx
-    // first term of cell list contains first and last idx of index_by_cell
+    cell_list_type             cell_list_;
+    std::vector<cell_key_type> cell_keys_;
+    cell_index_container_type  index_by_cell_;
+    // index_by_cell_ has {particle idx, cell key} and sorted by cell key.
+    // cell_keys_ has the keys of occupied cells in the ascending order.
+    // the last element of cell_list_ is an empty cell that represents all the
+    // unoccupied cells. first term of cell list contains first and last idx
+    // of index_by_cell.
+
+    // used in the half shell traversal. pairs_ has {particle idx, neighbor}.
+    std::vector<char>                   is_leading_;
+    std::vector<particle_neighbor_pair> pairs_;
+    std::vector<particle_neighbor_pair> pairs_buf_;
+    std::vector<std::size_t>            pair_offsets_;
 #ifdef MJOLNIR_WITH_OPENMP
     // OpenMP implementation uses its own specialization to run it in parallel.
     // So this implementation should not be instanciated with the OpenMP traits.
@@ -160,46 +221,59 @@ void UnlimitedGridCellList<traitsT, potentialT>::make(neighbor_list_type& neighb
     const auto& participants = pot.participants();
 
     neighbors.clear();
-    index_by_cell_.resize(participants.size());
 
-    for(std::size_t i=0; i<participants.size(); ++i)
+    // If the participants are the same as the last time, update the cell
+    // keys in the current (sorted) order. Usually only a few particles
+    // move to another cell between two updates, so we can skip sorting
+    // when none of them moves.
+    bool cell_changed = this->cell_list_.empty();
+    if(index_by_cell_.size() != participants.size())
     {
-        const auto idx = participants[i];
-        index_by_cell_[i] =
-            std::make_pair(idx, this->calc_index(sys.position(idx)));
+        index_by_cell_.resize(participants.size());
+        for(std::size_t i=0; i<participants.size(); ++i)
+        {
+            const auto idx = participants[i];
+            index_by_cell_[i] =
+                std::make_pair(idx, this->calc_key(sys.position(idx)));
+        }
+        cell_changed = true;
     }
-    std::sort(this->index_by_cell_.begin(), this->index_by_cell_.end(),
-        [](const particle_cell_idx_pair& lhs, const particle_cell_idx_pair& rhs)
-            noexcept -> bool {return lhs.second < rhs.second;});
-
-    { // assign first and last iterator for each cells
-        auto iter = index_by_cell_.cbegin();
-        for(std::size_t i=0; i<cell_list_.size(); ++i)
+    else
+    {
+        for(auto& item : index_by_cell_)
         {
-            if(iter == index_by_cell_.cend() || i != iter->second)
-            {
-                MJOLNIR_LOG_DEBUG("cell ", i, " does not have a particle inside");
-                cell_list_[i].first = make_range(iter, iter);
-                continue;
-            }
-            const auto first = iter;
-            while(iter != index_by_cell_.cend() && i == iter->second)
+            const auto key = this->calc_key(sys.position(item.first));
+            if(key != item.second)
             {
-                ++iter;
+                item.second  = key;
+                cell_changed = true;
             }
-            MJOLNIR_LOG_DEBUG("cell ", i, " has ", std::distance(first, iter),
-                              " particle inside");
-            cell_list_[i].first = make_range(first, iter);
         }
     }
-
-    MJOLNIR_LOG_DEBUG("cell list is updated");
+    if(cell_changed)
+    {
+        std::sort(this->index_by_cell_.begin(), this->index_by_cell_.end(),
+            [](const particle_cell_idx_pair& lhs,
+               const particle_cell_idx_pair& rhs) noexcept -> bool {
+                return (lhs.second == rhs.second) ? lhs.first < rhs.first :
+                                                    lhs.second < rhs.second;
+            });
+        this->construct_cells();
+    }
+    MJOLNIR_LOG_DEBUG("cell list is updated. number of cells = ", this->num_cells());
 
     const real_type r_c  = cutoff_ * (1 + margin_);
     const real_type r_c2 = r_c * r_c;
 
     const auto leading_participants = pot.leading_participants();
 
+    if(this->stencil_ == CellListStencil::Half)
+    {
+        this->make_half_shell(neighbors, sys, pot, r_c2);
+        this->current_margin_ = cutoff_ * margin_;
+        return;
+    }
+
     std::vector<neighbor_type> partner;
     for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
     {
@@ -207,10 +281,11 @@ void UnlimitedGridCellList<traitsT, potentialT>::make(neighbor_list_type& neighb
         const auto   i = leading_participants[idx];
         const auto& ri = sys.position(i);
 
-        const auto& cell = cell_list_[this->calc_index(ri)];
+        // leading participants are included in participants, so it must exist
+        const auto& cell = cell_list_[this->find_cell(this->calc_key(ri))];
 
         MJOLNIR_LOG_DEBUG("particle position ", sys.position(i));
-        MJOLNIR_LOG_DEBUG("cell index ",        calc_index(ri));
+        MJOLNIR_LOG_DEBUG("cell key ",          calc_key(ri));
         MJOLNIR_LOG_DEBUG("making verlet list for index ", i);
 
         for(std::size_t cidx : cell.second) // for all adjacent cells...
@@ -252,6 +327,107 @@ void UnlimitedGridCellList<traitsT, potentialT>::make(neighbor_list_type& neighb
     return ;
 }
 
+template<typename traitsT, typename potentialT>
+void UnlimitedGridCellList<traitsT, potentialT>::construct_cells()
+{
+    // collect keys of the occupied cells and the range of particles in them
+    this->cell_keys_.clear();
+    this->cell_list_.clear();
+    auto first = this->index_by_cell_.cbegin();
+    while(first != this->index_by_cell_.cend())
+    {
+        const auto key  = first->second;
+        const auto last = std::find_if(first, this->index_by_cell_.cend(),
+            [key](const particle_cell_idx_pair& item) noexcept -> bool {
+                return item.second != key;
+            });
+        this->cell_keys_.push_back(key);
+        this->cell_list_.emplace_back(make_range(first, last), adjacent_cell_idx{});
+        first = last;
+    }
+
+    // the last cell is an empty cell that represents all unoccupied cells
+    const std::size_t num_cells = this->cell_keys_.size();
+    this->cell_list_.emplace_back(make_range(this->index_by_cell_.cend(),
+        this->index_by_cell_.cend()), adjacent_cell_idx{});
+    this->cell_list_.back().second.fill(num_cells);
+
+    // The cells are sorted by key, and the keys of adjacent cells in the
+    // same row, {x-1, x, x+1}, are contiguous. Since the keys of the rows
+    // increase monotonically as the key of the center cell increases, adjacent
+    // cells can be found by moving one cursor per row.
+    constexpr cell_key_type dy = cell_key_type(1) << key_bits();
+    constexpr cell_key_type dz = cell_key_type(1) << (2 * key_bits());
+    const std::array<cell_key_type, 9> row_offsets{{
+        0-dy-dz, 0-dz, dy-dz, 0-dy, 0, dy, dz-dy, dz, dy+dz
+    }}; // unsigned wrap-around; the resulting keys never overflow.
+
+    std::array<std::size_t, 9> cursors;
+    cursors.fill(0);
+    for(std::size_t cell_idx=0; cell_idx<num_cells; ++cell_idx)
+    {
+        auto& adjacents = this->cell_list_[cell_idx].second;
+        for(std::size_t row=0; row<9; ++row)
+        {
+            const cell_key_type center = this->cell_keys_[cell_idx] + row_offsets[row];
+            auto& cursor = cursors[row];
+            while(cursor < num_cells && this->cell_keys_[cursor] < center - 1)
+            {
+                ++cursor;
+            }
+            std::size_t found = cursor;
+            for(std::size_t x=0; x<3; ++x)
+            {
+                const bool occupied = (found < num_cells) &&
+                    (this->cell_keys_[found] == center - 1 + x);
+                adjacents[row * 3 + x] = occupied ? found++ : num_cells;
+            }
+        }
+        assert(adjacents[half_shell_self_index()] == cell_idx);
+    }
+    return;
+}
+
+template<typename traitsT, typename potentialT>
+void UnlimitedGridCellList<traitsT, potentialT>::make_half_shell(
+        neighbor_list_type& neighbors, const system_type& sys,
+        const potential_type& pot, const real_type r_c2)
+{
+    const auto leading_participants = pot.leading_participants();
+
+    this->is_leading_.assign(sys.size(), 0);
+    for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+    {
+        this->is_leading_[leading_participants[idx]] = 1;
+    }
+
+    this->pairs_.clear();
+    find_half_shell_pairs(sys, pot, this->cell_list_, this->is_leading_,
+                          0, this->cell_keys_.size(), r_c2, this->pairs_);
+
+    // collect pairs by the leading participant
+    counting_sort(this->pairs_, this->pairs_buf_, this->pair_offsets_, sys.size(),
+        [](const particle_neighbor_pair& p) noexcept -> std::size_t {
+            return p.first;
+        });
+
+    std::vector<neighbor_type> partner;
+    for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+    {
+        const auto i = leading_participants[idx];
+
+        partner.clear();
+        for(std::size_t k=pair_offsets_[i]; k<pair_offsets_[i+1]; ++k)
+        {
+            partner.push_back(this->pairs_[k].second);
+        }
+        // make the result consistent with NaivePairCalculation...
+        std::sort(partner.begin(), partner.end());
+        neighbors.add_list_for(i, partner.begin(), partner.end());
+    }
+    return;
+}
+
 template<typename traitsT, typename potentialT>
 void UnlimitedGridCellList<traitsT, potentialT>::initialize(
         neighbor_list_type& neighbors,
@@ -260,58 +436,18 @@ void UnlimitedGridCellList<traitsT, potentialT>::initialize(
     MJOLNIR_GET_DEFAULT_LOGGER();
     MJOLNIR_LOG_FUNCTION();
 
-    constexpr std::int64_t d = dim();
-
     MJOLNIR_LOG_INFO(pot.name(), " cutoff = ", pot.max_cutoff_length());
-    MJOLNIR_LOG_INFO("dimension(independent from system size) = ", d, 'x', d, 'x', d);
     this->set_cutoff(pot.max_cutoff_length());
+    MJOLNIR_LOG_INFO("cell size = ", 1 / this->r_cell_size_,
+                     ", only the occupied cells are allocated");
 
-    // initialize cell list
-    for(int x = 0; x < d; ++x)
-    for(int y = 0; y < d; ++y)
-    for(int z = 0; z < d; ++z)
-    {
-        auto& cell = this->cell_list_[calc_index(x, y, z)];
-
-        const std::size_t x_prev = (x ==   0) ? d-1 : x-1;
-        const std::size_t x_next = (x == d-1) ?   0 : x+1;
-        const std::size_t y_prev = (y ==   0) ? d-1 : y-1;
-        const std::size_t y_next = (y == d-1) ?   0 : y+1;
-        const std::size_t z_prev = (z ==   0) ? d-1 : z-1;
-        const std::size_t z_next = (z == d-1) ?   0 : z+1;
-
-        cell.second[ 0] = calc_index(x_prev, y_prev, z_prev);
-        cell.second[ 1] = calc_index(x,      y_prev, z_prev);
-        cell.second[ 2] = calc_index(x_next, y_prev, z_prev);
-        cell.second[ 3] = calc_index(x_prev, y,      z_prev);
-        cell.second[ 4] = calc_index(x,      y,      z_prev);
-        cell.second[ 5] = calc_index(x_next, y,      z_prev);
-        cell.second[ 6] = calc_index(x_prev, y_next, z_prev);
-        cell.second[ 7] = calc_index(x,      y_next, z_prev);
-        cell.second[ 8] = calc_index(x_next, y_next, z_prev);
-
-        cell.second[ 9] = calc_index(x_prev, y_prev, z);
-        cell.second[10] = calc_index(x,      y_prev, z);
-        cell.second[11] = calc_index(x_next, y_prev, z);
-        cell.second[12] = calc_index(x_prev, y,      z);
-        cell.second[13] = calc_index(x,      y,      z);
-        cell.second[14] = calc_index(x_next, y,      z);
-        cell.second[15] = calc_index(x_prev, y_next, z);
-        cell.second[16] = calc_index(x,      y_next, z);
-        cell.second[17] = calc_index(x_next, y_next, z);
-
-        cell.second[18] = calc_index(x_prev, y_prev, z_next);
-        cell.second[19] = calc_index(x,      y_prev, z_next);
-        cell.second[20] = calc_index(x_next, y_prev, z_next);
-        cell.second[21] = calc_index(x_prev, y,      z_next);
-        cell.second[22] = calc_index(x,      y,      z_next);
-        cell.second[23] = calc_index(x_next, y,      z_next);
-        cell.second[24] = calc_index(x_prev, y_next, z_next);
-        cell.second[25] = calc_index(x,      y_next, z_next);
-        cell.second[26] = calc_index(x_next, y_next, z_next);
-    }
+    // participants might be changed. forget the last ordering.
+    this->index_by_cell_.clear();
+    this->cell_list_    .clear();
+    this->cell_keys_    .clear();
 
     this->make(neighbors, sys, pot);
+    MJOLNIR_LOG_INFO("number of occupied cells = ", this->num_cells());
     return;
 }
 } // mjolnir
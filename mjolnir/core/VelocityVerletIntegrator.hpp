@@ -5,10 +5,23 @@
 #include <mjolnir/core/RandomNumberGenerator.hpp>
 #include <mjolnir/core/SystemMotionRemover.hpp>
 #include <mjolnir/util/logger.hpp>
+#include <vector>
 
 namespace mjolnir
 {
 
+// Velocity Verlet integrator.
+//
+// If `global_interval` k is larger than 1, it runs as a multiple time step
+// integrator, r-RESPA (M. Tuckerman, B. J. Berne, and G. J. Martyna,
+// J. Chem. Phys. (1992)). The fast forces (local and external forcefields)
+// are integrated with dt and the slow forces (global forcefields) with k*dt,
+//   v += (k*dt/2) F_slow / m  ; at the beginning of a cycle
+//   k x [v += (dt/2) F_fast / m; x += dt v; v += (dt/2) F_fast / m]
+//   v += (k*dt/2) F_slow / m  ; at the end of a cycle, after updating F_slow
+// A call to `step` advances one inner step, so the number of steps and the
+// output interval in the input file are counted in dt as usual. `force(i)`
+// always contains the total force, F_fast(t) + F_slow at the last update.
 template<typename traitsT>
 class VelocityVerletIntegrator
 {
@@ -25,9 +38,11 @@ class VelocityVerletIntegrator
 
   public:
 
-    explicit VelocityVerletIntegrator(
-            const real_type dt, remover_type&& remover) noexcept
-        : dt_(dt), halfdt_(dt / 2), remover_(std::move(remover))
+    explicit VelocityVerletIntegrator(const real_type dt,
+            remover_type&& remover, const std::size_t global_interval = 1) noexcept
+        : dt_(dt), halfdt_(dt / 2), global_interval_(global_interval),
+          inner_step_(0), slow_virial_(0,0,0, 0,0,0, 0,0,0),
+          remover_(std::move(remover))
     {}
     ~VelocityVerletIntegrator() = default;
 
@@ -44,10 +59,26 @@ class VelocityVerletIntegrator
 
     void update(const system_type&) const noexcept {/* do nothing */}
 
+    std::size_t global_interval() const noexcept {return global_interval_;}
+
+  private:
+
+    real_type step_multiple_time_step(const real_type time, system_type& sys,
+                                      forcefield_type& ff);
+
+    // calculates the slow forces, stores them, and adds the fast forces.
+    // The forces and virial of the system should be zero before calling it.
+    void calc_split_force(system_type& sys, forcefield_type& ff);
+
   private:
     real_type dt_;      //!< dt
     real_type halfdt_;  //!< dt/2
 
+    std::size_t                  global_interval_; // k in r-RESPA
+    std::size_t                  inner_step_;      // [0, k)
+    std::vector<coordinate_type> slow_forces_;
+    matrix33_type                slow_virial_;
+
     remover_type remover_;
 };
 
@@ -67,6 +98,22 @@ void VelocityVerletIntegrator<traitsT>::initialize(
 
     this->update(system);
 
+    if(1 < this->global_interval_)
+    {
+        MJOLNIR_LOG_NOTICE("global forcefields are updated every ",
+                           this->global_interval_, " steps (r-RESPA)");
+
+        // the slow forces are not saved in MsgPack. re-calculate all.
+        for(std::size_t i=0; i<system.size(); ++i)
+        {
+            system.force(i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+        }
+        system.virial() = matrix33_type(0,0,0, 0,0,0, 0,0,0);
+        this->inner_step_ = 0;
+        this->calc_split_force(system, ff);
+        return;
+    }
+
     // if loaded from MsgPack, we can skip it.
     if( ! system.force_initialized())
     {
@@ -85,6 +132,11 @@ typename VelocityVerletIntegrator<traitsT>::real_type
 VelocityVerletIntegrator<traitsT>::step(
         const real_type time, system_type& sys, forcefield_type& ff, rng_type&)
 {
+    if(1 < this->global_interval_)
+    {
+        return this->step_multiple_time_step(time, sys, ff);
+    }
+
     real_type largest_disp2(0);
     for(std::size_t i=0; i<sys.size(); ++i)
     {
@@ -117,6 +169,83 @@ VelocityVerletIntegrator<traitsT>::step(
     return time + dt_;
 }
 
+template<typename traitsT>
+void VelocityVerletIntegrator<traitsT>::calc_split_force(
+        system_type& sys, forcefield_type& ff)
+{
+    ff->calc_slow_force(sys);
+
+    this->slow_forces_.resize(sys.size());
+    for(std::size_t i=0; i<sys.size(); ++i)
+    {
+        this->slow_forces_[i] = sys.force(i);
+    }
+    this->slow_virial_ = sys.virial();
+
+    ff->calc_fast_force(sys);
+    return;
+}
+
+template<typename traitsT>
+typename VelocityVerletIntegrator<traitsT>::real_type
+VelocityVerletIntegrator<traitsT>::step_multiple_time_step(
+        const real_type time, system_type& sys, forcefield_type& ff)
+{
+    const bool first = (this->inner_step_ == 0);
+    const bool last  = (this->inner_step_ + 1 == this->global_interval_);
+
+    // force(i) = F_fast + F_slow. To kick by (dt/2) F_fast + (k*dt/2) F_slow
+    // at the ends of a cycle and by (dt/2) F_fast otherwise, F_slow is added
+    // with the following coefficient.
+    const real_type slow_halfdt = halfdt_ * (global_interval_ - 1);
+    const real_type slow_coef1  = first ? slow_halfdt : -halfdt_;
+    const real_type slow_coef2  = last  ? slow_halfdt : -halfdt_;
+
+    real_type largest_disp2(0);
+    for(std::size_t i=0; i<sys.size(); ++i)
+    {
+        sys.velocity(i) += sys.rmass(i) *
+            (halfdt_ * sys.force(i) + slow_coef1 * slow_forces_[i]);
+
+        const auto disp = dt_ * sys.velocity(i);
+
+        sys.position(i) = sys.adjust_position(sys.position(i) + disp);
+        sys.force(i)    = math::make_coordinate<coordinate_type>(0, 0, 0);
+
+        largest_disp2 = std::max(largest_disp2, math::length_sq(disp));
+    }
+    sys.virial() = matrix33_type(0,0,0, 0,0,0, 0,0,0);
+
+    // the margin is reduced in every inner step even if global forcefields are
+    // not calculated, so the neighbor list is always valid when it is used.
+    ff->reduce_margin(2 * std::sqrt(largest_disp2), sys);
+
+    if(last)
+    {
+        this->calc_split_force(sys, ff);
+    }
+    else
+    {
+        ff->calc_fast_force(sys);
+        for(std::size_t i=0; i<sys.size(); ++i)
+        {
+            sys.force(i) += slow_forces_[i];
+        }
+        sys.virial() += slow_virial_;
+    }
+
+    for(std::size_t i=0; i<sys.size(); ++i)
+    {
+        sys.velocity(i) += sys.rmass(i) *
+            (halfdt_ * sys.force(i) + slow_coef2 * slow_forces_[i]);
+    }
+
+    remover_.remove(sys);
+
+    this->inner_step_ = last ? 0 : this->inner_step_ + 1;
+    return time + dt_;
+}
+
 #ifdef MJOLNIR_SEPARATE_BUILD
 extern template class VelocityVerletIntegrator<SimulatorTraits<double, UnlimitedBoundary>>;
 extern template class VelocityVerletIntegrator<SimulatorTraits<float,  UnlimitedBoundary>>;
@@ -1,8 +1,11 @@
 #ifndef MJOLNIR_CORE_XYZ_OBSERVER_HPP
 #define MJOLNIR_CORE_XYZ_OBSERVER_HPP
 #include <mjolnir/core/ObserverBase.hpp>
+#include <mjolnir/core/SnapshotBuffer.hpp>
+#include <mjolnir/util/buffered_file_writer.hpp>
+#include <mjolnir/util/background_worker.hpp>
 #include <iostream>
-#include <fstream>
+#include <sstream>
 #include <iomanip>
 
 namespace mjolnir
@@ -19,82 +22,139 @@ class XYZObserver final : public ObserverBase<traitsT>
     using system_type       = typename base_type::system_type;
     using forcefield_type   = typename base_type::forcefield_type;
 
+    using worker_type       = std::shared_ptr<BackgroundWorker>;
+    using names_type        = std::shared_ptr<const std::vector<std::string>>;
+    using snapshot_type     = typename SnapshotBuffer<traitsT>::snapshot_type;
+
   public:
 
-    explicit XYZObserver(const std::string& filename_prefix)
+    // files are kept open until the observer is destructed. `flush_interval`
+    // and `fsync_interval` are passed to BufferedFileWriter. If `worker` is
+    // given, frames are formatted and written in the background.
+    explicit XYZObserver(const std::string& filename_prefix,
+                         const std::size_t  flush_interval = 1,
+                         const std::size_t  fsync_interval = 0,
+                         worker_type        worker = nullptr)
       : base_type(), prefix_(filename_prefix),
         xyz_name_(filename_prefix + std::string("_position.xyz")),
-        vel_name_(filename_prefix + std::string("_velocity.xyz"))
+        vel_name_(filename_prefix + std::string("_velocity.xyz")),
+        // it throws an error if the files cannot be opened.
+        xyz_file_(xyz_name_, flush_interval, fsync_interval),
+        vel_file_(vel_name_, flush_interval, fsync_interval),
+        worker_(std::move(worker))
+    {}
+    ~XYZObserver() override
     {
-        // clear files and throw an error if the files cannot be opened.
-        this->clear_file(this->xyz_name_);
-        this->clear_file(this->vel_name_);
+        // tasks in the worker refer this.
+        if(this->worker_) {this->worker_->drain();}
     }
-    ~XYZObserver() override {}
 
     void initialize(const std::size_t,  const std::size_t, const real_type,
-                    const system_type&, const forcefield_type&) override
+                    const system_type& sys, const forcefield_type&) override
     {
-        // do nothing.
+        this->update_names(sys);
+        return;
     }
     void update(const std::size_t,  const real_type,
-                const system_type&, const forcefield_type&) override
+                const system_type& sys, const forcefield_type&) override
     {
-        // do nothing.
+        this->update_names(sys);
+        return;
     }
 
     void output(const std::size_t step, const real_type,
                 const system_type& sys, const forcefield_type&) override
     {
-        // -------------------------------------------------------------------
-        // output positions
+        if(!this->names_ || this->names_->size() != sys.size())
         {
-            std::ofstream ofs(xyz_name_, std::ios::app);
-            ofs << sys.size() << "\nstep = " << step << '\n';
-            for(std::size_t i=0; i<sys.size(); ++i)
-            {
-                const auto& p = sys.position(i);
-                ofs << sys.name(i) << ' ' << std::fixed << std::setprecision(8)
-                    << math::X(p)  << ' ' << math::Y(p) << ' ' << math::Z(p)
-                    << '\n';
-            }
-            ofs.close();
+            this->update_names(sys);
         }
 
-        // -------------------------------------------------------------------
-        // output velocities
+        if(!this->worker_)
         {
-            std::ofstream ofs(vel_name_, std::ios::app);
-            ofs << sys.size() << "\nstep = " << step << '\n';
-            for(std::size_t i=0; i<sys.size(); ++i)
-            {
-                const auto& v = sys.velocity(i);
-                ofs << sys.name(i) << ' ' << std::fixed << std::setprecision(8)
-                    << math::X(v)  << ' ' << math::Y(v) << ' ' << math::Z(v)
-                    << '\n';
-            }
-            ofs.close();
+            this->write_frame(sys, step, *this->names_);
+            return ;
         }
+
+        // take a snapshot. it is written in the background while the
+        // simulation continues.
+        auto& snapshot = this->snapshots_.acquire(*this->worker_);
+        snapshot.take(sys, /*forces = */ false);
+
+        const names_type names = this->names_;
+        this->worker_->push([this, &snapshot, step, names] {
+                this->write_frame(snapshot, step, *names);
+                snapshot.release();
+            });
         return ;
     }
 
     void finalize(const std::size_t, const real_type,
                   const system_type&, const forcefield_type&) override
     {
-        // do nothing.
+        run_in_background(this->worker_, [this] {
+                this->xyz_file_.flush();
+                this->vel_file_.flush();
+            });
+        if(this->worker_) {this->worker_->wait();}
+        return;
     }
 
     std::string const& prefix() const noexcept override {return prefix_;}
+    std::string        name()   const          override {return "xyz";}
 
   private:
 
-    void clear_file(const std::string& fname) const
+    // names are shared by the snapshots because they rarely change.
+    void update_names(const system_type& sys)
     {
-        std::ofstream ofs(fname);
-        if(not ofs.good())
+        auto names = std::make_shared<std::vector<std::string>>(sys.size());
+        for(std::size_t i=0; i<sys.size(); ++i)
         {
-            throw_exception<std::runtime_error>("[error] mjolnir::XYZObserver: "
-                    "file open error: ", fname);
+            (*names)[i] = sys.name(i);
+        }
+        this->names_ = std::move(names);
+        return;
+    }
+
+    // `frameT` is either system_type or snapshot_type.
+    template<typename frameT>
+    void write_frame(const frameT& frame, const std::size_t step,
+                     const std::vector<std::string>& names)
+    {
+        // a frame is formatted in a buffer, then written at once.
+        std::ostringstream& oss = this->format_buffer_;
+        oss.str("");
+
+        // -------------------------------------------------------------------
+        // output positions
+        {
+            oss << frame.size() << "\nstep = " << step << '\n';
+            for(std::size_t i=0; i<frame.size(); ++i)
+            {
+                const auto& p = frame.position(i);
+                oss << names[i]   << ' ' << std::fixed << std::setprecision(8)
+                    << math::X(p) << ' ' << math::Y(p) << ' ' << math::Z(p)
+                    << '\n';
+            }
+            this->xyz_file_.write(oss.str());
+            this->xyz_file_.end_frame();
+        }
+
+        // -------------------------------------------------------------------
+        // output velocities
+        {
+            oss.str("");
+            oss << frame.size() << "\nstep = " << step << '\n';
+            for(std::size_t i=0; i<frame.size(); ++i)
+            {
+                const auto& v = frame.velocity(i);
+                oss << names[i]   << ' ' << std::fixed << std::setprecision(8)
+                    << math::X(v) << ' ' << math::Y(v) << ' ' << math::Z(v)
+                    << '\n';
+            }
+            this->vel_file_.write(oss.str());
+            this->vel_file_.end_frame();
         }
         return;
     }
@@ -104,6 +164,12 @@ class XYZObserver final : public ObserverBase<traitsT>
     std::string prefix_;
     std::string xyz_name_;
     std::string vel_name_;
+    BufferedFileWriter xyz_file_;
+    BufferedFileWriter vel_file_;
+    worker_type        worker_;
+    names_type         names_;
+    SnapshotBuffer<traitsT> snapshots_;
+    std::ostringstream format_buffer_; // used only in write_frame
 };
 
 #ifdef MJOLNIR_SEPARATE_BUILD
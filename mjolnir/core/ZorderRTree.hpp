@@ -5,6 +5,7 @@
 #include <mjolnir/util/range.hpp>
 #include <mjolnir/util/logger.hpp>
 #include <mjolnir/util/fixed_vector.hpp>
+#include <mjolnir/util/zorder.hpp>
 #include <iostream>
 #include <vector>
 #include <cmath>
@@ -13,6 +14,63 @@
 namespace mjolnir
 {
 
+namespace detail
+{
+// helper functions shared by the default and the OpenMP implementations.
+
+template<typename aabbT, typename coordT>
+aabbT merge_aabb(const aabbT& box, const coordT& p) noexcept
+{
+    aabbT merged(box);
+    math::X(merged.lower) = std::min(math::X(merged.lower), math::X(p));
+    math::Y(merged.lower) = std::min(math::Y(merged.lower), math::Y(p));
+    math::Z(merged.lower) = std::min(math::Z(merged.lower), math::Z(p));
+
+    math::X(merged.upper) = std::max(math::X(merged.upper), math::X(p));
+    math::Y(merged.upper) = std::max(math::Y(merged.upper), math::Y(p));
+    math::Z(merged.upper) = std::max(math::Z(merged.upper), math::Z(p));
+    return merged;
+}
+template<typename aabbT>
+aabbT merge_aabb(const aabbT& lhs, const aabbT& rhs) noexcept
+{
+    aabbT merged;
+    math::X(merged.lower) = std::min(math::X(lhs.lower), math::X(rhs.lower));
+    math::Y(merged.lower) = std::min(math::Y(lhs.lower), math::Y(rhs.lower));
+    math::Z(merged.lower) = std::min(math::Z(lhs.lower), math::Z(rhs.lower));
+
+    math::X(merged.upper) = std::max(math::X(lhs.upper), math::X(rhs.upper));
+    math::Y(merged.upper) = std::max(math::Y(lhs.upper), math::Y(rhs.upper));
+    math::Z(merged.upper) = std::max(math::Z(lhs.upper), math::Z(rhs.upper));
+    return merged;
+}
+
+template<typename realT, typename coordT, typename aabbT>
+bool overlaps(const coordT& p, const realT r, const aabbT& box,
+              const UnlimitedBoundary<realT, coordT>&) noexcept
+{
+    const auto& l = box.lower;
+    const auto& u = box.upper;
+    if(math::X(p) + r < math::X(l) || math::X(u) < math::X(p) - r){return false;}
+    if(math::Y(p) + r < math::Y(l) || math::Y(u) < math::Y(p) - r){return false;}
+    if(math::Z(p) + r < math::Z(l) || math::Z(u) < math::Z(p) - r){return false;}
+    return true;
+}
+template<typename realT, typename coordT, typename aabbT>
+bool overlaps(const coordT& p, const realT r, const aabbT& box,
+              const CuboidalPeriodicBoundary<realT, coordT>& boundary) noexcept
+{
+    const auto center = (box.upper + box.lower) * 0.5;
+    const auto width  = (box.upper - box.lower) * 0.5;
+    const auto dist = boundary.adjust_direction(center, p);
+
+    if(math::X(width) + r < std::abs(math::X(dist))) {return false;}
+    if(math::Y(width) + r < std::abs(math::Y(dist))) {return false;}
+    if(math::Z(width) + r < std::abs(math::Z(dist))) {return false;}
+    return true;
+}
+} // detail
+
 template<typename traitsT, typename PotentialT, std::size_t MaxElem = 8>
 class ZorderRTree final : public SpatialPartitionBase<traitsT, PotentialT>
 {
@@ -68,13 +126,6 @@ class ZorderRTree final : public SpatialPartitionBase<traitsT, PotentialT>
         MJOLNIR_GET_DEFAULT_LOGGER();
         MJOLNIR_LOG_FUNCTION();
 
-        if( ! is_simulator_traits<traits_type>::value)
-        {
-            MJOLNIR_LOG_WARN("spatial_partition.RTree is implemented for single"
-                             " core simulation. Consider using CellList for"
-                             " parallel simulation.");
-        }
-
         const real_type max_cutoff = pot.max_cutoff_length();
         this->set_cutoff(max_cutoff);
 
@@ -120,51 +171,6 @@ class ZorderRTree final : public SpatialPartitionBase<traitsT, PotentialT>
 
   private:
 
-    static std::uint32_t expand_bits(std::uint32_t v) noexcept
-    {
-        v = (v * 0x00010001u) & 0xFF0000FFu;
-        v = (v * 0x00000101u) & 0x0F00F00Fu;
-        v = (v * 0x00000011u) & 0xC30C30C3u;
-        v = (v * 0x00000005u) & 0x49249249u;
-        return v;
-    }
-
-    static std::uint32_t zindex(coordinate_type r) noexcept
-    {
-        math::X(r) = math::clamp<real_type>(math::X(r) * 1024, 0, 1023);
-        math::Y(r) = math::clamp<real_type>(math::Y(r) * 1024, 0, 1023);
-        math::Z(r) = math::clamp<real_type>(math::Z(r) * 1024, 0, 1023);
-        const auto xx = expand_bits(static_cast<std::uint32_t>(math::X(r)));
-        const auto yy = expand_bits(static_cast<std::uint32_t>(math::Y(r)));
-        const auto zz = expand_bits(static_cast<std::uint32_t>(math::Z(r)));
-        return xx * 4 + yy * 2 + zz;
-    }
-
-    static AABB merge_aabb(const AABB& box, const coordinate_type& p) noexcept
-    {
-        AABB merged(box);
-        math::X(merged.lower) = std::min(math::X(merged.lower), math::X(p));
-        math::Y(merged.lower) = std::min(math::Y(merged.lower), math::Y(p));
-        math::Z(merged.lower) = std::min(math::Z(merged.lower), math::Z(p));
-
-        math::X(merged.upper) = std::max(math::X(merged.upper), math::X(p));
-        math::Y(merged.upper) = std::max(math::Y(merged.upper), math::Y(p));
-        math::Z(merged.upper) = std::max(math::Z(merged.upper), math::Z(p));
-        return merged;
-    }
-    static AABB merge_aabb(const AABB& lhs, const AABB& rhs) noexcept
-    {
-        AABB merged;
-        math::X(merged.lower) = std::min(math::X(lhs.lower), math::X(rhs.lower));
-        math::Y(merged.lower) = std::min(math::Y(lhs.lower), math::Y(rhs.lower));
-        math::Z(merged.lower) = std::min(math::Z(lhs.lower), math::Z(rhs.lower));
-
-        math::X(merged.upper) = std::max(math::X(lhs.upper), math::X(rhs.upper));
-        math::Y(merged.upper) = std::max(math::Y(lhs.upper), math::Y(rhs.upper));
-        math::Z(merged.upper) = std::max(math::Z(lhs.upper), math::Z(rhs.upper));
-        return merged;
-    }
-
     static std::pair<coordinate_type, coordinate_type> scaling(
         const system_type& sys, const std::vector<std::size_t>& participants,
         const UnlimitedBoundary<real_type, coordinate_type>&) noexcept
@@ -176,7 +182,7 @@ class ZorderRTree final : public SpatialPartitionBase<traitsT, PotentialT>
 
         for(const auto& i : participants)
         {
-            whole = merge_aabb(whole, sys.position(i));
+            whole = detail::merge_aabb(whole, sys.position(i));
         }
         const auto width = whole.upper - whole.lower;
 
@@ -197,31 +203,6 @@ class ZorderRTree final : public SpatialPartitionBase<traitsT, PotentialT>
         return std::make_pair(boundary.lower_bound(), scale);
     }
 
-    static bool overlaps(
-        const coordinate_type& p, const real_type r, const AABB& box,
-        const UnlimitedBoundary<real_type, coordinate_type>&) noexcept
-    {
-        const auto& l = box.lower;
-        const auto& u = box.upper;
-        if(math::X(p) + r < math::X(l) || math::X(u) < math::X(p) - r){return false;}
-        if(math::Y(p) + r < math::Y(l) || math::Y(u) < math::Y(p) - r){return false;}
-        if(math::Z(p) + r < math::Z(l) || math::Z(u) < math::Z(p) - r){return false;}
-        return true;
-    }
-    static bool overlaps(
-        const coordinate_type& p, const real_type r, const AABB& box,
-        const CuboidalPeriodicBoundary<real_type, coordinate_type>& boundary) noexcept
-    {
-        const auto center = (box.upper + box.lower) * 0.5;
-        const auto width  = (box.upper - box.lower) * 0.5;
-        const auto dist = boundary.adjust_direction(center, p);
-
-        if(math::X(width) + r < std::abs(math::X(dist))) {return false;}
-        if(math::Y(width) + r < std::abs(math::Y(dist))) {return false;}
-        if(math::Z(width) + r < std::abs(math::Z(dist))) {return false;}
-        return true;
-    }
-
     void set_cutoff(const real_type c) noexcept
     {
         this->cutoff_ = c;
@@ -241,6 +222,13 @@ class ZorderRTree final : public SpatialPartitionBase<traitsT, PotentialT>
     real_type margin_;
     real_type current_margin_;
     std::vector<Node> tree_;
+
+#ifdef MJOLNIR_WITH_OPENMP
+    // OpenMP implementation uses its own specialization to run it in parallel.
+    // So this implementation should not be instanciated with the OpenMP traits.
+    static_assert(!is_openmp_simulator_traits<traits_type>::value,
+                  "this is the default implementation, not for OpenMP");
+#endif
 };
 
 template<typename traitsT, typename PotentialT, std::size_t MaxElem>
@@ -277,7 +265,7 @@ void ZorderRTree<traitsT, PotentialT, MaxElem>::make(neighbor_list_type& neighbo
         math::X(pos) *= math::X(rwidth);
         math::Y(pos) *= math::Y(rwidth);
         math::Z(pos) *= math::Z(rwidth);
-        zindices[i] = std::make_pair(zindex(pos), static_cast<std::uint32_t>(idx));
+        zindices[i] = std::make_pair(detail::zorder_index<real_type>(pos), static_cast<std::uint32_t>(idx));
     }
     // zindices contains {zindex, particle idx}
 
@@ -300,7 +288,7 @@ void ZorderRTree<traitsT, PotentialT, MaxElem>::make(neighbor_list_type& neighbo
         for(std::size_t j=i+1; j<std::min(i + MaxElem, zindices.size()); ++j)
         {
             const auto jdx = zindices[j].second;
-            node.box = merge_aabb(node.box, sys.position(jdx));
+            node.box = detail::merge_aabb(node.box, sys.position(jdx));
             node.children.push_back(jdx);
         }
         tree_.push_back(std::move(node));
@@ -318,7 +306,7 @@ void ZorderRTree<traitsT, PotentialT, MaxElem>::make(neighbor_list_type& neighbo
             math::X(pos) *= math::X(rwidth);
             math::Y(pos) *= math::Y(rwidth);
             math::Z(pos) *= math::Z(rwidth);
-            zindices[i - node_front] = std::make_pair(zindex(pos), i);
+            zindices[i - node_front] = std::make_pair(detail::zorder_index<real_type>(pos), i);
         }
         // zindices contains {zindex, node idx}
         std::sort(zindices.begin(), zindices.end());
@@ -344,7 +332,7 @@ void ZorderRTree<traitsT, PotentialT, MaxElem>::make(neighbor_list_type& neighbo
             for(std::size_t j=i+1; j<std::min(i + MaxElem, N); ++j)
             {
                 const auto child_node_idx = zindices[j].second;
-                node.box = merge_aabb(node.box, tree_[child_node_idx].box);
+                node.box = detail::merge_aabb(node.box, tree_[child_node_idx].box);
                 node.children.push_back(child_node_idx);
                 tree_[child_node_idx].parent = parent_idx;
             }
@@ -360,7 +348,7 @@ void ZorderRTree<traitsT, PotentialT, MaxElem>::make(neighbor_list_type& neighbo
         node.children.push_back(node_front);
         for(std::size_t i=node_front+1; i < tree_.size(); ++i)
         {
-            node.box = merge_aabb(node.box, tree_[i].box);
+            node.box = detail::merge_aabb(node.box, tree_[i].box);
             node.children.push_back(i);
             tree_[i].parent = root;
         }
@@ -419,7 +407,7 @@ void ZorderRTree<traitsT, PotentialT, MaxElem>::make(neighbor_list_type& neighbo
             {
                 for(const auto& child : node.children)
                 {
-                    if(overlaps(ri, r_c, tree_[child].box, sys.boundary()))
+                    if(detail::overlaps(ri, r_c, tree_[child].box, sys.boundary()))
                     {
                         next_node.push_back(child);
                     }
@@ -108,6 +108,7 @@ template<typename traitsT>
 void ThreeSPN2BaseBaseInteraction<traitsT>::calc_force(
         system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     constexpr auto pi        = math::constants<real_type>::pi();
     constexpr auto two_pi    = math::constants<real_type>::two_pi();
     constexpr auto tolerance = math::abs_tolerance<real_type>();
@@ -580,6 +581,7 @@ typename ThreeSPN2BaseBaseInteraction<traitsT>::real_type
 ThreeSPN2BaseBaseInteraction<traitsT>::calc_energy(
         const system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     constexpr auto pi        = math::constants<real_type>::pi();
     constexpr auto two_pi    = math::constants<real_type>::two_pi();
 
@@ -836,6 +838,7 @@ typename ThreeSPN2BaseBaseInteraction<traitsT>::real_type
 ThreeSPN2BaseBaseInteraction<traitsT>::calc_force_and_energy(
         system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     constexpr auto pi        = math::constants<real_type>::pi();
     constexpr auto two_pi    = math::constants<real_type>::two_pi();
     constexpr auto tolerance = math::abs_tolerance<real_type>();
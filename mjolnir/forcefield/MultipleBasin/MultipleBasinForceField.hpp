@@ -139,6 +139,10 @@ class MultipleBasinForceField : public ForceFieldBase<traitsT>
         return E;
     }
 
+    // units calculate forces from energies of the basins, so energies of the
+    // terms are not kept. `format_energy` always calculates them.
+    void enable_energy_cache(const bool) noexcept override {return;}
+
     void update(const system_type& sys) override
     {
         // update parameters (e.g. temperature). TODO: topologies?
@@ -104,6 +104,7 @@ template<typename traitsT>
 void ProteinDNANonSpecificInteraction<traitsT>::calc_force(
         system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
     MJOLNIR_LOG_FUNCTION_DEBUG();
 
@@ -274,6 +275,7 @@ typename ProteinDNANonSpecificInteraction<traitsT>::real_type
 ProteinDNANonSpecificInteraction<traitsT>::calc_energy(
         const system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
     MJOLNIR_LOG_FUNCTION_DEBUG();
     // XXX Note: P is ambiguous because both Protein and Phosphate has `P`.
@@ -359,6 +361,7 @@ typename ProteinDNANonSpecificInteraction<traitsT>::real_type
 ProteinDNANonSpecificInteraction<traitsT>::calc_force_and_energy(
         system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
     MJOLNIR_LOG_FUNCTION_DEBUG();
 
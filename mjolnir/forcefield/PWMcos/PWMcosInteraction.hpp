@@ -101,6 +101,7 @@ class PWMcosInteraction final : public GlobalInteractionBase<traitsT>
 template<typename traitsT>
 void PWMcosInteraction<traitsT>::calc_force(system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
     MJOLNIR_LOG_FUNCTION_DEBUG();
     //   DNA        protein    |
@@ -341,6 +342,7 @@ template<typename traitsT>
 typename PWMcosInteraction<traitsT>::real_type
 PWMcosInteraction<traitsT>::calc_energy(const system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     const auto energy_unit  = potential_.energy_unit();  // overall coefficient
     const auto energy_shift = potential_.energy_shift(); // overall energy shift
 
@@ -436,6 +438,7 @@ template<typename traitsT>
 typename PWMcosInteraction<traitsT>::real_type
 PWMcosInteraction<traitsT>::calc_force_and_energy(system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
     MJOLNIR_LOG_FUNCTION_DEBUG();
     //   DNA        protein    |
@@ -0,0 +1,571 @@
+#ifndef MJOLNIR_FORCEFIELD_GLOBAL_BATCHED_PAIR_KERNEL_HPP
+#define MJOLNIR_FORCEFIELD_GLOBAL_BATCHED_PAIR_KERNEL_HPP
+#include <mjolnir/forcefield/global/ExcludedVolumePotential.hpp>
+#include <mjolnir/forcefield/global/LennardJonesPotential.hpp>
+#include <mjolnir/forcefield/global/DebyeHuckelPotential.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/math/compiletime.hpp>
+#include <mjolnir/math/Vector.hpp>
+#include <mjolnir/math/Matrix.hpp>
+#include <mjolnir/util/macro.hpp>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+
+namespace mjolnir
+{
+
+// Batched pair kernels.
+//
+// The normal pair interaction calculates one pair at a time through
+// `potential.derivative(r, param)`. It branches on the cutoff length and the
+// compiler cannot vectorize the loop because of the scattered force update.
+//
+// Here, the partners of a particle are processed in batches. First, the
+// displacement vectors and the parameters of `pair_batch_size` partners are
+// gathered into small contiguous arrays. Then the force coefficients of all
+// the lanes are calculated in a branch-free loop with masked cutoff. This loop
+// is vectorized by the compiler (with `std::exp` and `std::sqrt` mapped to
+// their vector versions). Finally, the forces are scattered to the partners.
+//
+// The batch size is determined from the instruction set that the compiler
+// targets (Mjolnir is built with `-march=native` by default), in the same way
+// as the approximate `rsqrt` in math/functions.hpp. The potentials' own
+// `potential(r, param)` and `derivative(r, param)` remain the reference.
+//
+// A kernel can be evaluated in a precision lower than that of the system
+// (`precision = "mixed"`). In that case, the displacement vectors are still
+// calculated from the positions in the system precision, so that the absolute
+// coordinates do not lose their digits, and are rounded after that. The forces,
+// virial, and energy are accumulated in the system precision. Since the lanes
+// are twice as many as double, the kernel runs nearly at the speed of float.
+
+namespace detail
+{
+constexpr std::size_t simd_register_bytes() noexcept
+{
+#if defined(__AVX512F__)
+    return 64;
+#elif defined(__AVX__)
+    return 32;
+#else
+    return 16;
+#endif
+}
+} // detail
+
+// number of pairs in a batch. 4/8/16 lanes for float, 4/4/8 for double.
+template<typename realT>
+struct pair_batch_size : std::integral_constant<std::size_t,
+    compiletime::max(std::size_t(4), detail::simd_register_bytes() / sizeof(realT))>
+{};
+
+// A kernel takes a squared distance and a pair parameter and returns
+//   - force(l2, p)  : (dU/dr) / r. The force on i is `force(l2, p) * rij`.
+//   - energy(l2, p) : U(r).
+// Both of them should return 0 if the distance is beyond the cutoff.
+// `parameter(p)` converts a pair parameter of the potential into `realT`.
+template<typename potentialT,
+         typename realT = typename potentialT::real_type>
+struct BatchedPairKernel; // not defined for general potentials
+
+template<typename potentialT>
+struct has_batched_pair_kernel : std::false_type {};
+
+// ---------------------------------------------------------------------------
+// ExcludedVolume
+
+template<typename traitsT, typename realT>
+struct BatchedPairKernel<ExcludedVolumePotential<traitsT>, realT>
+{
+    using potential_type      = ExcludedVolumePotential<traitsT>;
+    using real_type           = realT;
+
+    using pair_parameter_type = real_type; // ri + rj
+
+    explicit BatchedPairKernel(const potential_type& pot) noexcept
+        : epsilon_(pot.epsilon()),
+          cutoff_ratio_sq_(pot.cutoff_ratio() * pot.cutoff_ratio()),
+          coef_at_cutoff_(pot.coef_at_cutoff())
+    {}
+
+    static pair_parameter_type
+    parameter(const typename potential_type::pair_parameter_type& d) noexcept
+    {
+        return static_cast<real_type>(d);
+    }
+
+    real_type force(const real_type l2, const pair_parameter_type& d) const noexcept
+    {
+        const real_type d2       = d * d;
+        const real_type rcp_l2   = real_type(1) / l2;
+        const real_type d2l2     = d2 * rcp_l2;
+        const real_type d6l6     = d2l2 * d2l2 * d2l2;
+        const real_type f        = -12 * epsilon_ * d6l6 * d6l6 * rcp_l2;
+        return f * static_cast<real_type>(l2 <= d2 * cutoff_ratio_sq_);
+    }
+    real_type energy(const real_type l2, const pair_parameter_type& d) const noexcept
+    {
+        const real_type d2   = d * d;
+        const real_type d2l2 = d2 / l2;
+        const real_type d6l6 = d2l2 * d2l2 * d2l2;
+        const real_type e    = epsilon_ * (d6l6 * d6l6 - coef_at_cutoff_);
+        return e * static_cast<real_type>(l2 <= d2 * cutoff_ratio_sq_);
+    }
+
+    real_type epsilon_;
+    real_type cutoff_ratio_sq_;
+    real_type coef_at_cutoff_;
+};
+template<typename traitsT>
+struct has_batched_pair_kernel<ExcludedVolumePotential<traitsT>>: std::true_type{};
+
+// ---------------------------------------------------------------------------
+// LennardJones
+
+template<typename traitsT, typename realT>
+struct BatchedPairKernel<LennardJonesPotential<traitsT>, realT>
+{
+    using potential_type      = LennardJonesPotential<traitsT>;
+    using real_type           = realT;
+
+    using pair_parameter_type = std::pair<real_type, real_type>; // {sigma, epsilon}
+
+    explicit BatchedPairKernel(const potential_type& pot) noexcept
+        : cutoff_ratio_sq_(pot.cutoff_ratio() * pot.cutoff_ratio()),
+          coef_at_cutoff_(pot.coef_at_cutoff())
+    {}
+
+    static pair_parameter_type
+    parameter(const typename potential_type::pair_parameter_type& p) noexcept
+    {
+        return pair_parameter_type(static_cast<real_type>(p.first),
+                                   static_cast<real_type>(p.second));
+    }
+
+    real_type force(const real_type l2, const pair_parameter_type& p) const noexcept
+    {
+        const real_type s2     = p.first * p.first;
+        const real_type rcp_l2 = real_type(1) / l2;
+        const real_type s2l2   = s2 * rcp_l2;
+        const real_type s6l6   = s2l2 * s2l2 * s2l2;
+        const real_type f = 24 * p.second * (s6l6 - 2 * s6l6 * s6l6) * rcp_l2;
+        return f * static_cast<real_type>(l2 <= s2 * cutoff_ratio_sq_);
+    }
+    real_type energy(const real_type l2, const pair_parameter_type& p) const noexcept
+    {
+        const real_type s2   = p.first * p.first;
+        const real_type s2l2 = s2 / l2;
+        const real_type s6l6 = s2l2 * s2l2 * s2l2;
+        const real_type e = 4 * p.second * (s6l6 * s6l6 - s6l6 - coef_at_cutoff_);
+        return e * static_cast<real_type>(l2 <= s2 * cutoff_ratio_sq_);
+    }
+
+    real_type cutoff_ratio_sq_;
+    real_type coef_at_cutoff_;
+};
+template<typename traitsT>
+struct has_batched_pair_kernel<LennardJonesPotential<traitsT>>: std::true_type{};
+
+// ---------------------------------------------------------------------------
+// DebyeHuckel
+
+template<typename traitsT, typename realT>
+struct BatchedPairKernel<DebyeHuckelPotential<traitsT>, realT>
+{
+    using potential_type      = DebyeHuckelPotential<traitsT>;
+    using real_type           = realT;
+
+    using pair_parameter_type = real_type; // qi * qj / (4 pi eps0 epsk)
+
+    explicit BatchedPairKernel(const potential_type& pot) noexcept
+        : debye_length_(pot.debye_length()),
+          inv_debye_length_(1 / pot.debye_length()),
+          cutoff_sq_(pot.max_cutoff_length() * pot.max_cutoff_length()),
+          coef_at_cutoff_(pot.coef_at_cutoff())
+    {}
+
+    static pair_parameter_type
+    parameter(const typename potential_type::pair_parameter_type& p) noexcept
+    {
+        return static_cast<real_type>(p);
+    }
+
+    real_type force(const real_type l2, const pair_parameter_type& p) const noexcept
+    {
+        const real_type rl = real_type(1) / std::sqrt(l2);
+        const real_type l  = l2 * rl;
+        const real_type f  = -p * (debye_length_ + l) * inv_debye_length_ *
+                             rl * rl * rl * std::exp(-l * inv_debye_length_);
+        return f * static_cast<real_type>(l2 < cutoff_sq_);
+    }
+    real_type energy(const real_type l2, const pair_parameter_type& p) const noexcept
+    {
+        const real_type rl = real_type(1) / std::sqrt(l2);
+        const real_type l  = l2 * rl;
+        const real_type e  = p * (std::exp(-l * inv_debye_length_) * rl -
+                                  coef_at_cutoff_);
+        return e * static_cast<real_type>(l2 < cutoff_sq_);
+    }
+
+    real_type debye_length_;
+    real_type inv_debye_length_;
+    real_type cutoff_sq_;
+    real_type coef_at_cutoff_;
+};
+template<typename traitsT>
+struct has_batched_pair_kernel<DebyeHuckelPotential<traitsT>>: std::true_type{};
+
+// ---------------------------------------------------------------------------
+// helpers of the loops
+
+namespace detail
+{
+// reads positions from the structure-of-arrays copy in the system if it is
+// enabled (see util/packed_coordinates.hpp), otherwise from `position(i)`.
+template<typename systemT, bool Packed = systemT::packed_coordinates_enabled>
+struct position_reader
+{
+    using real_type = typename systemT::real_type;
+
+    explicit position_reader(const systemT& sys) noexcept: sys_(sys) {}
+
+    real_type x(const std::size_t i) const noexcept {return math::X(sys_.position(i));}
+    real_type y(const std::size_t i) const noexcept {return math::Y(sys_.position(i));}
+    real_type z(const std::size_t i) const noexcept {return math::Z(sys_.position(i));}
+
+    const systemT& sys_;
+};
+template<typename systemT>
+struct position_reader<systemT, true>
+{
+    using real_type = typename systemT::real_type;
+
+    explicit position_reader(const systemT& sys) noexcept
+        : xs_(sys.packed_positions().x()), ys_(sys.packed_positions().y()),
+          zs_(sys.packed_positions().z())
+    {}
+
+    real_type x(const std::size_t i) const noexcept {return xs_[i];}
+    real_type y(const std::size_t i) const noexcept {return ys_[i];}
+    real_type z(const std::size_t i) const noexcept {return zs_[i];}
+
+    real_type const* xs_;
+    real_type const* ys_;
+    real_type const* zs_;
+};
+
+// minimum image convention on lanes. The same as `adjust_direction`.
+template<typename realT, typename coordT>
+void adjust_direction_lanes(const UnlimitedBoundary<realT, coordT>&,
+        realT*, realT*, realT*, const std::size_t) noexcept
+{
+    return;
+}
+template<typename realT, typename coordT>
+void adjust_direction_lanes(const CuboidalPeriodicBoundary<realT, coordT>& b,
+        realT* dx, realT* dy, realT* dz, const std::size_t n) noexcept
+{
+    const realT wx = math::X(b.width()), hx = wx / 2;
+    const realT wy = math::Y(b.width()), hy = wy / 2;
+    const realT wz = math::Z(b.width()), hz = wz / 2;
+    MJOLNIR_SIMD_LOOP
+    for(std::size_t k=0; k<n; ++k)
+    {
+        dx[k] += wx * (realT(dx[k] < -hx) - realT(hx <= dx[k]));
+        dy[k] += wy * (realT(dy[k] < -hy) - realT(hy <= dy[k]));
+        dz[k] += wz * (realT(dz[k] < -hz) - realT(hz <= dz[k]));
+    }
+    return;
+}
+} // detail
+
+// ---------------------------------------------------------------------------
+// batched loop
+//
+// calculates forces between particle `i` and its `partners` in batches.
+// `force_of(j)` should return a reference to the force buffer of particle j.
+// The force on `i` and the virial are added to `force_i` and `virial`.
+// It returns the sum of energies if `WithEnergy` is true, otherwise 0.
+// The lanes are in the precision of the kernel, and the sums are in the
+// precision of the system. The gather only loads the coordinates of the
+// partners (from the packed arrays if they are enabled) and the minimum image
+// convention is applied to the whole batch at once.
+template<bool WithEnergy, typename kernelT, typename systemT,
+         typename partnersT, typename forceAccessorT>
+typename systemT::real_type
+calc_batched_pair_force(const kernelT& kernel, const systemT& sys,
+        const std::size_t i, const partnersT& partners,
+        forceAccessorT&& force_of,
+        typename systemT::coordinate_type& force_i,
+        typename systemT::matrix33_type&   virial) noexcept
+{
+    using real_type           = typename systemT::real_type;
+    using coordinate_type     = typename systemT::coordinate_type;
+    using lane_type           = typename kernelT::real_type;
+    using pair_parameter_type = typename kernelT::pair_parameter_type;
+    constexpr std::size_t W   = pair_batch_size<lane_type>::value;
+
+    alignas(64) real_type rx  [W];
+    alignas(64) real_type ry  [W];
+    alignas(64) real_type rz  [W];
+    alignas(64) lane_type dx  [W];
+    alignas(64) lane_type dy  [W];
+    alignas(64) lane_type dz  [W];
+    alignas(64) lane_type coef[W];
+    alignas(64) lane_type mask[W];
+    alignas(64) lane_type ene [W];
+    pair_parameter_type   params[W];
+    std::size_t           js[W];
+
+    real_type fx(0), fy(0), fz(0);
+    real_type vxx(0), vxy(0), vxz(0), vyy(0), vyz(0), vzz(0);
+    real_type energy(0);
+
+    const detail::position_reader<systemT> pos(sys);
+    const real_type xi = pos.x(i);
+    const real_type yi = pos.y(i);
+    const real_type zi = pos.z(i);
+
+    auto       iter = partners.begin();
+    const auto last = partners.end();
+    while(iter != last)
+    {
+        // gather
+        std::size_t n = 0;
+        for(; n < W && iter != last; ++n, ++iter)
+        {
+            const std::size_t j = iter->index;
+            js[n]     = j;
+            params[n] = kernel.parameter(iter->parameter());
+            rx[n]     = pos.x(j) - xi;
+            ry[n]     = pos.y(j) - yi;
+            rz[n]     = pos.z(j) - zi;
+            mask[n]   = lane_type(1);
+        }
+        // fill the remaining lanes by a copy of the first lane and mask them
+        for(std::size_t k=n; k<W; ++k)
+        {
+            js[k]     = js[0];
+            params[k] = params[0];
+            rx[k]     = rx[0];
+            ry[k]     = ry[0];
+            rz[k]     = rz[0];
+            mask[k]   = lane_type(0);
+        }
+        // the displacements are calculated in the system precision, and then
+        // rounded to the lanes.
+        detail::adjust_direction_lanes(sys.boundary(), rx, ry, rz, W);
+        MJOLNIR_SIMD_LOOP
+        for(std::size_t k=0; k<W; ++k)
+        {
+            dx[k] = static_cast<lane_type>(rx[k]);
+            dy[k] = static_cast<lane_type>(ry[k]);
+            dz[k] = static_cast<lane_type>(rz[k]);
+        }
+
+        // calculate (vectorized)
+        MJOLNIR_SIMD_LOOP
+        for(std::size_t k=0; k<W; ++k)
+        {
+            const lane_type l2 = dx[k] * dx[k] + dy[k] * dy[k] + dz[k] * dz[k];
+            coef[k] = mask[k] * kernel.force(l2, params[k]);
+        }
+        if(WithEnergy)
+        {
+            MJOLNIR_SIMD_LOOP
+            for(std::size_t k=0; k<W; ++k)
+            {
+                const lane_type l2 = dx[k] * dx[k] + dy[k] * dy[k] + dz[k] * dz[k];
+                ene[k] = mask[k] * kernel.energy(l2, params[k]);
+            }
+            for(std::size_t k=0; k<W; ++k)
+            {
+                energy += ene[k];
+            }
+        }
+        for(std::size_t k=0; k<W; ++k)
+        {
+            const real_type rx  = dx[k];
+            const real_type ry  = dy[k];
+            const real_type rz  = dz[k];
+            const real_type fxk = coef[k] * rx;
+            const real_type fyk = coef[k] * ry;
+            const real_type fzk = coef[k] * rz;
+            fx += fxk;
+            fy += fyk;
+            fz += fzk;
+            // (rj - ri) * Fj = (ri - rj) * Fi. Fi is parallel to rij, so the
+            // virial contribution is symmetric.
+            vxx -= rx * fxk;
+            vxy -= rx * fyk;
+            vxz -= rx * fzk;
+            vyy -= ry * fyk;
+            vyz -= ry * fzk;
+            vzz -= rz * fzk;
+        }
+
+        // scatter
+        for(std::size_t k=0; k<n; ++k)
+        {
+            const real_type c = coef[k];
+            force_of(js[k]) -= math::make_coordinate<coordinate_type>(
+                    c * dx[k], c * dy[k], c * dz[k]);
+        }
+    }
+    force_i += math::make_coordinate<coordinate_type>(fx, fy, fz);
+    virial  += typename systemT::matrix33_type(vxx, vxy, vxz,
+                                               vxy, vyy, vyz,
+                                               vxz, vyz, vzz);
+    return energy;
+}
+
+// ---------------------------------------------------------------------------
+// cluster pair loop
+//
+// calculates forces between the particles in the i-cluster `I` and their
+// partners in the blocks of a ClusterPairList. The positions of a cluster are
+// loaded once per block, and all the cluster_size x cluster_size lanes of a
+// block are calculated in one vectorized loop. Lanes that are not in the
+// neighbor list (excluded, too far, or padding) are masked by the mask of
+// the block. Other than that, it is the same as `calc_batched_pair_force`.
+
+template<bool WithEnergy, typename kernelT, typename systemT,
+         typename clusterPairListT, typename forceAccessorT>
+typename systemT::real_type
+calc_cluster_pair_force(const kernelT& kernel, const systemT& sys,
+        const clusterPairListT& clusters, const std::size_t I,
+        forceAccessorT&& force_of, typename systemT::matrix33_type& virial) noexcept
+{
+    using real_type           = typename systemT::real_type;
+    using coordinate_type     = typename systemT::coordinate_type;
+    using lane_type           = typename kernelT::real_type;
+    using pair_parameter_type = typename kernelT::pair_parameter_type;
+    constexpr std::size_t M   = clusterPairListT::cluster_size;
+    constexpr std::size_t B   = clusterPairListT::block_size;
+
+    alignas(64) real_type xi[M], yi[M], zi[M];
+    alignas(64) real_type rx[B], ry[B], rz[B];
+    alignas(64) lane_type dx  [B];
+    alignas(64) lane_type dy  [B];
+    alignas(64) lane_type dz  [B];
+    alignas(64) lane_type coef[B];
+    alignas(64) lane_type mask[B];
+    alignas(64) lane_type ene [B];
+    pair_parameter_type   params[B];
+
+    real_type fix[M] = {}, fiy[M] = {}, fiz[M] = {};
+    real_type vxx(0), vxy(0), vxz(0), vyy(0), vyz(0), vzz(0);
+    real_type energy(0);
+
+    const detail::position_reader<systemT> pos(sys);
+    const auto* is = clusters.members(I);
+    for(std::size_t a=0; a<M; ++a)
+    {
+        xi[a] = pos.x(is[a]);
+        yi[a] = pos.y(is[a]);
+        zi[a] = pos.z(is[a]);
+    }
+
+    for(const auto& blk : clusters.blocks(I))
+    {
+        const auto* js = clusters.members(blk.j_cluster);
+        const auto* ps = clusters.parameters(blk);
+
+        // the displacements are calculated in the system precision, and then
+        // rounded to the lanes.
+        for(std::size_t b=0; b<M; ++b)
+        {
+            const real_type xj = pos.x(js[b]);
+            const real_type yj = pos.y(js[b]);
+            const real_type zj = pos.z(js[b]);
+            for(std::size_t a=0; a<M; ++a)
+            {
+                rx[a * M + b] = xj - xi[a];
+                ry[a * M + b] = yj - yi[a];
+                rz[a * M + b] = zj - zi[a];
+            }
+        }
+        detail::adjust_direction_lanes(sys.boundary(), rx, ry, rz, B);
+        for(std::size_t k=0; k<B; ++k)
+        {
+            dx[k]     = static_cast<lane_type>(rx[k]);
+            dy[k]     = static_cast<lane_type>(ry[k]);
+            dz[k]     = static_cast<lane_type>(rz[k]);
+            mask[k]   = static_cast<lane_type>((blk.mask >> k) & 1u);
+            params[k] = kernel.parameter(ps[k]);
+        }
+
+        // calculate (vectorized). The masked lanes may have zero distance
+        // (e.g. a particle and itself), so their distance is replaced by 1.
+        MJOLNIR_SIMD_LOOP
+        for(std::size_t k=0; k<B; ++k)
+        {
+            const lane_type r2 = dx[k] * dx[k] + dy[k] * dy[k] + dz[k] * dz[k];
+            const lane_type l2 = mask[k] * r2 + (lane_type(1) - mask[k]);
+            coef[k] = mask[k] * kernel.force(l2, params[k]);
+        }
+        if(WithEnergy)
+        {
+            MJOLNIR_SIMD_LOOP
+            for(std::size_t k=0; k<B; ++k)
+            {
+                const lane_type r2 = dx[k] * dx[k] + dy[k] * dy[k] + dz[k] * dz[k];
+                const lane_type l2 = mask[k] * r2 + (lane_type(1) - mask[k]);
+                ene[k] = mask[k] * kernel.energy(l2, params[k]);
+            }
+            for(std::size_t k=0; k<B; ++k)
+            {
+                energy += ene[k];
+            }
+        }
+
+        real_type fjx[M] = {}, fjy[M] = {}, fjz[M] = {};
+        for(std::size_t a=0; a<M; ++a)
+        {
+            for(std::size_t b=0; b<M; ++b)
+            {
+                const std::size_t k = a * M + b;
+                const real_type rxk = dx[k];
+                const real_type ryk = dy[k];
+                const real_type rzk = dz[k];
+                const real_type fxk = coef[k] * rxk;
+                const real_type fyk = coef[k] * ryk;
+                const real_type fzk = coef[k] * rzk;
+                fix[a] += fxk;
+                fiy[a] += fyk;
+                fiz[a] += fzk;
+                fjx[b] -= fxk;
+                fjy[b] -= fyk;
+                fjz[b] -= fzk;
+                vxx -= rxk * fxk;
+                vxy -= rxk * fyk;
+                vxz -= rxk * fzk;
+                vyy -= ryk * fyk;
+                vyz -= ryk * fzk;
+                vzz -= rzk * fzk;
+            }
+        }
+
+        // scatter
+        const std::size_t nj = clusters.size(blk.j_cluster);
+        for(std::size_t b=0; b<nj; ++b)
+        {
+            force_of(js[b]) += math::make_coordinate<coordinate_type>(
+                    fjx[b], fjy[b], fjz[b]);
+        }
+    }
+    const std::size_t ni = clusters.size(I);
+    for(std::size_t a=0; a<ni; ++a)
+    {
+        force_of(is[a]) += math::make_coordinate<coordinate_type>(
+                fix[a], fiy[a], fiz[a]);
+    }
+    virial += typename systemT::matrix33_type(vxx, vxy, vxz,
+                                              vxy, vyy, vyz,
+                                              vxz, vyz, vzz);
+    return energy;
+}
+
+} // mjolnir
+#endif // MJOLNIR_FORCEFIELD_GLOBAL_BATCHED_PAIR_KERNEL_HPP
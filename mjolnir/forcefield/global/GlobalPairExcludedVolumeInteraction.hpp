@@ -2,6 +2,7 @@
 #define MJOLNIR_INTERACTION_GLOBAL_PAIR_EXCLUDED_VOLUME_INTEARACTION_HPP
 #include <mjolnir/forcefield/global/GlobalPairInteraction.hpp>
 #include <mjolnir/forcefield/global/ExcludedVolumePotential.hpp>
+#include <mjolnir/forcefield/global/BatchedPairKernel.hpp>
 #include <mjolnir/core/SimulatorTraits.hpp>
 #include <memory>
 
@@ -75,50 +76,26 @@ class GlobalPairInteraction<
 
     void calc_force(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
         MJOLNIR_LOG_FUNCTION_DEBUG();
 
-        const auto cutoff_ratio    = potential_.cutoff_ratio();
-        const auto cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
-        const auto epsilon12       = 12 * potential_.epsilon();
-
-        const auto leading_participants = this->potential_.leading_participants();
-        for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+        if(sys.mixed_precision())
         {
-            const auto i = leading_participants[idx];
-            for(const auto& ptnr : this->partition_.partners(i))
-            {
-                const auto  j     = ptnr.index;
-                const auto& param = ptnr.parameter(); // sum of radius
-
-                const coordinate_type rij =
-                    sys.adjust_direction(sys.position(i), sys.position(j));
-                const real_type l_sq = math::length_sq(rij);
-
-                const real_type sigma_sq = param * param;
-                if(sigma_sq * cutoff_ratio_sq < l_sq) {continue;}
-
-                MJOLNIR_LOG_DEBUG("calculating force between ", i, " and ", j);
-
-                const real_type rcp_l_sq = real_type(1) / l_sq;
-                const real_type s2l2     = sigma_sq * rcp_l_sq;
-                const real_type s6l6     = s2l2 * s2l2 * s2l2;
-
-                const coordinate_type f = rij *
-                    (-epsilon12 * s6l6 * s6l6 * rcp_l_sq);
-
-                sys.force(i) += f;
-                sys.force(j) -= f;
-
-                // rij * Fj = (rj - ri) * Fj = (ri - rj) * Fi
-                sys.virial() += math::tensor_product(rij, -f);
-            }
+            this->calc_force_batched(sys,
+                BatchedPairKernel<potential_type, float>(this->potential_));
+        }
+        else
+        {
+            this->calc_force_batched(sys,
+                BatchedPairKernel<potential_type>(this->potential_));
         }
         return ;
     }
 
     real_type calc_energy(const system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
         MJOLNIR_LOG_FUNCTION_DEBUG();
 
@@ -129,7 +106,7 @@ class GlobalPairInteraction<
         const auto coef_at_cutoff  = potential_.coef_at_cutoff();
         const auto epsilon         = potential_.epsilon();
 
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
         for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
         {
             const auto i = leading_participants[idx];
@@ -158,51 +135,17 @@ class GlobalPairInteraction<
 
     real_type calc_force_and_energy(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
         MJOLNIR_LOG_FUNCTION_DEBUG();
 
-        const auto coef_at_cutoff  = potential_.coef_at_cutoff();
-        const auto cutoff_ratio    = potential_.cutoff_ratio();
-        const auto cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
-        const auto epsilon         = potential_.epsilon();
-        const auto epsilon12       = 12 * epsilon;
-
-        real_type energy = 0;
-        const auto leading_participants = this->potential_.leading_participants();
-        for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+        if(sys.mixed_precision())
         {
-            const auto i = leading_participants[idx];
-            for(const auto& ptnr : this->partition_.partners(i))
-            {
-                const auto  j     = ptnr.index;
-                const auto& param = ptnr.parameter(); // sum of radius
-
-                const coordinate_type rij =
-                    sys.adjust_direction(sys.position(i), sys.position(j));
-                const real_type l_sq = math::length_sq(rij);
-
-                const real_type sigma_sq = param * param;
-                if(sigma_sq * cutoff_ratio_sq < l_sq) {continue;}
-
-                MJOLNIR_LOG_DEBUG("calculating force between ", i, " and ", j);
-
-                const real_type rcp_l_sq = real_type(1) / l_sq;
-                const real_type s2l2     = sigma_sq * rcp_l_sq;
-                const real_type s6l6     = s2l2 * s2l2 * s2l2;
-
-                energy += epsilon * (s6l6 * s6l6 - coef_at_cutoff);
-
-                const coordinate_type f = rij *
-                    (-epsilon12 * s6l6 * s6l6 * rcp_l_sq);
-
-                sys.force(i) += f;
-                sys.force(j) -= f;
-
-                // rij * Fj = (rj - ri) * Fj = (ri - rj) * Fi
-                sys.virial() += math::tensor_product(rij, -f);
-            }
+            return this->calc_force_and_energy_batched(sys,
+                BatchedPairKernel<potential_type, float>(this->potential_));
         }
-        return energy;
+        return this->calc_force_and_energy_batched(sys,
+                BatchedPairKernel<potential_type>(this->potential_));
     }
 
     std::string name() const override {return "GlobalPairExcludedVolume";}
@@ -213,6 +156,66 @@ class GlobalPairInteraction<
                 potential_type(potential_), partition_type(partition_));
     }
 
+  private:
+
+    template<typename kernelT>
+    void calc_force_batched(system_type& sys, const kernelT& kernel) const noexcept
+    {
+        if(this->partition_.has_cluster_pairs())
+        {
+            const auto& clusters = this->partition_.cluster_pairs();
+            for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+            {
+                calc_cluster_pair_force<false>(kernel, sys, clusters, I,
+                    [&sys](const std::size_t j) -> coordinate_type& {
+                        return sys.force(j);
+                    }, sys.virial());
+            }
+            return ;
+        }
+        const auto& leading_participants = this->partition_.leading_participants();
+        for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            calc_batched_pair_force<false>(kernel, sys, i,
+                this->partition_.partners(i),
+                [&sys](const std::size_t j) -> coordinate_type& {
+                    return sys.force(j);
+                }, sys.force(i), sys.virial());
+        }
+        return ;
+    }
+
+    template<typename kernelT>
+    real_type calc_force_and_energy_batched(system_type& sys,
+                                             const kernelT& kernel) const noexcept
+    {
+        real_type energy = 0;
+        if(this->partition_.has_cluster_pairs())
+        {
+            const auto& clusters = this->partition_.cluster_pairs();
+            for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+            {
+                energy += calc_cluster_pair_force<true>(kernel, sys, clusters, I,
+                    [&sys](const std::size_t j) -> coordinate_type& {
+                        return sys.force(j);
+                    }, sys.virial());
+            }
+            return energy;
+        }
+        const auto& leading_participants = this->partition_.leading_participants();
+        for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            energy += calc_batched_pair_force<true>(kernel, sys, i,
+                this->partition_.partners(i),
+                [&sys](const std::size_t j) -> coordinate_type& {
+                    return sys.force(j);
+                }, sys.force(i), sys.virial());
+        }
+        return energy;
+    }
+
   private:
 
     potential_type potential_;
@@ -3,6 +3,8 @@
 #include <mjolnir/core/SimulatorTraits.hpp>
 #include <mjolnir/core/GlobalInteractionBase.hpp>
 #include <mjolnir/core/SpatialPartitionBase.hpp>
+#include <mjolnir/forcefield/global/BatchedPairKernel.hpp>
+#include <mjolnir/forcefield/global/SplinePairTable.hpp>
 #include <mjolnir/math/math.hpp>
 #include <mjolnir/util/logger.hpp>
 #include <mjolnir/util/string.hpp>
@@ -24,6 +26,12 @@ namespace mjolnir
 // By combining potential calculations, we can omit `sqrt()` that is usually
 // used to calculate the distance between particles.
 //
+// If a potential has a BatchedPairKernel (e.g. DebyeHuckel), forces are
+// calculated in batches to vectorize the loop. See BatchedPairKernel.hpp.
+//
+// If a SplinePairTable is given, the potential is tabulated and the forces
+// are calculated in batches from the table. See SplinePairTable.hpp.
+//
 template<typename traitsT, typename potentialT>
 class GlobalPairInteraction final : public GlobalInteractionBase<traitsT>
 {
@@ -37,13 +45,16 @@ class GlobalPairInteraction final : public GlobalInteractionBase<traitsT>
     using topology_type   = typename base_type::topology_type;
     using boundary_type   = typename base_type::boundary_type;
     using partition_type  = SpatialPartition<traits_type, potential_type>;
+    using table_type      = SplinePairTable<potential_type>;
 
   public:
     GlobalPairInteraction()           = default;
     ~GlobalPairInteraction() override {}
 
-    GlobalPairInteraction(potential_type&& pot, partition_type&& part)
-        : potential_(std::move(pot)), partition_(std::move(part))
+    GlobalPairInteraction(potential_type&& pot, partition_type&& part,
+                          table_type&& table = table_type{})
+        : potential_(std::move(pot)), partition_(std::move(part)),
+          table_(std::move(table))
     {}
 
     /*! @brief initialize spatial partition (e.g. CellList)                   *
@@ -55,6 +66,7 @@ class GlobalPairInteraction final : public GlobalInteractionBase<traitsT>
         MJOLNIR_LOG_INFO("potential is ", this->name());
         this->potential_.initialize(sys, topol);
         this->partition_.initialize(sys, this->potential_);
+        this->table_.make(this->potential_, this->partition_);
     }
 
     /*! @brief update parameters (e.g. temperature, ionic strength, ...)  *
@@ -69,16 +81,24 @@ class GlobalPairInteraction final : public GlobalInteractionBase<traitsT>
         this->potential_.update(sys, topol);
         // potential update may change the cutoff length!
         this->partition_.initialize(sys, this->potential_);
+        // and the pair parameters.
+        this->table_.make(this->potential_, this->partition_);
     }
 
     void reduce_margin(const real_type dmargin, const system_type& sys) override
     {
-        this->partition_.reduce_margin(dmargin, sys, this->potential_);
+        if(this->partition_.reduce_margin(dmargin, sys, this->potential_))
+        {
+            this->table_.update(this->potential_, this->partition_);
+        }
         return;
     }
     void scale_margin(const real_type scale, const system_type& sys) override
     {
-        this->partition_.scale_margin(scale, sys, this->potential_);
+        if(this->partition_.scale_margin(scale, sys, this->potential_))
+        {
+            this->table_.update(this->potential_, this->partition_);
+        }
         return;
     }
 
@@ -94,14 +114,34 @@ class GlobalPairInteraction final : public GlobalInteractionBase<traitsT>
 
     base_type* clone() const override
     {
-        return new GlobalPairInteraction(
-                potential_type(potential_), partition_type(partition_));
+        return new GlobalPairInteraction(potential_type(potential_),
+                partition_type(partition_), table_type(table_));
     }
 
+  private:
+
+    // Since explicit instantiation instantiates all the non-template member
+    // functions, the batched versions are templates to avoid instantiating
+    // BatchedPairKernel for potentials that do not have it.
+    void      calc_force_impl(system_type&, std::false_type) const noexcept;
+    real_type calc_force_and_energy_impl(system_type&, std::false_type) const noexcept;
+
+    template<typename potT = potential_type>
+    void      calc_force_impl(system_type&, std::true_type)  const noexcept;
+    template<typename potT = potential_type>
+    real_type calc_force_and_energy_impl(system_type&, std::true_type)  const noexcept;
+
+    // the kernel is evaluated in float if `sys.mixed_precision()` is true.
+    template<typename kernelT>
+    void      calc_force_batched(system_type&, const kernelT&) const noexcept;
+    template<typename kernelT>
+    real_type calc_force_and_energy_batched(system_type&, const kernelT&) const noexcept;
+
   private:
 
     potential_type potential_;
     partition_type partition_;
+    table_type     table_;
 
 #ifdef MJOLNIR_WITH_OPENMP
     // OpenMP implementation uses its own implementation to run it in parallel.
@@ -115,7 +155,69 @@ template<typename traitsT, typename potT>
 void GlobalPairInteraction<traitsT, potT>::calc_force(
         system_type& sys) const noexcept
 {
-    const auto leading_participants = this->potential_.leading_participants();
+    const auto tuning_timer = this->partition_.tuning_timer();
+    if(this->table_.enabled())
+    {
+        this->calc_force_batched(sys, this->table_);
+        return ;
+    }
+    this->calc_force_impl(sys, has_batched_pair_kernel<potential_type>{});
+    return ;
+}
+
+template<typename traitsT, typename potT>
+template<typename potentialT>
+void GlobalPairInteraction<traitsT, potT>::calc_force_impl(
+        system_type& sys, std::true_type) const noexcept
+{
+    if(sys.mixed_precision())
+    {
+        this->calc_force_batched(sys,
+            BatchedPairKernel<potentialT, float>(this->potential_));
+    }
+    else
+    {
+        this->calc_force_batched(sys,
+            BatchedPairKernel<potentialT>(this->potential_));
+    }
+    return ;
+}
+
+template<typename traitsT, typename potT>
+template<typename kernelT>
+void GlobalPairInteraction<traitsT, potT>::calc_force_batched(
+        system_type& sys, const kernelT& kernel) const noexcept
+{
+    if(this->partition_.has_cluster_pairs())
+    {
+        const auto& clusters = this->partition_.cluster_pairs();
+        for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+        {
+            calc_cluster_pair_force<false>(kernel, sys, clusters, I,
+                [&sys](const std::size_t j) -> coordinate_type& {
+                    return sys.force(j);
+                }, sys.virial());
+        }
+        return ;
+    }
+    const auto& leading_participants = this->partition_.leading_participants();
+    for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+    {
+        const auto i = leading_participants[idx];
+        calc_batched_pair_force<false>(kernel, sys, i,
+            this->partition_.partners(i),
+            [&sys](const std::size_t j) -> coordinate_type& {
+                return sys.force(j);
+            }, sys.force(i), sys.virial());
+    }
+    return ;
+}
+
+template<typename traitsT, typename potT>
+void GlobalPairInteraction<traitsT, potT>::calc_force_impl(
+        system_type& sys, std::false_type) const noexcept
+{
+    const auto& leading_participants = this->partition_.leading_participants();
     for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
     {
         const auto i = leading_participants[idx];
@@ -150,9 +252,10 @@ typename GlobalPairInteraction<traitsT, potT>::real_type
 GlobalPairInteraction<traitsT, potT>::calc_energy(
         const system_type& sys) const noexcept
 {
+    const auto tuning_timer = this->partition_.tuning_timer();
     real_type E = 0.0;
 
-    const auto leading_participants = this->potential_.leading_participants();
+    const auto& leading_participants = this->partition_.leading_participants();
     for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
     {
         const auto i = leading_participants[idx];
@@ -173,9 +276,70 @@ template<typename traitsT, typename potT>
 typename GlobalPairInteraction<traitsT, potT>::real_type
 GlobalPairInteraction<traitsT, potT>::calc_force_and_energy(
         system_type& sys) const noexcept
+{
+    const auto tuning_timer = this->partition_.tuning_timer();
+    if(this->table_.enabled())
+    {
+        return this->calc_force_and_energy_batched(sys, this->table_);
+    }
+    return this->calc_force_and_energy_impl(
+            sys, has_batched_pair_kernel<potential_type>{});
+}
+
+template<typename traitsT, typename potT>
+template<typename potentialT>
+typename GlobalPairInteraction<traitsT, potT>::real_type
+GlobalPairInteraction<traitsT, potT>::calc_force_and_energy_impl(
+        system_type& sys, std::true_type) const noexcept
+{
+    if(sys.mixed_precision())
+    {
+        return this->calc_force_and_energy_batched(sys,
+            BatchedPairKernel<potentialT, float>(this->potential_));
+    }
+    return this->calc_force_and_energy_batched(sys,
+            BatchedPairKernel<potentialT>(this->potential_));
+}
+
+template<typename traitsT, typename potT>
+template<typename kernelT>
+typename GlobalPairInteraction<traitsT, potT>::real_type
+GlobalPairInteraction<traitsT, potT>::calc_force_and_energy_batched(
+        system_type& sys, const kernelT& kernel) const noexcept
+{
+    real_type energy = 0.0;
+    if(this->partition_.has_cluster_pairs())
+    {
+        const auto& clusters = this->partition_.cluster_pairs();
+        for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+        {
+            energy += calc_cluster_pair_force<true>(kernel, sys, clusters, I,
+                [&sys](const std::size_t j) -> coordinate_type& {
+                    return sys.force(j);
+                }, sys.virial());
+        }
+        return energy;
+    }
+    const auto& leading_participants = this->partition_.leading_participants();
+    for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+    {
+        const auto i = leading_participants[idx];
+        energy += calc_batched_pair_force<true>(kernel, sys, i,
+            this->partition_.partners(i),
+            [&sys](const std::size_t j) -> coordinate_type& {
+                return sys.force(j);
+            }, sys.force(i), sys.virial());
+    }
+    return energy;
+}
+
+template<typename traitsT, typename potT>
+typename GlobalPairInteraction<traitsT, potT>::real_type
+GlobalPairInteraction<traitsT, potT>::calc_force_and_energy_impl(
+        system_type& sys, std::false_type) const noexcept
 {
     real_type energy = 0.0;
-    const auto leading_participants = this->potential_.leading_participants();
+    const auto& leading_participants = this->partition_.leading_participants();
     for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
     {
         const auto i = leading_participants[idx];
@@ -75,6 +75,7 @@ class GlobalPairInteraction<
 
     void calc_force(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         const auto cutoff_ratio    = potential_.cutoff_ratio();
         const auto cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
         const auto sigma           = this->potential_.sigma();
@@ -82,7 +83,7 @@ class GlobalPairInteraction<
         const auto r_cutoff_sq     = cutoff_ratio_sq * sigma_sq;
         const auto epsilon         = this->potential_.epsilon();
 
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
         for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
         {
             const auto i = leading_participants[idx];
@@ -116,6 +117,7 @@ class GlobalPairInteraction<
 
     real_type calc_energy(const system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         real_type E(0);
 
         const auto cutoff_ratio    = potential_.cutoff_ratio();
@@ -126,7 +128,7 @@ class GlobalPairInteraction<
         const auto r_cutoff_sq     = cutoff_ratio_sq * sigma_sq;
         const auto epsilon         = this->potential_.epsilon();
 
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
         for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
         {
             const auto i = leading_participants[idx];
@@ -151,6 +153,7 @@ class GlobalPairInteraction<
 
     real_type calc_force_and_energy(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         const auto coef_at_cutoff  = potential_.coef_at_cutoff();
         const auto cutoff_ratio    = potential_.cutoff_ratio();
         const auto cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
@@ -161,7 +164,7 @@ class GlobalPairInteraction<
 
         real_type energy = 0;
 
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
         for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
         {
             const auto i = leading_participants[idx];
@@ -0,0 +1,288 @@
+#ifndef MJOLNIR_FORCEFIELD_GLOBAL_SPLINE_PAIR_TABLE_HPP
+#define MJOLNIR_FORCEFIELD_GLOBAL_SPLINE_PAIR_TABLE_HPP
+#include <mjolnir/util/logger.hpp>
+#include <mjolnir/util/throw_exception.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+namespace mjolnir
+{
+
+// SplinePairTable tabulates a global pair potential as a function of the
+// squared distance s = r^2, so that the pair loop does not call `std::exp`,
+// `std::pow`, trigonometric functions, or even `std::sqrt`.
+//
+// A table is made for each distinct pair parameter (e.g. qi * qj of
+// DebyeHuckel) that appears in the neighbor list. The range [r_min^2, rc^2]
+// is divided into `n` intervals of the same width. In each interval, both of
+// the energy U(s) and the force coefficient g(s) = (dU/dr) / r are
+// interpolated by cubic Hermite splines. The number of intervals is doubled
+// until the largest error at the points between the knots becomes smaller than
+// `tolerance` relative to the largest absolute value in the table. If the
+// force is not smooth (e.g. iSoLF at r = 2^(1/6) sigma), the error decreases
+// only linearly and it requires a large number of intervals.
+//
+// It has the same interface as BatchedPairKernel (`force(l2, p)`,
+// `energy(l2, p)` and `parameter(p)`), so `calc_batched_pair_force` and
+// `calc_cluster_pair_force` work with it. Here, the pair parameter in the
+// kernel is the index of the table.
+//
+// Below `r_min`, the first polynomial is extrapolated. `r_min` should be less
+// than the closest approach of the particles, which is normally limited by
+// other (e.g. excluded volume) interactions.
+//
+// Since the pair parameters depend on the system parameters (e.g. temperature
+// and ionic strength), the tables are re-made when the potential is updated.
+template<typename potentialT>
+class SplinePairTable
+{
+  public:
+    using potential_type      = potentialT;
+    using real_type           = typename potential_type::real_type;
+    using parameter_type      = typename potential_type::pair_parameter_type;
+    using pair_parameter_type = std::uint32_t; // index of a table
+    using coefficient_type    = std::array<real_type, 4>;
+
+    static constexpr std::size_t min_intervals() noexcept {return 64;}
+    static constexpr std::size_t max_intervals() noexcept {return 65536;}
+
+  public:
+
+    SplinePairTable()
+        : enabled_(false), min_distance_(0), tolerance_(0), n_(0),
+          s_min_(0), s_max_(0), rds_(0)
+    {}
+    SplinePairTable(const real_type min_distance, const real_type tolerance)
+        : enabled_(true), min_distance_(min_distance), tolerance_(tolerance),
+          n_(0), s_min_(0), s_max_(0), rds_(0)
+    {
+        if(!(0 < min_distance_))
+        {
+            throw_exception<std::invalid_argument>("mjolnir::SplinePairTable: "
+                "min_distance should be positive, but ", min_distance_);
+        }
+        if(!(0 < tolerance_))
+        {
+            throw_exception<std::invalid_argument>("mjolnir::SplinePairTable: "
+                "tolerance should be positive, but ", tolerance_);
+        }
+    }
+    ~SplinePairTable() = default;
+    SplinePairTable(SplinePairTable const&) = default;
+    SplinePairTable(SplinePairTable &&)     = default;
+    SplinePairTable& operator=(SplinePairTable const&) = default;
+    SplinePairTable& operator=(SplinePairTable &&)     = default;
+
+    bool enabled() const noexcept {return enabled_;}
+
+    // makes all the tables from scratch. It should be called after the
+    // potential parameters are changed and the list is re-constructed.
+    template<typename partitionT>
+    void make(const potential_type& pot, const partitionT& partition)
+    {
+        this->classes_.clear();
+        this->update(pot, partition);
+        return;
+    }
+
+    // adds tables for pair parameters that are newly found in the list.
+    // It should be called every time the list is re-constructed.
+    template<typename partitionT>
+    void update(const potential_type& pot, const partitionT& partition)
+    {
+        if(!this->enabled_) {return;}
+
+        const auto cutoff = pot.max_cutoff_length();
+        const bool range_changed = (s_max_ != cutoff * cutoff);
+
+        bool found_new = false;
+        for(const auto i : partition.leading_participants())
+        {
+            for(const auto& ptnr : partition.partners(i))
+            {
+                if(!std::binary_search(classes_.begin(), classes_.end(),
+                                       ptnr.parameter()))
+                {
+                    classes_.insert(std::upper_bound(classes_.begin(),
+                        classes_.end(), ptnr.parameter()), ptnr.parameter());
+                    found_new = true;
+                }
+            }
+        }
+        if(found_new || range_changed)
+        {
+            this->tabulate(pot);
+        }
+        return;
+    }
+
+    // ------------------------------------------------------------------------
+    // kernel interface
+
+    pair_parameter_type parameter(const parameter_type& p) const noexcept
+    {
+        return static_cast<pair_parameter_type>(std::distance(classes_.begin(),
+                std::lower_bound(classes_.begin(), classes_.end(), p)));
+    }
+
+    real_type force(const real_type l2, const pair_parameter_type idx) const noexcept
+    {
+        return this->interpolate(force_, l2, idx);
+    }
+    real_type energy(const real_type l2, const pair_parameter_type idx) const noexcept
+    {
+        return this->interpolate(energy_, l2, idx);
+    }
+
+    // ------------------------------------------------------------------------
+
+    real_type   min_distance()  const noexcept {return min_distance_;}
+    real_type   tolerance()     const noexcept {return tolerance_;}
+    std::size_t num_tables()    const noexcept {return classes_.size();}
+    std::size_t num_intervals() const noexcept {return n_;}
+
+  private:
+
+    real_type interpolate(const std::vector<coefficient_type>& table,
+        const real_type l2, const pair_parameter_type idx) const noexcept
+    {
+        // below s_min, t becomes negative and the first interval is used.
+        const real_type   x = (l2 - s_min_) * rds_;
+        const std::size_t k = static_cast<std::size_t>(
+                std::min(std::max(x, real_type(0)), real_type(n_ - 1)));
+        const real_type   t = x - static_cast<real_type>(k);
+        const auto& c = table[idx * n_ + k];
+        const real_type v = c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+        return v * static_cast<real_type>(l2 < s_max_);
+    }
+
+    void tabulate(const potential_type& pot)
+    {
+        MJOLNIR_GET_DEFAULT_LOGGER();
+        MJOLNIR_LOG_FUNCTION();
+
+        const real_type rc = pot.max_cutoff_length();
+        if(!(min_distance_ < rc))
+        {
+            throw_exception<std::runtime_error>("mjolnir::SplinePairTable: "
+                "min_distance (", min_distance_, ") should be less than the "
+                "cutoff length (", rc, ")");
+        }
+        this->s_min_ = min_distance_ * min_distance_;
+        this->s_max_ = rc * rc;
+
+        real_type error = 0;
+        for(n_ = min_intervals(); n_ <= max_intervals(); n_ *= 2)
+        {
+            this->rds_ = n_ / (s_max_ - s_min_);
+            error = real_type(0);
+            energy_.resize(classes_.size() * n_);
+            force_ .resize(classes_.size() * n_);
+            for(std::size_t idx=0; idx<classes_.size(); ++idx)
+            {
+                error = std::max(error, this->tabulate_class(pot, idx));
+            }
+            if(error <= tolerance_)
+            {
+                break;
+            }
+            if(n_ == max_intervals())
+            {
+                MJOLNIR_LOG_WARN("SplinePairTable: relative error ", error,
+                    " exceeds the tolerance ", tolerance_, " with ", n_,
+                    " intervals");
+                break;
+            }
+        }
+        MJOLNIR_LOG_INFO("SplinePairTable: ", classes_.size(), " tables with ",
+            n_, " intervals. relative error = ", error);
+        return;
+    }
+
+    // makes the table of classes_[idx] and returns the relative error.
+    real_type tabulate_class(const potential_type& pot, const std::size_t idx)
+    {
+        const auto& p = classes_[idx];
+        const real_type ds = (s_max_ - s_min_) / n_;
+
+        // the potential returns 0 at the cutoff. Here we need the limit.
+        const real_type s_top = s_max_ * (1 - std::numeric_limits<real_type>::epsilon() * 16);
+        const auto clamp = [this, s_top](const real_type s) noexcept {
+            return std::min(std::max(s, this->s_min_), s_top);
+        };
+        const auto U = [&pot, &p, &clamp](const real_type s) noexcept {
+            return pot.potential(std::sqrt(clamp(s)), p);
+        };
+        const auto g = [&pot, &p, &clamp](const real_type s) noexcept {
+            const real_type r = std::sqrt(clamp(s));
+            return pot.derivative(r, p) / r;
+        };
+        // dU/ds = g / 2. dg/ds is calculated numerically.
+        const real_type h = ds * real_type(1e-3);
+        const auto dg = [&g, &clamp, h](const real_type s) noexcept {
+            const real_type s1 = clamp(s + h), s0 = clamp(s - h);
+            return (g(s1) - g(s0)) / (s1 - s0);
+        };
+
+        for(std::size_t k=0; k<n_; ++k)
+        {
+            const real_type s0 = s_min_ + k * ds;
+            const real_type s1 = s0 + ds;
+            energy_[idx * n_ + k] = hermite(U(s0), U(s1), g(s0) / 2, g(s1) / 2, ds);
+            force_ [idx * n_ + k] = hermite(g(s0), g(s1), dg(s0), dg(s1), ds);
+        }
+
+        // check the values between the knots.
+        real_type max_u = 0, max_g = 0, err_u = 0, err_g = 0;
+        for(std::size_t k=0; k<n_; ++k)
+        {
+            for(const real_type t : {real_type(0.25), real_type(0.5), real_type(0.75)})
+            {
+                const real_type s = s_min_ + (k + t) * ds;
+                const real_type u_ref = U(s);
+                const real_type g_ref = g(s);
+                max_u = std::max(max_u, std::abs(u_ref));
+                max_g = std::max(max_g, std::abs(g_ref));
+                err_u = std::max(err_u, std::abs(this->energy(s, idx) - u_ref));
+                err_g = std::max(err_g, std::abs(this->force (s, idx) - g_ref));
+            }
+        }
+        const real_type rel_u = (max_u == 0) ? err_u : err_u / max_u;
+        const real_type rel_g = (max_g == 0) ? err_g : err_g / max_g;
+        return std::max(rel_u, rel_g);
+    }
+
+    // coefficients of y(t) = c0 + c1 t + c2 t^2 + c3 t^3 in t = [0, 1] that
+    // satisfy y(0) = y0, y(1) = y1, dy/ds(0) = m0, and dy/ds(1) = m1.
+    static coefficient_type hermite(const real_type y0, const real_type y1,
+            const real_type m0, const real_type m1, const real_type ds) noexcept
+    {
+        return coefficient_type{{
+            y0, ds * m0,
+            3 * (y1 - y0) - ds * (2 * m0 + m1),
+            2 * (y0 - y1) + ds * (m0 + m1)
+        }};
+    }
+
+  private:
+
+    bool        enabled_;
+    real_type   min_distance_;
+    real_type   tolerance_;
+    std::size_t n_;     // number of intervals in a table
+    real_type   s_min_; // r_min^2
+    real_type   s_max_; // rc^2
+    real_type   rds_;   // 1 / width of an interval
+    std::vector<parameter_type>   classes_; // sorted
+    std::vector<coefficient_type> energy_;  // n_ * classes_.size()
+    std::vector<coefficient_type> force_;   // n_ * classes_.size()
+};
+
+} // mjolnir
+#endif // MJOLNIR_FORCEFIELD_GLOBAL_SPLINE_PAIR_TABLE_HPP
@@ -1,6 +1,7 @@
 #ifndef MJOLNIR_FORCEFIELD_GLOBAL_TABULATED_LENNARD_JONES_ATTRACTIVE_POTENTIAL_HPP
 #define MJOLNIR_FORCEFIELD_GLOBAL_TABULATED_LENNARD_JONES_ATTRACTIVE_POTENTIAL_HPP
 #include <mjolnir/core/ExclusionList.hpp>
+#include <mjolnir/forcefield/global/TypePairParameterMatrix.hpp>
 #include <mjolnir/core/System.hpp>
 #include <mjolnir/math/math.hpp>
 #include <mjolnir/util/logger.hpp>
@@ -19,10 +20,12 @@ class TabulatedLennardJonesAttractivePotential
     using traits_type          = traitsT;
     using real_type            = typename traits_type::real_type;
     using system_type          = System<traits_type>;
-    using parameter_type       = std::string;
-    using pair_parameter_type  = std::pair<real_type, real_type>; // {sigma, epsilon};
+    using table_value_type     = std::pair<real_type, real_type>; // {sigma, epsilon}
+    using matrix_type          = TypePairParameterMatrix<table_value_type>;
+    using parameter_type       = typename matrix_type::type_id_type;
+    using pair_parameter_type  = typename matrix_type::pair_id_type;
     using container_type       = std::vector<parameter_type>;
-    using table_type           = std::unordered_map<std::string, pair_parameter_type>;
+    using table_type           = typename matrix_type::table_type;
 
     // topology stuff
     using topology_type        = Topology;
@@ -37,47 +40,66 @@ class TabulatedLennardJonesAttractivePotential
     {
         return real_type(2.5);
     }
-    static parameter_type default_parameter() noexcept
+    static constexpr parameter_type default_parameter() noexcept
     {
-        return std::string("");
+        return parameter_type(0);
     }
 
   public:
 
+    // type names are already interned into the matrix. parameters contain
+    // pairs of {particle index, type id}.
     TabulatedLennardJonesAttractivePotential(
-        const real_type cutoff_ratio, table_type&& table,
+        const real_type cutoff_ratio, matrix_type&& matrix,
         const std::vector<std::pair<std::size_t, parameter_type>>& parameters,
         const std::map<connection_kind_type, std::size_t>&         exclusions,
         ignore_molecule_type ignore_mol, ignore_group_type ignore_grp)
     : cutoff_ratio_(cutoff_ratio),
       coef_at_cutoff_(std::pow(1 / cutoff_ratio, 12) - std::pow(1 / cutoff_ratio, 6)),
-      table_(std::move(table)),
+      matrix_(std::move(matrix)),
       exclusion_list_(exclusions, std::move(ignore_mol), std::move(ignore_grp))
     {
-        this->parameters_  .reserve(parameters.size());
         this->participants_.reserve(parameters.size());
         for(const auto& idxp : parameters)
         {
-            const auto idx = idxp.first;
-            this->participants_.push_back(idx);
-            if(idx >= this->parameters_.size())
-            {
-                this->parameters_.resize(idx+1, default_parameter());
-            }
-            this->parameters_.at(idx) = idxp.second;
+            this->participants_.push_back(idxp.first);
+            this->matrix_.set_particle_type(idxp.first, idxp.second);
+        }
+    }
+    // with type names. it interns the names here.
+    TabulatedLennardJonesAttractivePotential(
+        const real_type cutoff_ratio, const table_type& table,
+        const std::vector<std::pair<std::size_t, std::string>>& parameters,
+        const std::map<connection_kind_type, std::size_t>&      exclusions,
+        ignore_molecule_type ignore_mol, ignore_group_type ignore_grp)
+    : cutoff_ratio_(cutoff_ratio),
+      coef_at_cutoff_(std::pow(1 / cutoff_ratio, 12) - std::pow(1 / cutoff_ratio, 6)),
+      exclusion_list_(exclusions, std::move(ignore_mol), std::move(ignore_grp))
+    {
+        this->participants_.reserve(parameters.size());
+        for(const auto& idxp : parameters)
+        {
+            this->participants_.push_back(idxp.first);
+            this->matrix_.set_particle_type(idxp.first,
+                                            this->matrix_.add_type(idxp.second));
         }
+        this->matrix_.set_table(table);
     }
     ~TabulatedLennardJonesAttractivePotential() = default;
 
+    // neighbor lists store only the type-pair id. The values, {sigma, epsilon},
+    // are looked up from the dense matrix while calculating forces.
     pair_parameter_type prepare_params(std::size_t i, std::size_t j) const noexcept
     {
-        const auto key = parameters_[i] + ":" + parameters_[j];
-        if(table_.count(key) == 0)
+        const auto id = matrix_.pair_id(i, j);
+        if(!matrix_.is_defined(id))
         {
             MJOLNIR_GET_DEFAULT_LOGGER();
-            MJOLNIR_LOG_ERROR("parameter \"", key, "\" is not in the table");
+            MJOLNIR_LOG_ERROR("parameter \"", matrix_.pair_name(id),
+                              "\" is not in the table");
+            matrix_.at(id); // throws std::out_of_range
         }
-        return table_.at(key);
+        return id;
     }
 
     // forwarding functions for clarity...
@@ -92,8 +114,9 @@ class TabulatedLennardJonesAttractivePotential
         return this->derivative(r, this->prepare_params(i, j));
     }
 
-    real_type potential(const real_type r, const pair_parameter_type& p) const noexcept
+    real_type potential(const real_type r, const pair_parameter_type id) const noexcept
     {
+        const auto& p = this->matrix_[id];
         constexpr real_type sixth_root_of_two(1.12246204831);
 
         const real_type sigma   = p.first;
@@ -112,8 +135,9 @@ class TabulatedLennardJonesAttractivePotential
         const real_type sr6 = sr3 * sr3;
         return 4 * epsilon * (sr6 * (sr6 - 1) - coef_at_cutoff_);
     }
-    real_type derivative(const real_type r, const pair_parameter_type& p) const noexcept
+    real_type derivative(const real_type r, const pair_parameter_type id) const noexcept
     {
+        const auto& p = this->matrix_[id];
         constexpr real_type sixth_root_of_two(1.12246204831);
 
         const real_type sigma   = p.first;
@@ -136,13 +160,14 @@ class TabulatedLennardJonesAttractivePotential
 
     real_type max_cutoff_length() const noexcept
     {
-        using value_type = typename table_type::value_type;
-        const real_type max_sigma = std::max_element(
-            this->table_.cbegin(), this->table_.cend(),
-            [](const value_type& lhs, const value_type& rhs) noexcept {
-                return lhs.second.first < rhs.second.first;
-            })->second.first;
-
+        real_type max_sigma(0);
+        for(pair_parameter_type id=0; id<this->matrix_.size(); ++id)
+        {
+            if(this->matrix_.is_defined(id))
+            {
+                max_sigma = std::max(max_sigma, this->matrix_[id].first);
+            }
+        }
         return max_sigma * this->cutoff_ratio_;
     }
 
@@ -206,19 +231,17 @@ class TabulatedLennardJonesAttractivePotential
     // ------------------------------------------------------------------------
     // the following accessers would be used in tests.
 
-    // access to the parameters...
-    std::vector<parameter_type>&       parameters()       noexcept {return parameters_;}
-    std::vector<parameter_type> const& parameters() const noexcept {return parameters_;}
+    // particle index -> type id
+    container_type const& parameters() const noexcept {return matrix_.type_ids();}
 
-    table_type&       table()       noexcept {return table_;}
-    table_type const& table() const noexcept {return table_;}
+    // type-pair id -> {sigma, epsilon}
+    matrix_type const& parameter_matrix() const noexcept {return matrix_;}
 
   private:
 
     real_type cutoff_ratio_;
     real_type coef_at_cutoff_;
-    table_type table_;
-    container_type parameters_;
+    matrix_type matrix_;
     std::vector<std::size_t> participants_;
 
     exclusion_list_type  exclusion_list_;
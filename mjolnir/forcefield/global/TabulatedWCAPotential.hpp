@@ -1,10 +1,10 @@
 #ifndef MJOLNIR_POTENTIAL_GLOBAL_TABULATED_WCA_POTENTIAL_HPP
 #define MJOLNIR_POTENTIAL_GLOBAL_TABULATED_WCA_POTENTIAL_HPP
 #include <mjolnir/core/ExclusionList.hpp>
+#include <mjolnir/forcefield/global/TypePairParameterMatrix.hpp>
 #include <mjolnir/core/System.hpp>
 #include <mjolnir/math/math.hpp>
 #include <mjolnir/util/logger.hpp>
-#include <unordered_map>
 #include <vector>
 #include <algorithm>
 #include <numeric>
@@ -23,10 +23,12 @@ class TabulatedWCAPotential
     using traits_type          = traitsT;
     using real_type            = typename traits_type::real_type;
     using system_type          = System<traits_type>;
-    using parameter_type       = std::string;
-    using pair_parameter_type  = std::pair<real_type, real_type>; // {sigma, epsilon}
+    using table_value_type     = std::pair<real_type, real_type>; // {sigma, epsilon}
+    using matrix_type          = TypePairParameterMatrix<table_value_type>;
+    using parameter_type       = typename matrix_type::type_id_type;
+    using pair_parameter_type  = typename matrix_type::pair_id_type;
     using container_type       = std::vector<parameter_type>;
-    using table_type           = std::unordered_map<std::string, pair_parameter_type>;
+    using table_type           = typename matrix_type::table_type;
 
     // topology stuff
     using topology_type        = Topology;
@@ -41,44 +43,60 @@ class TabulatedWCAPotential
     {
         return real_type(1.12246204831); // pow(2.0, 1.0 / 6.0)
     }
-    static parameter_type default_parameter() noexcept
+    static constexpr parameter_type default_parameter() noexcept
     {
-        return std::string("");
+        return parameter_type(0);
     }
 
   public:
 
-    TabulatedWCAPotential(const real_type /*cutoff_ratio*/, table_type&& table,
+    // type names are already interned into the matrix. parameters contain
+    // pairs of {particle index, type id}.
+    TabulatedWCAPotential(const real_type /*cutoff_ratio*/, matrix_type&& matrix,
         const std::vector<std::pair<std::size_t, parameter_type>>& parameters,
         const std::map<connection_kind_type, std::size_t>&         exclusions,
         ignore_molecule_type ignore_mol, ignore_group_type ignore_grp)
-      : table_(std::move(table)),
+      : matrix_(std::move(matrix)),
         exclusion_list_(exclusions, std::move(ignore_mol), std::move(ignore_grp))
     {
-        this->parameters_  .reserve(parameters.size());
         this->participants_.reserve(parameters.size());
         for(const auto& idxp : parameters)
         {
-            const auto idx = idxp.first;
-            this->participants_.push_back(idx);
-            if(idx >= this->parameters_.size())
-            {
-                this->parameters_.resize(idx+1, default_parameter());
-            }
-            this->parameters_.at(idx) = idxp.second;
+            this->participants_.push_back(idxp.first);
+            this->matrix_.set_particle_type(idxp.first, idxp.second);
+        }
+    }
+    // with type names. it interns the names here.
+    TabulatedWCAPotential(const real_type /*cutoff_ratio*/, const table_type& table,
+        const std::vector<std::pair<std::size_t, std::string>>& parameters,
+        const std::map<connection_kind_type, std::size_t>&      exclusions,
+        ignore_molecule_type ignore_mol, ignore_group_type ignore_grp)
+      : exclusion_list_(exclusions, std::move(ignore_mol), std::move(ignore_grp))
+    {
+        this->participants_.reserve(parameters.size());
+        for(const auto& idxp : parameters)
+        {
+            this->participants_.push_back(idxp.first);
+            this->matrix_.set_particle_type(idxp.first,
+                                            this->matrix_.add_type(idxp.second));
         }
+        this->matrix_.set_table(table);
     }
     ~TabulatedWCAPotential() = default;
 
+    // neighbor lists store only the type-pair id. The values, {sigma, epsilon},
+    // are looked up from the dense matrix while calculating forces.
     pair_parameter_type prepare_params(std::size_t i, std::size_t j) const noexcept
     {
-        const auto key = parameters_[i] + ":" + parameters_[j];
-        if(table_.count(key) == 0)
+        const auto id = matrix_.pair_id(i, j);
+        if(!matrix_.is_defined(id))
         {
             MJOLNIR_GET_DEFAULT_LOGGER();
-            MJOLNIR_LOG_ERROR("parameter \"", key, "\" is not in the table");
+            MJOLNIR_LOG_ERROR("parameter \"", matrix_.pair_name(id),
+                              "\" is not in the table");
+            matrix_.at(id); // throws std::out_of_range
         }
-        return table_.at(key);
+        return id;
     }
 
     // forwarding functions for clarity...
@@ -93,8 +111,9 @@ class TabulatedWCAPotential
         return this->derivative(r, this->prepare_params(i, j));
     }
 
-    real_type potential(const real_type r, const pair_parameter_type& p) const noexcept
+    real_type potential(const real_type r, const pair_parameter_type id) const noexcept
     {
+        const auto& p = this->matrix_[id];
         const real_type sigma = p.first;
         if(sigma * default_cutoff() < r){return 0;}
 
@@ -106,8 +125,9 @@ class TabulatedWCAPotential
         const real_type r12s12 = r6s6 * r6s6;
         return 4 * epsilon * (r12s12 - r6s6 + real_type(0.25));
     }
-    real_type derivative(const real_type r, const pair_parameter_type& p) const noexcept
+    real_type derivative(const real_type r, const pair_parameter_type id) const noexcept
     {
+        const auto& p = this->matrix_[id];
         const real_type sigma = p.first;
         if(sigma * default_cutoff() < r){return 0;}
 
@@ -126,12 +146,14 @@ class TabulatedWCAPotential
 
     real_type max_cutoff_length() const noexcept
     {
-        using value_type = typename table_type::value_type;
-        const real_type max_sigma = std::max_element(
-            this->table_.cbegin(), this->table_.cend(),
-            [](const value_type& lhs, const value_type& rhs) noexcept {
-                return lhs.second.first < rhs.second.first;
-            })->second.first;
+        real_type max_sigma(0);
+        for(pair_parameter_type id=0; id<this->matrix_.size(); ++id)
+        {
+            if(this->matrix_.is_defined(id))
+            {
+                max_sigma = std::max(max_sigma, this->matrix_[id].first);
+            }
+        }
         return max_sigma * this->default_cutoff();
     }
 
@@ -195,15 +217,16 @@ class TabulatedWCAPotential
     // ------------------------------------------------------------------------
     // the following accessers would be used in tests.
 
-    // access to the parameters...
-    std::vector<parameter_type>&       parameters()       noexcept {return parameters_;}
-    std::vector<parameter_type> const& parameters() const noexcept {return parameters_;}
+    // particle index -> type id
+    container_type const& parameters() const noexcept {return matrix_.type_ids();}
+
+    // type-pair id -> {sigma, epsilon}
+    matrix_type const& parameter_matrix() const noexcept {return matrix_;}
 
   private:
 
     real_type coef_at_cutoff_;
-    table_type table_;
-    container_type parameters_;
+    matrix_type matrix_;
     std::vector<std::size_t> participants_;
 
     exclusion_list_type  exclusion_list_;
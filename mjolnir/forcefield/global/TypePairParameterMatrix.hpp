@@ -0,0 +1,241 @@
+#ifndef MJOLNIR_FORCEFIELD_GLOBAL_TYPE_PAIR_PARAMETER_MATRIX_HPP
+#define MJOLNIR_FORCEFIELD_GLOBAL_TYPE_PAIR_PARAMETER_MATRIX_HPP
+#include <mjolnir/util/throw_exception.hpp>
+#include <unordered_map>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace mjolnir
+{
+
+// A dense ntypes x ntypes matrix of pair parameters.
+//
+// Potentials that have only a few kinds of particles (e.g. TabulatedWCA) do
+// not need to store the expanded pair parameter, like {sigma, epsilon}, in
+// each neighbor list entry. Instead, they can store a 32-bit type-pair id,
+// `type_i * ntypes + type_j`, and look the value up from this matrix that is
+// small enough to stay in the cache. It makes neighbor_element 8 bytes.
+//
+// Type names are interned into successive integers in order of appearance.
+// It is normally done once while reading the input (see
+// read_type_pair_parameters), so that no string is touched after that.
+//
+// A global potential can opt into this by
+// - having a TypePairParameterMatrix<value_type> as a member,
+// - defining `pair_parameter_type` as `pair_id_type`,
+// - returning `matrix.pair_id(i, j)` from `prepare_params(i, j)`, and
+// - looking `matrix[id]` up in `potential(r, id)` and `derivative(r, id)`.
+template<typename valueT>
+class TypePairParameterMatrix
+{
+  public:
+    using value_type   = valueT;
+    using type_id_type = std::uint32_t;
+    using pair_id_type = std::uint32_t;
+    using table_type   = std::unordered_map<std::string, value_type>; // "A:B"
+
+  public:
+
+    TypePairParameterMatrix()  = default;
+    ~TypePairParameterMatrix() = default;
+    TypePairParameterMatrix(const TypePairParameterMatrix&) = default;
+    TypePairParameterMatrix(TypePairParameterMatrix&&)      = default;
+    TypePairParameterMatrix& operator=(const TypePairParameterMatrix&) = default;
+    TypePairParameterMatrix& operator=(TypePairParameterMatrix&&)      = default;
+
+    // intern names of particles and expand the table into a dense matrix.
+    // combinations that are not in the table are kept undefined. Those are
+    // reported when a pair of them is actually looked up.
+    void build(const std::vector<std::string>& names, const table_type& table)
+    {
+        this->clear();
+        for(std::size_t i=0; i<names.size(); ++i)
+        {
+            this->set_particle_type(i, this->add_type(names[i]));
+        }
+
+        this->set_table(table);
+        return;
+    }
+
+    // set values of all the pairs of known types found in the table.
+    void set_table(const table_type& table)
+    {
+        const std::size_t ntypes = this->type_names_.size();
+        for(std::size_t i=0; i<ntypes; ++i)
+        {
+            for(std::size_t j=0; j<ntypes; ++j)
+            {
+                const auto key = type_names_[i] + ":" + type_names_[j];
+                const auto found = table.find(key);
+                if(found != table.end())
+                {
+                    this->set(static_cast<type_id_type>(i),
+                              static_cast<type_id_type>(j), found->second);
+                }
+            }
+        }
+        return;
+    }
+
+    void clear()
+    {
+        this->ids_       .clear();
+        this->type_names_.clear();
+        this->type_ids_  .clear();
+        this->values_    .clear();
+        this->defined_   .clear();
+        return;
+    }
+
+    // returns the id of the name. If it is new, assigns the next id.
+    type_id_type add_type(const std::string& name)
+    {
+        const auto found = this->ids_.find(name);
+        if(found != this->ids_.end())
+        {
+            return found->second;
+        }
+        const std::size_t ntypes = this->type_names_.size() + 1;
+        if(ntypes * ntypes > std::numeric_limits<pair_id_type>::max())
+        {
+            throw_exception<std::out_of_range>("mjolnir::TypePairParameterMatrix: "
+                "too many types (", ntypes, ") to be encoded in 32-bit id");
+        }
+        const auto id = static_cast<type_id_type>(this->type_names_.size());
+        this->ids_.emplace(name, id);
+        this->type_names_.push_back(name);
+        this->reshape(ntypes);
+        return id;
+    }
+    bool has_type(const std::string& name) const
+    {
+        return this->ids_.count(name) != 0;
+    }
+    type_id_type type_id(const std::string& name) const
+    {
+        const auto found = this->ids_.find(name);
+        if(found == this->ids_.end())
+        {
+            throw_exception<std::out_of_range>("mjolnir::TypePairParameterMatrix:"
+                " type \"", name, "\" is not defined");
+        }
+        return found->second;
+    }
+
+    // set a value for a pair of types. It does not set (j, i) automatically.
+    void set(const type_id_type i, const type_id_type j, const value_type& v)
+    {
+        const std::size_t ntypes = this->type_names_.size();
+        if(ntypes <= i || ntypes <= j)
+        {
+            throw_exception<std::out_of_range>("mjolnir::TypePairParameterMatrix:"
+                " type id (", i, ", ", j, ") exceeds the number of types (",
+                ntypes, ")");
+        }
+        this->values_ [i * ntypes + j] = v;
+        this->defined_[i * ntypes + j] = true;
+        return;
+    }
+
+    // assign a type to a particle
+    void set_particle_type(const std::size_t idx, const type_id_type type)
+    {
+        if(this->type_names_.size() <= type)
+        {
+            throw_exception<std::out_of_range>("mjolnir::TypePairParameterMatrix:"
+                " type id (", type, ") exceeds the number of types (",
+                this->type_names_.size(), ")");
+        }
+        if(this->type_ids_.size() <= idx)
+        {
+            this->type_ids_.resize(idx+1, 0);
+        }
+        this->type_ids_[idx] = type;
+        return;
+    }
+
+    // type-pair id of types i and j.
+    pair_id_type pair_id_of_types(const type_id_type i, const type_id_type j) const noexcept
+    {
+        return i * static_cast<pair_id_type>(type_names_.size()) + j;
+    }
+    // type-pair id of particles i and j.
+    pair_id_type pair_id(const std::size_t i, const std::size_t j) const noexcept
+    {
+        return type_ids_[i] * static_cast<pair_id_type>(type_names_.size()) +
+               type_ids_[j];
+    }
+
+    bool is_defined(const pair_id_type id) const noexcept {return defined_[id];}
+
+    value_type const& operator[](const pair_id_type id) const noexcept
+    {
+        return values_[id];
+    }
+    value_type const& at(const pair_id_type id) const
+    {
+        if(id >= values_.size() || !defined_.at(id))
+        {
+            throw_exception<std::out_of_range>("mjolnir::TypePairParameterMatrix:"
+                " parameter \"", this->pair_name(id), "\" is not defined");
+        }
+        return values_[id];
+    }
+
+    // "A:B"
+    std::string pair_name(const pair_id_type id) const
+    {
+        const std::size_t ntypes = type_names_.size();
+        if(ntypes == 0 || ntypes * ntypes <= id) {return "(unknown)";}
+        return type_names_[id / ntypes] + ":" + type_names_[id % ntypes];
+    }
+
+    // ntypes * ntypes. pair ids are in [0, size()).
+    std::size_t size() const noexcept {return values_.size();}
+
+    std::size_t number_of_types() const noexcept {return type_names_.size();}
+    std::vector<std::string>  const& type_names() const noexcept {return type_names_;}
+    std::vector<type_id_type> const& type_ids()   const noexcept {return type_ids_;}
+
+    type_id_type       type_of     (const std::size_t idx) const {return type_ids_.at(idx);}
+    std::string const& type_name_of(const std::size_t idx) const
+    {
+        return type_names_.at(type_ids_.at(idx));
+    }
+
+  private:
+
+    // keep the values while adding a new type (ntypes-1 -> ntypes)
+    void reshape(const std::size_t ntypes)
+    {
+        const std::size_t prev = ntypes - 1;
+        std::vector<value_type> values (ntypes * ntypes, value_type{});
+        std::vector<bool>       defined(ntypes * ntypes, false);
+        for(std::size_t i=0; i<prev; ++i)
+        {
+            for(std::size_t j=0; j<prev; ++j)
+            {
+                values [i * ntypes + j] = this->values_ [i * prev + j];
+                defined[i * ntypes + j] = this->defined_[i * prev + j];
+            }
+        }
+        this->values_  = std::move(values);
+        this->defined_ = std::move(defined);
+        return;
+    }
+
+  private:
+
+    std::unordered_map<std::string, type_id_type> ids_; // name -> type_id
+    std::vector<std::string>  type_names_; // type_id -> name
+    std::vector<type_id_type> type_ids_;   // particle index -> type_id
+    std::vector<value_type>   values_;     // pair_id -> value
+    std::vector<bool>         defined_;    // pair_id -> defined or not
+};
+
+} // mjolnir
+#endif // MJOLNIR_FORCEFIELD_GLOBAL_TYPE_PAIR_PARAMETER_MATRIX_HPP
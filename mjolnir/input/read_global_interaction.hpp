@@ -22,6 +22,28 @@ namespace mjolnir
 // global interaction
 // ----------------------------------------------------------------------------
 
+// It reads `spline = {min_distance = 2.0, tolerance = 1e-5}`. If it is given,
+// the potential is tabulated by cubic splines. Otherwise, the potential
+// function is evaluated for each pair.
+template<typename traitsT, typename potentialT>
+SplinePairTable<potentialT> read_spline_pair_table(const toml::value& global)
+{
+    MJOLNIR_GET_DEFAULT_LOGGER();
+    MJOLNIR_LOG_FUNCTION();
+    using real_type = typename traitsT::real_type;
+
+    if(!global.contains("spline"))
+    {
+        return SplinePairTable<potentialT>{};
+    }
+    const auto& spline = toml::find(global, "spline");
+    const auto rmin = toml::find<real_type>(spline, "min_distance");
+    const auto tol  = toml::find_or<real_type>(spline, "tolerance", 1e-5);
+    MJOLNIR_LOG_NOTICE("-- potential is tabulated from ", rmin,
+                       " with relative tolerance ", tol);
+    return SplinePairTable<potentialT>(rmin, tol);
+}
+
 template<typename traitsT>
 std::unique_ptr<GlobalInteractionBase<traitsT>>
 read_global_pair_interaction(const toml::value& global)
@@ -49,7 +71,8 @@ read_global_pair_interaction(const toml::value& global)
 
         return make_unique<interaction_t>(
             read_inverse_power_potential<traitsT>(global),
-            read_spatial_partition<traitsT, potential_t>(global));
+            read_spatial_partition<traitsT, potential_t>(global),
+            read_spline_pair_table<traitsT, potential_t>(global));
     }
     else if(potential == "HardCoreExcludedVolume")
     {
@@ -59,7 +82,8 @@ read_global_pair_interaction(const toml::value& global)
 
         return make_unique<interaction_t>(
             read_hard_core_excluded_volume_potential<traitsT>(global),
-            read_spatial_partition<traitsT, potential_t>(global));
+            read_spatial_partition<traitsT, potential_t>(global),
+            read_spline_pair_table<traitsT, potential_t>(global));
     }
     else if(potential == "DebyeHuckel")
     {
@@ -69,7 +93,8 @@ read_global_pair_interaction(const toml::value& global)
 
         return make_unique<interaction_t>(
             read_debye_huckel_potential<traitsT>(global),
-            read_spatial_partition<traitsT, potential_t>(global));
+            read_spatial_partition<traitsT, potential_t>(global),
+            read_spline_pair_table<traitsT, potential_t>(global));
     }
     else if(potential == "LennardJones")
     {
@@ -101,7 +126,8 @@ read_global_pair_interaction(const toml::value& global)
 
             return make_unique<interaction_t>(
                 read_tabulated_lennard_jones_attractive_potential<traitsT>(global),
-                read_spatial_partition<traitsT, potential_t>(global));
+                read_spatial_partition<traitsT, potential_t>(global),
+                read_spline_pair_table<traitsT, potential_t>(global));
         }
         else
         {
@@ -110,7 +136,8 @@ read_global_pair_interaction(const toml::value& global)
 
             return make_unique<interaction_t>(
                 read_lennard_jones_attractive_potential<traitsT>(global),
-                read_spatial_partition<traitsT, potential_t>(global));
+                read_spatial_partition<traitsT, potential_t>(global),
+                read_spline_pair_table<traitsT, potential_t>(global));
         }
     }
     else if(potential == "WCA")
@@ -123,7 +150,8 @@ read_global_pair_interaction(const toml::value& global)
 
             return make_unique<interaction_t>(
                 read_tabulated_wca_potential<traitsT>(global),
-                read_spatial_partition<traitsT, potential_t>(global));
+                read_spatial_partition<traitsT, potential_t>(global),
+                read_spline_pair_table<traitsT, potential_t>(global));
         }
         else
         {
@@ -132,7 +160,8 @@ read_global_pair_interaction(const toml::value& global)
 
             return make_unique<interaction_t>(
                 read_wca_potential<traitsT>(global),
-                read_spatial_partition<traitsT, potential_t>(global));
+                read_spatial_partition<traitsT, potential_t>(global),
+                read_spline_pair_table<traitsT, potential_t>(global));
         }
     }
     else if(potential == "3SPN2ExcludedVolume")
@@ -143,7 +172,8 @@ read_global_pair_interaction(const toml::value& global)
 
         return make_unique<interaction_t>(
             read_3spn2_excluded_volume_potential<traitsT>(global),
-            read_spatial_partition<traitsT, potential_t>(global));
+            read_spatial_partition<traitsT, potential_t>(global),
+            read_spline_pair_table<traitsT, potential_t>(global));
     }
     else if(potential == "iSoLFAttractive")
     {
@@ -153,7 +183,8 @@ read_global_pair_interaction(const toml::value& global)
 
         return make_unique<interaction_t>(
             read_isolf_potential<traitsT>(global),
-            read_spatial_partition<traitsT, potential_t>(global));
+            read_spatial_partition<traitsT, potential_t>(global),
+            read_spline_pair_table<traitsT, potential_t>(global));
     }
     else
     {
@@ -442,77 +442,109 @@ read_lennard_jones_attractive_potential(const toml::value& global)
             read_ignored_molecule(global), read_ignored_group(global));
 }
 
-template<typename traitsT>
-TabulatedLennardJonesAttractivePotential<traitsT>
-read_tabulated_lennard_jones_attractive_potential(const toml::value& global)
+//
+// reads `table` and `parameters` of a potential that depends only on the types
+// of particles into TypePairParameterMatrix.
+// ```toml
+// table.A.A = {sigma = 1.0, epsilon = 2.0}
+// table.A.B = {sigma = 1.0, epsilon = 2.0} # B.A will be the same
+// table.B.B = {sigma = 1.0, epsilon = 2.0}
+// parameters = [
+//     {index = 0, name = "A"},
+//     {index = 1, name = "B"},
+// ]
+// ```
+// Type names are interned here, so the potential never handles strings.
+// `read_value` converts each table element into matrix_type::value_type.
+// It returns a list of {particle index, type id}.
+//
+template<typename matrixT, typename readerT>
+std::vector<std::pair<std::size_t, typename matrixT::type_id_type>>
+read_type_pair_parameters(const toml::value& global, const toml::value& env,
+        const std::string& potential_name, matrixT& matrix, readerT read_value)
 {
     MJOLNIR_GET_DEFAULT_LOGGER();
     MJOLNIR_LOG_FUNCTION();
-    using potential_type      = TabulatedLennardJonesAttractivePotential<traitsT>;
-    using real_type           = typename potential_type::real_type;
-    using parameter_type      = typename potential_type::parameter_type;
-    using pair_parameter_type = typename potential_type::pair_parameter_type;
-
-    const auto& env = global.contains("env") ? global.at("env") : toml::value{};
-
-    const real_type cutoff = toml::find_or<real_type>(global, "cutoff",
-            potential_type::default_cutoff());
-    MJOLNIR_LOG_INFO("relative cutoff = ", cutoff);
+    using type_id_type = typename matrixT::type_id_type;
 
-    // [[forcefield.global]]
-    // interaciton = "Pair"
-    // potential = "AttractiveLennardJones"
-    // table.A.A = {sigma = 1.0, epsilon = 2.0}
-    // table.A.B = {sigma = 1.0, epsilon = 2.0} # B.A will be the same
-    // table.B.B = {sigma = 1.0, epsilon = 2.0}
-    // parameters = [
-    //     {index = 0, name = "A"},
-    //     {index = 1, name = "A"},
-    //     {index = 2, name = "B"},
-    //     {index = 3, name = "B"},
-    // ]
-    std::unordered_map<std::string, pair_parameter_type> table;
+    matrix.clear();
     for(const auto& kv : toml::find<toml::table>(global, "table"))
     {
-        const auto& p1 = kv.first;
+        const auto t1 = matrix.add_type(kv.first);
         for(const auto& kv2 : toml::get<toml::table>(kv.second))
         {
-            const auto& p2  = kv2.first;
-            const auto para = std::make_pair(
-                    find_parameter<real_type>(kv2.second, env, "sigma"),
-                    find_parameter<real_type>(kv2.second, env, "epsilon"));
-
-            const auto key = p1 + std::string(":") + p2;
-            table[key] = para;
-            if(p1 != p2)
+            const auto t2   = matrix.add_type(kv2.first);
+            const auto para = read_value(kv2.second, env);
+
+            if(t1 != t2 && matrix.is_defined(matrix.pair_id_of_types(t2, t1)))
             {
-                const auto key_opposite = p2 + std::string(":") + p1;
-                if(table.count(key_opposite) != 0)
-                {
-                    MJOLNIR_LOG_WARN("TabulatedLJ does not distinguish two parameters, A.B and B.A.");
-                }
-                table[key_opposite] = para;
+                MJOLNIR_LOG_WARN(potential_name, " does not distinguish two "
+                                 "pair-parameters, A.B and B.A.");
             }
+            matrix.set(t1, t2, para);
+            matrix.set(t2, t1, para);
         }
     }
+    MJOLNIR_LOG_INFO(matrix.number_of_types(), " types are found in the table");
 
     const auto& ps = toml::find<toml::array>(global, "parameters");
     MJOLNIR_LOG_INFO(ps.size(), " parameters are found");
 
-    std::vector<std::pair<std::size_t, parameter_type>> params;
+    std::vector<std::pair<std::size_t, type_id_type>> params;
     params.reserve(ps.size());
     for(const auto& param : ps)
     {
         const auto idx  = find_parameter   <std::size_t >(param, env, "index") +
                           find_parameter_or<std::int64_t>(param, env, "offset", 0);
         const auto name = toml::find<std::string>(param, "name");
-
-        params.emplace_back(idx, name);
+        if(!matrix.has_type(name))
+        {
+            MJOLNIR_LOG_WARN("type \"", name, "\" of particle ", idx,
+                             " does not appear in the table");
+        }
+        params.emplace_back(idx, matrix.add_type(name));
         MJOLNIR_LOG_INFO("idx = ", idx, ", name = ", name);
     }
     check_parameter_overlap(env, ps, params);
+    return params;
+}
 
-    return potential_type(cutoff, std::move(table), std::move(params),
+template<typename traitsT>
+TabulatedLennardJonesAttractivePotential<traitsT>
+read_tabulated_lennard_jones_attractive_potential(const toml::value& global)
+{
+    MJOLNIR_GET_DEFAULT_LOGGER();
+    MJOLNIR_LOG_FUNCTION();
+    using potential_type      = TabulatedLennardJonesAttractivePotential<traitsT>;
+    using real_type           = typename potential_type::real_type;
+    using matrix_type         = typename potential_type::matrix_type;
+    using table_value_type    = typename potential_type::table_value_type;
+
+    const auto& env = global.contains("env") ? global.at("env") : toml::value{};
+
+    const real_type cutoff = toml::find_or<real_type>(global, "cutoff",
+            potential_type::default_cutoff());
+    MJOLNIR_LOG_INFO("relative cutoff = ", cutoff);
+
+    // [[forcefield.global]]
+    // interaciton = "Pair"
+    // table.A.A = {sigma = 1.0, epsilon = 2.0}
+    // table.A.B = {sigma = 1.0, epsilon = 2.0} # B.A will be the same
+    // table.B.B = {sigma = 1.0, epsilon = 2.0}
+    // parameters = [
+    //     {index = 0, name = "A"},
+    //     {index = 1, name = "A"},
+    //     {index = 2, name = "B"},
+    //     {index = 3, name = "B"},
+    // ]
+    matrix_type matrix;
+    const auto params = read_type_pair_parameters(global, env, "TabulatedLJ", matrix,
+        [](const toml::value& v, const toml::value& e) -> table_value_type {
+            return table_value_type(find_parameter<real_type>(v, e, "sigma"),
+                                    find_parameter<real_type>(v, e, "epsilon"));
+        });
+
+    return potential_type(cutoff, std::move(matrix), params,
             read_ignore_particles_within(global),
             read_ignored_molecule(global), read_ignored_group(global));
 }
@@ -567,8 +599,8 @@ read_tabulated_wca_potential(const toml::value& global)
     MJOLNIR_LOG_FUNCTION();
     using potential_type      = TabulatedWCAPotential<traitsT>;
     using real_type           = typename potential_type::real_type;
-    using parameter_type      = typename potential_type::parameter_type;
-    using pair_parameter_type = typename potential_type::pair_parameter_type;
+    using matrix_type         = typename potential_type::matrix_type;
+    using table_value_type    = typename potential_type::table_value_type;
 
     const auto& env = global.contains("env") ? global.at("env") : toml::value{};
 
@@ -580,7 +612,6 @@ read_tabulated_wca_potential(const toml::value& global)
 
     // [[forcefield.global]]
     // interaciton = "Pair"
-    // potential = "AttractiveLennardJones"
     // table.A.A = {sigma = 1.0, epsilon = 2.0}
     // table.A.B = {sigma = 1.0, epsilon = 2.0} # B.A will be the same
     // table.B.B = {sigma = 1.0, epsilon = 2.0}
@@ -590,50 +621,14 @@ read_tabulated_wca_potential(const toml::value& global)
     //     {index = 2, name = "B"},
     //     {index = 3, name = "B"},
     // ]
-    std::unordered_map<std::string, pair_parameter_type> table;
-    for(const auto& kv : toml::find<toml::table>(global, "table"))
-    {
-        const auto& p1 = kv.first;
-        for(const auto& kv2 : toml::get<toml::table>(kv.second))
-        {
-            const auto& p2  = kv2.first;
-            const auto para = std::make_pair(
-                    find_parameter<real_type>(kv2.second, env, "sigma"),
-                    find_parameter<real_type>(kv2.second, env, "epsilon"));
-
-            const auto key = p1 + std::string(":") + p2;
-            table[key] = para;
-            if(p1 != p2)
-            {
-                const auto key_opposite = p2 + std::string(":") + p1;
-                if(table.count(key_opposite) != 0)
-                {
-                    MJOLNIR_LOG_WARN("WCA does not distinguish two pair-parameters, A.B and B.A.");
-                }
-                table[key_opposite] = para;
-            }
-        }
-    }
-
-    const auto& ps = toml::find<toml::array>(global, "parameters");
-    MJOLNIR_LOG_INFO(ps.size(), " parameters are found");
-
-    std::vector<std::pair<std::size_t, parameter_type>> params;
-    params.reserve(ps.size());
-    for(const auto& param : ps)
-    {
-        const auto idx  = find_parameter   <std::size_t>(param, env, "index") +
-                          find_parameter_or<std::size_t>(param, env, "offset", 0);
-        const auto name = toml::find<std::string>(param, "name");
-
-        params.emplace_back(idx, name);
-        MJOLNIR_LOG_INFO("idx = ", idx, ", name = ", name);
-    }
-
-    check_parameter_overlap(env, ps, params);
-
-    return potential_type(potential_type::default_cutoff(),
-            std::move(table), std::move(params),
+    matrix_type matrix;
+    const auto params = read_type_pair_parameters(global, env, "WCA", matrix,
+        [](const toml::value& v, const toml::value& e) -> table_value_type {
+            return table_value_type(find_parameter<real_type>(v, e, "sigma"),
+                                    find_parameter<real_type>(v, e, "epsilon"));
+        });
+
+    return potential_type(potential_type::default_cutoff(), std::move(matrix), params,
             read_ignore_particles_within(global),
             read_ignored_molecule(global), read_ignored_group(global));
 }
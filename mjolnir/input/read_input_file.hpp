@@ -121,6 +121,13 @@ read_precision(const toml::value& root, const toml::value& simulator)
         MJOLNIR_LOG_NOTICE("precision is double");
         return read_boundary<double>(root, simulator);
     }
+    if(prec == "mixed")
+    {
+        // positions, forces, and integrators are in double. pair kernels
+        // are evaluated in float (see read_system and BatchedPairKernel).
+        MJOLNIR_LOG_NOTICE("precision is mixed (double with float pair kernels)");
+        return read_boundary<double>(root, simulator);
+    }
 #endif
 
 #ifndef MJOLNIR_WITHOUT_SINGLE_PRECISION
@@ -137,6 +144,7 @@ read_precision(const toml::value& root, const toml::value& simulator)
         "expected value is one of the following."
 #ifndef MJOLNIR_WITHOUT_DOUBLE_PRECISION
         , "- \"double\": 64 bit floating-point"
+        , "- \"mixed\" : 64 bit floating-point with 32 bit pair kernels"
 #endif
 #ifndef MJOLNIR_WITHOUT_SINGLE_PRECISION
         , "- \"float\" : 32 bit floating-point"
@@ -45,8 +45,29 @@ read_velocity_verlet_integrator(const toml::value& simulator)
     const real_type delta_t = toml::find<real_type>(simulator, "delta_t");
     MJOLNIR_LOG_INFO("delta_t = ", delta_t);
 
+    // [simulator.integrator]
+    // global_interval = 2 # r-RESPA. update global forcefields every 2 steps
+    std::size_t global_interval = 1;
+    if(simulator.contains("integrator"))
+    {
+        const auto& integrator = toml::find(simulator, "integrator");
+        check_keys_available(integrator,
+                {"type"_s, "remove"_s, "global_interval"_s});
+
+        global_interval = toml::find_or<std::size_t>(
+                integrator, "global_interval", 1);
+        if(global_interval == 0)
+        {
+            throw_exception<std::runtime_error>(toml::format_error("[error] "
+                "mjolnir::read_velocity_verlet_integrator: invalid interval",
+                integrator.at("global_interval"), "here", {
+                "global_interval should be a positive integer."
+                }));
+        }
+        MJOLNIR_LOG_INFO("global_interval = ", global_interval);
+    }
     return VelocityVerletIntegrator<traitsT>(delta_t,
-            read_system_motion_remover<traitsT>(simulator));
+            read_system_motion_remover<traitsT>(simulator), global_interval);
 }
 
 template<typename traitsT>
@@ -7,10 +7,10 @@
 namespace mjolnir
 {
 
-template void add_observer<SimulatorTraits<double, UnlimitedBoundary>       >(ObserverContainer<SimulatorTraits<double, UnlimitedBoundary>       >& observers, const toml::value& format, const std::string& file_prefix);
-template void add_observer<SimulatorTraits<float,  UnlimitedBoundary>       >(ObserverContainer<SimulatorTraits<float,  UnlimitedBoundary>       >& observers, const toml::value& format, const std::string& file_prefix);
-template void add_observer<SimulatorTraits<double, CuboidalPeriodicBoundary>>(ObserverContainer<SimulatorTraits<double, CuboidalPeriodicBoundary>>& observers, const toml::value& format, const std::string& file_prefix);
-template void add_observer<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(ObserverContainer<SimulatorTraits<float,  CuboidalPeriodicBoundary>>& observers, const toml::value& format, const std::string& file_prefix);
+template void add_observer<SimulatorTraits<double, UnlimitedBoundary>       >(ObserverContainer<SimulatorTraits<double, UnlimitedBoundary>       >& observers, const toml::value& format, const std::string& file_prefix, const std::size_t flush_interval, const std::size_t fsync_interval, const std::shared_ptr<BackgroundWorker>& worker);
+template void add_observer<SimulatorTraits<float,  UnlimitedBoundary>       >(ObserverContainer<SimulatorTraits<float,  UnlimitedBoundary>       >& observers, const toml::value& format, const std::string& file_prefix, const std::size_t flush_interval, const std::size_t fsync_interval, const std::shared_ptr<BackgroundWorker>& worker);
+template void add_observer<SimulatorTraits<double, CuboidalPeriodicBoundary>>(ObserverContainer<SimulatorTraits<double, CuboidalPeriodicBoundary>>& observers, const toml::value& format, const std::string& file_prefix, const std::size_t flush_interval, const std::size_t fsync_interval, const std::shared_ptr<BackgroundWorker>& worker);
+template void add_observer<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(ObserverContainer<SimulatorTraits<float,  CuboidalPeriodicBoundary>>& observers, const toml::value& format, const std::string& file_prefix, const std::size_t flush_interval, const std::size_t fsync_interval, const std::shared_ptr<BackgroundWorker>& worker);
 
 template ObserverContainer<SimulatorTraits<double, UnlimitedBoundary>       > read_observer<SimulatorTraits<double, UnlimitedBoundary>       >(const toml::value& root);
 template ObserverContainer<SimulatorTraits<float,  UnlimitedBoundary>       > read_observer<SimulatorTraits<float,  UnlimitedBoundary>       >(const toml::value& root);
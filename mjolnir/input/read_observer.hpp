@@ -15,7 +15,9 @@ namespace mjolnir
 
 template<typename traitsT>
 void add_observer(ObserverContainer<traitsT>& observers,
-                  const toml::value& format, const std::string& file_prefix)
+                  const toml::value& format, const std::string& file_prefix,
+                  const std::size_t flush_interval, const std::size_t fsync_interval,
+                  const std::shared_ptr<BackgroundWorker>& worker)
 {
     MJOLNIR_GET_DEFAULT_LOGGER();
     MJOLNIR_LOG_FUNCTION();
@@ -29,21 +31,24 @@ void add_observer(ObserverContainer<traitsT>& observers,
     {
         using observer_type = XYZObserver<traitsT>;
         MJOLNIR_LOG_NOTICE("output xyz format.");
-        observers.push_back(make_unique<observer_type>(file_prefix));
+        observers.push_back(make_unique<observer_type>(
+                    file_prefix, flush_interval, fsync_interval, worker));
         return;
     }
     else if(format.as_string() == "dcd")
     {
         using observer_type = DCDObserver<traitsT>;
         MJOLNIR_LOG_NOTICE("output dcd format.");
-        observers.push_back(make_unique<observer_type>(file_prefix));
+        observers.push_back(make_unique<observer_type>(
+                    file_prefix, flush_interval, fsync_interval, worker));
         return;
     }
     else if(format.as_string() == "trr")
     {
         using observer_type = TRRObserver<traitsT>;
         MJOLNIR_LOG_NOTICE("output trr format.");
-        observers.push_back(make_unique<observer_type>(file_prefix));
+        observers.push_back(make_unique<observer_type>(
+                    file_prefix, flush_interval, fsync_interval, worker));
         return;
     }
     else
@@ -81,22 +86,66 @@ read_observer(const toml::value& root)
 
     ObserverContainer<traitsT> observers(progress_bar_activated);
 
+    // observers keep their files open and write buffered frames at once.
+    // frames are written every `flush_interval` outputs, and fsync is called
+    // after `fsync_interval` frames are written (0 means never).
+    const auto flush_interval =
+        toml::find_or<std::size_t>(output, "flush_interval", 1);
+    const auto fsync_interval =
+        toml::find_or<std::size_t>(output, "fsync_interval", 0);
+    MJOLNIR_LOG_INFO("flush interval = ", flush_interval, " frames");
+    MJOLNIR_LOG_INFO("fsync interval = ", fsync_interval, " frames");
+    if(flush_interval == 0)
+    {
+        throw_exception<std::runtime_error>(toml::format_error("[error] "
+            "mjolnir::read_observer: flush_interval should be positive",
+            toml::find(output, "flush_interval"), "here"));
+    }
+
+    // If `async` is true, frames are written by a background thread while the
+    // simulation continues. Each observer can have 2 frames in the queue.
+    std::shared_ptr<BackgroundWorker> worker(nullptr);
+    if(toml::find_or<bool>(output, "async", false))
+    {
+        const auto& format = toml::find(output, "format");
+        const std::size_t num_observers = 1 /* energy */ +
+            (format.is_array() ? format.as_array().size() : 1);
+
+        MJOLNIR_LOG_NOTICE("output files are written in the background.");
+        worker = std::make_shared<BackgroundWorker>(2 * num_observers);
+    }
+
     const auto& format = toml::find(output, "format");
 
     if(format.is_string())
     {
-        add_observer(observers, format, file_prefix);
+        add_observer(observers, format, file_prefix,
+                     flush_interval, fsync_interval, worker);
     }
     else if(format.is_array())
     {
         for(const auto& fmt : format.as_array())
         {
-            add_observer(observers, fmt, file_prefix);
+            add_observer(observers, fmt, file_prefix,
+                         flush_interval, fsync_interval, worker);
         }
     }
 
+    // If `profile` is true, the time spent in each interaction, neighbor list,
+    // integrator and observer is appended to the energy file.
+    const bool output_profile = toml::find_or<bool>(output, "profile", false);
+#ifndef MJOLNIR_WITH_PROFILER
+    if(output_profile)
+    {
+        MJOLNIR_LOG_WARN("mjolnir is compiled without profiler. "
+                         "To output profiling results, use -DUSE_PROFILER=ON.");
+    }
+#endif
+
     // Energy is always written to "prefix.ene".
-    observers.push_back(make_unique<EnergyObserver<traitsT>>(file_prefix));
+    observers.push_back(make_unique<EnergyObserver<traitsT>>(
+                file_prefix, flush_interval, fsync_interval, worker,
+                output_profile));
     return observers;
 }
 
@@ -108,10 +157,10 @@ read_observer(const toml::value& root)
 
 namespace mjolnir
 {
-extern template void add_observer<SimulatorTraits<double, UnlimitedBoundary>       >(ObserverContainer<SimulatorTraits<double, UnlimitedBoundary>       >& observers, const toml::value& format, const std::string& file_prefix);
-extern template void add_observer<SimulatorTraits<float,  UnlimitedBoundary>       >(ObserverContainer<SimulatorTraits<float,  UnlimitedBoundary>       >& observers, const toml::value& format, const std::string& file_prefix);
-extern template void add_observer<SimulatorTraits<double, CuboidalPeriodicBoundary>>(ObserverContainer<SimulatorTraits<double, CuboidalPeriodicBoundary>>& observers, const toml::value& format, const std::string& file_prefix);
-extern template void add_observer<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(ObserverContainer<SimulatorTraits<float,  CuboidalPeriodicBoundary>>& observers, const toml::value& format, const std::string& file_prefix);
+extern template void add_observer<SimulatorTraits<double, UnlimitedBoundary>       >(ObserverContainer<SimulatorTraits<double, UnlimitedBoundary>       >& observers, const toml::value& format, const std::string& file_prefix, const std::size_t flush_interval, const std::size_t fsync_interval, const std::shared_ptr<BackgroundWorker>& worker);
+extern template void add_observer<SimulatorTraits<float,  UnlimitedBoundary>       >(ObserverContainer<SimulatorTraits<float,  UnlimitedBoundary>       >& observers, const toml::value& format, const std::string& file_prefix, const std::size_t flush_interval, const std::size_t fsync_interval, const std::shared_ptr<BackgroundWorker>& worker);
+extern template void add_observer<SimulatorTraits<double, CuboidalPeriodicBoundary>>(ObserverContainer<SimulatorTraits<double, CuboidalPeriodicBoundary>>& observers, const toml::value& format, const std::string& file_prefix, const std::size_t flush_interval, const std::size_t fsync_interval, const std::shared_ptr<BackgroundWorker>& worker);
+extern template void add_observer<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(ObserverContainer<SimulatorTraits<float,  CuboidalPeriodicBoundary>>& observers, const toml::value& format, const std::string& file_prefix, const std::size_t flush_interval, const std::size_t fsync_interval, const std::shared_ptr<BackgroundWorker>& worker);
 
 extern template ObserverContainer<SimulatorTraits<double, UnlimitedBoundary>       > read_observer<SimulatorTraits<double, UnlimitedBoundary       >>(const toml::value& data);
 extern template ObserverContainer<SimulatorTraits<float,  UnlimitedBoundary>       > read_observer<SimulatorTraits<float,  UnlimitedBoundary       >>(const toml::value& data);
@@ -51,6 +51,22 @@ template std::unique_ptr<SimulatorBase> read_steepest_descent_simulator<Simulato
 template std::unique_ptr<SimulatorBase> read_steepest_descent_simulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
 template std::unique_ptr<SimulatorBase> read_steepest_descent_simulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
 
+// ----------------------------------------------------------------------------
+// read_fire_simulator
+
+template std::unique_ptr<SimulatorBase> read_fire_simulator<SimulatorTraits<double, UnlimitedBoundary>       >(const toml::value&, const toml::value&);
+template std::unique_ptr<SimulatorBase> read_fire_simulator<SimulatorTraits<float,  UnlimitedBoundary>       >(const toml::value&, const toml::value&);
+template std::unique_ptr<SimulatorBase> read_fire_simulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
+template std::unique_ptr<SimulatorBase> read_fire_simulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
+
+// ----------------------------------------------------------------------------
+// read_lbfgs_simulator
+
+template std::unique_ptr<SimulatorBase> read_lbfgs_simulator<SimulatorTraits<double, UnlimitedBoundary>       >(const toml::value&, const toml::value&);
+template std::unique_ptr<SimulatorBase> read_lbfgs_simulator<SimulatorTraits<float,  UnlimitedBoundary>       >(const toml::value&, const toml::value&);
+template std::unique_ptr<SimulatorBase> read_lbfgs_simulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
+template std::unique_ptr<SimulatorBase> read_lbfgs_simulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
+
 // ----------------------------------------------------------------------------
 // read_switching_forcefield_simulator
 
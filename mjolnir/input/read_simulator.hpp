@@ -3,6 +3,8 @@
 #include <extlib/toml/toml.hpp>
 #include <mjolnir/core/MolecularDynamicsSimulator.hpp>
 #include <mjolnir/core/SteepestDescentSimulator.hpp>
+#include <mjolnir/core/FIRESimulator.hpp>
+#include <mjolnir/core/LBFGSSimulator.hpp>
 #include <mjolnir/core/SimulatedAnnealingSimulator.hpp>
 #include <mjolnir/core/SwitchingForceFieldSimulator.hpp>
 #include <mjolnir/core/EnergyCalculationSimulator.hpp>
@@ -28,7 +30,7 @@ read_molecular_dynamics_simulator(
     MJOLNIR_LOG_FUNCTION();
 
     check_keys_available(simulator, {"type"_s, "boundary_type"_s, "precision"_s,
-        "parallelism"_s, "seed"_s, "total_step"_s, "save_step"_s, "checkpoint_step"_s,
+        "parallelism"_s, "force_reduction"_s, "seed"_s, "total_step"_s, "save_step"_s, "checkpoint_step"_s,
         "delta_t"_s, "integrator"_s, "forcefields"_s, "env"_s});
 
     const auto tstep = toml::find<std::size_t>(simulator, "total_step");
@@ -61,7 +63,7 @@ read_steepest_descent_simulator(
     using simulator_type = SteepestDescentSimulator<traitsT>;
 
     check_keys_available(simulator, {"type"_s, "boundary_type"_s, "precision"_s,
-        "parallelism"_s, "step_limit"_s, "save_step"_s, "delta"_s, "threshold"_s});
+        "parallelism"_s, "force_reduction"_s, "step_limit"_s, "save_step"_s, "delta"_s, "threshold"_s});
 
     const auto step_lim  = toml::find<std::size_t>(simulator, "step_limit");
     const auto save_step = toml::find<std::size_t>(simulator, "save_step");
@@ -82,6 +84,108 @@ read_steepest_descent_simulator(
             read_observer<traitsT>(root));
 }
 
+template<typename traitsT>
+std::unique_ptr<SimulatorBase>
+read_fire_simulator(const toml::value& root, const toml::value& simulator)
+{
+    MJOLNIR_GET_DEFAULT_LOGGER();
+    MJOLNIR_LOG_FUNCTION();
+    using real_type      = typename traitsT::real_type;
+    using simulator_type = FIRESimulator<traitsT>;
+
+    check_keys_available(simulator, {"type"_s, "boundary_type"_s, "precision"_s,
+        "parallelism"_s, "force_reduction"_s, "step_limit"_s, "save_step"_s,
+        "checkpoint_step"_s, "delta_t"_s, "delta_t_max"_s, "threshold"_s,
+        "max_displacement"_s, "N_min"_s, "f_inc"_s, "f_dec"_s, "alpha_start"_s,
+        "f_alpha"_s});
+
+    const auto step_lim  = toml::find<std::size_t>(simulator, "step_limit");
+    const auto save_step = toml::find<std::size_t>(simulator, "save_step");
+    const auto delta_t   = toml::find<real_type  >(simulator, "delta_t");
+    const auto threshold = toml::find<real_type  >(simulator, "threshold");
+    const auto chkp_step = toml::find_or(simulator, "checkpoint_step", save_step);
+
+    auto params = simulator_type::default_parameters(delta_t);
+    params.dt_max      = toml::find_or(simulator, "delta_t_max",      params.dt_max);
+    params.max_disp    = toml::find_or(simulator, "max_displacement", params.max_disp);
+    params.N_min       = toml::find_or(simulator, "N_min",            params.N_min);
+    params.f_inc       = toml::find_or(simulator, "f_inc",            params.f_inc);
+    params.f_dec       = toml::find_or(simulator, "f_dec",            params.f_dec);
+    params.alpha_start = toml::find_or(simulator, "alpha_start",      params.alpha_start);
+    params.f_alpha     = toml::find_or(simulator, "f_alpha",          params.f_alpha);
+
+    MJOLNIR_LOG_NOTICE("step_limit  is ", step_lim);
+    MJOLNIR_LOG_NOTICE("save_step   is ", save_step);
+    MJOLNIR_LOG_NOTICE("checkpoint  is ", chkp_step);
+    MJOLNIR_LOG_NOTICE("delta_t     is ", delta_t);
+    MJOLNIR_LOG_NOTICE("delta_t_max is ", params.dt_max);
+    MJOLNIR_LOG_NOTICE("threshold   is ", threshold);
+    MJOLNIR_LOG_INFO("max_displacement is ", params.max_disp);
+    MJOLNIR_LOG_INFO("N_min       is ", params.N_min);
+    MJOLNIR_LOG_INFO("f_inc       is ", params.f_inc);
+    MJOLNIR_LOG_INFO("f_dec       is ", params.f_dec);
+    MJOLNIR_LOG_INFO("alpha_start is ", params.alpha_start);
+    MJOLNIR_LOG_INFO("f_alpha     is ", params.f_alpha);
+
+    if(!(real_type(0) < delta_t) || params.dt_max < delta_t)
+    {
+        throw_exception<std::runtime_error>(toml::format_error("[error] "
+            "mjolnir::read_fire_simulator: invalid time step",
+            toml::find(simulator, "delta_t"), "here", {
+            "0 < delta_t <= delta_t_max is required."
+            }));
+    }
+
+    return make_unique<simulator_type>(delta_t, threshold, params, step_lim,
+            save_step, chkp_step,
+            read_system<traitsT>(root, 0),
+            read_forcefield<traitsT>(root, simulator),
+            read_observer<traitsT>(root));
+}
+
+template<typename traitsT>
+std::unique_ptr<SimulatorBase>
+read_lbfgs_simulator(const toml::value& root, const toml::value& simulator)
+{
+    MJOLNIR_GET_DEFAULT_LOGGER();
+    MJOLNIR_LOG_FUNCTION();
+    using real_type      = typename traitsT::real_type;
+    using simulator_type = LBFGSSimulator<traitsT>;
+
+    check_keys_available(simulator, {"type"_s, "boundary_type"_s, "precision"_s,
+        "parallelism"_s, "force_reduction"_s, "step_limit"_s, "save_step"_s,
+        "checkpoint_step"_s, "memory"_s, "max_step"_s, "threshold"_s});
+
+    const auto step_lim  = toml::find<std::size_t>(simulator, "step_limit");
+    const auto save_step = toml::find<std::size_t>(simulator, "save_step");
+    const auto max_step  = toml::find<real_type  >(simulator, "max_step");
+    const auto threshold = toml::find<real_type  >(simulator, "threshold");
+    const auto memory    = toml::find_or<std::size_t>(simulator, "memory", 10);
+    const auto chkp_step = toml::find_or(simulator, "checkpoint_step", save_step);
+
+    MJOLNIR_LOG_NOTICE("step_limit is ", step_lim);
+    MJOLNIR_LOG_NOTICE("save_step  is ", save_step);
+    MJOLNIR_LOG_NOTICE("checkpoint is ", chkp_step);
+    MJOLNIR_LOG_NOTICE("memory     is ", memory);
+    MJOLNIR_LOG_NOTICE("max_step   is ", max_step);
+    MJOLNIR_LOG_NOTICE("threshold  is ", threshold);
+
+    if(memory == 0)
+    {
+        throw_exception<std::runtime_error>(toml::format_error("[error] "
+            "mjolnir::read_lbfgs_simulator: invalid memory size",
+            toml::find(simulator, "memory"), "here", {
+            "memory should be a positive integer."
+            }));
+    }
+
+    return make_unique<simulator_type>(memory, max_step, threshold, step_lim,
+            save_step, chkp_step,
+            read_system<traitsT>(root, 0),
+            read_forcefield<traitsT>(root, simulator),
+            read_observer<traitsT>(root));
+}
+
 template<typename traitsT, typename integratorT>
 std::unique_ptr<SimulatorBase>
 read_simulated_annealing_simulator(
@@ -92,7 +196,7 @@ read_simulated_annealing_simulator(
     using real_type   = typename traitsT::real_type;
 
     check_keys_available(simulator, {"type"_s, "boundary_type"_s, "precision"_s,
-            "parallelism"_s, "seed"_s, "total_step"_s, "save_step"_s, "delta_t"_s,
+            "parallelism"_s, "force_reduction"_s, "seed"_s, "total_step"_s, "save_step"_s, "delta_t"_s,
             "integrator"_s, "forcefields"_s, "schedule"_s, "each_step"_s, "env"_s});
 
     const auto tstep = toml::find<std::size_t>(simulator, "total_step");
@@ -171,7 +275,7 @@ read_switching_forcefield_simulator(
     MJOLNIR_LOG_FUNCTION();
 
     check_keys_available(simulator, {"type"_s, "boundary_type"_s, "precision"_s,
-            "parallelism"_s, "seed"_s, "total_step"_s, "save_step"_s,
+            "parallelism"_s, "force_reduction"_s, "seed"_s, "total_step"_s, "save_step"_s,
             "delta_t"_s, "integrator"_s, "forcefields"_s, "schedule"_s, "env"_s});
 
     const auto tstep = toml::find<std::size_t>(simulator, "total_step");
@@ -258,7 +362,7 @@ read_energy_calculation_simulator(
     using coordinate_type = typename traitsT::coordinate_type;
 
     check_keys_available(simulator, {"type"_s, "boundary_type"_s, "precision"_s,
-            "file"_s, "parallelism"_s, "env"_s});
+            "file"_s, "parallelism"_s, "force_reduction"_s, "env"_s});
 
     // ------------------------------------------------------------------------
     // construct observers manually ...
@@ -435,6 +539,20 @@ read_simulator(const toml::value& root, const toml::value& simulator)
         // It does not do "time integration", so integratorT is not needed.
         return read_steepest_descent_simulator<traitsT>(root, simulator);
     }
+    else if(type == "FIRE")
+    {
+        MJOLNIR_LOG_NOTICE("Simulator type is FIRE.");
+
+        // It uses its own integration scheme, so integratorT is not needed.
+        return read_fire_simulator<traitsT>(root, simulator);
+    }
+    else if(type == "L-BFGS")
+    {
+        MJOLNIR_LOG_NOTICE("Simulator type is L-BFGS.");
+
+        // It does not do "time integration", so integratorT is not needed.
+        return read_lbfgs_simulator<traitsT>(root, simulator);
+    }
     else if(type == "SimulatedAnnealing")
     {
         MJOLNIR_LOG_NOTICE("Simulator type is SimulatedAnnealing.");
@@ -460,6 +578,8 @@ read_simulator(const toml::value& root, const toml::value& simulator)
             "expected value is one of the following.",
             "- \"MolecularDynamcis\"  : standard MD simulation",
             "- \"SteepestDescent\"    : energy minimization by gradient method",
+            "- \"FIRE\"               : energy minimization by FIRE",
+            "- \"L-BFGS\"             : energy minimization by limited-memory BFGS",
             "- \"SimulatedAnnealing\" : energy minimization by Annealing",
             "- \"SwitchingForceField\": switch forcefield while running simulation",
             "- \"EnergyCalculation\"  : calculate energy based on a trajectory file"
@@ -476,7 +596,7 @@ read_integrator_type(const toml::value& root, const toml::value& simulator)
     // just determine types, not read the whole integrator.
 
     // There are some Simulators that does not require time integration, such as
-    // SteepestDescentSimulator. In that case, any `integrator.type` is defined.
+    // SteepestDescentSimulator, FIRESimulator and LBFGSSimulator. In that case, any `integrator.type` is defined.
     // So if any integrator is defined, it uses VelocityVerletIntegrator for a
     // workaround.
     //     When the read_integrator called later, read_integrator function
@@ -597,6 +717,22 @@ extern template std::unique_ptr<SimulatorBase> read_steepest_descent_simulator<S
 extern template std::unique_ptr<SimulatorBase> read_steepest_descent_simulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
 extern template std::unique_ptr<SimulatorBase> read_steepest_descent_simulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
 
+// ----------------------------------------------------------------------------
+// read_fire_simulator
+
+extern template std::unique_ptr<SimulatorBase> read_fire_simulator<SimulatorTraits<double, UnlimitedBoundary>       >(const toml::value&, const toml::value&);
+extern template std::unique_ptr<SimulatorBase> read_fire_simulator<SimulatorTraits<float,  UnlimitedBoundary>       >(const toml::value&, const toml::value&);
+extern template std::unique_ptr<SimulatorBase> read_fire_simulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
+extern template std::unique_ptr<SimulatorBase> read_fire_simulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
+
+// ----------------------------------------------------------------------------
+// read_lbfgs_simulator
+
+extern template std::unique_ptr<SimulatorBase> read_lbfgs_simulator<SimulatorTraits<double, UnlimitedBoundary>       >(const toml::value&, const toml::value&);
+extern template std::unique_ptr<SimulatorBase> read_lbfgs_simulator<SimulatorTraits<float,  UnlimitedBoundary>       >(const toml::value&, const toml::value&);
+extern template std::unique_ptr<SimulatorBase> read_lbfgs_simulator<SimulatorTraits<double, CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
+extern template std::unique_ptr<SimulatorBase> read_lbfgs_simulator<SimulatorTraits<float,  CuboidalPeriodicBoundary>>(const toml::value&, const toml::value&);
+
 // ----------------------------------------------------------------------------
 // read_switching_forcefield_simulator
 
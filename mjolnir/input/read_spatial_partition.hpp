@@ -10,6 +10,8 @@
 #include <mjolnir/core/ZorderRTree.hpp>
 #include <mjolnir/util/make_unique.hpp>
 #include <mjolnir/util/logger.hpp>
+#include <string>
+#include <vector>
 
 namespace mjolnir
 {
@@ -31,9 +33,10 @@ struct celllist_dispatcher<UnlimitedBoundary<realT, coordT>>
 
     template<typename traitsT, typename potentialT>
     static std::unique_ptr<UnlimitedGridCellList<traitsT, potentialT>>
-    invoke(const real_type margin)
+    invoke(const real_type margin, const CellListStencil stencil)
     {
-        return make_unique<UnlimitedGridCellList<traitsT, potentialT>>(margin);
+        return make_unique<UnlimitedGridCellList<traitsT, potentialT>>(
+                margin, stencil);
     }
 };
 
@@ -45,12 +48,117 @@ struct celllist_dispatcher<CuboidalPeriodicBoundary<realT, coordT>>
 
     template<typename traitsT, typename potentialT>
     static std::unique_ptr<PeriodicGridCellList<traitsT, potentialT>>
-    invoke(const real_type margin)
+    invoke(const real_type margin, const CellListStencil stencil)
     {
-        return make_unique<PeriodicGridCellList<traitsT, potentialT>>(margin);
+        return make_unique<PeriodicGridCellList<traitsT, potentialT>>(
+                margin, stencil);
     }
 };
 
+// ---------------------------------------------------------------------------
+// "Full" searches all the 27 adjacent cells for each particle.
+// "Half" visits each pair of adjacent cells only once.
+
+inline CellListStencil read_cell_list_stencil(const toml::value& sp)
+{
+    if(sp.as_table().count("stencil") == 0)
+    {
+        return CellListStencil::Full;
+    }
+    const auto name = toml::find<std::string>(sp, "stencil");
+    if(name == "Full")
+    {
+        return CellListStencil::Full;
+    }
+    else if(name == "Half")
+    {
+        return CellListStencil::Half;
+    }
+    throw std::runtime_error(toml::format_error("[error] "
+        "mjolnir::read_spatial_partition: unknown stencil",
+        toml::find(sp, "stencil"), "expected \"Full\" or \"Half\""));
+}
+
+// ---------------------------------------------------------------------------
+// It reads `spatial_partition.type = "Auto"`.
+// Each of the `candidates` is tried with each of the `margins` for `steps`
+// steps, and the fastest one is chosen. If `retune_interval` is set, the
+// candidates are tried again after the interval.
+
+template<typename traitsT, typename potentialT>
+SpatialPartition<traitsT, potentialT>
+read_auto_spatial_partition(const toml::value& sp, const bool reorder,
+                            const bool cluster)
+{
+    MJOLNIR_GET_DEFAULT_LOGGER();
+    MJOLNIR_LOG_FUNCTION();
+    using real_type      = typename traitsT::real_type;
+    using boundary_type  = typename traitsT::boundary_type;
+    using tuner_type     = typename SpatialPartition<traitsT, potentialT>::tuner_type;
+    using candidate_type = typename tuner_type::candidate_type;
+
+    const auto names   = toml::find_or<std::vector<std::string>>(sp, "candidates",
+            std::vector<std::string>{"CellList", "RTree"});
+    const auto margins = toml::find_or<std::vector<real_type>>(sp, "margins",
+            std::vector<real_type>{0.2, 0.4, 0.8});
+    const auto steps   = toml::find_or<std::size_t>(sp, "steps", 200);
+    const auto retune  = toml::find_or<std::size_t>(sp, "retune_interval", 0);
+    const auto stencil = read_cell_list_stencil(sp);
+
+    if(names.empty() || margins.empty() || steps == 0)
+    {
+        throw std::runtime_error(toml::format_error("[error] "
+            "mjolnir::read_spatial_partition: Auto requires at least one "
+            "candidate, one margin and a positive number of steps", sp,
+            "here"));
+    }
+
+    std::vector<candidate_type> candidates;
+    for(const auto& name : names)
+    {
+        if(name == "Naive")
+        {
+            candidates.emplace_back(name,
+                make_unique<NaivePairCalculation<traitsT, potentialT>>());
+            continue;
+        }
+        for(const auto margin : margins)
+        {
+            const auto label = name + " (margin = " + std::to_string(margin) + ")";
+            if(name == "CellList")
+            {
+                candidates.emplace_back(label, celllist_dispatcher<boundary_type>::
+                    template invoke<traitsT, potentialT>(margin, stencil));
+            }
+            else if(name == "RTree" || name == "ZorderRTree")
+            {
+                candidates.emplace_back(label,
+                    make_unique<ZorderRTree<traitsT, potentialT>>(margin));
+            }
+            else if(name == "VerletList")
+            {
+                candidates.emplace_back(label,
+                    make_unique<VerletList<traitsT, potentialT>>(margin));
+            }
+            else
+            {
+                throw std::runtime_error(toml::format_error("[error] "
+                    "mjolnir::read_spatial_partition: unknown candidate \"" +
+                    name + "\"", toml::find(sp, "candidates"), "expected "
+                    "\"CellList\", \"RTree\", \"VerletList\" or \"Naive\""));
+            }
+        }
+    }
+    MJOLNIR_LOG_NOTICE("-- Spatial Partition is chosen from ", candidates.size(),
+                       " candidates, ", steps, " steps each");
+    if(retune != 0)
+    {
+        MJOLNIR_LOG_NOTICE("-- it will be re-tuned every ", retune, " steps");
+    }
+    return SpatialPartition<traitsT, potentialT>(make_unique<tuner_type>(
+            std::move(candidates), steps, retune), reorder, cluster);
+}
+
 // ---------------------------------------------------------------------------
 // It reads spatial partition that is dedicated for a GlobalPotential.
 // In most of the cases, "type" would be a "CellList".
@@ -66,6 +174,19 @@ read_spatial_partition(const toml::value& global)
     const auto& sp   = toml::find<toml::value>(global, "spatial_partition");
     const auto  type = toml::find<std::string>(sp,     "type");
 
+    // visit particles along the z-order curve to improve cache locality.
+    const bool reorder = toml::find_or<bool>(sp, "reorder", false);
+    if(reorder)
+    {
+        MJOLNIR_LOG_NOTICE("-- particles are visited in z-order");
+    }
+    // calculate pairs in blocks of spatially close clusters.
+    const bool cluster = toml::find_or<bool>(sp, "cluster", false);
+    if(cluster)
+    {
+        MJOLNIR_LOG_NOTICE("-- pairs are calculated in blocks of clusters");
+    }
+
     if(type == "CellList")
     {
         using boundary_type = typename traitsT::boundary_type;
@@ -74,9 +195,12 @@ read_spatial_partition(const toml::value& global)
         MJOLNIR_LOG_NOTICE("-- Spatial Partition is CellList "
                            "with relative margin = ", margin);
 
+        const auto stencil = read_cell_list_stencil(sp);
+        MJOLNIR_LOG_NOTICE("-- CellList uses ", stencil, " stencil");
+
         return SpatialPartition<traitsT, potentialT>(
                 celllist_dispatcher<boundary_type>::template
-                invoke<traitsT, potentialT>(margin));
+                invoke<traitsT, potentialT>(margin, stencil), reorder, cluster);
     }
     else if(type == "RTree" || type == "ZorderRTree")
     {
@@ -85,7 +209,7 @@ read_spatial_partition(const toml::value& global)
                            "with relative margin = ", margin);
 
         return SpatialPartition<traitsT, potentialT>(
-                make_unique<ZorderRTree<traitsT, potentialT>>(margin));
+                make_unique<ZorderRTree<traitsT, potentialT>>(margin), reorder, cluster);
     }
 
     else if(type == "VerletList")
@@ -97,7 +221,7 @@ read_spatial_partition(const toml::value& global)
                            "with relative margin = ", margin);
 
         return SpatialPartition<traitsT, potentialT>(
-                make_unique<verlet_list_type>(margin));
+                make_unique<verlet_list_type>(margin), reorder, cluster);
     }
     else if(type == "Naive")
     {
@@ -105,13 +229,18 @@ read_spatial_partition(const toml::value& global)
                            "Calculate all the possible pairs.");
 
         return SpatialPartition<traitsT, potentialT>(
-                make_unique<NaivePairCalculation<traitsT, potentialT>>());
+                make_unique<NaivePairCalculation<traitsT, potentialT>>(), reorder, cluster);
+    }
+    else if(type == "Auto")
+    {
+        return read_auto_spatial_partition<traitsT, potentialT>(sp, reorder, cluster);
     }
     else
     {
         throw std::runtime_error(toml::format_error("[error] "
             "mjolnir::read_spatial_partition: unknown option appeared",
-            toml::find(sp, "type"), "expected \"CellList\" or \"VerletList\""));
+            toml::find(sp, "type"), "expected \"CellList\", \"RTree\", "
+            "\"VerletList\", \"Naive\" or \"Auto\""));
     }
 }
 
@@ -12,6 +12,10 @@
 #include <mjolnir/input/read_path.hpp>
 #include <mjolnir/input/utility.hpp>
 
+#ifdef MJOLNIR_WITH_OPENMP
+#include <mjolnir/omp/System.hpp>
+#endif
+
 namespace mjolnir
 {
 namespace detail
@@ -70,6 +74,102 @@ struct read_boundary_impl<CuboidalPeriodicBoundary<realT, coordT>>
     }
 };
 
+// constructs a System. OpenMP implementation reads how to merge thread-local
+// forces from [simulator] table.
+template<typename traitsT>
+struct make_system_impl
+{
+    static System<traitsT>
+    invoke(const std::size_t num_particles,
+           const typename traitsT::boundary_type& boundary,
+           const toml::value& /*root*/)
+    {
+        return System<traitsT>(num_particles, boundary);
+    }
+    // for a system loaded from a msgpack file
+    static void reconfigure(System<traitsT>&, const toml::value& /*root*/) {}
+};
+
+#ifdef MJOLNIR_WITH_OPENMP
+template<typename realT, template<typename, typename> class boundaryT>
+struct make_system_impl<OpenMPSimulatorTraits<realT, boundaryT>>
+{
+    using traits_type = OpenMPSimulatorTraits<realT, boundaryT>;
+
+    static System<traits_type>
+    invoke(const std::size_t num_particles,
+           const typename traits_type::boundary_type& boundary,
+           const toml::value& root)
+    {
+        return System<traits_type>(num_particles, boundary, read(root));
+    }
+    static void reconfigure(System<traits_type>& sys, const toml::value& root)
+    {
+        sys.set_force_reduction(read(root));
+        return;
+    }
+
+    // [simulator]
+    // parallelism     = "OpenMP"
+    // force_reduction = "BlockSparse" # default: "ThreadLocal"
+    static ForceReduction read(const toml::value& root)
+    {
+        MJOLNIR_GET_DEFAULT_LOGGER();
+        MJOLNIR_LOG_FUNCTION();
+
+        if(!root.contains("simulator")) {return ForceReduction::ThreadLocal;}
+        const auto simulator = read_table_from_file(
+                toml::find(root, "simulator"), "simulator");
+        if(!simulator.contains("force_reduction"))
+        {
+            return ForceReduction::ThreadLocal;
+        }
+
+        const auto kind = toml::find<std::string>(simulator, "force_reduction");
+        if(kind == "ThreadLocal")
+        {
+            MJOLNIR_LOG_NOTICE("forces are merged from thread-local arrays");
+            return ForceReduction::ThreadLocal;
+        }
+        else if(kind == "BlockSparse")
+        {
+            MJOLNIR_LOG_NOTICE("forces are merged from touched blocks only");
+            return ForceReduction::BlockSparse;
+        }
+        throw_exception<std::runtime_error>(toml::format_error("[error] "
+            "mjolnir::read_system: unknown force_reduction",
+            toml::find(simulator, "force_reduction"), "here", {
+            "expected value is one of the following.",
+            "- \"ThreadLocal\": each thread has its own N-sized force array (default)",
+            "- \"BlockSparse\": merge only the blocks of particles touched by each thread"
+            }));
+    }
+};
+#endif // MJOLNIR_WITH_OPENMP
+
+// [simulator]
+// precision = "mixed"
+//
+// The state of the system is kept in double (see read_precision), but the
+// pair kernels are evaluated in float. See BatchedPairKernel.hpp.
+inline bool read_mixed_precision(const toml::value& root)
+{
+    MJOLNIR_GET_DEFAULT_LOGGER();
+    MJOLNIR_LOG_FUNCTION();
+
+    if(!root.contains("simulator")) {return false;}
+    const auto simulator = read_table_from_file(
+            toml::find(root, "simulator"), "simulator");
+    if(!simulator.contains("precision")) {return false;}
+
+    const bool mixed = (toml::find<std::string>(simulator, "precision") == "mixed");
+    if(mixed)
+    {
+        MJOLNIR_LOG_NOTICE("pair kernels are evaluated in float");
+    }
+    return mixed;
+}
+
 } // detail
 
 template<typename traitsT>
@@ -120,7 +220,10 @@ read_system(const toml::value& root, const std::size_t N)
             MJOLNIR_LOG_NOTICE("msgpack file specified. load system status from ",
                                input_path, fname);
 
-            return load_system_from_msgpack<traitsT>(input_path + fname);
+            auto sys = load_system_from_msgpack<traitsT>(input_path + fname);
+            detail::make_system_impl<traitsT>::reconfigure(sys, root);
+            sys.mixed_precision() = detail::read_mixed_precision(root);
+            return sys;
         }
         else
         {
@@ -137,7 +240,9 @@ read_system(const toml::value& root, const std::size_t N)
 
     const auto& particles = toml::find<toml::array>(system, "particles");
 
-    System<traitsT> sys(particles.size(), read_boundary<traitsT>(system));
+    auto sys = detail::make_system_impl<traitsT>::invoke(
+            particles.size(), read_boundary<traitsT>(system), root);
+    sys.mixed_precision() = detail::read_mixed_precision(root);
 
     for(const auto& attr : toml::find<toml::table>(system, "attributes"))
     {
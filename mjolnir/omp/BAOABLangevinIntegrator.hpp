@@ -66,10 +66,13 @@ class BAOABLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
     {
         real_type largest_disp2(0.0);
 
+        // random vectors do not depend on the thread that generates them.
+        rng.next_block();
+
 #pragma omp parallel for reduction(max:largest_disp2)
         for(std::size_t i=0; i<sys.size(); ++i)
         {
-            const auto R  = this->gen_R(rng); // random gaussian vector (0 mean, 1 var)
+            const auto R  = rng.gaussian_vector(i); // random gaussian vector (0 mean, 1 var)
             const auto rm = sys.rmass(i);  // reciprocal mass
             auto&      p  = sys.position(i);
             auto&      v  = sys.velocity(i);
@@ -149,14 +152,6 @@ class BAOABLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
         return;
     }
 
-    coordinate_type gen_R(rng_type& rng) noexcept
-    {
-        const auto x = rng.gaussian();
-        const auto y = rng.gaussian();
-        const auto z = rng.gaussian();
-        return math::make_coordinate<coordinate_type>(x, y, z);
-    }
-
   private:
     real_type dt_;
     real_type halfdt_;
@@ -0,0 +1,92 @@
+#ifndef MJOLNIR_OMP_DISPLACEMENT_TRACKER_HPP
+#define MJOLNIR_OMP_DISPLACEMENT_TRACKER_HPP
+#include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
+#include <mjolnir/omp/System.hpp>
+#include <mjolnir/core/DisplacementTracker.hpp>
+
+namespace mjolnir
+{
+
+template<typename realT, template<typename, typename> class boundaryT>
+class DisplacementTracker<OpenMPSimulatorTraits<realT, boundaryT>>
+{
+  public:
+    using traits_type     = OpenMPSimulatorTraits<realT, boundaryT>;
+    using system_type     = System<traits_type>;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+
+  public:
+
+    DisplacementTracker()  = default;
+    ~DisplacementTracker() = default;
+    DisplacementTracker(DisplacementTracker const&) = default;
+    DisplacementTracker(DisplacementTracker &&)     = default;
+    DisplacementTracker& operator=(DisplacementTracker const&) = default;
+    DisplacementTracker& operator=(DisplacementTracker &&)     = default;
+
+    void record(const system_type& sys, const std::vector<std::size_t>& ps)
+    {
+        this->participants_ = ps;
+        this->references_.resize(ps.size());
+#pragma omp parallel for
+        for(std::size_t idx=0; idx<ps.size(); ++idx)
+        {
+            this->references_[idx] = sys.position(ps[idx]);
+        }
+        return;
+    }
+
+    // each thread finds its own two largest displacements, then they are
+    // merged into the global ones.
+    real_type largest_displacements(const system_type& sys) const noexcept
+    {
+        real_type max1 = 0;
+        real_type max2 = 0;
+#pragma omp parallel shared(max1, max2)
+        {
+            real_type local1 = 0;
+            real_type local2 = 0;
+#pragma omp for nowait
+            for(std::size_t idx=0; idx<participants_.size(); ++idx)
+            {
+                const auto dr = sys.adjust_direction(references_[idx],
+                                    sys.position(participants_[idx]));
+                const auto d2 = math::length_sq(dr);
+                if(local1 < d2)
+                {
+                    local2 = local1;
+                    local1 = d2;
+                }
+                else if(local2 < d2)
+                {
+                    local2 = d2;
+                }
+            }
+#pragma omp critical
+            {
+                if(max1 < local1)
+                {
+                    max2 = std::max(max1, local2);
+                    max1 = local1;
+                }
+                else
+                {
+                    max2 = std::max(max2, local1);
+                }
+            }
+        }
+        return std::sqrt(max1) + std::sqrt(max2);
+    }
+
+    std::vector<std::size_t> const& participants() const noexcept {return participants_;}
+    std::vector<coordinate_type> const& references() const noexcept {return references_;}
+
+  private:
+
+    std::vector<std::size_t>     participants_;
+    std::vector<coordinate_type> references_;
+};
+
+} // mjolnir
+#endif// MJOLNIR_OMP_DISPLACEMENT_TRACKER_HPP
@@ -195,10 +195,12 @@ class GFWNPTLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
         // --------------------------------------------------------------------
         // update particle velocities (Ornstein-Uhlenbeck)
 
+        // random vectors do not depend on the thread that generates them.
+        rng.next_block();
 #pragma omp parallel for
         for(std::size_t i=0; i<sys.size(); ++i)
         {
-            const auto R     = this->gen_R(rng);
+            const auto R     = rng.gaussian_vector(i);
             sys.velocity(i) *= this->exp_gamma_dt_[i];
             sys.velocity(i) += this->noise_coeff_[i] * R;
         }
@@ -69,6 +69,10 @@ class GJFNVTLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
     real_type step(const real_type time, system_type& sys, forcefield_type& ff, rng_type& rng)
     {
         real_type largest_disp2(0);
+
+        // random vectors do not depend on the thread that generates them.
+        rng.next_block();
+
 #pragma omp parallel for reduction(max:largest_disp2)
         for(std::size_t i=0; i<sys.size(); ++i)
         {
@@ -85,7 +89,7 @@ class GJFNVTLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
             // f^(n+1)    = -dU/dr|r^(n+1)
             // v^(n+1)    = (1 - alpha*b*dt/m) * v^(n+1/2) + dt/2m f^(n+1) + beta^(n+1) / 2m
 
-            beta = this->gen_R(rng) * betas_[i] * rm;
+            beta = rng.gaussian_vector(i) * betas_[i] * rm;
             v   += ((dt_ * rm) * f + beta) * real_type(0.5);
 
             const auto dp = (b * dt_) * v;
@@ -160,14 +164,6 @@ class GJFNVTLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
         return;
     }
 
-    coordinate_type gen_R(rng_type& rng) noexcept
-    {
-        const auto x = rng.gaussian();
-        const auto y = rng.gaussian();
-        const auto z = rng.gaussian();
-        return math::make_coordinate<coordinate_type>(x, y, z);
-    }
-
   private:
     real_type dt_;
     real_type halfdt_;
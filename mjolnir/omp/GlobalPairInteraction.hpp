@@ -2,6 +2,7 @@
 #define MJOLNIR_OMP_GLOBAL_PAIR_INTEARACTION_HPP
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
 #include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/DisplacementTracker.hpp>
 #include <mjolnir/forcefield/global/GlobalPairInteraction.hpp>
 
 namespace mjolnir
@@ -23,13 +24,16 @@ class GlobalPairInteraction<
     using topology_type   = typename base_type::topology_type;
     using boundary_type   = typename base_type::boundary_type;
     using partition_type  = SpatialPartition<traits_type, potential_type>;
+    using table_type      = SplinePairTable<potential_type>;
 
   public:
     GlobalPairInteraction()  = default;
     ~GlobalPairInteraction() override {}
 
-    GlobalPairInteraction(potential_type&& pot, partition_type&& part)
-        : potential_(std::move(pot)), partition_(std::move(part))
+    GlobalPairInteraction(potential_type&& pot, partition_type&& part,
+                          table_type&& table = table_type{})
+        : potential_(std::move(pot)), partition_(std::move(part)),
+          table_(std::move(table))
     {}
 
     /*! @brief initialize spatial partition (e.g. CellList)                   *
@@ -41,6 +45,7 @@ class GlobalPairInteraction<
         MJOLNIR_LOG_INFO("potential is ", this->name());
         this->potential_.initialize(sys, topol);
         this->partition_.initialize(sys, this->potential_);
+        this->table_.make(this->potential_, this->partition_);
     }
 
     /*! @brief update parameters (e.g. temperature, ionic strength, ...)  *
@@ -55,22 +60,138 @@ class GlobalPairInteraction<
         this->potential_.update(sys, topol);
         // potential update may change the cutoff length!
         this->partition_.initialize(sys, this->potential_);
+        // and the pair parameters.
+        this->table_.make(this->potential_, this->partition_);
     }
 
     void reduce_margin(const real_type dmargin, const system_type& sys) override
     {
-        this->partition_.reduce_margin(dmargin, sys, this->potential_);
+        if(this->partition_.reduce_margin(dmargin, sys, this->potential_))
+        {
+            this->table_.update(this->potential_, this->partition_);
+        }
         return;
     }
     void scale_margin(const real_type scale, const system_type& sys) override
     {
-        this->partition_.scale_margin(scale, sys, this->potential_);
+        if(this->partition_.scale_margin(scale, sys, this->potential_))
+        {
+            this->table_.update(this->potential_, this->partition_);
+        }
         return;
     }
 
     void calc_force (system_type& sys) const noexcept override
     {
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto tuning_timer = this->partition_.tuning_timer();
+        if(this->table_.enabled())
+        {
+            this->calc_force_batched(sys, this->table_);
+            return ;
+        }
+        this->calc_force_impl(sys, has_batched_pair_kernel<potential_type>{});
+        return ;
+    }
+
+    real_type calc_energy(const system_type& sys) const noexcept override
+    {
+        const auto tuning_timer = this->partition_.tuning_timer();
+        real_type E = 0.0;
+        const auto& leading_participants = this->partition_.leading_participants();
+#pragma omp parallel for reduction(+:E)
+        for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            for(const auto& ptnr : this->partition_.partners(i))
+            {
+                const auto  j     = ptnr.index;
+                const auto& param = ptnr.parameter();
+
+                const real_type l = math::length(
+                    sys.adjust_direction(sys.position(i), sys.position(j)));
+                E += potential_.potential(l, param);
+            }
+        }
+        return E;
+    }
+
+    real_type calc_force_and_energy(system_type& sys) const noexcept override
+    {
+        const auto tuning_timer = this->partition_.tuning_timer();
+        if(this->table_.enabled())
+        {
+            return this->calc_force_and_energy_batched(sys, this->table_);
+        }
+        return this->calc_force_and_energy_impl(
+                sys, has_batched_pair_kernel<potential_type>{});
+    }
+
+    std::string name() const override
+    {return "Pair:"_s + potential_type::name();}
+
+    base_type* clone() const override
+    {
+        return new GlobalPairInteraction(potential_type(potential_),
+                partition_type(partition_), table_type(table_));
+    }
+
+
+  private:
+
+    // Since explicit instantiation instantiates all the non-template member
+    // functions, the batched versions are templates to avoid instantiating
+    // BatchedPairKernel for potentials that do not have it.
+    template<typename potT = potential_type>
+    void calc_force_impl(system_type& sys, std::true_type) const noexcept
+    {
+        if(sys.mixed_precision())
+        {
+            this->calc_force_batched(sys,
+                BatchedPairKernel<potT, float>(this->potential_));
+        }
+        else
+        {
+            this->calc_force_batched(sys,
+                BatchedPairKernel<potT>(this->potential_));
+        }
+        return ;
+    }
+
+    template<typename kernelT>
+    void calc_force_batched(system_type& sys, const kernelT& kernel) const noexcept
+    {
+        if(this->partition_.has_cluster_pairs())
+        {
+            const auto& clusters = this->partition_.cluster_pairs();
+#pragma omp parallel for
+            for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+            {
+                const std::size_t thread_id = omp_get_thread_num();
+                calc_cluster_pair_force<false>(kernel, sys, clusters, I,
+                    [&sys, thread_id](const std::size_t j) -> coordinate_type& {
+                        return sys.force_thread(thread_id, j);
+                    }, sys.virial_thread(thread_id));
+            }
+            return ;
+        }
+        const auto& leading_participants = this->partition_.leading_participants();
+#pragma omp parallel for
+        for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            const std::size_t thread_id = omp_get_thread_num();
+            calc_batched_pair_force<false>(kernel, sys, i,
+                this->partition_.partners(i),
+                [&sys, thread_id](const std::size_t j) -> coordinate_type& {
+                    return sys.force_thread(thread_id, j);
+                }, sys.force_thread(thread_id, i), sys.virial_thread(thread_id));
+        }
+        return ;
+    }
+
+    void calc_force_impl(system_type& sys, std::false_type) const noexcept
+    {
+        const auto& leading_participants = this->partition_.leading_participants();
 #pragma omp parallel for
         for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
         {
@@ -100,31 +221,57 @@ class GlobalPairInteraction<
         }
         return ;
     }
-    real_type calc_energy(const system_type& sys) const noexcept override
+
+    template<typename potT = potential_type>
+    real_type calc_force_and_energy_impl(system_type& sys, std::true_type) const noexcept
     {
-        real_type E = 0.0;
-        const auto leading_participants = this->potential_.leading_participants();
-#pragma omp parallel for reduction(+:E)
-        for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
+        if(sys.mixed_precision())
         {
-            const auto i = leading_participants[idx];
-            for(const auto& ptnr : this->partition_.partners(i))
-            {
-                const auto  j     = ptnr.index;
-                const auto& param = ptnr.parameter();
+            return this->calc_force_and_energy_batched(sys,
+                BatchedPairKernel<potT, float>(this->potential_));
+        }
+        return this->calc_force_and_energy_batched(sys,
+                BatchedPairKernel<potT>(this->potential_));
+    }
 
-                const real_type l = math::length(
-                    sys.adjust_direction(sys.position(i), sys.position(j)));
-                E += potential_.potential(l, param);
+    template<typename kernelT>
+    real_type calc_force_and_energy_batched(system_type& sys,
+                                             const kernelT& kernel) const noexcept
+    {
+        real_type energy = 0.0;
+        if(this->partition_.has_cluster_pairs())
+        {
+            const auto& clusters = this->partition_.cluster_pairs();
+#pragma omp parallel for reduction(+:energy)
+            for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+            {
+                const std::size_t thread_id = omp_get_thread_num();
+                energy += calc_cluster_pair_force<true>(kernel, sys, clusters, I,
+                    [&sys, thread_id](const std::size_t j) -> coordinate_type& {
+                        return sys.force_thread(thread_id, j);
+                    }, sys.virial_thread(thread_id));
             }
+            return energy;
         }
-        return E;
+        const auto& leading_participants = this->partition_.leading_participants();
+#pragma omp parallel for reduction(+:energy)
+        for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            const std::size_t thread_id = omp_get_thread_num();
+            energy += calc_batched_pair_force<true>(kernel, sys, i,
+                this->partition_.partners(i),
+                [&sys, thread_id](const std::size_t j) -> coordinate_type& {
+                    return sys.force_thread(thread_id, j);
+                }, sys.force_thread(thread_id, i), sys.virial_thread(thread_id));
+        }
+        return energy;
     }
 
-    real_type calc_force_and_energy(system_type& sys) const noexcept override
+    real_type calc_force_and_energy_impl(system_type& sys, std::false_type) const noexcept
     {
         real_type energy = 0.0;
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
 #pragma omp parallel for reduction(+:energy)
         for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
         {
@@ -157,20 +304,11 @@ class GlobalPairInteraction<
         return energy;
     }
 
-    std::string name() const override
-    {return "Pair:"_s + potential_type::name();}
-
-    base_type* clone() const override
-    {
-        return new GlobalPairInteraction(
-                potential_type(potential_), partition_type(partition_));
-    }
-
-
   private:
 
     potential_type potential_;
     partition_type partition_;
+    table_type     table_;
 };
 
 } // mjolnir
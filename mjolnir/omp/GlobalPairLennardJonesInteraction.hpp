@@ -2,6 +2,7 @@
 #define MJOLNIR_OMP_GLOBAL_PAIR_LENNARD_JONES_INTEARACTION_HPP
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
 #include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/DisplacementTracker.hpp>
 #include <mjolnir/forcefield/global/GlobalPairLennardJonesInteraction.hpp>
 
 namespace mjolnir
@@ -72,54 +73,30 @@ class GlobalPairInteraction<
 
     void calc_force(system_type& sys) const noexcept override
     {
-        const auto  cutoff_ratio    = potential_.cutoff_ratio();
-        const auto  cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
-
-        const auto leading_participants = this->potential_.leading_participants();
-#pragma omp parallel for
-        for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
+        const auto tuning_timer = this->partition_.tuning_timer();
+        if(sys.mixed_precision())
         {
-            const auto i = leading_participants[idx];
-            for(const auto& ptnr : this->partition_.partners(i))
-            {
-                const auto  j     = ptnr.index;
-                const auto& param = ptnr.parameter();
-
-                const coordinate_type rij =
-                    sys.adjust_direction(sys.position(i), sys.position(j));
-                const real_type l_sq = math::length_sq(rij);
-
-                const real_type sigma_sq = param.first * param.first;
-                if(sigma_sq * cutoff_ratio_sq < l_sq) {continue;}
-
-                const real_type epsilon = param.second;
-
-                const real_type rcp_l_sq = 1 / l_sq;
-                const real_type s2l2 = sigma_sq * rcp_l_sq;
-                const real_type s6l6 = s2l2 * s2l2 * s2l2;
-
-                const coordinate_type f = rij *
-                    (24 * epsilon * (s6l6 - 2 * s6l6 * s6l6) * rcp_l_sq);
-
-                const std::size_t thread_id = omp_get_thread_num();
-                sys.force_thread(thread_id, i) += f;
-                sys.force_thread(thread_id, j) -= f;
-
-                sys.virial_thread(thread_id) += math::tensor_product(rij, -f);
-            }
+            this->calc_force_batched(sys,
+                BatchedPairKernel<potential_type, float>(this->potential_));
+        }
+        else
+        {
+            this->calc_force_batched(sys,
+                BatchedPairKernel<potential_type>(this->potential_));
         }
         return ;
     }
 
     real_type calc_energy(const system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         real_type E(0);
 
         const auto  cutoff_ratio    = potential_.cutoff_ratio();
         const auto  cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
         const auto  coef_at_cutoff  = potential_.coef_at_cutoff();
 
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
 #pragma omp parallel for reduction(+:E)
         for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
         {
@@ -149,56 +126,91 @@ class GlobalPairInteraction<
 
     real_type calc_force_and_energy(system_type& sys) const noexcept override
     {
-        const auto cutoff_ratio    = potential_.cutoff_ratio();
-        const auto cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
-        const auto coef_at_cutoff  = potential_.coef_at_cutoff();
-
-        real_type energy = 0;
-        const auto leading_participants = this->potential_.leading_participants();
-#pragma omp parallel for reduction(+:energy)
-        for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
+        const auto tuning_timer = this->partition_.tuning_timer();
+        if(sys.mixed_precision())
         {
-            const auto i = leading_participants[idx];
-            for(const auto& ptnr : this->partition_.partners(i))
-            {
-                const auto  j     = ptnr.index;
-                const auto& param = ptnr.parameter();
-
-                const coordinate_type rij =
-                    sys.adjust_direction(sys.position(i), sys.position(j));
-                const real_type l_sq = math::length_sq(rij);
-
-                const real_type sigma_sq = param.first * param.first;
-                if(sigma_sq * cutoff_ratio_sq < l_sq) {continue;}
+            return this->calc_force_and_energy_batched(sys,
+                BatchedPairKernel<potential_type, float>(this->potential_));
+        }
+        return this->calc_force_and_energy_batched(sys,
+                BatchedPairKernel<potential_type>(this->potential_));
+    }
 
-                const real_type epsilon = param.second;
 
-                const real_type rcp_l_sq = 1 / l_sq;
-                const real_type s2l2 = sigma_sq * rcp_l_sq;
-                const real_type s6l6 = s2l2 * s2l2 * s2l2;
+    std::string name() const override {return "GlobalPairLennardJones";}
 
-                energy += 4 * epsilon * (s6l6 * s6l6 - s6l6 - coef_at_cutoff);
+    base_type* clone() const override
+    {
+        return new GlobalPairInteraction(
+                potential_type(potential_), partition_type(partition_));
+    }
 
-                const coordinate_type f = rij *
-                    (24 * epsilon * (s6l6 - 2 * s6l6 * s6l6) * rcp_l_sq);
+  private:
 
+    template<typename kernelT>
+    void calc_force_batched(system_type& sys, const kernelT& kernel) const noexcept
+    {
+        if(this->partition_.has_cluster_pairs())
+        {
+            const auto& clusters = this->partition_.cluster_pairs();
+#pragma omp parallel for
+            for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+            {
                 const std::size_t thread_id = omp_get_thread_num();
-                sys.force_thread(thread_id, i) += f;
-                sys.force_thread(thread_id, j) -= f;
-
-                sys.virial_thread(thread_id) += math::tensor_product(rij, -f);
+                calc_cluster_pair_force<false>(kernel, sys, clusters, I,
+                    [&sys, thread_id](const std::size_t j) -> coordinate_type& {
+                        return sys.force_thread(thread_id, j);
+                    }, sys.virial_thread(thread_id));
             }
+            return ;
         }
-        return energy;
+        const auto& leading_participants = this->partition_.leading_participants();
+#pragma omp parallel for
+        for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            const std::size_t thread_id = omp_get_thread_num();
+            calc_batched_pair_force<false>(kernel, sys, i,
+                this->partition_.partners(i),
+                [&sys, thread_id](const std::size_t j) -> coordinate_type& {
+                    return sys.force_thread(thread_id, j);
+                }, sys.force_thread(thread_id, i), sys.virial_thread(thread_id));
+        }
+        return ;
     }
 
-
-    std::string name() const override {return "GlobalPairLennardJones";}
-
-    base_type* clone() const override
+    template<typename kernelT>
+    real_type calc_force_and_energy_batched(system_type& sys,
+                                             const kernelT& kernel) const noexcept
     {
-        return new GlobalPairInteraction(
-                potential_type(potential_), partition_type(partition_));
+        real_type energy = 0;
+        if(this->partition_.has_cluster_pairs())
+        {
+            const auto& clusters = this->partition_.cluster_pairs();
+#pragma omp parallel for reduction(+:energy)
+            for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+            {
+                const std::size_t thread_id = omp_get_thread_num();
+                energy += calc_cluster_pair_force<true>(kernel, sys, clusters, I,
+                    [&sys, thread_id](const std::size_t j) -> coordinate_type& {
+                        return sys.force_thread(thread_id, j);
+                    }, sys.virial_thread(thread_id));
+            }
+            return energy;
+        }
+        const auto& leading_participants = this->partition_.leading_participants();
+#pragma omp parallel for reduction(+:energy)
+        for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            const std::size_t thread_id = omp_get_thread_num();
+            energy += calc_batched_pair_force<true>(kernel, sys, i,
+                this->partition_.partners(i),
+                [&sys, thread_id](const std::size_t j) -> coordinate_type& {
+                    return sys.force_thread(thread_id, j);
+                }, sys.force_thread(thread_id, i), sys.virial_thread(thread_id));
+        }
+        return energy;
     }
 
   private:
@@ -2,6 +2,7 @@
 #define MJOLNIR_OMP_GLOBAL_PAIR_UNIFORM_LENNARD_JONES_INTEARACTION_HPP
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
 #include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/DisplacementTracker.hpp>
 #include <mjolnir/forcefield/global/GlobalPairUniformLennardJonesInteraction.hpp>
 
 namespace mjolnir
@@ -72,6 +73,7 @@ class GlobalPairInteraction<
 
     void calc_force(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         const auto cutoff_ratio    = potential_.cutoff_ratio();
         const auto cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
         const auto sigma           = this->potential_.sigma();
@@ -79,7 +81,7 @@ class GlobalPairInteraction<
         const auto r_cutoff_sq     = cutoff_ratio_sq * sigma_sq;
         const auto epsilon         = this->potential_.epsilon();
 
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
 #pragma omp parallel for
         for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
         {
@@ -113,6 +115,7 @@ class GlobalPairInteraction<
 
     real_type calc_energy(const system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         real_type E(0);
 
         const auto cutoff_ratio    = potential_.cutoff_ratio();
@@ -123,7 +126,7 @@ class GlobalPairInteraction<
         const auto r_cutoff_sq     = cutoff_ratio_sq * sigma_sq;
         const auto epsilon         = this->potential_.epsilon();
 
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
 #pragma omp parallel for reduction(+:E)
         for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
         {
@@ -149,6 +152,7 @@ class GlobalPairInteraction<
 
     real_type calc_force_and_energy(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         const auto coef_at_cutoff  = potential_.coef_at_cutoff();
         const auto cutoff_ratio    = potential_.cutoff_ratio();
         const auto cutoff_ratio_sq = cutoff_ratio * cutoff_ratio;
@@ -158,7 +162,7 @@ class GlobalPairInteraction<
         const auto epsilon         = this->potential_.epsilon();
 
         real_type energy = 0;
-        const auto leading_participants = this->potential_.leading_participants();
+        const auto& leading_participants = this->partition_.leading_participants();
 #pragma omp parallel for reduction(+:energy)
         for(std::size_t idx=0; idx < leading_participants.size(); ++idx)
         {
@@ -2,6 +2,7 @@
 #define MJOLNIR_OMP_PWMCOS_INTERACTION_HPP
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
 #include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/DisplacementTracker.hpp>
 #include <mjolnir/forcefield/PWMcos/PWMcosInteraction.hpp>
 
 namespace mjolnir
@@ -77,6 +78,7 @@ class PWMcosInteraction<OpenMPSimulatorTraits<realT, boundaryT>>
 
     void calc_force(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
         MJOLNIR_LOG_FUNCTION_DEBUG();
         //   DNA        protein    |
@@ -314,6 +316,7 @@ class PWMcosInteraction<OpenMPSimulatorTraits<realT, boundaryT>>
 
     real_type calc_energy(const system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         const auto energy_unit  = potential_.energy_unit();  // overall coefficient
         const auto energy_shift = potential_.energy_shift(); // overall energy shift
 
@@ -408,6 +411,7 @@ class PWMcosInteraction<OpenMPSimulatorTraits<realT, boundaryT>>
 
     real_type calc_force_and_energy(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
         MJOLNIR_LOG_FUNCTION_DEBUG();
         //   DNA        protein    |
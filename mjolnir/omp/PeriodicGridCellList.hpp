@@ -37,16 +37,19 @@ class PeriodicGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
     using adjacent_cell_idx         = std::array<std::size_t, 27>;
     using cell_type                 = std::pair<range<cell_index_const_iterator>, adjacent_cell_idx>;
     using cell_list_type            = std::vector<cell_type>;
+    using particle_neighbor_pair    = std::pair<std::size_t, neighbor_type>;
 
   public:
 
     PeriodicGridCellList()
         : cutoff_(0), margin_(1), current_margin_(-1),
+          stencil_(CellListStencil::Full),
           r_x_(-1), r_y_(-1), r_z_(-1), dim_x_(0), dim_y_(0), dim_z_(0),
           offsets_threads_(omp_get_max_threads()),
           partners_threads_(omp_get_max_threads()),
           neighbors_threads_(omp_get_max_threads()),
-          nranges_threads_(omp_get_max_threads())
+          nranges_threads_(omp_get_max_threads()),
+          pairs_threads_(omp_get_max_threads())
     {}
     ~PeriodicGridCellList() override {}
     PeriodicGridCellList(PeriodicGridCellList const&) = default;
@@ -54,13 +57,15 @@ class PeriodicGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
     PeriodicGridCellList& operator=(PeriodicGridCellList const&) = default;
     PeriodicGridCellList& operator=(PeriodicGridCellList &&)     = default;
 
-    explicit PeriodicGridCellList(const real_type margin)
-        : cutoff_(0), margin_(margin), current_margin_(-1),
+    explicit PeriodicGridCellList(const real_type margin,
+            const CellListStencil stencil = CellListStencil::Full)
+        : cutoff_(0), margin_(margin), current_margin_(-1), stencil_(stencil),
           r_x_(-1), r_y_(-1), r_z_(-1), dim_x_(0), dim_y_(0), dim_z_(0),
           offsets_threads_(omp_get_max_threads()),
           partners_threads_(omp_get_max_threads()),
           neighbors_threads_(omp_get_max_threads()),
-          nranges_threads_(omp_get_max_threads())
+          nranges_threads_(omp_get_max_threads()),
+          pairs_threads_(omp_get_max_threads())
     {}
 
     bool valid() const noexcept override
@@ -94,6 +99,9 @@ class PeriodicGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
         this->r_y_ = real_type(1) / (math::Y(this->system_size_) / this->dim_y_);
         this->r_z_ = real_type(1) / (math::Z(this->system_size_) / this->dim_z_);
 
+        // participants might be changed. forget the last ordering.
+        this->index_by_cell_.clear();
+
         // construct neighbor list using cells
         this->make(neighbors, sys, pot);
         return;
@@ -154,51 +162,68 @@ class PeriodicGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
         const auto& participants = pot.participants();
 
         neighbor_list.clear();
-        if(index_by_cell_    .size() != participants.size() ||
-           index_by_cell_buf_.size() != participants.size())
-        {
-            index_by_cell_    .resize(participants.size());
-            index_by_cell_buf_.resize(participants.size());
-        }
 
-#pragma omp parallel for
-        for(std::size_t i=0; i<participants.size(); ++i)
+        // If the participants are the same as the last time, update the cell
+        // indices in the current (sorted) order. Usually only a few particles
+        // move to another cell between two updates, so we can skip sorting
+        // when none of them moves.
+        bool cell_changed = (cell_offsets_.size() != cell_list_.size() + 1);
+        if(index_by_cell_.size() != participants.size())
         {
-            const auto idx = participants[i];
-            index_by_cell_[i] =
-                std::make_pair(idx, this->calc_index(sys.position(idx)));
+            index_by_cell_.resize(participants.size());
+#pragma omp parallel for
+            for(std::size_t i=0; i<participants.size(); ++i)
+            {
+                const auto idx = participants[i];
+                index_by_cell_[i] =
+                    std::make_pair(idx, this->calc_index(sys.position(idx)));
+            }
+            cell_changed = true;
         }
-
-        omp::sort(this->index_by_cell_, this->index_by_cell_buf_,
-            [](const particle_cell_idx_pair& lhs,
-               const particle_cell_idx_pair& rhs) noexcept -> bool
+        else
+        {
+            std::size_t num_moved = 0;
+#pragma omp parallel for reduction(+:num_moved)
+            for(std::size_t i=0; i<index_by_cell_.size(); ++i)
             {
-                return lhs.second < rhs.second;
-            });
+                auto& item = index_by_cell_[i];
+                const auto cell_idx = this->calc_index(sys.position(item.first));
+                if(cell_idx != item.second)
+                {
+                    item.second = cell_idx;
+                    num_moved  += 1;
+                }
+            }
+            cell_changed = cell_changed || (num_moved != 0);
+        }
+        if(cell_changed)
+        {
+            omp::counting_sort(this->index_by_cell_, this->index_by_cell_buf_,
+                this->cell_offsets_, this->cell_list_.size(),
+                [](const particle_cell_idx_pair& item) noexcept -> std::size_t {
+                    return item.second;
+                });
+        }
 
+        // assign first and last iterator for each cells
 #pragma omp parallel for
         for(std::size_t cell_idx=0; cell_idx<cell_list_.size(); ++cell_idx)
         {
-            auto iter = std::find_if(index_by_cell_.cbegin(), index_by_cell_.cend(),
-                [cell_idx](const particle_cell_idx_pair& item) noexcept -> bool {
-                    return item.second == cell_idx;
-                });
-            if(iter == index_by_cell_.cend())
-            {
-                cell_list_[cell_idx].first = make_range(iter, iter);
-                continue;
-            }
-            const auto first = iter; // the first iter of the range
-            while(iter != index_by_cell_.cend() && iter->second == cell_idx)
-            {
-                ++iter;
-            }
-            cell_list_[cell_idx].first = make_range(first, iter);
+            cell_list_[cell_idx].first = make_range(
+                index_by_cell_.cbegin() + cell_offsets_[cell_idx],
+                index_by_cell_.cbegin() + cell_offsets_[cell_idx+1]);
         }
 
         const real_type r_c  = cutoff_ * (1. + margin_);
         const real_type r_c2 = r_c * r_c;
 
+        if(this->stencil_ == CellListStencil::Half)
+        {
+            this->make_half_shell(neighbor_list, sys, pot, r_c2);
+            this->current_margin_ = cutoff_ * margin_;
+            return;
+        }
+
         const auto leading_participants = pot.leading_participants();
 
         assert(std::is_sorted(leading_participants.begin(), leading_participants.end()));
@@ -345,11 +370,95 @@ class PeriodicGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
 
     base_type* clone() const override
     {
-        return new PeriodicGridCellList(margin_);
+        return new PeriodicGridCellList(margin_, stencil_);
     }
 
+    CellListStencil stencil() const noexcept {return this->stencil_;}
+
   private:
 
+    //XXX do NOT call this from parallel region
+    // construct neighbor list by traversing the half shell of each cell.
+    void make_half_shell(neighbor_list_type& neighbor_list, const system_type& sys,
+                         const potential_type& pot, const real_type r_c2)
+    {
+        const auto leading_participants = pot.leading_participants();
+
+        this->is_leading_.assign(sys.size(), 0);
+#pragma omp parallel for
+        for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+        {
+            this->is_leading_[leading_participants[idx]] = 1;
+        }
+
+#pragma omp parallel
+        {
+            auto& pairs = this->pairs_threads_[omp_get_thread_num()];
+            pairs.clear(); // keep capacity
+
+            // the number of particles in a cell varies. balance it dynamically
+#pragma omp for schedule(dynamic, 16)
+            for(std::size_t cell_idx=0; cell_idx<cell_list_.size(); ++cell_idx)
+            {
+                find_half_shell_pairs(sys, pot, this->cell_list_,
+                    this->is_leading_, cell_idx, cell_idx+1, r_c2, pairs);
+            }
+        }
+
+        std::size_t total_pairs = 0;
+        for(const auto& pairs : this->pairs_threads_)
+        {
+            total_pairs += pairs.size();
+        }
+        this->pairs_.resize(total_pairs);
+
+#pragma omp parallel for schedule(static, 1)
+        for(std::size_t th=0; th < pairs_threads_.size(); ++th)
+        {
+            std::size_t pair_offset = 0;
+            for(std::size_t t=0; t<th; ++t)
+            {
+                pair_offset += pairs_threads_[t].size();
+            }
+            std::copy(pairs_threads_[th].begin(), pairs_threads_[th].end(),
+                      this->pairs_.begin() + pair_offset);
+        }
+
+        // collect pairs by the leading participant
+        omp::counting_sort(this->pairs_, this->pairs_buf_, this->pair_offsets_,
+            sys.size(), [](const particle_neighbor_pair& p) noexcept -> std::size_t {
+                return p.first;
+            });
+
+        // make the result consistent with NaivePairCalculation...
+#pragma omp parallel for schedule(dynamic, 16)
+        for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            std::sort(this->pairs_.begin() + pair_offsets_[i],
+                      this->pairs_.begin() + pair_offsets_[i+1],
+                [](const particle_neighbor_pair& lhs,
+                   const particle_neighbor_pair& rhs) noexcept -> bool {
+                    return lhs.second < rhs.second;
+                });
+        }
+
+        auto& principal_neighbors = neighbor_list.neighbors();
+        auto& principal_ranges    = neighbor_list.ranges();
+
+        // pairs_ contains only leading participants, so the ranges of the
+        // other particles become empty.
+        principal_neighbors.resize(this->pairs_.size());
+        principal_ranges.assign(pair_offsets_.begin(), pair_offsets_.end());
+
+#pragma omp parallel for
+        for(std::size_t k=0; k<this->pairs_.size(); ++k)
+        {
+            principal_neighbors[k] = this->pairs_[k].second;
+        }
+        return;
+    }
+
     std::size_t calc_index(const coordinate_type& pos) const noexcept
     {
         const auto ofs = pos - this->lower_bound_;
@@ -471,6 +580,7 @@ class PeriodicGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
     real_type   cutoff_;
     real_type   margin_;
     real_type   current_margin_;
+    CellListStencil stencil_;
     real_type   r_x_;
     real_type   r_y_;
     real_type   r_z_;
@@ -483,13 +593,22 @@ class PeriodicGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
     cell_list_type            cell_list_;
     cell_index_container_type index_by_cell_;
     cell_index_container_type index_by_cell_buf_;
+    std::vector<std::size_t>  cell_offsets_;
     // index_by_cell_ has {particle idx, cell idx} and sorted by cell idx
     // first term of cell list contains first and last idx of index_by_cell
+    // cell_offsets_[i] is the first idx of cell i in index_by_cell_
 
     std::vector<std::size_t> offsets_threads_;
     std::vector<std::vector<neighbor_type>> partners_threads_;
     std::vector<std::vector<neighbor_type>> neighbors_threads_;
     std::vector<std::vector<std::size_t>>   nranges_threads_;
+
+    // used in the half shell traversal. pairs_ has {particle idx, neighbor}.
+    std::vector<char>                                is_leading_;
+    std::vector<std::vector<particle_neighbor_pair>> pairs_threads_;
+    std::vector<particle_neighbor_pair>              pairs_;
+    std::vector<particle_neighbor_pair>              pairs_buf_;
+    std::vector<std::size_t>                         pair_offsets_;
 };
 } // mjolnir
 
@@ -3,12 +3,37 @@
 #include <mjolnir/util/logger.hpp>
 #include <mjolnir/util/aligned_allocator.hpp>
 #include <mjolnir/util/aligned_storage.hpp>
+#include <mjolnir/util/philox.hpp>
+#include <mjolnir/util/macro.hpp>
 #include <mjolnir/core/RandomNumberGenerator.hpp>
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
 
 namespace mjolnir
 {
 
+// RandomNumberGenerator for OpenMP implementation.
+//
+// It uses a counter-based generator, Philox4x32-10, instead of std::mt19937.
+// There are two kinds of streams.
+//
+// - A stream keyed by particle index. `gaussian_vector(idx)` returns a random
+//   vector determined only by (seed, block, idx). So the random numbers given
+//   to a particle do not depend on the number of threads or on the scheduling.
+//   (Trajectories still depend on the number of threads in the last digits
+//   because forces are summed up in a different order.)
+//   Call `next_block()` (outside of a parallel region) before generating a
+//   new set of vectors, e.g. once per step.
+//   One Philox call gives 4 x 32 bits, i.e. two Box-Muller pairs. A vector
+//   needs only 3 numbers, so the sine of the second pair is not calculated.
+//   Caching it for the next call would make the vector depend on the order of
+//   the calls.
+// - A stream for each thread, used by `uniform_real01()` and `gaussian()`.
+//   They are for the other uses, e.g. random numbers in a serial region.
+//   `gaussian()` keeps the second number of a Box-Muller pair and returns it
+//   in the next call.
+//
+// The internal state is only the seed, counters, and whether each thread has
+// a cached number. The cached number is re-generated from the counter.
 template<typename realT, template<typename, typename> class boundaryT>
 class RandomNumberGenerator<OpenMPSimulatorTraits<realT, boundaryT>>
 {
@@ -19,69 +44,101 @@ class RandomNumberGenerator<OpenMPSimulatorTraits<realT, boundaryT>>
 
     static constexpr std::size_t cache_alignment = 64;
 
-    using rng_type = aligned_storage<std::mt19937, cache_alignment>;
-    using nrm_type = aligned_storage<std::normal_distribution<real_type>,
-                                     cache_alignment>;
+    using generator_type  = philox4x32;
+
+    struct thread_state
+    {
+        std::uint64_t counter;   // number of Philox calls in this thread
+        bool          has_spare; // true if `spare` is not used yet
+        real_type     spare;     // the second one of the last Box-Muller pair
+    };
+    using thread_state_type = aligned_storage<thread_state, cache_alignment>;
 
   public:
     explicit RandomNumberGenerator(const std::uint32_t seed)
-        : seed_(seed),
-          rngs_(omp_get_max_threads()),
-          nrms_(omp_get_max_threads(),
-                nrm_type(std::normal_distribution<real_type>(0.0, 1.0)))
+        : seed_(seed), block_(0),
+          states_(omp_get_max_threads(), thread_state_type(thread_state{0, false, 0}))
     {
         MJOLNIR_GET_DEFAULT_LOGGER();
         MJOLNIR_LOG_FUNCTION();
-        std::seed_seq              sseq{seed};
-        std::vector<std::uint32_t> buf(omp_get_max_threads());
-        sseq.generate(buf.begin(), buf.end());
-        for(std::size_t i=0, e=omp_get_max_threads(); i<e; ++i)
-        {
-            MJOLNIR_LOG_INFO("the ", i, "-th RNG is seeded by ", buf.at(i));
-            rngs_.at(i).value.seed(buf.at(i));
-        }
+        MJOLNIR_LOG_INFO("Philox4x32-10 is seeded by ", seed);
     }
     ~RandomNumberGenerator() = default;
 
     explicit RandomNumberGenerator(const std::string& internal_state)
-        : rngs_(omp_get_max_threads()), nrms_(omp_get_max_threads())
+        : seed_(0), block_(0),
+          states_(omp_get_max_threads(), thread_state_type(thread_state{0, false, 0}))
     {
+        MJOLNIR_GET_DEFAULT_LOGGER();
         std::istringstream iss(internal_state);
-        iss >> this->seed_;
-        for(auto& rng : this->rngs_)
+        std::size_t num_counters = 0;
+        iss >> this->seed_ >> this->block_ >> num_counters;
+        if(iss.fail())
+        {
+            throw_exception<std::runtime_error>("[error] mjolnir::"
+                "RandomNumberGenerator<OMP>: parse error in ", internal_state);
+        }
+        if(num_counters != this->states_.size())
         {
-            iss >> rng.value;
+            // The per-particle stream does not depend on the number of threads.
+            // Only the per-thread streams are affected.
+            MJOLNIR_LOG_WARN("RandomNumberGenerator<OMP>: the number of threads"
+                " has been changed from ", num_counters, " to ",
+                this->states_.size(), ". The per-thread streams are resized.");
         }
-        for(auto& nrm : this->nrms_)
+        for(std::size_t i=0; i<num_counters; ++i)
         {
-            iss >> nrm.value;
+            std::uint64_t c;
+            iss >> c;
+            if(i < this->states_.size())
+            {
+                this->states_[i].value.counter = c;
+            }
         }
         if(iss.fail())
         {
             throw_exception<std::runtime_error>("[error] mjolnir::"
                 "RandomNumberGenerator<OMP>: parse error in ", internal_state);
         }
+        // flags of the cached numbers follow the counters. They are missing
+        // in a state written by an older version.
+        for(std::size_t i=0; i<num_counters; ++i)
+        {
+            int has_spare = 0;
+            if(!(iss >> has_spare)) {break;}
+            if(i < this->states_.size() && has_spare != 0)
+            {
+                auto& state = this->states_[i].value;
+                real_type z0;
+                const auto r = this->generate(i, state.counter - 1);
+                philox_box_muller(r[0], r[1], z0, state.spare);
+                state.has_spare = true;
+            }
+        }
     }
     std::string internal_state() const
     {
         std::ostringstream oss;
-        oss << this->seed_ << ' ';
-        for(const auto& rng : this->rngs_)
+        oss << this->seed_ << ' ' << this->block_ << ' ' << this->states_.size();
+        for(const auto& state : this->states_)
         {
-            oss << rng.value << ' ';
+            oss << ' ' << state.value.counter;
         }
-        for(const auto& nrm : this->nrms_)
+        for(const auto& state : this->states_)
         {
-            oss << nrm.value << ' ';
+            oss << ' ' << (state.value.has_spare ? 1 : 0);
         }
         return oss.str();
     }
 
+    // ------------------------------------------------------------------------
+    // per-thread stream
+
     real_type uniform_real01()
     {
-        auto& rng = this->rngs_.at(omp_get_thread_num()).value;
-        return std::generate_canonical<
-            real_type, std::numeric_limits<real_type>::digits>(rng);
+        auto& state = this->states_.at(omp_get_thread_num()).value;
+        const auto r = this->generate(omp_get_thread_num(), state.counter++);
+        return philox_uniform<real_type>::invoke(r[0], r[1]);
     }
     real_type uniform_real(const real_type min, const real_type max)
     {
@@ -90,29 +147,98 @@ class RandomNumberGenerator<OpenMPSimulatorTraits<realT, boundaryT>>
 
     real_type gaussian()
     {
-        const std::size_t thread_id = omp_get_thread_num();
-        auto& rng = this->rngs_.at(thread_id).value;
-        auto& nrm = this->nrms_.at(thread_id).value;
-        return nrm(rng);
+        auto& state = this->states_.at(omp_get_thread_num()).value;
+        if(state.has_spare)
+        {
+            state.has_spare = false;
+            return state.spare;
+        }
+        const auto r = this->generate(omp_get_thread_num(), state.counter++);
+        real_type z0;
+        philox_box_muller(r[0], r[1], z0, state.spare);
+        state.has_spare = true;
+        return z0;
     }
     real_type gaussian(const real_type mean, const real_type stddev)
     {
-        const std::size_t thread_id = omp_get_thread_num();
-        auto& rng = this->rngs_.at(thread_id).value;
-        auto& nrm = this->nrms_.at(thread_id).value;
-        return nrm(rng) * stddev + mean;
+        return this->gaussian() * stddev + mean;
     }
 
+    // ------------------------------------------------------------------------
+    // per-particle stream
+
+    // Do NOT call this from parallel region.
+    void next_block() noexcept {this->block_ += 1;}
+
+    // a vector of standard normal random numbers for the `idx`-th particle in
+    // the current block. It can be called from any thread.
+    coordinate_type gaussian_vector(const std::size_t idx) const noexcept
+    {
+        std::uint32_t c0, c1, c2, c3;
+        this->set_particle_counter(idx, c0, c1, c2, c3);
+        generator_type::generate(c0, c1, c2, c3, this->seed_, 0u);
+
+        real_type x, y;
+        philox_box_muller(c0, c1, x, y);
+        const real_type z = philox_box_muller_first<real_type>(c2, c3);
+        return math::make_coordinate<coordinate_type>(x, y, z);
+    }
+
+    // fill `out[0, last-first)` with `gaussian_vector(first ... last-1)`.
+    // Random bits for a chunk of particles are generated at once in a loop
+    // that can be vectorized.
+    void gaussian_vectors(const std::size_t first, const std::size_t last,
+                          coordinate_type* out) const noexcept
+    {
+        constexpr std::size_t chunk = 64;
+        alignas(cache_alignment) std::uint32_t c0[chunk];
+        alignas(cache_alignment) std::uint32_t c1[chunk];
+        alignas(cache_alignment) std::uint32_t c2[chunk];
+        alignas(cache_alignment) std::uint32_t c3[chunk];
+        alignas(cache_alignment) real_type     xs[chunk];
+        alignas(cache_alignment) real_type     ys[chunk];
+        alignas(cache_alignment) real_type     zs[chunk];
+
+        for(std::size_t offset=first; offset<last; offset+=chunk)
+        {
+            const std::size_t n = std::min(chunk, last - offset);
+            for(std::size_t k=0; k<n; ++k)
+            {
+                this->set_particle_counter(offset + k, c0[k], c1[k], c2[k], c3[k]);
+            }
+            const std::uint32_t key = this->seed_;
+            MJOLNIR_SIMD_LOOP
+            for(std::size_t k=0; k<chunk; ++k)
+            {
+                generator_type::generate(c0[k], c1[k], c2[k], c3[k], key, 0u);
+            }
+            MJOLNIR_SIMD_LOOP
+            for(std::size_t k=0; k<chunk; ++k)
+            {
+                philox_box_muller(c0[k], c1[k], xs[k], ys[k]);
+                zs[k] = philox_box_muller_first<real_type>(c2[k], c3[k]);
+            }
+            for(std::size_t k=0; k<n; ++k)
+            {
+                out[offset - first + k] =
+                    math::make_coordinate<coordinate_type>(xs[k], ys[k], zs[k]);
+            }
+        }
+        return;
+    }
+
+    std::uint32_t seed()  const noexcept {return seed_;}
+    std::uint64_t block() const noexcept {return block_;}
+
     bool operator==(const RandomNumberGenerator<traits_type>& other) const
     {
-        return this->rngs_.size() == other.rngs_.size() && std::equal(
-                this->rngs_.begin(), this->rngs_.end(), other.rngs_.begin(),
-                [](const rng_type& lhs, const rng_type& rhs) noexcept {
-                    return lhs.value == rhs.value;
-                }) && this->nrms_.size() == other.nrms_.size() && std::equal(
-                this->nrms_.begin(), this->nrms_.end(), other.nrms_.begin(),
-                [](const nrm_type& lhs, const nrm_type& rhs) noexcept {
-                    return lhs.value == rhs.value;
+        return this->seed_ == other.seed_ && this->block_ == other.block_ &&
+            this->states_.size() == other.states_.size() && std::equal(
+                this->states_.begin(), this->states_.end(),
+                other.states_.begin(),
+                [](const thread_state_type& lhs, const thread_state_type& rhs) noexcept {
+                    return lhs.value.counter   == rhs.value.counter &&
+                           lhs.value.has_spare == rhs.value.has_spare;
                 });
     }
     bool operator!=(const RandomNumberGenerator<traits_type>& other) const
@@ -121,10 +247,38 @@ class RandomNumberGenerator<OpenMPSimulatorTraits<realT, boundaryT>>
     }
 
   private:
-    std::uint32_t seed_;
 
-    std::vector<rng_type, aligned_allocator<rng_type>> rngs_;
-    std::vector<nrm_type, aligned_allocator<nrm_type>> nrms_;
+    // counter = {idx, block}, key = {seed, 0}.
+    void set_particle_counter(const std::size_t idx,
+            std::uint32_t& c0, std::uint32_t& c1,
+            std::uint32_t& c2, std::uint32_t& c3) const noexcept
+    {
+        const std::uint64_t i = idx;
+        c0 = static_cast<std::uint32_t>(i);
+        c1 = static_cast<std::uint32_t>(i >> 32);
+        c2 = static_cast<std::uint32_t>(block_);
+        c3 = static_cast<std::uint32_t>(block_ >> 32);
+        return;
+    }
+
+    // counter = {thread-local count, 0}, key = {seed, thread_id + 1}.
+    typename generator_type::counter_type
+    generate(const std::size_t thread_id, const std::uint64_t count) const noexcept
+    {
+        const typename generator_type::counter_type ctr{{
+            static_cast<std::uint32_t>(count),
+            static_cast<std::uint32_t>(count >> 32), 0u, 0u
+        }};
+        const typename generator_type::key_type key{{
+            this->seed_, static_cast<std::uint32_t>(thread_id + 1)
+        }};
+        return generator_type::generate(ctr, key);
+    }
+
+  private:
+    std::uint32_t seed_;
+    std::uint64_t block_;
+    std::vector<thread_state_type, aligned_allocator<thread_state_type>> states_;
 };
 
 template<typename realT, template<typename, typename> class boundaryT>
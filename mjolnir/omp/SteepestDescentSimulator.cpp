@@ -0,0 +1,13 @@
+#include <mjolnir/omp/SteepestDescentSimulator.hpp>
+
+#ifndef MJOLNIR_SEPARATE_BUILD
+#error "MJOLNIR_SEPARATE_BUILD flag is required"
+#endif
+
+namespace mjolnir
+{
+template class SteepestDescentSimulator<OpenMPSimulatorTraits<double, UnlimitedBoundary>       >;
+template class SteepestDescentSimulator<OpenMPSimulatorTraits<float,  UnlimitedBoundary>       >;
+template class SteepestDescentSimulator<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>>;
+template class SteepestDescentSimulator<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>>;
+} // mjolnir
@@ -1,13 +1,53 @@
 #ifndef MJOLNIR_OMP_SYSTEM_HPP
 #define MJOLNIR_OMP_SYSTEM_HPP
 #include <mjolnir/util/aligned_allocator.hpp>
+#include <mjolnir/util/packed_coordinates.hpp>
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
 #include <mjolnir/omp/RandomNumberGenerator.hpp>
 #include <mjolnir/core/System.hpp>
+#include <algorithm>
+#include <ostream>
+#include <cstdint>
 
 namespace mjolnir
 {
 
+// The way to merge thread-local forces into the main force array.
+//
+// - ThreadLocal: each thread has an N-sized buffer. It is the fastest for
+//   small systems, but postprocess_forces walks (threads x N) elements and
+//   the memory consumption also scales as (threads x N).
+// - BlockSparse: thread-local buffers are split into blocks of
+//   `force_block_size` particles. When a thread writes a force to a block for
+//   the first time, the block is taken from a pool of zero-cleared blocks of
+//   the thread. postprocess_forces merges only the blocks touched in the
+//   current step, returns the blocks that have not been touched for
+//   `force_block_max_idle` steps to the pool, and refills (or trims) the
+//   pool to `force_block_spares` blocks. Before the first step, the pool has
+//   the share of blocks for each thread. So the force loop does not allocate
+//   memory unless a thread starts writing to more new blocks than the pool.
+//   The saving depends on the spatial ordering of particles. If each thread
+//   handles a spatially close set of particles whose indices are also close
+//   (see `reorder` in SpatialPartition), the memory and the cost scale with
+//   the work actually done. Otherwise, it approaches ThreadLocal.
+enum class ForceReduction : std::uint8_t
+{
+    ThreadLocal,
+    BlockSparse,
+};
+
+template<typename charT, typename traitsT>
+std::basic_ostream<charT, traitsT>&
+operator<<(std::basic_ostream<charT, traitsT>& os, const ForceReduction fr)
+{
+    switch(fr)
+    {
+        case ForceReduction::ThreadLocal: {os << "ThreadLocal"; return os;}
+        case ForceReduction::BlockSparse: {os << "BlockSparse"; return os;}
+        default:                          {os << "Unknown";     return os;}
+    }
+}
+
 template<typename realT, template<typename, typename> class boundaryT>
 class System<OpenMPSimulatorTraits<realT, boundaryT>>
 {
@@ -29,16 +69,36 @@ class System<OpenMPSimulatorTraits<realT, boundaryT>>
     using real_container_type          = std::vector<real_type>;
     using coordinate_container_type    = std::vector<coordinate_type>;
     using string_container_type        = std::vector<std::string>;
+    using packed_coordinate_type       = packed_coordinates<real_type, coordinate_type>;
 
-    static constexpr std::size_t cache_alignment = 64;
+    static constexpr std::size_t cache_alignment  = 64;
+    static constexpr std::size_t force_block_shift = 8;
+    static constexpr std::size_t force_block_size  = 1 << force_block_shift;
+    static constexpr std::size_t force_block_mask  = force_block_size - 1;
+    static constexpr std::size_t force_block_spares   = 4;
+    static constexpr std::uint8_t force_block_max_idle = 16;
+    static constexpr bool packed_coordinates_enabled =
+        uses_packed_coordinates<traits_type>::value;
 
     template<typename T>
     using cache_aligned_allocator = aligned_allocator<T, cache_alignment>;
 
+    // thread-local force buffer in BlockSparse mode.
+    // an empty block is not assigned to the thread.
+    struct force_blocks_type
+    {
+        std::vector<coordinate_container_type> blocks;
+        std::vector<std::uint8_t>              idle;   // steps since last touch
+        std::vector<coordinate_container_type> spares; // zero-cleared blocks
+    };
+
   public:
 
-    System(const std::size_t num_particles, const boundary_type& bound)
+    System(const std::size_t num_particles, const boundary_type& bound,
+           const ForceReduction reduction = ForceReduction::ThreadLocal)
         : velocity_initialized_(false), force_initialized_(false),
+          mixed_precision_(false),
+          force_reduction_(reduction),
           boundary_(bound), attributes_(),
           virial_(0,0,0, 0,0,0, 0,0,0),
           virial_threads_(omp_get_max_threads(),
@@ -47,12 +107,11 @@ class System<OpenMPSimulatorTraits<realT, boundaryT>>
           masses_   (num_particles), rmasses_   (num_particles),
           positions_(num_particles), velocities_(num_particles),
           forces_main_(num_particles),
-          forces_threads_(omp_get_max_threads(),
-              coordinate_container_type(num_particles,
-                  math::make_coordinate<coordinate_type>(0,0,0)),
-              cache_aligned_allocator<coordinate_container_type>{}),
-          names_(num_particles), groups_(num_particles)
-    {}
+          names_(num_particles), groups_(num_particles),
+          packed_positions_(packed_coordinates_enabled ? num_particles : 0)
+    {
+        this->allocate_thread_local_forces();
+    }
     ~System() = default;
 
     void initialize(rng_type& rng)
@@ -81,12 +140,12 @@ class System<OpenMPSimulatorTraits<realT, boundaryT>>
 
         // generate Maxwell-Boltzmann distribution
         const real_type kBT = kB * T_ref;
+        rng.next_block();
+        rng.gaussian_vectors(0, this->size(), this->velocities_.data());
+#pragma omp parallel for
         for(std::size_t i=0; i<this->size(); ++i)
         {
-            const auto vel_coef = std::sqrt(kBT / this->mass(i));
-            math::X(this->velocity(i)) = rng.gaussian(0, vel_coef);
-            math::Y(this->velocity(i)) = rng.gaussian(0, vel_coef);
-            math::Z(this->velocity(i)) = rng.gaussian(0, vel_coef);
+            this->velocity(i) *= std::sqrt(kBT / this->mass(i));
         }
         MJOLNIR_LOG_NOTICE("done.");
         return;
@@ -155,12 +214,62 @@ class System<OpenMPSimulatorTraits<realT, boundaryT>>
     coordinate_type const&
     force_thread(std::size_t thread_num, std::size_t particle_id) const noexcept
     {
-        return forces_threads_[thread_num][particle_id];
+        if(force_reduction_ == ForceReduction::ThreadLocal)
+        {
+            return forces_threads_[thread_num][particle_id];
+        }
+        const auto& blk = force_blocks_[thread_num].blocks[particle_id >> force_block_shift];
+        if(blk.empty()) {return zero_force_;}
+        return blk[particle_id & force_block_mask];
     }
     coordinate_type&
     force_thread(std::size_t thread_num, std::size_t particle_id)       noexcept
     {
-        return forces_threads_[thread_num][particle_id];
+        if(force_reduction_ == ForceReduction::ThreadLocal)
+        {
+            return forces_threads_[thread_num][particle_id];
+        }
+        // only the thread `thread_num` touches its own buffer. no lock needed.
+        const std::size_t block = particle_id >> force_block_shift;
+        auto& buf = force_blocks_[thread_num];
+        auto& blk = buf.blocks[block];
+        if(blk.empty())
+        {
+            if(!buf.spares.empty())
+            {
+                blk.swap(buf.spares.back());
+                buf.spares.pop_back();
+            }
+            else // the pool runs out. it rarely happens after the first step.
+            {
+                blk.resize(force_block_size,
+                           math::make_coordinate<coordinate_type>(0, 0, 0));
+            }
+        }
+        buf.idle[block] = 0;
+        return blk[particle_id & force_block_mask];
+    }
+
+    ForceReduction force_reduction() const noexcept {return force_reduction_;}
+
+    // the number of blocks assigned to a thread in BlockSparse mode.
+    // mainly for testing purpose.
+    std::size_t num_force_blocks(std::size_t thread_num) const noexcept
+    {
+        if(force_reduction_ == ForceReduction::ThreadLocal) {return 0;}
+        const auto& blocks = force_blocks_[thread_num].blocks;
+        return static_cast<std::size_t>(std::count_if(blocks.begin(), blocks.end(),
+            [](const coordinate_container_type& blk) {return !blk.empty();}));
+    }
+
+    // switch the reduction scheme. It should be called between steps, when
+    // all the thread-local forces are already merged.
+    void set_force_reduction(const ForceReduction reduction)
+    {
+        if(reduction == this->force_reduction_) {return;}
+        this->force_reduction_ = reduction;
+        this->allocate_thread_local_forces();
+        return;
     }
 
     matrix33_type&       virial()       noexcept {return virial_;}
@@ -177,9 +286,24 @@ class System<OpenMPSimulatorTraits<realT, boundaryT>>
 
     void preprocess_forces()  noexcept
     {
-        // Do nothing. We already allocated the thread local forces and virials
-        // with zero values. Also, in the end of each step, postprocess_forces
-        // zero-clears everything.
+        // We already allocated the thread local forces (or the block tables)
+        // and virials with zero values. Also, in the end of each step, postprocess_forces zero-clears
+        // everything. The only thing to do is to update packed positions.
+        if(packed_coordinates_enabled)
+        {
+            const std::size_t N = this->size();
+            real_type* const xs = packed_positions_.x();
+            real_type* const ys = packed_positions_.y();
+            real_type* const zs = packed_positions_.z();
+#pragma omp parallel for
+            for(std::size_t i=0; i<N; ++i)
+            {
+                xs[i] = math::X(positions_[i]);
+                ys[i] = math::Y(positions_[i]);
+                zs[i] = math::Z(positions_[i]);
+            }
+        }
+        return;
     }
 
     // Since all the forces will be calculated in different cores, we need to
@@ -195,6 +319,12 @@ class System<OpenMPSimulatorTraits<realT, boundaryT>>
             virial_threads_[thread_id] = matrix33_type(0,0,0, 0,0,0, 0,0,0);
         }
 
+        if(force_reduction_ == ForceReduction::BlockSparse)
+        {
+            this->merge_force_blocks();
+            return;
+        }
+
 #pragma omp parallel for
         for(std::size_t i=0; i<this->size(); ++i)
         {
@@ -235,12 +365,117 @@ class System<OpenMPSimulatorTraits<realT, boundaryT>>
     bool  force_initialized() const noexcept {return force_initialized_;}
     bool& force_initialized()       noexcept {return force_initialized_;}
 
+    // see core/System.hpp
+    bool  mixed_precision() const noexcept {return mixed_precision_;}
+    bool& mixed_precision()       noexcept {return mixed_precision_;}
+
     coordinate_container_type const& forces() const noexcept {return forces_main_;}
     coordinate_container_type&       forces()       noexcept {return forces_main_;}
 
+    // structure-of-arrays copy of positions that the batched pair kernels read
+    // (see forcefield/global/BatchedPairKernel.hpp). It is empty if
+    // `packed_coordinates_enabled` is false. Since forces are
+    // accumulated in thread-local buffers, there is no packed force buffer in
+    // the OpenMP implementation.
+    packed_coordinate_type const& packed_positions() const noexcept {return packed_positions_;}
+
+  private:
+
+    void allocate_thread_local_forces()
+    {
+        const std::size_t max_threads = omp_get_max_threads();
+        this->forces_threads_.clear();
+        this->force_blocks_  .clear();
+        this->forces_threads_.shrink_to_fit();
+        this->force_blocks_  .shrink_to_fit();
+
+        if(force_reduction_ == ForceReduction::ThreadLocal)
+        {
+            this->forces_threads_.resize(max_threads, coordinate_container_type(
+                num_particles_, math::make_coordinate<coordinate_type>(0,0,0)));
+        }
+        else
+        {
+            const std::size_t num_blocks =
+                (num_particles_ + force_block_mask) >> force_block_shift;
+            // in the first step, each thread will take its share of blocks.
+            const std::size_t num_spares = std::max(force_block_spares,
+                    (num_blocks + max_threads - 1) / max_threads);
+            this->force_blocks_.resize(max_threads);
+            for(auto& buf : this->force_blocks_)
+            {
+                buf.blocks.resize(num_blocks);
+                buf.idle  .resize(num_blocks, force_block_max_idle);
+                buf.spares.resize(num_spares, coordinate_container_type(
+                    force_block_size, math::make_coordinate<coordinate_type>(0,0,0)));
+            }
+        }
+        return;
+    }
+
+    // merge only the blocks that are touched by any thread in this step.
+    // Blocks that are not touched for a while are returned to the pool, and
+    // the pool is refilled here, out of the force loop.
+    void merge_force_blocks() noexcept
+    {
+        const std::size_t max_threads = this->force_blocks_.size();
+        const std::size_t num_blocks  = (max_threads == 0) ? 0 :
+                                        this->force_blocks_.front().idle.size();
+#pragma omp parallel for schedule(dynamic, 16)
+        for(std::size_t block=0; block<num_blocks; ++block)
+        {
+            const std::size_t first = block << force_block_shift;
+            const std::size_t last  = std::min(first + force_block_size,
+                                               this->num_particles_);
+            for(std::size_t thread_id=0; thread_id<max_threads; ++thread_id)
+            {
+                auto& buf = this->force_blocks_[thread_id];
+                if(buf.idle[block] != 0) {continue;}
+
+                auto& blk = buf.blocks[block];
+                for(std::size_t i=first; i<last; ++i)
+                {
+                    auto& f = blk[i - first];
+                    this->forces_main_[i] += f;
+                    f = math::make_coordinate<coordinate_type>(0, 0, 0);
+                }
+            }
+        }
+
+        // each buffer (and its pool) is handled by one thread.
+#pragma omp parallel for
+        for(std::size_t thread_id=0; thread_id<max_threads; ++thread_id)
+        {
+            auto& buf = this->force_blocks_[thread_id];
+            for(std::size_t block=0; block<num_blocks; ++block)
+            {
+                auto& blk = buf.blocks[block];
+                if(blk.empty()) {continue;}
+                if(++buf.idle[block] < force_block_max_idle) {continue;}
+
+                // it is already zero-cleared when it is merged.
+                if(buf.spares.size() < force_block_spares)
+                {
+                    buf.spares.emplace_back();
+                    buf.spares.back().swap(blk);
+                }
+                else
+                {
+                    coordinate_container_type().swap(blk); // release the memory
+                }
+            }
+            // the capacity is kept, so emplace_back above does not re-allocate.
+            buf.spares.resize(force_block_spares, coordinate_container_type(
+                force_block_size, math::make_coordinate<coordinate_type>(0,0,0)));
+        }
+        return;
+    }
+
   private:
 
     bool           velocity_initialized_, force_initialized_;
+    bool           mixed_precision_;
+    ForceReduction force_reduction_;
     boundary_type  boundary_;
     attribute_type attributes_;
 
@@ -253,15 +488,34 @@ class System<OpenMPSimulatorTraits<realT, boundaryT>>
     coordinate_container_type    positions_;
     coordinate_container_type    velocities_;
     coordinate_container_type    forces_main_;
-    // thread-local forces
+    // thread-local forces (ThreadLocal)
     std::vector<coordinate_container_type,
                 cache_aligned_allocator<coordinate_container_type>
         > forces_threads_;
+    // thread-local forces (BlockSparse)
+    std::vector<force_blocks_type,
+                cache_aligned_allocator<force_blocks_type>
+        > force_blocks_;
+    coordinate_type              zero_force_ =
+        math::make_coordinate<coordinate_type>(0, 0, 0);
     string_container_type        names_;
     string_container_type        groups_;
+    packed_coordinate_type       packed_positions_;
 
     // names and groups are in Topology class
 };
+template<typename realT, template<typename, typename> class boundaryT>
+constexpr bool System<OpenMPSimulatorTraits<realT, boundaryT>>::packed_coordinates_enabled;
+template<typename realT, template<typename, typename> class boundaryT>
+constexpr std::size_t System<OpenMPSimulatorTraits<realT, boundaryT>>::force_block_shift;
+template<typename realT, template<typename, typename> class boundaryT>
+constexpr std::size_t System<OpenMPSimulatorTraits<realT, boundaryT>>::force_block_size;
+template<typename realT, template<typename, typename> class boundaryT>
+constexpr std::size_t System<OpenMPSimulatorTraits<realT, boundaryT>>::force_block_mask;
+template<typename realT, template<typename, typename> class boundaryT>
+constexpr std::size_t System<OpenMPSimulatorTraits<realT, boundaryT>>::force_block_spares;
+template<typename realT, template<typename, typename> class boundaryT>
+constexpr std::uint8_t System<OpenMPSimulatorTraits<realT, boundaryT>>::force_block_max_idle;
 
 #ifdef MJOLNIR_SEPARATE_BUILD
 extern template class System<OpenMPSimulatorTraits<double, UnlimitedBoundary>>;
@@ -2,6 +2,7 @@
 #define MJOLNIR_OMP_3SPN2_BASE_BASE_INTERACTION_HPP
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
 #include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/DisplacementTracker.hpp>
 #include <mjolnir/omp/UnlimitedGridCellList.hpp>
 #include <mjolnir/omp/PeriodicGridCellList.hpp>
 #include <mjolnir/forcefield/3SPN2/ThreeSPN2BaseBaseInteraction.hpp>
@@ -80,6 +81,7 @@ class ThreeSPN2BaseBaseInteraction<
 
     void      calc_force (system_type& sys)       const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         constexpr auto pi        = math::constants<real_type>::pi();
         constexpr auto two_pi    = math::constants<real_type>::two_pi();
         constexpr auto tolerance = math::abs_tolerance<real_type>();
@@ -554,6 +556,7 @@ class ThreeSPN2BaseBaseInteraction<
 
     real_type calc_energy(const system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         constexpr auto pi        = math::constants<real_type>::pi();
         constexpr auto two_pi    = math::constants<real_type>::two_pi();
 
@@ -807,6 +810,7 @@ class ThreeSPN2BaseBaseInteraction<
 
     real_type calc_force_and_energy(system_type& sys) const noexcept override
     {
+        const auto tuning_timer = this->partition_.tuning_timer();
         constexpr auto pi        = math::constants<real_type>::pi();
         constexpr auto two_pi    = math::constants<real_type>::two_pi();
         constexpr auto tolerance = math::abs_tolerance<real_type>();
@@ -62,6 +62,7 @@ class UnderdampedLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
 
             ff->calc_force(sys);
 
+            rng.next_block();
 #pragma omp parallel for
             for(std::size_t i=0; i<sys.size(); ++i)
             {
@@ -70,7 +71,7 @@ class UnderdampedLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
 
                 sqrt_gamma_over_mass_[i] = std::sqrt(gammas_[i] * rmass);
                 acceleration_[i]         = force * rmass +
-                    this->gen_gaussian_vec(rng, this->noise_coef_ * sqrt_gamma_over_mass_[i]);
+                    (this->noise_coef_ * sqrt_gamma_over_mass_[i]) * rng.gaussian_vector(i);
             }
         }
         return;
@@ -114,6 +115,8 @@ class UnderdampedLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
         ff->calc_force(sys);
 
         // calc a(t+dt) and v(t+dt), generate noise
+        // random vectors do not depend on the thread that generates them.
+        rng.next_block();
 #pragma omp parallel for
         for(std::size_t i=0; i<sys.size(); ++i)
         {
@@ -122,7 +125,7 @@ class UnderdampedLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
             const auto& f  = sys.force(i);
             auto&       a  = this->acceleration_[i];
 
-            a  = f * rm + gen_gaussian_vec(rng, noise_coef_ * sqrt_gamma_over_mass_[i]);
+            a  = f * rm + (noise_coef_ * sqrt_gamma_over_mass_[i]) * rng.gaussian_vector(i);
             v += halfdt_ * (1 - gammas_[i] * halfdt_) * a;
         }
 
@@ -153,16 +156,6 @@ class UnderdampedLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
 
     std::vector<real_type> const& parameters() const noexcept {return gammas_;}
 
-  private:
-
-    coordinate_type gen_gaussian_vec(rng_type& rng, const real_type coef)
-    {
-        return math::make_coordinate<coordinate_type>(
-                rng.gaussian(0, coef),
-                rng.gaussian(0, coef),
-                rng.gaussian(0, coef));
-    }
-
   private:
     real_type dt_;
     real_type halfdt_;
@@ -25,25 +25,30 @@ class UnlimitedGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
     using neighbor_type      = typename base_type::neighbor_type;
     using range_type         = typename base_type::range_type;
 
-    static constexpr std::size_t  dim_size () {return 8;}
-    static constexpr std::int64_t dim      () {return 8;}
-    static constexpr real_type mesh_epsilon() {return 1e-6;}
+    using cell_key_type = std::uint64_t;
 
-    using particle_cell_idx_pair    = std::pair<std::size_t, std::size_t>;
+    static constexpr std::size_t  key_bits()     {return 21u;}
+    static constexpr std::int64_t key_limit()    {return (std::int64_t(1) << 20) - 2;}
+    static constexpr real_type    mesh_epsilon() {return 1e-6;}
+
+    using particle_cell_idx_pair    = std::pair<std::size_t, cell_key_type>;
     using cell_index_container_type = std::vector<particle_cell_idx_pair>;
     using cell_index_const_iterator = typename cell_index_container_type::const_iterator;
     using adjacent_cell_idx         = std::array<std::size_t, 27>;
     using cell_type                 = std::pair<range<cell_index_const_iterator>, adjacent_cell_idx>;
-    using cell_list_type            = std::array<cell_type, dim_size() * dim_size() * dim_size()>;
+    using cell_list_type            = std::vector<cell_type>;
+    using particle_neighbor_pair    = std::pair<std::size_t, neighbor_type>;
 
   public:
 
     UnlimitedGridCellList()
-        : margin_(0.5), current_margin_(-1.0), r_cell_size_(-1.0),
+        : margin_(0.5), current_margin_(-1.0), stencil_(CellListStencil::Full),
+          r_cell_size_(-1.0),
           offsets_threads_(omp_get_max_threads()),
           partners_threads_(omp_get_max_threads()),
           neighbors_threads_(omp_get_max_threads()),
-          nranges_threads_(omp_get_max_threads())
+          nranges_threads_(omp_get_max_threads()),
+          pairs_threads_(omp_get_max_threads())
     {}
 
     ~UnlimitedGridCellList() override {};
@@ -52,12 +57,15 @@ class UnlimitedGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
     UnlimitedGridCellList& operator=(UnlimitedGridCellList const&) = default;
     UnlimitedGridCellList& operator=(UnlimitedGridCellList &&)     = default;
 
-    explicit UnlimitedGridCellList(const real_type margin)
-        : margin_(margin), current_margin_(-1.0), r_cell_size_(-1.0),
+    explicit UnlimitedGridCellList(const real_type margin,
+            const CellListStencil stencil = CellListStencil::Full)
+        : margin_(margin), current_margin_(-1.0), stencil_(stencil),
+          r_cell_size_(-1.0),
           offsets_threads_(omp_get_max_threads()),
           partners_threads_(omp_get_max_threads()),
           neighbors_threads_(omp_get_max_threads()),
-          nranges_threads_(omp_get_max_threads())
+          nranges_threads_(omp_get_max_threads()),
+          pairs_threads_(omp_get_max_threads())
     {}
 
     bool valid() const noexcept override
@@ -72,63 +80,18 @@ class UnlimitedGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
         MJOLNIR_GET_DEFAULT_LOGGER();
         MJOLNIR_LOG_FUNCTION();
 
-        constexpr std::int64_t d = dim();
-
         MJOLNIR_LOG_INFO(pot.name(), " cutoff = ", pot.max_cutoff_length());
-        MJOLNIR_LOG_INFO("dimension = ", d, 'x', d, 'x', d);
         this->set_cutoff(pot.max_cutoff_length());
+        MJOLNIR_LOG_INFO("cell size = ", 1 / this->r_cell_size_,
+                         ", only the occupied cells are allocated");
 
-        // initialize cell list
-#pragma omp parallel for
-        for(int x = 0; x < d; ++x)
-        {
-            for(int y = 0; y < d; ++y)
-            {
-            for(int z = 0; z < d; ++z)
-            {
-                auto& cell = this->cell_list_[calc_index(x, y, z)];
-
-                const std::size_t x_prev = (x ==   0) ? d-1 : x-1;
-                const std::size_t x_next = (x == d-1) ?   0 : x+1;
-                const std::size_t y_prev = (y ==   0) ? d-1 : y-1;
-                const std::size_t y_next = (y == d-1) ?   0 : y+1;
-                const std::size_t z_prev = (z ==   0) ? d-1 : z-1;
-                const std::size_t z_next = (z == d-1) ?   0 : z+1;
-
-                cell.second[ 0] = calc_index(x_prev, y_prev, z_prev);
-                cell.second[ 1] = calc_index(x,      y_prev, z_prev);
-                cell.second[ 2] = calc_index(x_next, y_prev, z_prev);
-                cell.second[ 3] = calc_index(x_prev, y,      z_prev);
-                cell.second[ 4] = calc_index(x,      y,      z_prev);
-                cell.second[ 5] = calc_index(x_next, y,      z_prev);
-                cell.second[ 6] = calc_index(x_prev, y_next, z_prev);
-                cell.second[ 7] = calc_index(x,      y_next, z_prev);
-                cell.second[ 8] = calc_index(x_next, y_next, z_prev);
-
-                cell.second[ 9] = calc_index(x_prev, y_prev, z);
-                cell.second[10] = calc_index(x,      y_prev, z);
-                cell.second[11] = calc_index(x_next, y_prev, z);
-                cell.second[12] = calc_index(x_prev, y,      z);
-                cell.second[13] = calc_index(x,      y,      z);
-                cell.second[14] = calc_index(x_next, y,      z);
-                cell.second[15] = calc_index(x_prev, y_next, z);
-                cell.second[16] = calc_index(x,      y_next, z);
-                cell.second[17] = calc_index(x_next, y_next, z);
-
-                cell.second[18] = calc_index(x_prev, y_prev, z_next);
-                cell.second[19] = calc_index(x,      y_prev, z_next);
-                cell.second[20] = calc_index(x_next, y_prev, z_next);
-                cell.second[21] = calc_index(x_prev, y,      z_next);
-                cell.second[22] = calc_index(x,      y,      z_next);
-                cell.second[23] = calc_index(x_next, y,      z_next);
-                cell.second[24] = calc_index(x_prev, y_next, z_next);
-                cell.second[25] = calc_index(x,      y_next, z_next);
-                cell.second[26] = calc_index(x_next, y_next, z_next);
-            } // for z
-            } // for y
-        } // for x (in parallel)
+        // participants might be changed. forget the last ordering.
+        this->index_by_cell_.clear();
+        this->cell_list_    .clear();
+        this->cell_keys_    .clear();
 
         this->make(neighbors, sys, pot);
+        MJOLNIR_LOG_INFO("number of occupied cells = ", this->num_cells());
         return;
     }
 
@@ -144,51 +107,61 @@ class UnlimitedGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
         const auto& participants = pot.participants();
 
         neighbor_list.clear();
-        if(index_by_cell_    .size() != participants.size() ||
-           index_by_cell_buf_.size() != participants.size())
-        {
-            index_by_cell_    .resize(participants.size());
-            index_by_cell_buf_.resize(participants.size());
-        }
 
-#pragma omp parallel for
-        for(std::size_t i=0; i<participants.size(); ++i)
+        // If the participants are the same as the last time, update the cell
+        // keys in the current (sorted) order. Usually only a few particles
+        // move to another cell between two updates, so we can skip sorting
+        // when none of them moves.
+        bool cell_changed = this->cell_list_.empty();
+        if(index_by_cell_.size() != participants.size())
         {
-            const auto idx = participants[i];
-            index_by_cell_[i] =
-                std::make_pair(idx, this->calc_index(sys.position(idx)));
-        }
-
-        omp::sort(this->index_by_cell_, this->index_by_cell_buf_,
-                  [](const particle_cell_idx_pair& lhs,
-                     const particle_cell_idx_pair& rhs) noexcept -> bool {
-                      return lhs.second < rhs.second;
-                  });
-
-        // assign first and last iterator for each cells
+            index_by_cell_.resize(participants.size());
 #pragma omp parallel for
-        for(std::size_t cell_idx=0; cell_idx<cell_list_.size(); ++cell_idx)
-        {
-            auto iter = std::find_if(index_by_cell_.cbegin(), index_by_cell_.cend(),
-                [cell_idx](const particle_cell_idx_pair& item) noexcept -> bool {
-                    return item.second == cell_idx;
-                });
-            if(iter == index_by_cell_.cend())
+            for(std::size_t i=0; i<participants.size(); ++i)
             {
-                cell_list_[cell_idx].first = make_range(iter, iter);
-                continue;
+                const auto idx = participants[i];
+                index_by_cell_[i] =
+                    std::make_pair(idx, this->calc_key(sys.position(idx)));
             }
-            const auto first = iter; // the first iter of the range
-            while(iter != index_by_cell_.cend() && iter->second == cell_idx)
+            cell_changed = true;
+        }
+        else
+        {
+            std::size_t num_moved = 0;
+#pragma omp parallel for reduction(+:num_moved)
+            for(std::size_t i=0; i<index_by_cell_.size(); ++i)
             {
-                ++iter;
+                auto& item = index_by_cell_[i];
+                const auto key = this->calc_key(sys.position(item.first));
+                if(key != item.second)
+                {
+                    item.second = key;
+                    num_moved  += 1;
+                }
             }
-            cell_list_[cell_idx].first = make_range(first, iter);
+            cell_changed = cell_changed || (num_moved != 0);
+        }
+        if(cell_changed)
+        {
+            omp::sort(this->index_by_cell_, this->index_by_cell_buf_,
+                [](const particle_cell_idx_pair& lhs,
+                   const particle_cell_idx_pair& rhs) noexcept -> bool {
+                    return (lhs.second == rhs.second) ? lhs.first < rhs.first :
+                                                        lhs.second < rhs.second;
+                });
+            this->construct_cells();
         }
 
         const real_type r_c  = cutoff_ * (1 + margin_);
         const real_type r_c2 = r_c * r_c;
 
+        if(this->stencil_ == CellListStencil::Half)
+        {
+            this->make_half_shell(neighbor_list, sys, pot, r_c2);
+            this->current_margin_ = cutoff_ * margin_;
+            return;
+        }
+
         const auto leading_participants = pot.leading_participants();
 
         assert(std::is_sorted(leading_participants.begin(), leading_participants.end()));
@@ -225,7 +198,7 @@ class UnlimitedGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
                 partners.clear();
                 const auto     i = leading_participants[idx];
                 const auto    ri = sys.position(i);
-                const auto& cell = cell_list_[calc_index(ri)];
+                const auto& cell = cell_list_[find_cell(calc_key(ri))];
 
                 for(std::size_t cidx : cell.second) // for all adjacent cells...
                 {
@@ -337,26 +310,186 @@ class UnlimitedGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
 
     base_type* clone() const override
     {
-        return new UnlimitedGridCellList(margin_);
+        return new UnlimitedGridCellList(margin_, stencil_);
     }
 
+    CellListStencil stencil() const noexcept {return this->stencil_;}
+
+    // the number of cells that contain at least one participant
+    std::size_t num_cells() const noexcept {return this->cell_keys_.size();}
+
   private:
 
-    // calc cell index of the position
-    std::size_t calc_index(const coordinate_type& pos) const noexcept
+    //XXX do NOT call this from parallel region
+    // collect occupied cells from sorted index_by_cell_ and find adjacent cells
+    void construct_cells()
     {
-        constexpr std::int64_t d = dim();
-        const auto x = std::int64_t(std::floor(math::X(pos) * r_cell_size_)) % d;
-        const auto y = std::int64_t(std::floor(math::Y(pos) * r_cell_size_)) % d;
-        const auto z = std::int64_t(std::floor(math::Z(pos) * r_cell_size_)) % d;
+        this->cell_keys_.clear();
+        this->cell_list_.clear();
+        auto first = this->index_by_cell_.cbegin();
+        while(first != this->index_by_cell_.cend())
+        {
+            const auto key  = first->second;
+            const auto last = std::find_if(first, this->index_by_cell_.cend(),
+                [key](const particle_cell_idx_pair& item) noexcept -> bool {
+                    return item.second != key;
+                });
+            this->cell_keys_.push_back(key);
+            this->cell_list_.emplace_back(make_range(first, last), adjacent_cell_idx{});
+            first = last;
+        }
+
+        // the last cell is an empty cell that represents all unoccupied cells
+        const std::size_t num_cells = this->cell_keys_.size();
+        this->cell_list_.emplace_back(make_range(this->index_by_cell_.cend(),
+            this->index_by_cell_.cend()), adjacent_cell_idx{});
+        this->cell_list_.back().second.fill(num_cells);
+
+        // keys of the adjacent cells in the same row, {x-1, x, x+1}, are
+        // contiguous. search the first one and check the following cells.
+        constexpr cell_key_type dy = cell_key_type(1) << key_bits();
+        constexpr cell_key_type dz = cell_key_type(1) << (2 * key_bits());
+        const std::array<cell_key_type, 9> row_offsets{{
+            0-dy-dz, 0-dz, dy-dz, 0-dy, 0, dy, dz-dy, dz, dy+dz
+        }}; // unsigned wrap-around; the resulting keys never overflow.
 
-        return this->calc_index((x<0) ? x+d : x, (y<0) ? y+d : y, (z<0) ? z+d : z);
+#pragma omp parallel for
+        for(std::size_t cell_idx=0; cell_idx<num_cells; ++cell_idx)
+        {
+            auto& adjacents = this->cell_list_[cell_idx].second;
+            for(std::size_t row=0; row<9; ++row)
+            {
+                const cell_key_type center = this->cell_keys_[cell_idx] + row_offsets[row];
+                std::size_t found = std::distance(this->cell_keys_.begin(),
+                    std::lower_bound(this->cell_keys_.begin(),
+                                     this->cell_keys_.end(), center - 1));
+                for(std::size_t x=0; x<3; ++x)
+                {
+                    const bool occupied = (found < num_cells) &&
+                        (this->cell_keys_[found] == center - 1 + x);
+                    adjacents[row * 3 + x] = occupied ? found++ : num_cells;
+                }
+            }
+            assert(adjacents[half_shell_self_index()] == cell_idx);
+        }
+        return;
     }
 
-    std::size_t calc_index(const std::size_t x, const std::size_t y,
-                           const std::size_t z) const noexcept
+    //XXX do NOT call this from parallel region
+    // construct neighbor list by traversing the half shell of each cell.
+    void make_half_shell(neighbor_list_type& neighbor_list, const system_type& sys,
+                         const potential_type& pot, const real_type r_c2)
     {
-        return x + dim_size() * y + dim_size() * dim_size() * z;
+        const auto leading_participants = pot.leading_participants();
+
+        this->is_leading_.assign(sys.size(), 0);
+#pragma omp parallel for
+        for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+        {
+            this->is_leading_[leading_participants[idx]] = 1;
+        }
+
+#pragma omp parallel
+        {
+            auto& pairs = this->pairs_threads_[omp_get_thread_num()];
+            pairs.clear(); // keep capacity
+
+            // the number of particles in a cell varies. balance it dynamically
+#pragma omp for schedule(dynamic, 16)
+            for(std::size_t cell_idx=0; cell_idx<cell_keys_.size(); ++cell_idx)
+            {
+                find_half_shell_pairs(sys, pot, this->cell_list_,
+                    this->is_leading_, cell_idx, cell_idx+1, r_c2, pairs);
+            }
+        }
+
+        std::size_t total_pairs = 0;
+        for(const auto& pairs : this->pairs_threads_)
+        {
+            total_pairs += pairs.size();
+        }
+        this->pairs_.resize(total_pairs);
+
+#pragma omp parallel for schedule(static, 1)
+        for(std::size_t th=0; th < pairs_threads_.size(); ++th)
+        {
+            std::size_t pair_offset = 0;
+            for(std::size_t t=0; t<th; ++t)
+            {
+                pair_offset += pairs_threads_[t].size();
+            }
+            std::copy(pairs_threads_[th].begin(), pairs_threads_[th].end(),
+                      this->pairs_.begin() + pair_offset);
+        }
+
+        // collect pairs by the leading participant
+        omp::counting_sort(this->pairs_, this->pairs_buf_, this->pair_offsets_,
+            sys.size(), [](const particle_neighbor_pair& p) noexcept -> std::size_t {
+                return p.first;
+            });
+
+        // make the result consistent with NaivePairCalculation...
+#pragma omp parallel for schedule(dynamic, 16)
+        for(std::size_t idx=0; idx<leading_participants.size(); ++idx)
+        {
+            const auto i = leading_participants[idx];
+            std::sort(this->pairs_.begin() + pair_offsets_[i],
+                      this->pairs_.begin() + pair_offsets_[i+1],
+                [](const particle_neighbor_pair& lhs,
+                   const particle_neighbor_pair& rhs) noexcept -> bool {
+                    return lhs.second < rhs.second;
+                });
+        }
+
+        auto& principal_neighbors = neighbor_list.neighbors();
+        auto& principal_ranges    = neighbor_list.ranges();
+
+        // pairs_ contains only leading participants, so the ranges of the
+        // other particles become empty.
+        principal_neighbors.resize(this->pairs_.size());
+        principal_ranges.assign(pair_offsets_.begin(), pair_offsets_.end());
+
+#pragma omp parallel for
+        for(std::size_t k=0; k<this->pairs_.size(); ++k)
+        {
+            principal_neighbors[k] = this->pairs_[k].second;
+        }
+        return;
+    }
+
+    // calc cell key of the position.
+    // A coordinate is clamped so that a particle that is extremely far away
+    // is put into the outermost cell. Clamping never separates adjacent cells,
+    // so it does not miss any pair.
+    cell_key_type calc_key(const coordinate_type& pos) const noexcept
+    {
+        return this->calc_key(this->calc_coord(math::X(pos)),
+                              this->calc_coord(math::Y(pos)),
+                              this->calc_coord(math::Z(pos)));
+    }
+    cell_key_type calc_coord(const real_type x) const noexcept
+    {
+        constexpr real_type lim = key_limit();
+        const real_type c = std::min(std::max(std::floor(x * r_cell_size_), -lim), lim);
+        return static_cast<cell_key_type>(static_cast<std::int64_t>(c) + key_limit() + 2);
+    }
+    cell_key_type calc_key(const cell_key_type x, const cell_key_type y,
+                           const cell_key_type z) const noexcept
+    {
+        return x | (y << key_bits()) | (z << (2 * key_bits()));
+    }
+
+    // find the index of the cell that has the key. returns num_cells() if
+    // there is no such cell.
+    std::size_t find_cell(const cell_key_type key) const noexcept
+    {
+        const auto found = std::lower_bound(
+                this->cell_keys_.begin(), this->cell_keys_.end(), key);
+        if(found == this->cell_keys_.end() || *found != key)
+        {
+            return this->cell_keys_.size();
+        }
+        return std::distance(this->cell_keys_.begin(), found);
     }
 
     void set_cutoff(const real_type c) noexcept
@@ -375,19 +508,31 @@ class UnlimitedGridCellList<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
     real_type cutoff_;
     real_type margin_;
     real_type current_margin_;
+    CellListStencil stencil_;
     real_type r_cell_size_;
 
-    neighbor_list_type        neighbors_;
-    cell_list_type            cell_list_;
-    cell_index_container_type index_by_cell_;
-    cell_index_container_type index_by_cell_buf_; // buffer for sort
-    // index_by_cell_ has {particle idx, cell idx} and sorted by cell idx
-    // first term of cell list contains first and last idx of index_by_cell
+    neighbor_list_type         neighbors_;
+    cell_list_type             cell_list_;
+    std::vector<cell_key_type> cell_keys_;
+    cell_index_container_type  index_by_cell_;
+    cell_index_container_type  index_by_cell_buf_; // buffer for sort
+    // index_by_cell_ has {particle idx, cell key} and sorted by cell key.
+    // cell_keys_ has the keys of occupied cells in the ascending order.
+    // the last element of cell_list_ is an empty cell that represents all the
+    // unoccupied cells. first term of cell list contains first and last idx
+    // of index_by_cell.
 
     std::vector<std::size_t> offsets_threads_;
     std::vector<std::vector<neighbor_type>> partners_threads_;
     std::vector<std::vector<neighbor_type>> neighbors_threads_;
     std::vector<std::vector<std::size_t>>   nranges_threads_;
+
+    // used in the half shell traversal. pairs_ has {particle idx, neighbor}.
+    std::vector<char>                                is_leading_;
+    std::vector<std::vector<particle_neighbor_pair>> pairs_threads_;
+    std::vector<particle_neighbor_pair>              pairs_;
+    std::vector<particle_neighbor_pair>              pairs_buf_;
+    std::vector<std::size_t>                         pair_offsets_;
 };
 } // mjolnir
 
@@ -0,0 +1,13 @@
+#include <mjolnir/omp/VelocityVerletIntegrator.hpp>
+
+#ifndef MJOLNIR_SEPARATE_BUILD
+#error "MJOLNIR_SEPARATE_BUILD flag is required"
+#endif
+
+namespace mjolnir
+{
+template class VelocityVerletIntegrator<OpenMPSimulatorTraits<double, UnlimitedBoundary>>;
+template class VelocityVerletIntegrator<OpenMPSimulatorTraits<float,  UnlimitedBoundary>>;
+template class VelocityVerletIntegrator<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>>;
+template class VelocityVerletIntegrator<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>>;
+} // mjolnir
@@ -0,0 +1,236 @@
+#ifndef MJOLNIR_OMP_VELOCITY_VERLET_INTEGRATOR_HPP
+#define MJOLNIR_OMP_VELOCITY_VERLET_INTEGRATOR_HPP
+#include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
+#include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/RandomNumberGenerator.hpp>
+#include <mjolnir/omp/SystemMotionRemover.hpp>
+#include <mjolnir/core/VelocityVerletIntegrator.hpp>
+#include <vector>
+
+namespace mjolnir
+{
+
+// a specialization of VelocityVerletIntegrator for OpenMP implementation.
+// see core/VelocityVerletIntegrator.hpp for the multiple time step mode.
+template<typename realT, template<typename, typename> class boundaryT>
+class VelocityVerletIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
+{
+  public:
+    using traits_type     = OpenMPSimulatorTraits<realT, boundaryT>;
+    using boundary_type   = typename traits_type::boundary_type;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using matrix33_type   = typename traits_type::matrix33_type;
+    using system_type     = System<traits_type>;
+    using forcefield_type = std::unique_ptr<ForceFieldBase<traits_type>>;
+    using rng_type        = RandomNumberGenerator<traits_type>;
+    using remover_type    = SystemMotionRemover<traits_type>;
+
+  public:
+
+    explicit VelocityVerletIntegrator(const real_type dt,
+            remover_type&& remover, const std::size_t global_interval = 1) noexcept
+        : dt_(dt), halfdt_(dt / 2), global_interval_(global_interval),
+          inner_step_(0), slow_virial_(0,0,0, 0,0,0, 0,0,0),
+          remover_(std::move(remover))
+    {}
+    ~VelocityVerletIntegrator() = default;
+
+    void initialize(system_type& sys, forcefield_type& ff, rng_type&)
+    {
+        MJOLNIR_GET_DEFAULT_LOGGER();
+        MJOLNIR_LOG_FUNCTION();
+
+        if(!ff->constraint().empty())
+        {
+            MJOLNIR_LOG_WARN(
+                "Velocity verlet integrator does not support constraint forcefield."
+                " [[forcefields.constraint]] will be ignored.");
+        }
+
+        this->update(sys);
+
+        if(1 < this->global_interval_)
+        {
+            MJOLNIR_LOG_NOTICE("global forcefields are updated every ",
+                               this->global_interval_, " steps (r-RESPA)");
+
+            // the slow forces are not saved in MsgPack. re-calculate all.
+#pragma omp parallel for
+            for(std::size_t i=0; i<sys.size(); ++i)
+            {
+                sys.force(i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+            }
+            sys.virial() = matrix33_type(0,0,0, 0,0,0, 0,0,0);
+            this->inner_step_ = 0;
+            this->calc_split_force(sys, ff);
+            return;
+        }
+
+        // if loaded from MsgPack, we can skip it.
+        if( ! sys.force_initialized())
+        {
+#pragma omp parallel for
+            for(std::size_t i=0; i<sys.size(); ++i)
+            {
+                sys.force(i) = math::make_coordinate<coordinate_type>(0, 0, 0);
+            }
+            sys.virial() = matrix33_type(0,0,0, 0,0,0, 0,0,0);
+            ff->calc_force(sys);
+        }
+        return;
+    }
+
+    real_type step(const real_type time, system_type& sys, forcefield_type& ff,
+                   rng_type&)
+    {
+        if(1 < this->global_interval_)
+        {
+            return this->step_multiple_time_step(time, sys, ff);
+        }
+
+        real_type largest_disp2(0);
+
+#pragma omp parallel for reduction(max:largest_disp2)
+        for(std::size_t i=0; i<sys.size(); ++i)
+        {
+            auto& v = sys.velocity(i);
+            auto& f = sys.force(i);
+
+            v += (halfdt_ * sys.rmass(i)) * f;
+
+            const auto disp = dt_ * v;
+
+            sys.position(i) = sys.adjust_position(sys.position(i) + disp);
+            f = math::make_coordinate<coordinate_type>(0, 0, 0);
+
+            largest_disp2 = std::max(largest_disp2, math::length_sq(disp));
+        }
+        sys.virial() = matrix33_type(0,0,0, 0,0,0, 0,0,0);
+
+        // update neighbor list; reduce margin, reconstruct the list if needed
+        ff->reduce_margin(2 * std::sqrt(largest_disp2), sys);
+
+        // calc f(t+dt)
+        ff->calc_force(sys);
+
+        // calc v(t+dt)
+#pragma omp parallel for
+        for(std::size_t i=0; i<sys.size(); ++i)
+        {
+            sys.velocity(i) += (halfdt_ * sys.rmass(i)) * sys.force(i);
+        }
+
+        // remove net rotation/translation
+        remover_.remove(sys);
+
+        return time + dt_;
+    }
+
+    real_type delta_t() const noexcept {return dt_;}
+    void  set_delta_t(const real_type dt) noexcept
+    {
+        dt_ = dt; halfdt_ = dt / 2;
+    }
+
+    void update(const system_type&) const noexcept {/* do nothing */}
+
+    std::size_t global_interval() const noexcept {return global_interval_;}
+
+  private:
+
+    void calc_split_force(system_type& sys, forcefield_type& ff)
+    {
+        ff->calc_slow_force(sys);
+
+        this->slow_forces_.resize(sys.size());
+#pragma omp parallel for
+        for(std::size_t i=0; i<sys.size(); ++i)
+        {
+            this->slow_forces_[i] = sys.force(i);
+        }
+        this->slow_virial_ = sys.virial();
+
+        ff->calc_fast_force(sys);
+        return;
+    }
+
+    real_type step_multiple_time_step(const real_type time, system_type& sys,
+                                      forcefield_type& ff)
+    {
+        const bool first = (this->inner_step_ == 0);
+        const bool last  = (this->inner_step_ + 1 == this->global_interval_);
+
+        const real_type slow_halfdt = halfdt_ * (global_interval_ - 1);
+        const real_type slow_coef1  = first ? slow_halfdt : -halfdt_;
+        const real_type slow_coef2  = last  ? slow_halfdt : -halfdt_;
+
+        real_type largest_disp2(0);
+#pragma omp parallel for reduction(max:largest_disp2)
+        for(std::size_t i=0; i<sys.size(); ++i)
+        {
+            auto& v = sys.velocity(i);
+            auto& f = sys.force(i);
+
+            v += sys.rmass(i) * (halfdt_ * f + slow_coef1 * slow_forces_[i]);
+
+            const auto disp = dt_ * v;
+
+            sys.position(i) = sys.adjust_position(sys.position(i) + disp);
+            f = math::make_coordinate<coordinate_type>(0, 0, 0);
+
+            largest_disp2 = std::max(largest_disp2, math::length_sq(disp));
+        }
+        sys.virial() = matrix33_type(0,0,0, 0,0,0, 0,0,0);
+
+        ff->reduce_margin(2 * std::sqrt(largest_disp2), sys);
+
+        if(last)
+        {
+            this->calc_split_force(sys, ff);
+        }
+        else
+        {
+            ff->calc_fast_force(sys);
+#pragma omp parallel for
+            for(std::size_t i=0; i<sys.size(); ++i)
+            {
+                sys.force(i) += slow_forces_[i];
+            }
+            sys.virial() += slow_virial_;
+        }
+
+#pragma omp parallel for
+        for(std::size_t i=0; i<sys.size(); ++i)
+        {
+            sys.velocity(i) += sys.rmass(i) *
+                (halfdt_ * sys.force(i) + slow_coef2 * slow_forces_[i]);
+        }
+
+        remover_.remove(sys);
+
+        this->inner_step_ = last ? 0 : this->inner_step_ + 1;
+        return time + dt_;
+    }
+
+  private:
+    real_type dt_;      //!< dt
+    real_type halfdt_;  //!< dt/2
+
+    std::size_t                  global_interval_; // k in r-RESPA
+    std::size_t                  inner_step_;      // [0, k)
+    std::vector<coordinate_type> slow_forces_;
+    matrix33_type                slow_virial_;
+
+    remover_type remover_;
+};
+
+#ifdef MJOLNIR_SEPARATE_BUILD
+extern template class VelocityVerletIntegrator<OpenMPSimulatorTraits<double, UnlimitedBoundary>>;
+extern template class VelocityVerletIntegrator<OpenMPSimulatorTraits<float,  UnlimitedBoundary>>;
+extern template class VelocityVerletIntegrator<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>>;
+extern template class VelocityVerletIntegrator<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>>;
+#endif
+
+} // mjolnir
+#endif // MJOLNIR_OMP_VELOCITY_VERLET_INTEGRATOR_HPP
@@ -0,0 +1,607 @@
+#ifndef MJOLNIR_OMP_ZORDER_R_TREE_HPP
+#define MJOLNIR_OMP_ZORDER_R_TREE_HPP
+#include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
+#include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/sort.hpp>
+#include <mjolnir/core/ZorderRTree.hpp>
+
+namespace mjolnir
+{
+
+// OpenMP implementation of ZorderRTree.
+//
+// The particles are sorted by z-index in parallel, and the tree is built from
+// the bottom by packing MaxElem consecutive nodes into a parent node, level by
+// level. All the nodes in a level are constructed in parallel. Unlike the
+// default implementation, nodes are not re-sorted in each level because
+// the nodes in a level are already ordered along the z-curve.
+//
+// If the z-order of the particles is almost the same as the last time, it
+// keeps the structure of the tree and only refits the bounding boxes. Since the
+// boxes always contain all the particles in the subtree, it does not change
+// the result. Only the efficiency of the query depends on the structure.
+template<typename realT, template<typename, typename> class boundaryT,
+         typename potentialT, std::size_t MaxElem>
+class ZorderRTree<OpenMPSimulatorTraits<realT, boundaryT>, potentialT, MaxElem>
+    final : public SpatialPartitionBase<OpenMPSimulatorTraits<realT, boundaryT>, potentialT>
+{
+    static_assert(MaxElem > 1, "MaxElem > 1");
+
+  public:
+    using traits_type        = OpenMPSimulatorTraits<realT, boundaryT>;
+    using potential_type     = potentialT;
+    using base_type          = SpatialPartitionBase<traits_type, potential_type>;
+
+    using system_type        = typename base_type::system_type;
+    using boundary_type      = typename base_type::boundary_type;
+    using real_type          = typename base_type::real_type;
+    using coordinate_type    = typename base_type::coordinate_type;
+    using neighbor_list_type = typename base_type::neighbor_list_type;
+    using neighbor_type      = typename base_type::neighbor_type;
+    using range_type         = typename base_type::range_type;
+
+    struct AABB
+    {
+        coordinate_type lower;
+        coordinate_type upper;
+    };
+    struct Node
+    {
+        fixed_vector<std::size_t, MaxElem> children;
+        std::size_t parent;
+        AABB box;
+        bool is_leaf;
+    };
+
+    // {z-index, particle idx}
+    using zindex_pair_type = std::pair<std::uint32_t, std::uint32_t>;
+
+    // The tree is rebuilt if more than 1/rebuild_ratio() of the adjacent
+    // pairs of particles in the tree are not in the z-order.
+    static constexpr std::size_t rebuild_ratio() noexcept {return 16;}
+
+  public:
+
+    ZorderRTree()
+        : cutoff_(0), margin_(1), current_margin_(-1),
+          num_rebuild_(0), num_refit_(0),
+          offsets_threads_(omp_get_max_threads()),
+          partners_threads_(omp_get_max_threads()),
+          neighbors_threads_(omp_get_max_threads()),
+          nranges_threads_(omp_get_max_threads()),
+          next_node_threads_(omp_get_max_threads())
+    {}
+    ~ZorderRTree() override {}
+    ZorderRTree(ZorderRTree const&) = default;
+    ZorderRTree(ZorderRTree &&)     = default;
+    ZorderRTree& operator=(ZorderRTree const&) = default;
+    ZorderRTree& operator=(ZorderRTree &&)     = default;
+
+    explicit ZorderRTree(const real_type margin)
+        : cutoff_(0), margin_(margin), current_margin_(-1),
+          num_rebuild_(0), num_refit_(0),
+          offsets_threads_(omp_get_max_threads()),
+          partners_threads_(omp_get_max_threads()),
+          neighbors_threads_(omp_get_max_threads()),
+          nranges_threads_(omp_get_max_threads()),
+          next_node_threads_(omp_get_max_threads())
+    {}
+
+    bool valid() const noexcept override
+    {
+        return current_margin_ >= 0.0;
+    }
+
+    //XXX do NOT call this from parallel region.
+    void initialize(neighbor_list_type& neighbors,
+                    const system_type& sys, const potential_type& pot) override
+    {
+        MJOLNIR_GET_DEFAULT_LOGGER();
+        MJOLNIR_LOG_FUNCTION();
+
+        const real_type max_cutoff = pot.max_cutoff_length();
+        this->set_cutoff(max_cutoff);
+
+        MJOLNIR_LOG_INFO(pot.name(), " cutoff = ", max_cutoff);
+
+        // participants might be changed. forget the last tree.
+        this->tree_    .clear();
+        this->zindices_.clear();
+
+        this->make(neighbors, sys, pot);
+        return;
+    }
+
+    //XXX do NOT call this from parallel region.
+    void make(neighbor_list_type& neighbors,
+              const system_type& sys, const potential_type& pot) override;
+
+    //XXX do NOT call this from parallel region.
+    bool reduce_margin(neighbor_list_type& neighbors, const real_type dmargin,
+                       const system_type& sys, const potential_type& pot) override
+    {
+        this->current_margin_ -= dmargin;
+        if(this->current_margin_ < 0)
+        {
+            this->make(neighbors, sys, pot);
+            return true;
+        }
+        return false;
+    }
+    bool scale_margin(neighbor_list_type& neighbors, const real_type scale,
+                const system_type& sys, const potential_type& pot) override
+    {
+        this->current_margin_ = (cutoff_ + current_margin_) * scale - cutoff_;
+        if(this->current_margin_ < 0)
+        {
+            this->make(neighbors, sys, pot);
+            return true;
+        }
+        return false;
+    }
+
+    real_type cutoff() const noexcept override {return this->cutoff_;}
+    real_type margin() const noexcept override {return this->margin_;}
+
+    base_type* clone() const override
+    {
+        return new ZorderRTree(margin_);
+    }
+
+    // the number of times the tree is rebuilt and refitted. for diagnosis.
+    std::size_t num_rebuild() const noexcept {return this->num_rebuild_;}
+    std::size_t num_refit()   const noexcept {return this->num_refit_;}
+
+  private:
+
+    // calculate z-indices of particles in the current order of zindices_.
+    // returns the number of adjacent pairs that are not in the z-order.
+    std::size_t update_zindices(const system_type& sys)
+    {
+        const std::size_t N = this->zindices_.size();
+#pragma omp parallel for
+        for(std::size_t i=0; i<N; ++i)
+        {
+            auto pos = sys.position(zindices_[i].second) - lower_;
+            math::X(pos) *= math::X(rwidth_);
+            math::Y(pos) *= math::Y(rwidth_);
+            math::Z(pos) *= math::Z(rwidth_);
+            zindices_[i].first = detail::zorder_index<real_type>(pos);
+        }
+        std::size_t num_unordered = 0;
+#pragma omp parallel for reduction(+:num_unordered)
+        for(std::size_t i=1; i<N; ++i)
+        {
+            if(zindices_[i].first < zindices_[i-1].first)
+            {
+                num_unordered += 1;
+            }
+        }
+        return num_unordered;
+    }
+
+    // construct the structure of the tree from sorted zindices_.
+    void build_tree();
+    // update bounding boxes of all the nodes from the bottom.
+    void refit_tree(const system_type& sys);
+
+    std::pair<coordinate_type, coordinate_type> scaling(
+        const system_type& sys, const std::vector<std::size_t>& participants,
+        const UnlimitedBoundary<real_type, coordinate_type>&) const noexcept
+    {
+        constexpr auto inf = std::numeric_limits<real_type>::infinity();
+        real_type lx( inf), ly( inf), lz( inf);
+        real_type ux(-inf), uy(-inf), uz(-inf);
+
+#pragma omp parallel for reduction(min:lx,ly,lz) reduction(max:ux,uy,uz)
+        for(std::size_t i=0; i<participants.size(); ++i)
+        {
+            const auto& pos = sys.position(participants[i]);
+            lx = std::min(lx, math::X(pos));
+            ly = std::min(ly, math::Y(pos));
+            lz = std::min(lz, math::Z(pos));
+            ux = std::max(ux, math::X(pos));
+            uy = std::max(uy, math::Y(pos));
+            uz = std::max(uz, math::Z(pos));
+        }
+        // avoid zero division when all the particles are on the same plane
+        coordinate_type scale;
+        math::X(scale) = (lx < ux) ? real_type(1) / (ux - lx) : real_type(1);
+        math::Y(scale) = (ly < uy) ? real_type(1) / (uy - ly) : real_type(1);
+        math::Z(scale) = (lz < uz) ? real_type(1) / (uz - lz) : real_type(1);
+        return std::make_pair(math::make_coordinate<coordinate_type>(lx, ly, lz), scale);
+    }
+    std::pair<coordinate_type, coordinate_type> scaling(
+        const system_type&, const std::vector<std::size_t>&,
+        const CuboidalPeriodicBoundary<real_type, coordinate_type>& boundary) const noexcept
+    {
+        coordinate_type scale;
+        math::X(scale) = static_cast<real_type>(1) / math::X(boundary.width());
+        math::Y(scale) = static_cast<real_type>(1) / math::Y(boundary.width());
+        math::Z(scale) = static_cast<real_type>(1) / math::Z(boundary.width());
+        return std::make_pair(boundary.lower_bound(), scale);
+    }
+
+    void set_cutoff(const real_type c) noexcept
+    {
+        this->cutoff_ = c;
+        return;
+    }
+    void set_margin(const real_type m) noexcept
+    {
+        this->margin_ = m;
+        return;
+    }
+
+  private:
+
+    real_type cutoff_;
+    real_type margin_;
+    real_type current_margin_;
+    std::size_t num_rebuild_;
+    std::size_t num_refit_;
+    coordinate_type lower_;  // lower bound of the region at the last rebuild
+    coordinate_type rwidth_; // reciprocal width of the region
+
+    std::vector<Node>             tree_;
+    std::vector<std::size_t>      level_offsets_;
+    std::vector<zindex_pair_type> zindices_;
+    std::vector<zindex_pair_type> zindices_buf_; // buffer for sort
+    // tree_ contains leaves at first, and then the nodes in upper levels.
+    // The nodes in the l-th level are in [level_offsets_[l], level_offsets_[l+1]).
+    // The last node is the root. zindices_ keeps the order of particles in
+    // the leaves.
+
+    std::vector<std::size_t> offsets_threads_;
+    std::vector<std::vector<neighbor_type>> partners_threads_;
+    std::vector<std::vector<neighbor_type>> neighbors_threads_;
+    std::vector<std::vector<std::size_t>>   nranges_threads_;
+    std::vector<std::vector<std::size_t>>   next_node_threads_;
+};
+
+template<typename realT, template<typename, typename> class boundaryT,
+         typename potentialT, std::size_t MaxElem>
+void ZorderRTree<OpenMPSimulatorTraits<realT, boundaryT>, potentialT, MaxElem>::make(
+        neighbor_list_type& neighbor_list, const system_type& sys,
+        const potential_type& pot)
+{
+    MJOLNIR_GET_DEFAULT_LOGGER_DEBUG();
+    MJOLNIR_LOG_FUNCTION_DEBUG();
+
+    // `participants` is a list that contains indices of particles that are
+    // related to the potential.
+    const auto& participants = pot.participants();
+
+    neighbor_list.clear();
+    if(participants.empty())
+    {
+        this->tree_    .clear();
+        this->zindices_.clear();
+        this->current_margin_ = cutoff_ * margin_;
+        return;
+    }
+
+    // ------------------------------------------------------------------------
+    // update the tree
+
+    // normally there are not so many particles
+    assert(participants.size() < std::numeric_limits<std::uint32_t>::max());
+
+    bool rebuild = (this->zindices_.size() != participants.size()) ||
+                   this->tree_.empty();
+    if(!rebuild)
+    {
+        // the same participants as the last time. Check the particles in the
+        // leaves are still ordered along the z-curve. The same scaling as the
+        // last construction is used so that a change in the bounding box of
+        // the system does not shift all the z-indices.
+        const auto num_unordered = this->update_zindices(sys);
+        rebuild = (num_unordered * rebuild_ratio() > zindices_.size());
+        MJOLNIR_LOG_DEBUG(num_unordered, " particles are not in z-order");
+    }
+
+    if(rebuild)
+    {
+        const auto scale = this->scaling(sys, participants, sys.boundary());
+        this->lower_  = scale.first;
+        this->rwidth_ = scale.second;
+
+        this->zindices_.resize(participants.size());
+#pragma omp parallel for
+        for(std::size_t i=0; i<participants.size(); ++i)
+        {
+            zindices_[i].second = static_cast<std::uint32_t>(participants[i]);
+        }
+        this->update_zindices(sys);
+
+        omp::sort(this->zindices_, this->zindices_buf_);
+        this->build_tree();
+        this->num_rebuild_ += 1;
+    }
+    else
+    {
+        this->num_refit_ += 1;
+    }
+    this->refit_tree(sys);
+
+    // ------------------------------------------------------------------------
+    // construct NeighborList
+
+    MJOLNIR_LOG_DEBUG("tree is updated");
+
+    const real_type r_c  = cutoff_ * (1. + margin_);
+    const real_type r_c2 = r_c * r_c;
+    const std::size_t root = this->tree_.size() - 1;
+
+    const auto leading_participants = pot.leading_participants();
+
+    assert(std::is_sorted(leading_participants.begin(), leading_participants.end()));
+
+    constexpr std::size_t nil = std::numeric_limits<std::size_t>::max();
+    std::fill(offsets_threads_.begin(), offsets_threads_.end(), nil);
+
+    if(leading_participants.size() == 0)
+    {
+        this->current_margin_ = cutoff_ * margin_;
+        return;
+    }
+
+#pragma omp parallel
+    {
+        const std::size_t num_threads = omp_get_num_threads();
+        const std::size_t thread_id   = omp_get_thread_num();
+
+        const std::size_t dN = leading_participants.size() / num_threads;
+        const std::size_t first = dN *  thread_id;
+        const std::size_t last  = (thread_id+1 == num_threads) ?
+            leading_participants.size() : dN * (thread_id+1);
+
+        const std::size_t first_idx = leading_participants[first];
+        const std::size_t  last_idx = (thread_id+1 == num_threads) ?
+            leading_participants[leading_participants.size()-1] + 1 : leading_participants[last];
+
+        this->offsets_threads_[thread_id] = first_idx;
+
+        auto& partners  = this->partners_threads_ [thread_id];
+        auto& neighbors = this->neighbors_threads_[thread_id];
+        auto& nranges   = this->nranges_threads_  [thread_id];
+        auto& next_node = this->next_node_threads_[thread_id];
+
+        neighbors.clear(); // keep capacity
+        nranges  .clear();
+        nranges.resize(last_idx + 1 - first_idx, 0);
+
+        for(std::size_t idx=first; idx<last; ++idx)
+        {
+            partners .clear();
+            next_node.clear();
+            const auto   i = leading_participants[idx];
+            const auto& ri = sys.position(i);
+
+            next_node.push_back(root);
+            while( ! next_node.empty())
+            {
+                const auto& node = tree_[next_node.back()];
+                next_node.pop_back();
+
+                if(node.is_leaf)
+                {
+                    for(const auto& j : node.children)
+                    {
+                        if( ! pot.has_interaction(i, j))
+                        {
+                            continue;
+                        }
+                        // here we don't need to search `participants` because
+                        // the tree contains only participants. non-related
+                        // particles are already filtered.
+
+                        const auto& rj = sys.position(j);
+                        if(math::length_sq(sys.adjust_direction(ri, rj)) < r_c2)
+                        {
+                            partners.emplace_back(j, pot.prepare_params(i, j));
+                        }
+                    }
+                }
+                else // internal node
+                {
+                    for(const auto& child : node.children)
+                    {
+                        if(detail::overlaps(ri, r_c, tree_[child].box, sys.boundary()))
+                        {
+                            next_node.push_back(child);
+                        }
+                    }
+                }
+            }
+            // make the result consistent with NaivePairCalculation...
+            std::sort(partners.begin(), partners.end());
+
+            nranges[i - first_idx    ] = neighbors.size();
+            nranges[i - first_idx + 1] = neighbors.size() + partners.size();
+
+            neighbors.reserve(neighbors.size() + partners.size());
+            std::copy(partners.begin(), partners.end(),
+                      std::back_inserter(neighbors));
+
+            if(idx == first+16)
+            {
+                neighbors.reserve(dN * neighbors.size() / 16);
+            }
+        }
+    }
+
+    auto& principal_neighbors = neighbor_list.neighbors();
+    auto& principal_ranges    = neighbor_list.ranges();
+
+    std::size_t total_neighbors = 0;
+    for(std::size_t th=0; th < offsets_threads_.size(); ++th)
+    {
+        const auto offset = offsets_threads_[th];
+        if(offset == nil)
+        {
+            break;
+        }
+        total_neighbors += neighbors_threads_[th].size();
+    }
+
+    principal_neighbors.resize(total_neighbors);
+    principal_ranges   .resize(sys.size(), 0);
+
+#pragma omp parallel for schedule(static, 1)
+    for(std::size_t th=0; th < offsets_threads_.size(); ++th)
+    {
+        const auto index_offset = offsets_threads_[th];
+        if(index_offset != nil)
+        {
+            std::size_t neighbor_offset = 0;
+            for(std::size_t t=0; t<th; ++t)
+            {
+                neighbor_offset += neighbors_threads_[t].size();
+            }
+            auto& neighbors = this->neighbors_threads_[th];
+            std::copy(neighbors.begin(), neighbors.end(),
+                      principal_neighbors.begin() + neighbor_offset);
+
+            auto& nranges = this->nranges_threads_[th];
+            std::transform(nranges.begin() + 1, nranges.end(),
+                  principal_ranges.begin() + 1 + index_offset,
+                  [=](const std::size_t i) {return i + neighbor_offset;});
+        }
+    }
+    this->current_margin_ = cutoff_ * margin_;
+    return ;
+}
+
+template<typename realT, template<typename, typename> class boundaryT,
+         typename potentialT, std::size_t MaxElem>
+void ZorderRTree<OpenMPSimulatorTraits<realT, boundaryT>, potentialT, MaxElem>::build_tree()
+{
+    constexpr auto nil = std::numeric_limits<std::size_t>::max();
+
+    // calculate the number of nodes in each level
+    this->level_offsets_.clear();
+    this->level_offsets_.push_back(0);
+    std::size_t num_nodes = (zindices_.size() + MaxElem - 1) / MaxElem;
+    while(true)
+    {
+        this->level_offsets_.push_back(level_offsets_.back() + num_nodes);
+        if(num_nodes == 1) {break;}
+        num_nodes = (num_nodes + MaxElem - 1) / MaxElem;
+    }
+    this->tree_.resize(level_offsets_.back());
+
+    // leaves
+    const std::size_t num_leaves = level_offsets_[1];
+#pragma omp parallel for
+    for(std::size_t k=0; k<num_leaves; ++k)
+    {
+        auto& node = this->tree_[k];
+        node.is_leaf = true;
+        node.parent  = (level_offsets_.size() == 2) ? nil :
+                       level_offsets_[1] + k / MaxElem;
+        node.children.clear();
+        const std::size_t last = std::min((k+1) * MaxElem, zindices_.size());
+        for(std::size_t i=k * MaxElem; i<last; ++i)
+        {
+            node.children.push_back(zindices_[i].second);
+        }
+    }
+
+    // internal nodes. each node has consecutive nodes in the lower level.
+    for(std::size_t level=1; level+1<level_offsets_.size(); ++level)
+    {
+        const std::size_t lower_first = level_offsets_[level-1];
+        const std::size_t lower_last  = level_offsets_[level];
+        const std::size_t first       = level_offsets_[level];
+        const std::size_t last        = level_offsets_[level+1];
+        const bool        is_root     = (level+2 == level_offsets_.size());
+
+#pragma omp parallel for
+        for(std::size_t k=first; k<last; ++k)
+        {
+            auto& node = this->tree_[k];
+            node.is_leaf = false;
+            node.parent  = is_root ? nil : last + (k - first) / MaxElem;
+            node.children.clear();
+
+            const std::size_t child_first = lower_first + (k - first) * MaxElem;
+            const std::size_t child_last  = std::min(child_first + MaxElem, lower_last);
+            for(std::size_t c=child_first; c<child_last; ++c)
+            {
+                node.children.push_back(c);
+            }
+        }
+    }
+    return;
+}
+
+template<typename realT, template<typename, typename> class boundaryT,
+         typename potentialT, std::size_t MaxElem>
+void ZorderRTree<OpenMPSimulatorTraits<realT, boundaryT>, potentialT, MaxElem>::refit_tree(
+        const system_type& sys)
+{
+    const std::size_t num_leaves = level_offsets_[1];
+#pragma omp parallel for
+    for(std::size_t k=0; k<num_leaves; ++k)
+    {
+        auto& node = this->tree_[k];
+        node.box.lower = sys.position(node.children.front());
+        node.box.upper = sys.position(node.children.front());
+        for(const auto& idx : node.children)
+        {
+            node.box = detail::merge_aabb(node.box, sys.position(idx));
+        }
+    }
+    for(std::size_t level=1; level+1<level_offsets_.size(); ++level)
+    {
+#pragma omp parallel for
+        for(std::size_t k=level_offsets_[level]; k<level_offsets_[level+1]; ++k)
+        {
+            auto& node = this->tree_[k];
+            node.box = tree_[node.children.front()].box;
+            for(const auto& child : node.children)
+            {
+                node.box = detail::merge_aabb(node.box, tree_[child].box);
+            }
+        }
+    }
+    return;
+}
+
+} // mjolnir
+
+#ifdef MJOLNIR_SEPARATE_BUILD
+#include <mjolnir/forcefield/global/DebyeHuckelPotential.hpp>
+#include <mjolnir/forcefield/global/ExcludedVolumePotential.hpp>
+#include <mjolnir/forcefield/global/LennardJonesPotential.hpp>
+#include <mjolnir/forcefield/global/UniformLennardJonesPotential.hpp>
+
+namespace mjolnir
+{
+extern template class ZorderRTree<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>, DebyeHuckelPotential<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>>>;
+extern template class ZorderRTree<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>, DebyeHuckelPotential<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>>>;
+
+extern template class ZorderRTree<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>, ExcludedVolumePotential<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>>>;
+extern template class ZorderRTree<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>, ExcludedVolumePotential<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>>>;
+
+extern template class ZorderRTree<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>, LennardJonesPotential<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>>>;
+extern template class ZorderRTree<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>, LennardJonesPotential<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>>>;
+
+extern template class ZorderRTree<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>, UniformLennardJonesPotential<OpenMPSimulatorTraits<double, CuboidalPeriodicBoundary>>>;
+extern template class ZorderRTree<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>, UniformLennardJonesPotential<OpenMPSimulatorTraits<float,  CuboidalPeriodicBoundary>>>;
+
+extern template class ZorderRTree<OpenMPSimulatorTraits<double, UnlimitedBoundary>, DebyeHuckelPotential<OpenMPSimulatorTraits<double, UnlimitedBoundary>>>;
+extern template class ZorderRTree<OpenMPSimulatorTraits<float,  UnlimitedBoundary>, DebyeHuckelPotential<OpenMPSimulatorTraits<float,  UnlimitedBoundary>>>;
+
+extern template class ZorderRTree<OpenMPSimulatorTraits<double, UnlimitedBoundary>, ExcludedVolumePotential<OpenMPSimulatorTraits<double, UnlimitedBoundary>>>;
+extern template class ZorderRTree<OpenMPSimulatorTraits<float,  UnlimitedBoundary>, ExcludedVolumePotential<OpenMPSimulatorTraits<float,  UnlimitedBoundary>>>;
+
+extern template class ZorderRTree<OpenMPSimulatorTraits<double, UnlimitedBoundary>, LennardJonesPotential<OpenMPSimulatorTraits<double, UnlimitedBoundary>>>;
+extern template class ZorderRTree<OpenMPSimulatorTraits<float,  UnlimitedBoundary>, LennardJonesPotential<OpenMPSimulatorTraits<float,  UnlimitedBoundary>>>;
+
+extern template class ZorderRTree<OpenMPSimulatorTraits<double, UnlimitedBoundary>, UniformLennardJonesPotential<OpenMPSimulatorTraits<double, UnlimitedBoundary>>>;
+extern template class ZorderRTree<OpenMPSimulatorTraits<float,  UnlimitedBoundary>, UniformLennardJonesPotential<OpenMPSimulatorTraits<float,  UnlimitedBoundary>>>;
+}
+#endif // MJOLNIR_SEPARATE_BUILD
+#endif /* MJOLNIR_OMP_ZORDER_R_TREE_HPP */
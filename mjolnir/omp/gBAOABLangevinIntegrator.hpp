@@ -132,11 +132,13 @@ class gBAOABLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
         }
 
         // O step
+        // random vectors do not depend on the thread that generates them.
+        rng.next_block();
 #pragma omp parallel for
         for(std::size_t i=0; i<sys.size(); ++i)
         {
             sys.velocity(i) *= this->exp_gamma_dt_[i]; // *= exp(- gamma dt)
-            sys.velocity(i) += this->noise_coeff_[i] * this->gen_R(rng);
+            sys.velocity(i) += this->noise_coeff_[i] * rng.gaussian_vector(i);
         }
         correct_velocity(sys, ff);
 
@@ -222,14 +224,6 @@ class gBAOABLangevinIntegrator<OpenMPSimulatorTraits<realT, boundaryT>>
         return;
     };
 
-    coordinate_type gen_R(rng_type& rng) noexcept
-    {
-        const auto x = rng.gaussian();
-        const auto y = rng.gaussian();
-        const auto z = rng.gaussian();
-        return math::make_coordinate<coordinate_type>(x, y, z);
-    }
-
     void correct_coordinate(system_type& sys, const forcefield_type& ff)
     {
         const auto& constraint_ff = ff->constraint();
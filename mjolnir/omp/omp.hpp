@@ -18,6 +18,7 @@
 #include <mjolnir/omp/OpenMPSimulatorTraits.hpp>
 #include <mjolnir/omp/RandomNumberGenerator.hpp>
 #include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/DisplacementTracker.hpp>
 #include <mjolnir/omp/BondLengthInteraction.hpp>
 #include <mjolnir/omp/BondLengthGoContactInteraction.hpp>
 #include <mjolnir/omp/ContactInteraction.hpp>
@@ -36,11 +37,14 @@
 #include <mjolnir/omp/ExternalDistanceInteraction.hpp>
 #include <mjolnir/omp/UnlimitedGridCellList.hpp>
 #include <mjolnir/omp/PeriodicGridCellList.hpp>
+#include <mjolnir/omp/ZorderRTree.hpp>
 #include <mjolnir/omp/UnderdampedLangevinIntegrator.hpp>
 #include <mjolnir/omp/GFWNPTLangevinIntegrator.hpp>
 #include <mjolnir/omp/BAOABLangevinIntegrator.hpp>
 #include <mjolnir/omp/gBAOABLangevinIntegrator.hpp>
 #include <mjolnir/omp/GJFNVTLangevinIntegrator.hpp>
+#include <mjolnir/omp/VelocityVerletIntegrator.hpp>
+#include <mjolnir/omp/SteepestDescentSimulator.hpp>
 #include <mjolnir/omp/SystemMotionRemover.hpp>
 
 #endif// MJOLNIR_OMP_OMP_HPP
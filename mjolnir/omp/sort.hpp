@@ -1,5 +1,6 @@
 #ifndef MJOLNIR_OMP_SORT_HPP
 #define MJOLNIR_OMP_SORT_HPP
+#include <mjolnir/util/counting_sort.hpp>
 #include <type_traits>
 #include <algorithm>
 #include <functional>
@@ -97,6 +98,104 @@ void sort(std::vector<Value, Alloc>& vec, std::vector<Value, Alloc>& buf)
     return;
 }
 
+// Sort values by an integer key in [0, num_keys) in O(N + num_keys), the same
+// as the sequential `counting_sort` in mjolnir/util/counting_sort.hpp.
+//
+// Unlike the sequential version, this is NOT stable. Values are put into the
+// range of their key concurrently, so the order in a key is unspecified.
+//
+// Do NOT call this from parallel region.
+template<typename Value, typename Alloc, typename KeyFunc>
+void counting_sort(std::vector<Value, Alloc>& vec, std::vector<Value, Alloc>& buf,
+                   std::vector<std::size_t>& offsets, const std::size_t num_keys,
+                   KeyFunc key)
+{
+    const std::size_t max_threads = omp_get_max_threads();
+    if(max_threads == 1 || vec.size() < max_threads * 4)
+    {
+        ::mjolnir::counting_sort(vec, buf, offsets, num_keys, key);
+        return;
+    }
+    if(vec.size() != buf.size())
+    {
+        buf.resize(vec.size());
+    }
+    if(offsets.size() != num_keys + 1)
+    {
+        offsets.resize(num_keys + 1);
+    }
+    const std::size_t num_offsets = offsets.size();
+    const std::size_t num_values  = vec.size();
+    std::vector<std::size_t> partial_sums(max_threads, 0);
+
+#pragma omp parallel shared(vec, buf, offsets, partial_sums)
+    {
+        const std::size_t num_threads = omp_get_num_threads();
+        const std::size_t thread_id   = omp_get_thread_num();
+
+#pragma omp for
+        for(std::size_t k=0; k<num_offsets; ++k)
+        {
+            offsets[k] = 0;
+        } // an implicit barrier here
+
+        // count the number of values in each key. offsets[k+1] = count(k)
+#pragma omp for
+        for(std::size_t i=0; i<num_values; ++i)
+        {
+            const std::size_t k = key(vec[i]);
+            assert(k < num_keys);
+#pragma omp atomic
+            offsets[k + 1] += 1;
+        } // an implicit barrier here
+
+        // prefix sum. each thread scans its own subrange first, and then adds
+        // the sum of the preceding subranges.
+        const std::size_t subrange_size = (num_offsets + num_threads - 1) / num_threads;
+        const std::size_t first = std::min(num_offsets, thread_id * subrange_size);
+        const std::size_t last  = std::min(num_offsets, first + subrange_size);
+
+        std::size_t local_sum = 0;
+        for(std::size_t k=first; k<last; ++k)
+        {
+            local_sum += offsets[k];
+            offsets[k] = local_sum;
+        }
+        partial_sums[thread_id] = local_sum;
+#pragma omp barrier
+
+        std::size_t base = 0;
+        for(std::size_t t=0; t<thread_id; ++t)
+        {
+            base += partial_sums[t];
+        }
+        for(std::size_t k=first; k<last; ++k)
+        {
+            offsets[k] += base;
+        }
+#pragma omp barrier
+
+        // scatter. after this, offsets[k] points the end of key k.
+#pragma omp for
+        for(std::size_t i=0; i<num_values; ++i)
+        {
+            const std::size_t k = key(vec[i]);
+            std::size_t pos;
+#pragma omp atomic capture
+            pos = offsets[k]++;
+
+            buf[pos] = vec[i];
+        } // an implicit barrier here
+    }
+    // restore the first positions.
+    std::copy_backward(offsets.begin(), offsets.end() - 1, offsets.end());
+    offsets.front() = 0;
+
+    // both are std::vector. we don't need to use ADL.
+    std::swap(vec, buf);
+    return;
+}
+
 } // omp
 } // mjolnir
 #endif // MJOLNIR_OMP_SORT_HPP
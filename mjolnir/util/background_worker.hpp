@@ -0,0 +1,170 @@
+#ifndef MJOLNIR_UTIL_BACKGROUND_WORKER_HPP
+#define MJOLNIR_UTIL_BACKGROUND_WORKER_HPP
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <memory>
+#include <utility>
+
+namespace mjolnir
+{
+
+// A thread that runs tasks in the order they are pushed.
+//
+// It is used by observers to write frames without stopping the simulation.
+// An observer takes a snapshot of the data it needs and pushes a task that
+// formats and writes the snapshot. At most `capacity` tasks can wait in the
+// queue. If the worker falls behind, `push` blocks until a task finishes, so
+// the memory used by the snapshots is bounded.
+//
+// If a task throws, the remaining tasks are discarded and the exception is
+// re-thrown from the next `push` or `wait` in the main thread.
+class BackgroundWorker
+{
+  public:
+    using task_type = std::function<void()>;
+
+  public:
+
+    explicit BackgroundWorker(const std::size_t capacity = 2)
+        : capacity_(capacity == 0 ? 1 : capacity), running_(false),
+          stopped_(false), error_(nullptr)
+    {
+        this->thread_ = std::thread([this]{this->run();});
+    }
+    ~BackgroundWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mtx_);
+            this->stopped_ = true;
+        }
+        this->cv_task_.notify_all();
+        this->thread_.join(); // the remaining tasks are done before stopping
+    }
+
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker(BackgroundWorker&&)      = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(BackgroundWorker&&)      = delete;
+
+    void push(task_type task)
+    {
+        std::unique_lock<std::mutex> lock(this->mtx_);
+        this->cv_done_.wait(lock, [this]{
+                return this->tasks_.size() < this->capacity_ || this->error_;
+            });
+        this->rethrow_if_failed();
+
+        this->tasks_.push_back(std::move(task));
+        lock.unlock();
+        this->cv_task_.notify_one();
+        return;
+    }
+
+    // wait until all the tasks finish.
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(this->mtx_);
+        this->cv_done_.wait(lock, [this]{
+                return (this->tasks_.empty() && !this->running_) || this->error_;
+            });
+        this->rethrow_if_failed();
+        return;
+    }
+    // wait until all the tasks finish, ignoring errors. for destructors.
+    void drain() noexcept
+    {
+        std::unique_lock<std::mutex> lock(this->mtx_);
+        this->cv_done_.wait(lock, [this]{
+                return this->tasks_.empty() && !this->running_;
+            });
+        return;
+    }
+
+    std::size_t capacity() const noexcept {return capacity_;}
+
+  private:
+
+    // call it with the lock.
+    void rethrow_if_failed()
+    {
+        if(this->error_)
+        {
+            std::exception_ptr err(nullptr);
+            std::swap(err, this->error_);
+            std::rethrow_exception(err);
+        }
+        return;
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(this->mtx_);
+        while(true)
+        {
+            this->cv_task_.wait(lock, [this]{
+                    return !this->tasks_.empty() || this->stopped_;
+                });
+            if(this->tasks_.empty()) // stopped and nothing to do
+            {
+                return;
+            }
+            task_type task = std::move(this->tasks_.front());
+            this->tasks_.pop_front();
+            this->running_ = true;
+            lock.unlock();
+
+            std::exception_ptr err(nullptr);
+            try
+            {
+                task();
+            }
+            catch(...)
+            {
+                err = std::current_exception();
+            }
+
+            lock.lock();
+            this->running_ = false;
+            if(err)
+            {
+                this->error_ = err;
+                this->tasks_.clear();
+            }
+            this->cv_done_.notify_all();
+        }
+    }
+
+  private:
+
+    std::size_t             capacity_;
+    bool                    running_;
+    bool                    stopped_;
+    std::exception_ptr      error_;
+    std::deque<task_type>   tasks_;
+    std::mutex              mtx_;
+    std::condition_variable cv_task_; // notified when a task is pushed
+    std::condition_variable cv_done_; // notified when a task is finished
+    std::thread             thread_;
+};
+
+// run `task` in the background if the worker exists. otherwise, run it now.
+template<typename F>
+void run_in_background(const std::shared_ptr<BackgroundWorker>& worker, F&& task)
+{
+    if(worker)
+    {
+        worker->push(std::forward<F>(task));
+    }
+    else
+    {
+        task();
+    }
+    return;
+}
+
+} // mjolnir
+#endif // MJOLNIR_UTIL_BACKGROUND_WORKER_HPP
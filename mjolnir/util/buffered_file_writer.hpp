@@ -0,0 +1,262 @@
+#ifndef MJOLNIR_UTIL_BUFFERED_FILE_WRITER_HPP
+#define MJOLNIR_UTIL_BUFFERED_FILE_WRITER_HPP
+#include <mjolnir/util/throw_exception.hpp>
+#include <stdexcept>
+#include <utility>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <unistd.h> // ::fsync
+#endif
+
+namespace mjolnir
+{
+
+// A file that is kept open while a simulation runs.
+//
+// Observers used to re-open their files in every output and write a frame in
+// many small pieces. On a shared filesystem, opening and closing a file can be
+// slower than an MD step. This keeps the file open, stores data in a buffer,
+// and writes the buffered frames at once.
+//
+// - `end_frame()` marks the end of a frame. When `flush_interval` frames are
+//   buffered, they are written to the file. If it is 1, each frame is written
+//   to the file as one block immediately.
+// - At a flush, if `fsync_interval` frames or more have been written since the
+//   last fsync, it calls fsync so that the data reaches the storage even if
+//   the node crashes. If it is 0, fsync will never be called.
+// - `patch()` keeps bytes that will overwrite a part of the file that is
+//   already written (e.g. the number of frames in a header). Seeking back and
+//   forth in every frame is costly, so the patch is applied only just before
+//   fsync and when the file is closed, or explicitly by `apply_patch()`.
+class BufferedFileWriter
+{
+  public:
+
+    BufferedFileWriter() noexcept
+        : fp_(nullptr), flush_interval_(1), fsync_interval_(0),
+          buffered_frames_(0), unsynced_frames_(0)
+    {}
+
+    // open a file. the existing contents will be discarded.
+    explicit BufferedFileWriter(const std::string& fname,
+            const std::size_t flush_interval = 1,
+            const std::size_t fsync_interval = 0)
+        : fp_(std::fopen(fname.c_str(), "wb")), filename_(fname),
+          flush_interval_(flush_interval == 0 ? 1 : flush_interval),
+          fsync_interval_(fsync_interval),
+          buffered_frames_(0), unsynced_frames_(0)
+    {
+        if(this->fp_ == nullptr)
+        {
+            throw_exception<std::runtime_error>("[error] mjolnir::"
+                "BufferedFileWriter: file open error: ", fname);
+        }
+    }
+    ~BufferedFileWriter() {this->close();}
+
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    BufferedFileWriter(BufferedFileWriter&& other) noexcept
+        : fp_(other.fp_), filename_(std::move(other.filename_)),
+          buffer_(std::move(other.buffer_)),
+          patches_(std::move(other.patches_)),
+          flush_interval_(other.flush_interval_),
+          fsync_interval_(other.fsync_interval_),
+          buffered_frames_(other.buffered_frames_),
+          unsynced_frames_(other.unsynced_frames_)
+    {
+        other.fp_ = nullptr;
+    }
+    BufferedFileWriter& operator=(BufferedFileWriter&& other) noexcept
+    {
+        if(this != std::addressof(other))
+        {
+            this->close();
+            this->fp_              = other.fp_;
+            this->filename_        = std::move(other.filename_);
+            this->buffer_          = std::move(other.buffer_);
+            this->patches_         = std::move(other.patches_);
+            this->flush_interval_  = other.flush_interval_;
+            this->fsync_interval_  = other.fsync_interval_;
+            this->buffered_frames_ = other.buffered_frames_;
+            this->unsynced_frames_ = other.unsynced_frames_;
+            other.fp_ = nullptr;
+        }
+        return *this;
+    }
+
+    void write(const char* ptr, const std::size_t size)
+    {
+        this->buffer_.append(ptr, size);
+        return;
+    }
+    void write(const std::string& str)
+    {
+        this->buffer_.append(str);
+        return;
+    }
+    template<typename T>
+    void write_as_bytes(const T& v)
+    {
+        this->buffer_.append(reinterpret_cast<const char*>(std::addressof(v)),
+                             sizeof(T));
+        return;
+    }
+
+    // returns true if the buffered frames are written to the file.
+    bool end_frame()
+    {
+        this->buffered_frames_ += 1;
+        if(this->flush_interval_ <= this->buffered_frames_)
+        {
+            this->flush();
+            return true;
+        }
+        return false;
+    }
+
+    // write all the buffered data to the file.
+    void flush()
+    {
+        if(this->fp_ == nullptr) {return;}
+
+        if(!this->buffer_.empty())
+        {
+            const auto written = std::fwrite(this->buffer_.data(), 1,
+                                             this->buffer_.size(), this->fp_);
+            if(written != this->buffer_.size())
+            {
+                throw_exception<std::runtime_error>("[error] mjolnir::"
+                    "BufferedFileWriter: failed to write to ", this->filename_);
+            }
+            this->buffer_.clear();
+        }
+        std::fflush(this->fp_);
+
+        this->unsynced_frames_ += this->buffered_frames_;
+        this->buffered_frames_  = 0;
+        if(this->fsync_interval_ != 0 &&
+           this->fsync_interval_ <= this->unsynced_frames_)
+        {
+            this->write_patches();
+            this->sync();
+        }
+        return;
+    }
+
+    // overwrite `size` bytes from `pos` in the file, e.g. the number of frames
+    // in a header. The buffered data are written before that.
+    void overwrite(const std::size_t pos, const char* ptr, const std::size_t size)
+    {
+        this->flush();
+        if(this->fp_ == nullptr) {return;}
+
+        std::fseek(this->fp_, static_cast<long>(pos), SEEK_SET);
+        std::fwrite(ptr, 1, size, this->fp_);
+        std::fseek(this->fp_, 0, SEEK_END);
+        std::fflush(this->fp_);
+        return;
+    }
+    template<typename T>
+    void overwrite_as_bytes(const std::size_t pos, const T& v)
+    {
+        this->overwrite(pos, reinterpret_cast<const char*>(std::addressof(v)),
+                        sizeof(T));
+        return;
+    }
+
+    // keep `size` bytes to be written at `pos` later. A patch at the same
+    // position replaces the previous one.
+    void patch(const std::size_t pos, const char* ptr, const std::size_t size)
+    {
+        for(auto& p : this->patches_)
+        {
+            if(p.first == pos)
+            {
+                p.second.assign(ptr, size);
+                return;
+            }
+        }
+        this->patches_.emplace_back(pos, std::string(ptr, size));
+        return;
+    }
+    template<typename T>
+    void patch_as_bytes(const std::size_t pos, const T& v)
+    {
+        this->patch(pos, reinterpret_cast<const char*>(std::addressof(v)),
+                    sizeof(T));
+        return;
+    }
+    // write the buffered data and the patches to the file.
+    void apply_patch()
+    {
+        this->flush();
+        this->write_patches();
+        return;
+    }
+
+    void close()
+    {
+        if(this->fp_ == nullptr) {return;}
+        // a destructor should not throw. write as much as possible.
+        if(!this->buffer_.empty())
+        {
+            std::fwrite(this->buffer_.data(), 1, this->buffer_.size(), this->fp_);
+            this->buffer_.clear();
+        }
+        this->write_patches();
+        std::fclose(this->fp_);
+        this->fp_ = nullptr;
+        return;
+    }
+
+    bool               is_open()  const noexcept {return fp_ != nullptr;}
+    std::string const& filename() const noexcept {return filename_;}
+
+    std::size_t flush_interval() const noexcept {return flush_interval_;}
+    std::size_t fsync_interval() const noexcept {return fsync_interval_;}
+
+  private:
+
+    // it is called after the buffer is written.
+    void write_patches() noexcept
+    {
+        if(this->fp_ == nullptr || this->patches_.empty()) {return;}
+        for(const auto& p : this->patches_)
+        {
+            std::fseek(this->fp_, static_cast<long>(p.first), SEEK_SET);
+            std::fwrite(p.second.data(), 1, p.second.size(), this->fp_);
+        }
+        std::fseek(this->fp_, 0, SEEK_END);
+        std::fflush(this->fp_);
+        this->patches_.clear();
+        return;
+    }
+
+    void sync() noexcept
+    {
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+        ::fsync(::fileno(this->fp_));
+#endif
+        this->unsynced_frames_ = 0;
+        return;
+    }
+
+  private:
+
+    std::FILE*  fp_;
+    std::string filename_;
+    std::string buffer_;
+    std::vector<std::pair<std::size_t, std::string>> patches_;
+    std::size_t flush_interval_;
+    std::size_t fsync_interval_;
+    std::size_t buffered_frames_;
+    std::size_t unsynced_frames_;
+};
+
+} // mjolnir
+#endif // MJOLNIR_UTIL_BUFFERED_FILE_WRITER_HPP
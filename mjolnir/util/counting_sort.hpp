@@ -0,0 +1,50 @@
+#ifndef MJOLNIR_UTIL_COUNTING_SORT_HPP
+#define MJOLNIR_UTIL_COUNTING_SORT_HPP
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace mjolnir
+{
+
+// Sort values by an integer key in [0, num_keys) in O(N + num_keys).
+//
+// After this, values that have key `k` are in [offsets[k], offsets[k+1]) of
+// `vec`. `offsets` will have `num_keys + 1` elements. `buf` is used as a
+// working space; its contents are unspecified after this call.
+//
+// This is stable. Values that have the same key keep their relative order.
+template<typename Value, typename Alloc, typename KeyFunc>
+void counting_sort(std::vector<Value, Alloc>& vec, std::vector<Value, Alloc>& buf,
+                   std::vector<std::size_t>& offsets, const std::size_t num_keys,
+                   KeyFunc key)
+{
+    // count the number of values in each key. offsets[k+1] = count(k)
+    offsets.assign(num_keys + 1, 0);
+    for(const auto& v : vec)
+    {
+        assert(key(v) < num_keys);
+        offsets[key(v) + 1] += 1;
+    }
+    // offsets[k] = sum of count(0..k-1) = the first position of key k
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    // scatter. after this, offsets[k] points the end of key k.
+    buf.resize(vec.size());
+    for(const auto& v : vec)
+    {
+        buf[offsets[key(v)]++] = v;
+    }
+    // restore the first positions.
+    std::copy_backward(offsets.begin(), offsets.end() - 1, offsets.end());
+    offsets.front() = 0;
+
+    // both are std::vector. we don't need to use ADL.
+    std::swap(vec, buf);
+    return;
+}
+
+} // mjolnir
+#endif // MJOLNIR_UTIL_COUNTING_SORT_HPP
@@ -14,6 +14,14 @@
 #  define MJOLNIR_FUNC_NAME __func__
 #endif
 
+// MJOLNIR_SIMD_LOOP, placed just before a `for` loop to ask the compiler to
+// vectorize it. It requires OpenMP 4.0 (`omp simd`). Otherwise it does nothing.
+#if defined(_OPENMP) && _OPENMP >= 201307
+#  define MJOLNIR_SIMD_LOOP _Pragma("omp simd")
+#else
+#  define MJOLNIR_SIMD_LOOP
+#endif
+
 // check the architecture uses little endian or big endian.
 // GCC and clang have __BYTE_ORDER__ macro. The value of the macro is equal to
 // __ORDER_BIG_ENDIAN__ if the platform uses big endian, or
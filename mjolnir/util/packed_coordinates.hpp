@@ -0,0 +1,155 @@
+#ifndef MJOLNIR_UTIL_PACKED_COORDINATES_HPP
+#define MJOLNIR_UTIL_PACKED_COORDINATES_HPP
+#include <mjolnir/util/aligned_allocator.hpp>
+#include <mjolnir/math/Vector.hpp>
+#include <algorithm>
+#include <vector>
+#include <cassert>
+
+namespace mjolnir
+{
+
+// Structure-of-Arrays representation of a set of 3D vectors.
+//
+// x, y, and z components are stored in separate, contiguous arrays so that
+// a kernel can load consecutive lanes of the same component at once. Each
+// array starts at a `alignment`-byte boundary and has `padded_size()` elements
+// (a multiple of `lanes`), so a SIMD loop can always process a full register
+// without a remainder loop. The padded region is kept zero.
+//
+//  |<------------------------ storage_ ------------------------------>|
+//  |x0 x1 ... xN-1 0 .. 0|y0 y1 ... yN-1 0 .. 0|z0 z1 ... zN-1 0 .. 0|
+//  ^ x()                 ^ y()                 ^ z()
+//
+template<typename realT, typename coordT>
+class packed_coordinates
+{
+  public:
+    using real_type       = realT;
+    using coordinate_type = coordT;
+
+    // 64 bytes is the size of a cache line and AVX-512 register.
+    static constexpr std::size_t alignment = 64;
+    static constexpr std::size_t lanes     = alignment / sizeof(real_type);
+
+    using container_type = std::vector<real_type,
+                                       aligned_allocator<real_type, alignment>>;
+
+    static_assert(alignment % sizeof(real_type) == 0,
+                  "packed_coordinates: alignment should be a multiple of "
+                  "sizeof(real_type)");
+
+  public:
+
+    packed_coordinates(): size_(0), padded_size_(0) {}
+    explicit packed_coordinates(const std::size_t N)
+        : size_(N), padded_size_(pad(N)), storage_(3 * pad(N), real_type(0))
+    {}
+    ~packed_coordinates() = default;
+    packed_coordinates(const packed_coordinates&) = default;
+    packed_coordinates(packed_coordinates&&)      = default;
+    packed_coordinates& operator=(const packed_coordinates&) = default;
+    packed_coordinates& operator=(packed_coordinates&&)      = default;
+
+    void resize(const std::size_t N)
+    {
+        this->size_        = N;
+        this->padded_size_ = pad(N);
+        this->storage_.assign(3 * this->padded_size_, real_type(0));
+        return;
+    }
+
+    std::size_t size()        const noexcept {return size_;}
+    std::size_t padded_size() const noexcept {return padded_size_;}
+    bool        empty()       const noexcept {return size_ == 0;}
+
+    // raw spans for kernels. each of them has `padded_size()` elements.
+    real_type*       x()       noexcept {return storage_.data();}
+    real_type const* x() const noexcept {return storage_.data();}
+    real_type*       y()       noexcept {return storage_.data() + padded_size_;}
+    real_type const* y() const noexcept {return storage_.data() + padded_size_;}
+    real_type*       z()       noexcept {return storage_.data() + padded_size_ * 2;}
+    real_type const* z() const noexcept {return storage_.data() + padded_size_ * 2;}
+
+    coordinate_type load(const std::size_t i) const noexcept
+    {
+        assert(i < size_);
+        return math::make_coordinate<coordinate_type>(
+                this->x()[i], this->y()[i], this->z()[i]);
+    }
+    void store(const std::size_t i, const coordinate_type& v) noexcept
+    {
+        assert(i < size_);
+        this->x()[i] = math::X(v);
+        this->y()[i] = math::Y(v);
+        this->z()[i] = math::Z(v);
+        return;
+    }
+    void add(const std::size_t i, const coordinate_type& v) noexcept
+    {
+        assert(i < size_);
+        this->x()[i] += math::X(v);
+        this->y()[i] += math::Y(v);
+        this->z()[i] += math::Z(v);
+        return;
+    }
+
+    void fill_zero() noexcept
+    {
+        std::fill(storage_.begin(), storage_.end(), real_type(0));
+        return;
+    }
+
+    // copy AoS values into this.
+    template<typename Alloc>
+    void pack(const std::vector<coordinate_type, Alloc>& aos) noexcept
+    {
+        assert(aos.size() == this->size_);
+        real_type* const xs = this->x();
+        real_type* const ys = this->y();
+        real_type* const zs = this->z();
+        for(std::size_t i=0; i<this->size_; ++i)
+        {
+            xs[i] = math::X(aos[i]);
+            ys[i] = math::Y(aos[i]);
+            zs[i] = math::Z(aos[i]);
+        }
+        return;
+    }
+    // add values to AoS vectors. it does not clear the values in this.
+    template<typename Alloc>
+    void accumulate_to(std::vector<coordinate_type, Alloc>& aos) const noexcept
+    {
+        assert(aos.size() == this->size_);
+        const real_type* const xs = this->x();
+        const real_type* const ys = this->y();
+        const real_type* const zs = this->z();
+        for(std::size_t i=0; i<this->size_; ++i)
+        {
+            math::X(aos[i]) += xs[i];
+            math::Y(aos[i]) += ys[i];
+            math::Z(aos[i]) += zs[i];
+        }
+        return;
+    }
+
+  private:
+
+    static constexpr std::size_t pad(const std::size_t N) noexcept
+    {
+        return (N + lanes - 1) / lanes * lanes;
+    }
+
+  private:
+
+    std::size_t    size_;
+    std::size_t    padded_size_;
+    container_type storage_;
+};
+template<typename realT, typename coordT>
+constexpr std::size_t packed_coordinates<realT, coordT>::alignment;
+template<typename realT, typename coordT>
+constexpr std::size_t packed_coordinates<realT, coordT>::lanes;
+
+} // mjolnir
+#endif // MJOLNIR_UTIL_PACKED_COORDINATES_HPP
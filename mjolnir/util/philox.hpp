@@ -0,0 +1,123 @@
+#ifndef MJOLNIR_UTIL_PHILOX_HPP
+#define MJOLNIR_UTIL_PHILOX_HPP
+#include <mjolnir/math/constants.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace mjolnir
+{
+
+// Philox4x32-10, a counter-based pseudo random number generator.
+//
+// J. K. Salmon, M. A. Moraes, R. O. Dror, and D. E. Shaw, (2011)
+// "Parallel random numbers: as easy as 1, 2, 3", SC'11.
+//
+// It is a bijection from a 128-bit counter to 128-bit random bits, keyed by
+// 64 bits. Unlike an ordinary generator, it does not have any internal state;
+// the i-th random number is obtained directly from the counter `i`. So the
+// numbers do not depend on the order of generation, nor on the thread that
+// generates them.
+struct philox4x32
+{
+    using counter_type = std::array<std::uint32_t, 4>;
+    using key_type     = std::array<std::uint32_t, 2>;
+
+    static constexpr std::uint32_t M0 = 0xD2511F53u;
+    static constexpr std::uint32_t M1 = 0xCD9E8D57u;
+    static constexpr std::uint32_t W0 = 0x9E3779B9u; // golden ratio
+    static constexpr std::uint32_t W1 = 0xBB67AE85u; // sqrt(3) - 1
+    static constexpr std::size_t   rounds = 10;
+
+    // It takes counter and key as scalars so that a loop of this can be
+    // vectorized by a compiler.
+    static void generate(std::uint32_t& c0, std::uint32_t& c1,
+                         std::uint32_t& c2, std::uint32_t& c3,
+                         std::uint32_t   k0, std::uint32_t   k1) noexcept
+    {
+        for(std::size_t r=0; r<rounds; ++r)
+        {
+            const std::uint64_t p0 = static_cast<std::uint64_t>(M0) * c0;
+            const std::uint64_t p1 = static_cast<std::uint64_t>(M1) * c2;
+            const std::uint32_t hi0 = static_cast<std::uint32_t>(p0 >> 32);
+            const std::uint32_t lo0 = static_cast<std::uint32_t>(p0);
+            const std::uint32_t hi1 = static_cast<std::uint32_t>(p1 >> 32);
+            const std::uint32_t lo1 = static_cast<std::uint32_t>(p1);
+
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+
+            k0 += W0;
+            k1 += W1;
+        }
+        return;
+    }
+
+    static counter_type generate(counter_type ctr, const key_type& key) noexcept
+    {
+        generate(ctr[0], ctr[1], ctr[2], ctr[3], key[0], key[1]);
+        return ctr;
+    }
+};
+
+// convert random bits into a uniform real number in [0, 1).
+template<typename realT>
+struct philox_uniform;
+
+template<>
+struct philox_uniform<float>
+{
+    static float invoke(const std::uint32_t hi, const std::uint32_t) noexcept
+    {
+        // use the upper 24 bits (the number of digits of float)
+        return static_cast<float>(hi >> 8) * 5.9604644775390625e-8f; // 2^-24
+    }
+};
+template<>
+struct philox_uniform<double>
+{
+    static double invoke(const std::uint32_t hi, const std::uint32_t lo) noexcept
+    {
+        // use the upper 53 bits (the number of digits of double)
+        const std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32) | lo;
+        return static_cast<double>(bits >> 11) * 1.1102230246251565e-16; // 2^-53
+    }
+};
+
+// Box-Muller transformation. It converts two sets of 32 random bits into two
+// independent standard normal random numbers.
+template<typename realT>
+void philox_box_muller(const std::uint32_t a, const std::uint32_t b,
+                       realT& z0, realT& z1) noexcept
+{
+    constexpr realT two_pi = math::constants<realT>::two_pi();
+    constexpr realT r2_32  = realT(2.3283064365386962890625e-10); // 2^-32
+
+    // u1 in (0, 1] to avoid log(0). u2 in [0, 1).
+    const realT u1 = (static_cast<realT>(a) + realT(0.5)) * r2_32;
+    const realT u2 =  static_cast<realT>(b)               * r2_32;
+
+    const realT r     = std::sqrt(realT(-2) * std::log(u1));
+    const realT theta = two_pi * u2;
+    z0 = r * std::cos(theta);
+    z1 = r * std::sin(theta);
+    return;
+}
+
+// the first one of `philox_box_muller`. It is for the case when only one
+// normal random number is needed. The result is the same as `z0` above.
+template<typename realT>
+realT philox_box_muller_first(const std::uint32_t a, const std::uint32_t b) noexcept
+{
+    constexpr realT two_pi = math::constants<realT>::two_pi();
+    constexpr realT r2_32  = realT(2.3283064365386962890625e-10); // 2^-32
+
+    const realT u1 = (static_cast<realT>(a) + realT(0.5)) * r2_32;
+    const realT u2 =  static_cast<realT>(b)               * r2_32;
+    return std::sqrt(realT(-2) * std::log(u1)) * std::cos(two_pi * u2);
+}
+
+} // mjolnir
+#endif// MJOLNIR_UTIL_PHILOX_HPP
@@ -0,0 +1,219 @@
+#ifndef MJOLNIR_UTIL_PROFILER_HPP
+#define MJOLNIR_UTIL_PROFILER_HPP
+#include <mjolnir/util/make_unique.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <x86intrin.h>
+#  define MJOLNIR_PROFILER_USE_RDTSC
+#endif
+
+// A lightweight wall-clock profiler for each interaction, neighbor list
+// construction, integrator and observer.
+//
+// Each instrumented place holds a pointer to a ProfileCounter that is
+// registered by name in the ProfileManager at the construction or
+// initialization time. MJOLNIR_PROFILE_SCOPE(counter) adds the elapsed ticks
+// of the enclosing scope to the counter. Ticks are read by `rdtsc` on x86 and
+// by std::chrono::steady_clock otherwise, and converted into seconds when a
+// summary is formatted.
+//
+// The timers are enabled only if MJOLNIR_WITH_PROFILER is defined (cmake
+// -DUSE_PROFILER=ON). Otherwise, the macros are expanded into nothing. The
+// counter pointers and their registration in the instrumented classes are
+// enclosed by the same macro, so that a build without the profiler does not
+// have any counter nor any access to the ProfileManager.
+//
+// NOTE: counters are not thread-safe. Instrumented scopes must be called from
+//       the main thread. OpenMP parallel regions inside of a scope are fine.
+
+namespace mjolnir
+{
+
+struct ProfileCounter
+{
+    std::string   name;
+    std::uint64_t ticks;
+    std::uint64_t calls;
+
+    void add(const std::uint64_t dt) noexcept
+    {
+        this->ticks += dt;
+        this->calls += 1;
+        return;
+    }
+};
+
+template<typename tickT>
+class basic_profile_manager
+{
+  public:
+    using tick_type      = tickT;
+    using counter_type   = ProfileCounter;
+    using clock_type     = std::chrono::steady_clock;
+    using container_type = std::map<std::string, std::unique_ptr<counter_type>>;
+
+  public:
+
+    static tick_type now() noexcept
+    {
+#ifdef MJOLNIR_PROFILER_USE_RDTSC
+        return static_cast<tick_type>(__rdtsc());
+#else
+        return static_cast<tick_type>(std::chrono::duration_cast<
+            std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count());
+#endif
+    }
+
+    // counters with the same name are shared.
+    static counter_type* get_counter(const std::string& name)
+    {
+        if(order_.empty()) {start_calibration();}
+
+        auto found = counters_.find(name);
+        if(found == counters_.end())
+        {
+            auto counter = ::mjolnir::make_unique<counter_type>(
+                    counter_type{name, 0, 0});
+            order_.push_back(counter.get());
+            found = counters_.emplace(name, std::move(counter)).first;
+        }
+        return found->second.get();
+    }
+
+    // in the order of registration
+    static std::vector<counter_type*> const& counters() noexcept {return order_;}
+
+    // reset all the ticks and calls. counters themselves are kept.
+    static void reset() noexcept
+    {
+        for(auto* counter : order_)
+        {
+            counter->ticks = 0;
+            counter->calls = 0;
+        }
+        return;
+    }
+
+    // compare ticks with steady_clock from the first registration.
+    static double seconds_per_tick() noexcept
+    {
+#ifdef MJOLNIR_PROFILER_USE_RDTSC
+        const auto t = clock_type::now();
+        const auto c = now();
+        const double sec = std::chrono::duration<double>(t - start_time_).count();
+        if(c <= start_tick_ || sec <= 0.0) {return 0.0;}
+        return sec / static_cast<double>(c - start_tick_);
+#else
+        return 1e-9;
+#endif
+    }
+
+    // a table of total time, number of calls and time per call.
+    static std::string summary()
+    {
+        const double spt = seconds_per_tick();
+
+        std::size_t width = 10;
+        for(const auto* counter : order_)
+        {
+            width = std::max(width, counter->name.size());
+        }
+
+        std::ostringstream oss;
+        oss << std::setw(width) << std::left << "name"
+            << std::setw(14) << std::right << "total[s]"
+            << std::setw(12) << std::right << "calls"
+            << std::setw(14) << std::right << "per call[ms]" << '\n';
+        for(const auto* counter : order_)
+        {
+            const double total = counter->ticks * spt;
+            const double mean  = (counter->calls == 0) ? 0.0 :
+                                 total * 1e3 / counter->calls;
+            oss << std::setw(width) << std::left << counter->name
+                << std::setw(14) << std::right << std::fixed
+                << std::setprecision(4) << total
+                << std::setw(12) << std::right << counter->calls
+                << std::setw(14) << std::right << std::fixed
+                << std::setprecision(6) << mean << '\n';
+        }
+        return oss.str();
+    }
+
+  private:
+
+    static void start_calibration() noexcept
+    {
+        start_time_ = clock_type::now();
+        start_tick_ = now();
+        return;
+    }
+
+  private:
+
+    static container_type              counters_;
+    static std::vector<counter_type*>  order_;
+    static clock_type::time_point      start_time_;
+    static tick_type                   start_tick_;
+};
+
+template<typename tickT>
+typename basic_profile_manager<tickT>::container_type
+basic_profile_manager<tickT>::counters_;
+template<typename tickT>
+std::vector<ProfileCounter*> basic_profile_manager<tickT>::order_;
+template<typename tickT>
+typename basic_profile_manager<tickT>::clock_type::time_point
+basic_profile_manager<tickT>::start_time_;
+template<typename tickT>
+tickT basic_profile_manager<tickT>::start_tick_ = 0;
+
+using ProfileManager = basic_profile_manager<std::uint64_t>;
+
+class ScopedProfileTimer
+{
+  public:
+    explicit ScopedProfileTimer(ProfileCounter* counter) noexcept
+        : counter_(counter), start_(ProfileManager::now())
+    {}
+    ~ScopedProfileTimer() noexcept
+    {
+        counter_->add(ProfileManager::now() - start_);
+    }
+
+    ScopedProfileTimer(const ScopedProfileTimer&) = delete;
+    ScopedProfileTimer& operator=(const ScopedProfileTimer&) = delete;
+
+  private:
+    ProfileCounter* counter_;
+    std::uint64_t   start_;
+};
+
+} // mjolnir
+
+#define MJOLNIR_PROFILE_CONCAT_AUX(x, y) x ## y
+#define MJOLNIR_PROFILE_CONCAT(x, y)     MJOLNIR_PROFILE_CONCAT_AUX(x, y)
+
+#ifdef MJOLNIR_WITH_PROFILER
+// measure the time until the end of the current scope
+#  define MJOLNIR_PROFILE_SCOPE(counter) ::mjolnir::ScopedProfileTimer \
+    MJOLNIR_PROFILE_CONCAT(p_r_o_f_i_l_e_, __LINE__)(counter)
+// measure the time between START and STOP. STOP can be conditional.
+#  define MJOLNIR_PROFILE_START(tick) const auto tick = ::mjolnir::ProfileManager::now()
+#  define MJOLNIR_PROFILE_STOP(counter, tick) \
+    (counter)->add(::mjolnir::ProfileManager::now() - (tick))
+#else
+#  define MJOLNIR_PROFILE_SCOPE(counter)      /**/
+#  define MJOLNIR_PROFILE_START(tick)         /**/
+#  define MJOLNIR_PROFILE_STOP(counter, tick) /**/
+#endif
+
+#endif // MJOLNIR_UTIL_PROFILER_HPP
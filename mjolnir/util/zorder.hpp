@@ -0,0 +1,37 @@
+#ifndef MJOLNIR_UTIL_ZORDER_HPP
+#define MJOLNIR_UTIL_ZORDER_HPP
+#include <mjolnir/math/math.hpp>
+#include <cstdint>
+
+namespace mjolnir
+{
+namespace detail
+{
+
+// spread the lower 10 bits of v so that there are two 0-bits between them.
+inline std::uint32_t zorder_expand_bits(std::uint32_t v) noexcept
+{
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+// Morton code of a position on a 1024^3 grid.
+// r is a position normalized into [0, 1)
+template<typename realT, typename coordT>
+std::uint32_t zorder_index(coordT r) noexcept
+{
+    math::X(r) = math::clamp<realT>(math::X(r) * 1024, 0, 1023);
+    math::Y(r) = math::clamp<realT>(math::Y(r) * 1024, 0, 1023);
+    math::Z(r) = math::clamp<realT>(math::Z(r) * 1024, 0, 1023);
+    const auto xx = zorder_expand_bits(static_cast<std::uint32_t>(math::X(r)));
+    const auto yy = zorder_expand_bits(static_cast<std::uint32_t>(math::Y(r)));
+    const auto zz = zorder_expand_bits(static_cast<std::uint32_t>(math::Z(r)));
+    return xx * 4 + yy * 2 + zz;
+}
+
+} // detail
+} // mjolnir
+#endif// MJOLNIR_UTIL_ZORDER_HPP
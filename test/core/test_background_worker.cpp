@@ -0,0 +1,80 @@
+#define BOOST_TEST_MODULE "test_background_worker"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/util/background_worker.hpp>
+#include <stdexcept>
+#include <atomic>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(BackgroundWorker_order)
+{
+    std::vector<int> done;
+    {
+        mjolnir::BackgroundWorker worker(2);
+        for(int i=0; i<100; ++i)
+        {
+            worker.push([&done, i] {done.push_back(i);});
+        }
+        worker.wait();
+        BOOST_TEST_REQUIRE(done.size() == 100u);
+        for(int i=0; i<100; ++i)
+        {
+            BOOST_TEST(done.at(i) == i);
+        }
+
+        // tasks remaining at the destruction are done
+        for(int i=100; i<110; ++i)
+        {
+            worker.push([&done, i] {done.push_back(i);});
+        }
+    }
+    BOOST_TEST(done.size() == 110u);
+}
+
+BOOST_AUTO_TEST_CASE(BackgroundWorker_capacity)
+{
+    std::atomic<std::size_t> in_queue(0);
+    std::atomic<std::size_t> max_in_queue(0);
+
+    mjolnir::BackgroundWorker worker(3);
+    for(int i=0; i<50; ++i)
+    {
+        const auto n = ++in_queue;
+        if(max_in_queue < n) {max_in_queue = n;}
+        worker.push([&in_queue] {--in_queue;});
+    }
+    worker.wait();
+    BOOST_TEST(in_queue.load() == 0u);
+    // 3 in the queue, 1 that is running, and 1 that is being pushed
+    BOOST_TEST(max_in_queue.load() <= 5u);
+}
+
+BOOST_AUTO_TEST_CASE(BackgroundWorker_error)
+{
+    mjolnir::BackgroundWorker worker(2);
+    worker.push([] {throw std::runtime_error("error in a task");});
+    BOOST_CHECK_THROW(worker.wait(), std::runtime_error);
+
+    // the error is reported only once and the worker can be used again
+    int value = 0;
+    worker.push([&value] {value = 42;});
+    worker.wait();
+    BOOST_TEST(value == 42);
+}
+
+BOOST_AUTO_TEST_CASE(run_in_background)
+{
+    int value = 0;
+    mjolnir::run_in_background(nullptr, [&value] {value = 1;});
+    BOOST_TEST(value == 1); // run immediately
+
+    const auto worker = std::make_shared<mjolnir::BackgroundWorker>(2);
+    mjolnir::run_in_background(worker, [&value] {value = 2;});
+    worker->wait();
+    BOOST_TEST(value == 2);
+}
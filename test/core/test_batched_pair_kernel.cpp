@@ -0,0 +1,363 @@
+#define BOOST_TEST_MODULE "test_batched_pair_kernel"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/forcefield/global/BatchedPairKernel.hpp>
+#include <mjolnir/core/NeighborList.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/util/logger.hpp>
+#include <random>
+
+using traits_type      = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+using real_type        = typename traits_type::real_type;
+using coordinate_type  = typename traits_type::coordinate_type;
+using boundary_type    = typename traits_type::boundary_type;
+using system_type      = mjolnir::System<traits_type>;
+using molecule_id_type = mjolnir::Topology::molecule_id_type;
+using group_id_type    = mjolnir::Topology::group_id_type;
+
+// periodic systems in this test read positions from the packed array.
+using periodic_traits_type = mjolnir::SimulatorTraits<double, mjolnir::CuboidalPeriodicBoundary>;
+namespace mjolnir
+{
+template<>
+struct uses_packed_coordinates<periodic_traits_type> : std::true_type {};
+} // mjolnir
+
+// compare kernel with the reference implementation in the potential
+template<typename potentialT>
+void check_kernel(const potentialT& pot,
+        const typename potentialT::pair_parameter_type& param,
+        const real_type x_min, const real_type x_max)
+{
+    constexpr std::size_t N = 10000;
+    const mjolnir::BatchedPairKernel<potentialT> kernel(pot);
+
+    const real_type dx = (x_max - x_min) / N;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const real_type x = x_min + i * dx;
+        const real_type f_ref = pot.derivative(x, param) / x;
+        const real_type e_ref = pot.potential (x, param);
+
+        BOOST_TEST(kernel.force (x * x, param) == f_ref,
+                   boost::test_tools::tolerance(1e-8));
+        BOOST_TEST(kernel.energy(x * x, param) == e_ref,
+                   boost::test_tools::tolerance(1e-8));
+    }
+    return;
+}
+
+BOOST_AUTO_TEST_CASE(BatchedPairKernel_ExcludedVolume)
+{
+    mjolnir::LoggerManager::set_default_logger("test_batched_pair_kernel.log");
+    using potential_type = mjolnir::ExcludedVolumePotential<traits_type>;
+
+    const real_type sigma   = 3.0;
+    const real_type epsilon = 1.0;
+    potential_type exv{
+        epsilon, potential_type::default_cutoff(),
+        {{0, sigma}, {1, sigma}}, {},
+        mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+        mjolnir::IgnoreGroup   <group_id_type   >({})
+    };
+    const auto param = exv.prepare_params(0, 1);
+    // it also checks outside the cutoff
+    check_kernel(exv, param, 0.8 * param, 1.2 * exv.cutoff_ratio() * param);
+}
+
+BOOST_AUTO_TEST_CASE(BatchedPairKernel_LennardJones)
+{
+    mjolnir::LoggerManager::set_default_logger("test_batched_pair_kernel.log");
+    using potential_type = mjolnir::LennardJonesPotential<traits_type>;
+
+    const potential_type::parameter_type param{3.0, 1.0};
+    potential_type lj{
+        potential_type::default_cutoff(),
+        {{0, param}, {1, param}}, {},
+        mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+        mjolnir::IgnoreGroup   <group_id_type   >({})
+    };
+    const auto p = lj.prepare_params(0, 1);
+    check_kernel(lj, p, 0.8 * p.first, 1.2 * lj.cutoff_ratio() * p.first);
+}
+
+BOOST_AUTO_TEST_CASE(BatchedPairKernel_DebyeHuckel)
+{
+    mjolnir::LoggerManager::set_default_logger("test_batched_pair_kernel.log");
+    using potential_type = mjolnir::DebyeHuckelPotential<traits_type>;
+
+    system_type sys(0, boundary_type{});
+    sys.attribute("temperature")    = 300.0;
+    sys.attribute("ionic_strength") =   0.1;
+
+    mjolnir::Topology top(0);
+    top.construct_molecules();
+
+    potential_type dh(potential_type::default_cutoff(),
+        {{0u, 1.0}, {1u, -1.0}}, {},
+        mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+        mjolnir::IgnoreGroup   <group_id_type   >({}));
+    dh.initialize(sys, top);
+
+    const auto param = dh.prepare_params(0, 1);
+    check_kernel(dh, param, 0.5 * dh.debye_length(), 1.2 * dh.max_cutoff_length());
+}
+
+// compare the batched loop with a simple loop, including the remainder lanes.
+BOOST_AUTO_TEST_CASE(BatchedPairKernel_loop)
+{
+    mjolnir::LoggerManager::set_default_logger("test_batched_pair_kernel.log");
+    using potential_type = mjolnir::ExcludedVolumePotential<traits_type>;
+    using neighbor_type  = mjolnir::neighbor_element<real_type>;
+
+    constexpr std::size_t N = 40;
+    std::vector<std::pair<std::size_t, real_type>> params;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        params.emplace_back(i, 1.0);
+    }
+    potential_type exv{1.0, potential_type::default_cutoff(), params, {},
+        mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+        mjolnir::IgnoreGroup   <group_id_type   >({})
+    };
+    const mjolnir::BatchedPairKernel<potential_type> kernel(exv);
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(-3.0, 3.0);
+
+    system_type sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.position(i) = coordinate_type(uni(mt), uni(mt), uni(mt));
+        sys.force(i)    = coordinate_type(0.0, 0.0, 0.0);
+    }
+    sys.position(0) = coordinate_type(0.0, 0.0, 0.0);
+
+    // check all the number of partners including remainders
+    for(std::size_t n=0; n<N; ++n)
+    {
+        std::vector<neighbor_type> partners;
+        for(std::size_t j=1; j<=n; ++j)
+        {
+            partners.emplace_back(j, exv.prepare_params(0, j));
+        }
+
+        std::vector<coordinate_type> forces(N, coordinate_type(0.0, 0.0, 0.0));
+        mjolnir::math::Matrix<real_type, 3, 3> virial(0,0,0, 0,0,0, 0,0,0);
+        const real_type energy = mjolnir::calc_batched_pair_force<true>(
+            kernel, sys, 0, partners,
+            [&forces](const std::size_t j) -> coordinate_type& {
+                return forces.at(j);
+            }, forces.at(0), virial);
+
+        std::vector<coordinate_type> forces_ref(N, coordinate_type(0.0, 0.0, 0.0));
+        mjolnir::math::Matrix<real_type, 3, 3> virial_ref(0,0,0, 0,0,0, 0,0,0);
+        real_type energy_ref = 0.0;
+        for(const auto& ptnr : partners)
+        {
+            const auto rij = sys.adjust_direction(sys.position(0),
+                                                  sys.position(ptnr.index));
+            const real_type l = mjolnir::math::length(rij);
+            energy_ref += exv.potential(l, ptnr.parameter());
+            const coordinate_type f =
+                rij * (exv.derivative(l, ptnr.parameter()) / l);
+            forces_ref.at(0)          += f;
+            forces_ref.at(ptnr.index) -= f;
+            virial_ref += mjolnir::math::tensor_product(rij, -f);
+        }
+
+        BOOST_TEST(energy == energy_ref, boost::test_tools::tolerance(1e-8));
+        for(std::size_t i=0; i<N; ++i)
+        {
+            BOOST_TEST(mjolnir::math::X(forces.at(i)) == mjolnir::math::X(forces_ref.at(i)),
+                       boost::test_tools::tolerance(1e-8));
+            BOOST_TEST(mjolnir::math::Y(forces.at(i)) == mjolnir::math::Y(forces_ref.at(i)),
+                       boost::test_tools::tolerance(1e-8));
+            BOOST_TEST(mjolnir::math::Z(forces.at(i)) == mjolnir::math::Z(forces_ref.at(i)),
+                       boost::test_tools::tolerance(1e-8));
+        }
+        for(std::size_t i=0; i<9; ++i)
+        {
+            BOOST_TEST(virial[i] == virial_ref[i], boost::test_tools::tolerance(1e-8));
+        }
+    }
+}
+
+// the kernel evaluated in float with double accumulation (precision = "mixed")
+// should agree with the double reference within the float precision, even if
+// the particles are far from the origin.
+BOOST_AUTO_TEST_CASE(BatchedPairKernel_mixed_precision)
+{
+    mjolnir::LoggerManager::set_default_logger("test_batched_pair_kernel.log");
+    using potential_type = mjolnir::LennardJonesPotential<traits_type>;
+    using neighbor_type  = mjolnir::neighbor_element<std::pair<real_type, real_type>>;
+
+    constexpr std::size_t N = 40;
+    std::vector<std::pair<std::size_t, potential_type::parameter_type>> params;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        params.emplace_back(i, potential_type::parameter_type(1.0, 1.0));
+    }
+    potential_type lj{potential_type::default_cutoff(), params, {},
+        mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+        mjolnir::IgnoreGroup   <group_id_type   >({})
+    };
+    const mjolnir::BatchedPairKernel<potential_type, float> kernel(lj);
+    static_assert(std::is_same<decltype(kernel)::real_type, float>::value, "");
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(-2.0, 2.0);
+
+    // the absolute coordinates have only 2-3 significant digits in float.
+    const coordinate_type origin(1.0e4, -1.0e4, 1.0e4);
+    system_type sys(N, boundary_type{});
+    sys.position(0) = origin;
+    for(std::size_t i=1; i<N; ++i)
+    {
+        coordinate_type dr(0.0, 0.0, 0.0);
+        do
+        {
+            dr = coordinate_type(uni(mt), uni(mt), uni(mt));
+        }
+        while(mjolnir::math::length(dr) < 0.9);
+        sys.position(i) = origin + dr;
+    }
+
+    std::vector<neighbor_type> partners;
+    for(std::size_t j=1; j<N; ++j)
+    {
+        partners.emplace_back(j, lj.prepare_params(0, j));
+    }
+
+    std::vector<coordinate_type> forces(N, coordinate_type(0.0, 0.0, 0.0));
+    mjolnir::math::Matrix<real_type, 3, 3> virial(0,0,0, 0,0,0, 0,0,0);
+    const real_type energy = mjolnir::calc_batched_pair_force<true>(
+        kernel, sys, 0, partners,
+        [&forces](const std::size_t j) -> coordinate_type& {
+            return forces.at(j);
+        }, forces.at(0), virial);
+
+    std::vector<coordinate_type> forces_ref(N, coordinate_type(0.0, 0.0, 0.0));
+    real_type energy_ref = 0.0;
+    real_type energy_abs = 0.0;
+    real_type force_abs  = 0.0;
+    for(const auto& ptnr : partners)
+    {
+        const auto rij = sys.adjust_direction(sys.position(0),
+                                              sys.position(ptnr.index));
+        const real_type l = mjolnir::math::length(rij);
+        const real_type e = lj.potential(l, ptnr.parameter());
+        energy_ref += e;
+        energy_abs += std::abs(e);
+        const coordinate_type f = rij * (lj.derivative(l, ptnr.parameter()) / l);
+        forces_ref.at(0)          += f;
+        forces_ref.at(ptnr.index) -= f;
+        force_abs += mjolnir::math::length(f);
+    }
+
+    BOOST_TEST(std::abs(energy - energy_ref) <= 1e-5 * energy_abs);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const real_type tol = 1e-5 * ((i == 0) ? force_abs :
+            mjolnir::math::length(forces_ref.at(i))) + 1e-12;
+        BOOST_TEST(std::abs(mjolnir::math::X(forces.at(i)) -
+                            mjolnir::math::X(forces_ref.at(i))) <= tol);
+        BOOST_TEST(std::abs(mjolnir::math::Y(forces.at(i)) -
+                            mjolnir::math::Y(forces_ref.at(i))) <= tol);
+        BOOST_TEST(std::abs(mjolnir::math::Z(forces.at(i)) -
+                            mjolnir::math::Z(forces_ref.at(i))) <= tol);
+    }
+}
+
+// the packed positions and the minimum image convention applied to the lanes
+// give the same result as the reference.
+BOOST_AUTO_TEST_CASE(BatchedPairKernel_packed_periodic)
+{
+    mjolnir::LoggerManager::set_default_logger("test_batched_pair_kernel.log");
+    using periodic_system_type   = mjolnir::System<periodic_traits_type>;
+    using periodic_boundary_type = typename periodic_traits_type::boundary_type;
+    using potential_type = mjolnir::LennardJonesPotential<periodic_traits_type>;
+    using neighbor_type  = mjolnir::neighbor_element<std::pair<real_type, real_type>>;
+    static_assert(periodic_system_type::packed_coordinates_enabled, "");
+
+    constexpr std::size_t N = 40;
+    std::vector<std::pair<std::size_t, potential_type::parameter_type>> params;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        params.emplace_back(i, potential_type::parameter_type(1.0, 1.0));
+    }
+    potential_type lj{potential_type::default_cutoff(), params, {},
+        mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+        mjolnir::IgnoreGroup   <group_id_type   >({})
+    };
+    const mjolnir::BatchedPairKernel<potential_type> kernel(lj);
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(0.0, 6.0);
+
+    // particle 0 is at the corner, so most of the partners are across the
+    // boundary.
+    periodic_system_type sys(N, periodic_boundary_type(
+        coordinate_type(0.0, 0.0, 0.0), coordinate_type(6.0, 6.0, 6.0)));
+    sys.position(0) = coordinate_type(0.1, 5.9, 0.1);
+    for(std::size_t i=1; i<N; ++i)
+    {
+        do
+        {
+            sys.position(i) = coordinate_type(uni(mt), uni(mt), uni(mt));
+        }
+        while(mjolnir::math::length(sys.adjust_direction(
+                sys.position(0), sys.position(i))) < 0.9);
+    }
+    sys.preprocess_forces();
+
+    std::vector<neighbor_type> partners;
+    for(std::size_t j=1; j<N; ++j)
+    {
+        partners.emplace_back(j, lj.prepare_params(0, j));
+    }
+
+    std::vector<coordinate_type> forces(N, coordinate_type(0.0, 0.0, 0.0));
+    mjolnir::math::Matrix<real_type, 3, 3> virial(0,0,0, 0,0,0, 0,0,0);
+    const real_type energy = mjolnir::calc_batched_pair_force<true>(
+        kernel, sys, 0, partners,
+        [&forces](const std::size_t j) -> coordinate_type& {
+            return forces.at(j);
+        }, forces.at(0), virial);
+
+    std::vector<coordinate_type> forces_ref(N, coordinate_type(0.0, 0.0, 0.0));
+    mjolnir::math::Matrix<real_type, 3, 3> virial_ref(0,0,0, 0,0,0, 0,0,0);
+    real_type energy_ref = 0.0;
+    for(const auto& ptnr : partners)
+    {
+        const auto rij = sys.adjust_direction(sys.position(0),
+                                              sys.position(ptnr.index));
+        const real_type l = mjolnir::math::length(rij);
+        energy_ref += lj.potential(l, ptnr.parameter());
+        const coordinate_type f = rij * (lj.derivative(l, ptnr.parameter()) / l);
+        forces_ref.at(0)          += f;
+        forces_ref.at(ptnr.index) -= f;
+        virial_ref += mjolnir::math::tensor_product(rij, -f);
+    }
+
+    BOOST_TEST(energy == energy_ref, boost::test_tools::tolerance(1e-8));
+    for(std::size_t i=0; i<N; ++i)
+    {
+        BOOST_TEST(mjolnir::math::X(forces.at(i)) == mjolnir::math::X(forces_ref.at(i)),
+                   boost::test_tools::tolerance(1e-8));
+        BOOST_TEST(mjolnir::math::Y(forces.at(i)) == mjolnir::math::Y(forces_ref.at(i)),
+                   boost::test_tools::tolerance(1e-8));
+        BOOST_TEST(mjolnir::math::Z(forces.at(i)) == mjolnir::math::Z(forces_ref.at(i)),
+                   boost::test_tools::tolerance(1e-8));
+    }
+    for(std::size_t i=0; i<9; ++i)
+    {
+        BOOST_TEST(virial[i] == virial_ref[i], boost::test_tools::tolerance(1e-8));
+    }
+}
@@ -0,0 +1,144 @@
+#define BOOST_TEST_MODULE "test_buffered_file_writer"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/util/buffered_file_writer.hpp>
+#include <fstream>
+#include <iterator>
+#include <cstdint>
+
+namespace
+{
+std::string read_file(const std::string& fname)
+{
+    std::ifstream ifs(fname, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs),
+                       std::istreambuf_iterator<char>());
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(BufferedFileWriter_flush_interval)
+{
+    const std::string fname("test_buffered_file_writer.dat");
+    {
+        mjolnir::BufferedFileWriter writer(fname, /*flush = */3);
+        BOOST_TEST(writer.is_open());
+
+        writer.write(std::string("frame1\n"));
+        BOOST_TEST(!writer.end_frame());
+        writer.write(std::string("frame2\n"));
+        BOOST_TEST(!writer.end_frame());
+        BOOST_TEST(read_file(fname).empty());
+
+        writer.write(std::string("frame3\n"));
+        BOOST_TEST(writer.end_frame());
+        BOOST_TEST(read_file(fname) == "frame1\nframe2\nframe3\n");
+
+        writer.write(std::string("frame4\n"));
+        BOOST_TEST(!writer.end_frame());
+        writer.flush();
+        BOOST_TEST(read_file(fname) == "frame1\nframe2\nframe3\nframe4\n");
+
+        // it should be written at the destruction
+        writer.write(std::string("frame5\n"));
+    }
+    BOOST_TEST(read_file(fname) == "frame1\nframe2\nframe3\nframe4\nframe5\n");
+
+    // the existing contents are discarded
+    {
+        mjolnir::BufferedFileWriter writer(fname, 1, 1);
+        writer.write(std::string("new\n"));
+        BOOST_TEST(writer.end_frame());
+        BOOST_TEST(read_file(fname) == "new\n");
+    }
+    BOOST_TEST(read_file(fname) == "new\n");
+}
+
+BOOST_AUTO_TEST_CASE(BufferedFileWriter_overwrite)
+{
+    const std::string fname("test_buffered_file_writer.bin");
+    {
+        mjolnir::BufferedFileWriter writer(fname, 100);
+        writer.write_as_bytes(std::int32_t(0)); // header
+        for(std::int32_t i=1; i<=10; ++i)
+        {
+            writer.write_as_bytes(i);
+            writer.end_frame();
+        }
+        // buffered frames are written before updating the header
+        writer.overwrite_as_bytes(0, std::int32_t(10));
+        writer.write_as_bytes(std::int32_t(11));
+    }
+    const auto content = read_file(fname);
+    BOOST_TEST_REQUIRE(content.size() == 12 * sizeof(std::int32_t));
+    for(std::size_t i=0; i<12; ++i)
+    {
+        std::int32_t v;
+        std::copy(content.begin() + i * sizeof(v),
+                  content.begin() + (i + 1) * sizeof(v),
+                  reinterpret_cast<char*>(&v));
+        BOOST_TEST(v == static_cast<std::int32_t>(i == 0 ? 10 : i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BufferedFileWriter_patch)
+{
+    const std::string fname("test_buffered_file_writer_patch.bin");
+    const auto header = [&fname]() -> std::int32_t {
+        const auto content = read_file(fname);
+        std::int32_t v = -1;
+        if(content.size() >= sizeof(v))
+        {
+            std::copy(content.begin(), content.begin() + sizeof(v),
+                      reinterpret_cast<char*>(&v));
+        }
+        return v;
+    };
+    {
+        // flush every frame, fsync every 3 frames
+        mjolnir::BufferedFileWriter writer(fname, 1, 3);
+        writer.write_as_bytes(std::int32_t(0)); // header
+        for(std::int32_t i=1; i<=4; ++i)
+        {
+            writer.write_as_bytes(i);
+            writer.patch_as_bytes(0, i);
+            BOOST_TEST(writer.end_frame());
+            BOOST_TEST(read_file(fname).size() == (i + 1) * sizeof(std::int32_t));
+
+            // the patch is applied only at fsync
+            BOOST_TEST(header() == (i < 3 ? 0 : 3));
+        }
+        writer.apply_patch();
+        BOOST_TEST(header() == 4);
+
+        writer.write_as_bytes(std::int32_t(5));
+        writer.patch_as_bytes(0, std::int32_t(5));
+        BOOST_TEST(writer.end_frame());
+        BOOST_TEST(header() == 4);
+    }
+    // and when the file is closed
+    BOOST_TEST(header() == 5);
+    BOOST_TEST(read_file(fname).size() == 6 * sizeof(std::int32_t));
+}
+
+BOOST_AUTO_TEST_CASE(BufferedFileWriter_move)
+{
+    const std::string fname("test_buffered_file_writer_move.dat");
+    {
+        mjolnir::BufferedFileWriter writer(fname, 10);
+        writer.write(std::string("abc"));
+
+        mjolnir::BufferedFileWriter moved(std::move(writer));
+        BOOST_TEST(!writer.is_open());
+        BOOST_TEST( moved.is_open());
+        moved.write(std::string("def"));
+    }
+    BOOST_TEST(read_file(fname) == "abcdef");
+
+    BOOST_CHECK_THROW(mjolnir::BufferedFileWriter("./no/such/dir/file.dat"),
+                      std::runtime_error);
+}
@@ -0,0 +1,202 @@
+#define BOOST_TEST_MODULE "test_cluster_pair_list"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/core/ClusterPairList.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/VerletList.hpp>
+#include <mjolnir/forcefield/global/GlobalPairLennardJonesInteraction.hpp>
+#include <mjolnir/util/make_unique.hpp>
+#include <mjolnir/util/logger.hpp>
+#include <map>
+#include <random>
+
+using traits_type      = mjolnir::SimulatorTraits<double, mjolnir::CuboidalPeriodicBoundary>;
+using real_type        = typename traits_type::real_type;
+using coordinate_type  = typename traits_type::coordinate_type;
+using boundary_type    = typename traits_type::boundary_type;
+using system_type      = mjolnir::System<traits_type>;
+using topology_type    = mjolnir::Topology;
+using potential_type   = mjolnir::LennardJonesPotential<traits_type>;
+using parameter_type   = typename potential_type::parameter_type;
+using partition_type   = mjolnir::SpatialPartition<traits_type, potential_type>;
+using interaction_type = mjolnir::GlobalPairInteraction<traits_type, potential_type>;
+
+// 6x6x6 particles on a jittered lattice. Particles are connected into chains
+// of 6 particles and the bonded pairs are excluded.
+constexpr std::size_t L = 6;
+constexpr std::size_t N = L * L * L;
+constexpr real_type   a = 1.2;
+
+system_type make_system()
+{
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(-0.1, 0.1);
+
+    system_type sys(N, boundary_type(coordinate_type(0.0, 0.0, 0.0),
+                                     coordinate_type(L * a, L * a, L * a)));
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const auto x = i % L;
+        const auto y = (i / L) % L;
+        const auto z = i / (L * L);
+        sys.mass(i)     = 1.0;
+        sys.rmass(i)    = 1.0;
+        sys.position(i) = sys.adjust_position(coordinate_type(
+            (x + 0.5) * a + uni(mt), (y + 0.5) * a + uni(mt), (z + 0.5) * a + uni(mt)));
+        sys.velocity(i) = coordinate_type(0.0, 0.0, 0.0);
+        sys.force(i)    = coordinate_type(0.0, 0.0, 0.0);
+        sys.name(i)     = "X";
+        sys.group(i)    = "NONE";
+    }
+    return sys;
+}
+
+topology_type make_topology()
+{
+    topology_type topol(N);
+    for(std::size_t i=0; i+1<N; ++i)
+    {
+        if((i+1) % L != 0)
+        {
+            topol.add_connection(i, i+1, "bond");
+        }
+    }
+    topol.construct_molecules();
+    return topol;
+}
+
+potential_type make_potential()
+{
+    std::mt19937 mt(987654321);
+    std::uniform_real_distribution<real_type> uni(0.9, 1.1);
+
+    std::vector<std::pair<std::size_t, parameter_type>> params;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        params.emplace_back(i, parameter_type(uni(mt), uni(mt)));
+    }
+    return potential_type(potential_type::default_cutoff(), params,
+        {{"bond", 1}}, typename potential_type::ignore_molecule_type("Nothing"),
+                       typename potential_type::ignore_group_type   ({}));
+}
+
+// every pair in the neighbor list appears exactly once in the blocks.
+BOOST_AUTO_TEST_CASE(ClusterPairList_covers_NeighborList)
+{
+    mjolnir::LoggerManager::set_default_logger("test_cluster_pair_list.log");
+
+    auto sys   = make_system();
+    auto topol = make_topology();
+    auto pot   = make_potential();
+    pot.initialize(sys, topol);
+
+    partition_type part(mjolnir::make_unique<
+        mjolnir::VerletList<traits_type, potential_type>>(0.25), false, true);
+    part.initialize(sys, pot);
+    BOOST_TEST_REQUIRE(part.has_cluster_pairs());
+
+    const auto& clusters = part.cluster_pairs();
+    constexpr std::size_t M = partition_type::cluster_size;
+    BOOST_TEST(clusters.num_clusters() == N / M);
+
+    // pair -> number of appearance
+    std::map<std::pair<std::size_t, std::size_t>, std::size_t> found;
+    for(std::size_t I=0; I<clusters.num_clusters(); ++I)
+    {
+        const auto* is = clusters.members(I);
+        for(const auto& blk : clusters.blocks(I))
+        {
+            const auto* js = clusters.members(blk.j_cluster);
+            const auto* ps = clusters.parameters(blk);
+            for(std::size_t k=0; k<M*M; ++k)
+            {
+                if(((blk.mask >> k) & 1u) == 0) {continue;}
+                const std::size_t i = is[k / M];
+                const std::size_t j = js[k % M];
+                BOOST_TEST(ps[k].first  == pot.prepare_params(i, j).first);
+                BOOST_TEST(ps[k].second == pot.prepare_params(i, j).second);
+                found[std::make_pair(i, j)] += 1;
+            }
+        }
+    }
+
+    std::size_t num_pairs = 0;
+    for(const auto i : pot.leading_participants())
+    {
+        for(const auto& ptnr : part.partners(i))
+        {
+            num_pairs += 1;
+            BOOST_TEST(found[std::make_pair(i, std::size_t(ptnr.index))] == 1u);
+            // bonded pairs are excluded
+            BOOST_TEST(!(ptnr.index == i + 1 && (i+1) % L != 0));
+        }
+    }
+    BOOST_TEST(found.size() == num_pairs);
+}
+
+// forces, virial and energy are the same as those calculated with NeighborList.
+BOOST_AUTO_TEST_CASE(ClusterPairList_GlobalPairInteraction)
+{
+    mjolnir::LoggerManager::set_default_logger("test_cluster_pair_list.log");
+
+    auto sys_ref = make_system();
+    auto sys     = make_system();
+    auto topol   = make_topology();
+
+    interaction_type interaction_ref(make_potential(), partition_type(
+        mjolnir::make_unique<mjolnir::VerletList<traits_type, potential_type>>(0.25)));
+    interaction_type interaction(make_potential(), partition_type(
+        mjolnir::make_unique<mjolnir::VerletList<traits_type, potential_type>>(0.25),
+        false, true));
+
+    interaction_ref.initialize(sys_ref, topol);
+    interaction    .initialize(sys,     topol);
+
+    for(int pass=0; pass<2; ++pass)
+    {
+        for(std::size_t i=0; i<N; ++i)
+        {
+            sys_ref.force(i) = coordinate_type(0.0, 0.0, 0.0);
+            sys    .force(i) = coordinate_type(0.0, 0.0, 0.0);
+        }
+        sys_ref.virial() = typename system_type::matrix33_type(0,0,0, 0,0,0, 0,0,0);
+        sys    .virial() = typename system_type::matrix33_type(0,0,0, 0,0,0, 0,0,0);
+
+        real_type energy_ref = 0.0, energy = 0.0;
+        if(pass == 0)
+        {
+            interaction_ref.calc_force(sys_ref);
+            interaction    .calc_force(sys);
+        }
+        else
+        {
+            energy_ref = interaction_ref.calc_force_and_energy(sys_ref);
+            energy     = interaction    .calc_force_and_energy(sys);
+            BOOST_TEST(energy == energy_ref, boost::test_tools::tolerance(1e-8));
+            BOOST_TEST(energy == interaction_ref.calc_energy(sys_ref),
+                       boost::test_tools::tolerance(1e-8));
+        }
+
+        real_type fmax = 0.0;
+        for(std::size_t i=0; i<N; ++i)
+        {
+            fmax = std::max(fmax, mjolnir::math::length(sys_ref.force(i)));
+        }
+        for(std::size_t i=0; i<N; ++i)
+        {
+            const auto df = sys.force(i) - sys_ref.force(i);
+            BOOST_TEST(mjolnir::math::length(df) <= 1e-10 * fmax);
+        }
+        for(std::size_t k=0; k<9; ++k)
+        {
+            BOOST_TEST(sys.virial()[k] == sys_ref.virial()[k],
+                       boost::test_tools::tolerance(1e-8));
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#define BOOST_TEST_MODULE "test_displacement_tracker"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/util/empty.hpp>
+#include <mjolnir/util/logger.hpp>
+#include <mjolnir/util/range.hpp>
+#include <mjolnir/util/make_unique.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/DisplacementTracker.hpp>
+#include <mjolnir/core/VerletList.hpp>
+#include <mjolnir/core/System.hpp>
+#include <mjolnir/core/Topology.hpp>
+#include <numeric>
+
+template<typename T>
+struct dummy_potential
+{
+    using real_type      = T;
+    using parameter_type = mjolnir::empty_t;
+    using pair_parameter_type = parameter_type;
+
+    using topology_type        = mjolnir::Topology;
+    using molecule_id_type     = typename topology_type::molecule_id_type;
+    using connection_kind_type = typename topology_type::connection_kind_type;
+
+    explicit dummy_potential(const real_type cutoff,
+                             const std::vector<std::size_t>& participants)
+        : cutoff_(cutoff), participants_(participants)
+    {}
+
+    real_type max_cutoff_length() const noexcept {return this->cutoff_;}
+
+    pair_parameter_type prepare_params(std::size_t, std::size_t) const noexcept
+    {
+        return pair_parameter_type{};
+    }
+
+    bool is_ignored_molecule(std::size_t, std::size_t) const {return false;}
+    bool is_ignored_group   (std::string, std::string) const {return false;}
+
+    std::vector<std::pair<connection_kind_type, std::size_t>> ignore_within() const
+    {
+        return std::vector<std::pair<connection_kind_type, std::size_t>>{};
+    }
+
+    std::vector<std::size_t> const& participants() const noexcept
+    {
+        return this->participants_;
+    }
+    mjolnir::range<typename std::vector<std::size_t>::const_iterator>
+    leading_participants() const noexcept
+    {
+        return mjolnir::make_range(participants_.begin(), std::prev(participants_.end()));
+    }
+    mjolnir::range<typename std::vector<std::size_t>::const_iterator>
+    possible_partners_of(const std::size_t participant_idx,
+                         const std::size_t /*particle_idx*/) const noexcept
+    {
+        return mjolnir::make_range(participants_.begin() + participant_idx + 1,
+                                   participants_.end());
+    }
+    bool has_interaction(const std::size_t i, const std::size_t j) const noexcept
+    {
+        return (i < j);
+    }
+
+    std::string name() const {return "dummy potential";}
+
+    real_type cutoff_;
+    std::vector<std::size_t> participants_;
+};
+
+BOOST_AUTO_TEST_CASE(test_DisplacementTracker_PeriodicBoundary)
+{
+    mjolnir::LoggerManager::set_default_logger("test_displacement_tracker.log");
+    using traits_type     = mjolnir::SimulatorTraits<double, mjolnir::CuboidalPeriodicBoundary>;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using boundary_type   = typename traits_type::boundary_type;
+
+    constexpr std::size_t N = 10;
+    mjolnir::System<traits_type> sys(N, boundary_type(
+        coordinate_type(0.0, 0.0, 0.0), coordinate_type(10.0, 10.0, 10.0)));
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.position(i) = coordinate_type(1.0 * i + 0.5, 5.0, 5.0);
+    }
+
+    std::vector<std::size_t> participants(N);
+    std::iota(participants.begin(), participants.end(), 0);
+
+    mjolnir::DisplacementTracker<traits_type> tracker;
+    tracker.record(sys, participants);
+    BOOST_TEST(tracker.largest_displacements(sys) == 0.0);
+
+    // crosses the boundary. the displacement is 0.8, not 9.2.
+    sys.position(0) = sys.adjust_position(sys.position(0) + coordinate_type(-0.8, 0.0, 0.0));
+    sys.position(3) = sys.position(3) + coordinate_type(0.0, 0.4, 0.0);
+    sys.position(7) = sys.position(7) + coordinate_type(0.0, 0.0, 0.1);
+    BOOST_TEST(tracker.largest_displacements(sys) == 1.2,
+               boost::test_tools::tolerance(1e-8));
+}
+
+BOOST_AUTO_TEST_CASE(test_SpatialPartition_rebuild_by_displacement)
+{
+    mjolnir::LoggerManager::set_default_logger("test_displacement_tracker.log");
+    using traits_type     = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using potential_type  = dummy_potential<real_type>;
+
+    constexpr std::size_t N = 8;
+    constexpr double cutoff = 2.0;
+    constexpr double margin = 0.25; // skin = 0.5
+
+    std::vector<std::size_t> participants(N);
+    std::iota(participants.begin(), participants.end(), 0);
+    potential_type pot(cutoff, participants);
+
+    mjolnir::System<traits_type> sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.at(i).mass     = 1.0;
+        sys.at(i).position = coordinate_type(1.5 * i, 0.0, 0.0);
+    }
+
+    mjolnir::SpatialPartition<traits_type, potential_type> vlist(
+        mjolnir::make_unique<mjolnir::VerletList<traits_type, potential_type>>(margin));
+    vlist.initialize(sys, pot);
+    BOOST_TEST(vlist.skin() == 0.5, boost::test_tools::tolerance(1e-8));
+
+    // a particle goes back and forth. The sum of the displacements in each
+    // step exceeds the skin, but the actual displacement does not.
+    for(std::size_t step=0; step<10; ++step)
+    {
+        const double dx = (step % 2 == 0) ? 0.2 : -0.2;
+        sys.position(3) += coordinate_type(dx, 0.0, 0.0);
+        BOOST_TEST(!vlist.reduce_margin(2 * 0.2, sys, pot));
+    }
+
+    // two particles approach each other by 0.3 + 0.3 > 0.5.
+    sys.position(4) += coordinate_type(-0.3, 0.0, 0.0);
+    BOOST_TEST(!vlist.reduce_margin(2 * 0.3, sys, pot));
+    sys.position(5) += coordinate_type( 0.0, 0.3, 0.0);
+    BOOST_TEST( vlist.reduce_margin(2 * 0.3, sys, pot));
+
+    // the list is re-constructed, so the references are updated.
+    BOOST_TEST(!vlist.reduce_margin(2 * 0.3, sys, pot));
+    BOOST_TEST(vlist.skin() == 0.5, boost::test_tools::tolerance(1e-8));
+}
@@ -666,3 +666,70 @@ BOOST_AUTO_TEST_CASE(ExclusionList_gruop_dependent)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(ExclusionList_many_molecules)
+{
+    mjolnir::LoggerManager::set_default_logger("test_ExclusionList");
+    using traits_type          = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using boundary_type        = traits_type::boundary_type;
+    using topology_type        = mjolnir::Topology;
+    using molecule_id_type     = topology_type::molecule_id_type;
+    using group_id_type        = topology_type::group_id_type;
+    using ignore_molecule_type = mjolnir::IgnoreMolecule<molecule_id_type>;
+    using ignore_group_type    = mjolnir::IgnoreGroup   <group_id_type>;
+
+    // 50k dimers. It should not construct a table of Nmolecules x Nmolecules.
+    constexpr std::size_t N = 100000;
+
+    mjolnir::System<traits_type> sys(N, boundary_type{});
+    topology_type topol(N);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.name(i)  = "X";
+        sys.group(i) = (i < N / 2) ? "lipid1" : "lipid2";
+    }
+    for(std::size_t i=0; i<N; i+=2)
+    {
+        topol.add_connection(i, i+1, "bond");
+    }
+    topol.construct_molecules();
+    BOOST_TEST_REQUIRE(topol.number_of_molecules() == N / 2);
+
+    for(const auto& rule : {"Nothing", "Self", "Others"})
+    {
+        mjolnir::ExclusionList<traits_type> exl({},
+                ignore_molecule_type(rule), ignore_group_type({}));
+        exl.make(sys, topol);
+
+        for(const std::size_t i : {std::size_t(0), std::size_t(1), N/2, N-1})
+        {
+            for(const std::size_t j : {std::size_t(0), std::size_t(1),
+                                       std::size_t(2), N/2, N-2, N-1})
+            {
+                const bool same_mol = (i / 2 == j / 2);
+                const bool ignored  = (std::string(rule) == "Self")   ?  same_mol :
+                                      (std::string(rule) == "Others") ? !same_mol : false;
+                BOOST_TEST(exl.is_excluded(i, j) == (i == j || ignored));
+            }
+        }
+    }
+
+    // groups are resolved into ids; inter-group pairs are ignored
+    {
+        mjolnir::ExclusionList<traits_type> exl({},
+                ignore_molecule_type("Nothing"), ignore_group_type({
+                    {"lipid1", {"lipid2"}}, {"lipid2", {"lipid1"}}
+                }));
+        exl.make(sys, topol);
+
+        BOOST_TEST( exl.is_excluded(0,     N-1));
+        BOOST_TEST( exl.is_excluded(N-1,   0));
+        BOOST_TEST(!exl.is_excluded(0,     N/2-1));
+        BOOST_TEST(!exl.is_excluded(N/2,   N-1));
+
+        // calling make twice gives the same result
+        exl.make(sys, topol);
+        BOOST_TEST( exl.is_excluded(0,     N-1));
+        BOOST_TEST(!exl.is_excluded(0,     N/2-1));
+    }
+}
@@ -0,0 +1,96 @@
+#define BOOST_TEST_MODULE "test_fire_simulator"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/ForceField.hpp>
+#include <mjolnir/core/EnergyObserver.hpp>
+#include <mjolnir/core/FIRESimulator.hpp>
+#include <mjolnir/forcefield/local/HarmonicPotential.hpp>
+#include <mjolnir/forcefield/local/BondLengthInteraction.hpp>
+#include <mjolnir/util/make_unique.hpp>
+
+#include <random>
+
+BOOST_AUTO_TEST_CASE(FIRE_harmonic_chain)
+{
+    mjolnir::LoggerManager::set_default_logger("test_fire_simulator.log");
+
+    using traits_type      = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using real_type        = typename traits_type::real_type;
+    using coordinate_type  = typename traits_type::coordinate_type;
+    using boundary_type    = typename traits_type::boundary_type;
+    using system_type      = mjolnir::System<traits_type>;
+    using potential_type   = mjolnir::HarmonicPotential<real_type>;
+    using bond_type        = mjolnir::BondLengthInteraction<traits_type, potential_type>;
+    using simulator_type   = mjolnir::FIRESimulator<traits_type>;
+
+    constexpr std::size_t N = 100;
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(-0.3, 0.3);
+
+    system_type sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.mass(i)     = 1.0 + (i % 3); // heterogeneous mass
+        sys.rmass(i)    = 1.0 / sys.mass(i);
+        sys.position(i) = mjolnir::math::make_coordinate<coordinate_type>(
+                1.0 * i + uni(mt), uni(mt), uni(mt));
+        sys.velocity(i) = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys.force(i)    = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys.name(i)     = "X";
+        sys.group(i)    = "NONE";
+    }
+
+    mjolnir::LocalForceField<traits_type> loc;
+    std::vector<std::pair<std::array<std::size_t, 2>, potential_type>> bonds;
+    for(std::size_t i=0; i+1<N; ++i)
+    {
+        bonds.emplace_back(std::array<std::size_t, 2>{{i, i+1}},
+                           potential_type(10.0, 1.0));
+    }
+    loc.emplace(mjolnir::make_unique<bond_type>("none", std::move(bonds)));
+    auto ff = mjolnir::make_unique<mjolnir::ForceField<traits_type>>(
+            std::move(loc), mjolnir::GlobalForceField<traits_type>{},
+            mjolnir::ExternalForceField<traits_type>{},
+            mjolnir::ConstraintForceField<traits_type>{});
+
+    mjolnir::ObserverContainer<traits_type> obs;
+    obs.push_back(mjolnir::make_unique<mjolnir::EnergyObserver<traits_type>>(
+                "test_fire_simulator"));
+
+    constexpr std::size_t step_limit = 10000;
+    constexpr real_type   threshold  = 1e-6;
+    simulator_type sim(0.01, threshold, simulator_type::default_parameters(0.01),
+            step_limit, step_limit, step_limit,
+            std::move(sys), std::move(ff), std::move(obs));
+
+    sim.initialize();
+    std::size_t steps = 0;
+    while(sim.step()) {++steps;}
+    sim.finalize();
+
+    // converged before reaching the step limit
+    BOOST_TEST(steps + 1 < step_limit);
+    BOOST_TEST_MESSAGE("converged in " << steps << " steps");
+
+    const auto& result = sim.system();
+    for(std::size_t i=0; i<N; ++i)
+    {
+        BOOST_TEST(std::abs(mjolnir::math::X(result.force(i))) < threshold);
+        BOOST_TEST(std::abs(mjolnir::math::Y(result.force(i))) < threshold);
+        BOOST_TEST(std::abs(mjolnir::math::Z(result.force(i))) < threshold);
+    }
+    for(std::size_t i=0; i+1<N; ++i)
+    {
+        const auto dr = result.position(i+1) - result.position(i);
+        BOOST_TEST(mjolnir::math::length(dr) == 1.0, boost::test_tools::tolerance(1e-6));
+    }
+    BOOST_TEST(sim.forcefields()->calc_energy(result) < 1e-10);
+}
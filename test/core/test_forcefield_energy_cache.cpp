@@ -0,0 +1,115 @@
+#define BOOST_TEST_MODULE "test_forcefield_energy_cache"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/ForceField.hpp>
+#include <mjolnir/forcefield/local/BondLengthInteraction.hpp>
+#include <mjolnir/forcefield/local/HarmonicPotential.hpp>
+#include <mjolnir/forcefield/external/PositionRestraintInteraction.hpp>
+#include <mjolnir/util/make_unique.hpp>
+
+#include <random>
+
+BOOST_AUTO_TEST_CASE(ForceField_energy_cache)
+{
+    mjolnir::LoggerManager::set_default_logger("test_forcefield_energy_cache.log");
+    using traits_type      = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using real_type        = traits_type::real_type;
+    using coord_type       = traits_type::coordinate_type;
+    using boundary_type    = traits_type::boundary_type;
+    using system_type      = mjolnir::System<traits_type>;
+    using potential_type   = mjolnir::HarmonicPotential<real_type>;
+    using bond_type        = mjolnir::BondLengthInteraction<traits_type, potential_type>;
+    using restraint_type   = mjolnir::PositionRestraintInteraction<traits_type, potential_type>;
+    using forcefield_type  = mjolnir::ForceField<traits_type>;
+
+    constexpr std::size_t N = 4;
+
+    mjolnir::LocalForceField<traits_type>      loc;
+    mjolnir::GlobalForceField<traits_type>     glo;
+    mjolnir::ExternalForceField<traits_type>   ext;
+    mjolnir::ConstraintForceField<traits_type> con;
+    {
+        std::vector<std::pair<std::array<std::size_t, 2>, potential_type>> bonds;
+        for(std::size_t i=0; i+1<N; ++i)
+        {
+            bonds.emplace_back(std::array<std::size_t, 2>{{i, i+1}},
+                               potential_type(10.0, 1.0));
+        }
+        loc.emplace(mjolnir::make_unique<bond_type>("none", std::move(bonds)));
+    }
+    {
+        std::vector<std::pair<std::array<std::size_t, 2>, potential_type>> bonds;
+        bonds.emplace_back(std::array<std::size_t, 2>{{0, N-1}},
+                           potential_type(1.0, 3.0));
+        loc.emplace(mjolnir::make_unique<bond_type>("none", std::move(bonds)));
+    }
+    {
+        std::vector<std::tuple<std::size_t, coord_type, potential_type>> params;
+        params.emplace_back(0, coord_type(0.0, 0.0, 0.0), potential_type(1.0, 0.0));
+        ext.emplace(mjolnir::make_unique<restraint_type>(std::move(params)));
+    }
+    forcefield_type ff(std::move(loc), std::move(glo), std::move(ext), std::move(con));
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(-0.1, 0.1);
+
+    system_type sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.at(i).mass     = 1.0;
+        sys.at(i).rmass    = 1.0;
+        sys.at(i).position = coord_type(1.0 * i, 0.0, 0.0);
+        sys.at(i).velocity = coord_type(0.0, 0.0, 0.0);
+        sys.at(i).force    = coord_type(0.0, 0.0, 0.0);
+        sys.at(i).name     = "X";
+        sys.at(i).group    = "NONE";
+    }
+    ff.initialize(sys);
+
+    for(std::size_t trial=0; trial<100; ++trial)
+    {
+        for(std::size_t i=0; i<N; ++i)
+        {
+            sys.position(i) += coord_type(uni(mt), uni(mt), uni(mt));
+        }
+        auto ref = sys;
+
+        // reference: forces and energies are calculated separately
+        ff.enable_energy_cache(false);
+        ff.calc_force(ref);
+        std::string ref_fmt;
+        const auto ref_energy = ff.format_energy(ref, ref_fmt);
+
+        // energies are calculated in calc_force
+        ff.enable_energy_cache(true);
+        ff.calc_force(sys);
+
+        for(std::size_t i=0; i<N; ++i)
+        {
+            BOOST_TEST(mjolnir::math::X(sys.force(i)) == mjolnir::math::X(ref.force(i)));
+            BOOST_TEST(mjolnir::math::Y(sys.force(i)) == mjolnir::math::Y(ref.force(i)));
+            BOOST_TEST(mjolnir::math::Z(sys.force(i)) == mjolnir::math::Z(ref.force(i)));
+        }
+
+        std::string fmt;
+        const auto energy = ff.format_energy(sys, fmt);
+        BOOST_TEST(energy == ref_energy, boost::test_tools::tolerance(1e-10));
+        BOOST_TEST(fmt    == ref_fmt);
+
+        // the cache is used only once. after the configuration changes, the
+        // energy should be re-calculated.
+        sys.position(1) += coord_type(0.5, 0.0, 0.0);
+        std::string moved_fmt;
+        const auto moved_energy = ff.format_energy(sys, moved_fmt);
+        BOOST_TEST(moved_energy == ff.calc_energy(sys), boost::test_tools::tolerance(1e-10));
+        BOOST_TEST(moved_energy != ref_energy);
+        sys.position(1) -= coord_type(0.5, 0.0, 0.0);
+    }
+}
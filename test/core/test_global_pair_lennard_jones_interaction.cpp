@@ -11,6 +11,8 @@
 #include <mjolnir/core/NaivePairCalculation.hpp>
 #include <mjolnir/forcefield/global/GlobalPairLennardJonesInteraction.hpp>
 #include <mjolnir/util/make_unique.hpp>
+#include <algorithm>
+#include <numeric>
 #include <random>
 
 BOOST_AUTO_TEST_CASE(GlobalPairLennardJonesInteraction_numeric_limits)
@@ -297,3 +299,189 @@ BOOST_AUTO_TEST_CASE(GlobalPairLennardJonesInteraction_numeric_force_and_energy)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(GlobalPairLennardJonesInteraction_mixed_precision)
+{
+    mjolnir::LoggerManager::set_default_logger("test_global_pair_lennard_jones_interaction.log");
+    using traits = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+
+    using real_type        = traits::real_type;
+    using coordinate_type  = traits::coordinate_type;
+    using boundary_type    = traits::boundary_type;
+    using system_type      = mjolnir::System<traits>;
+    using topology_type    = mjolnir::Topology;
+    using potential_type   = mjolnir::LennardJonesPotential<traits>;
+    using parameter_type   = typename potential_type::parameter_type;
+    using partition_type   = mjolnir::NaivePairCalculation<traits, potential_type>;
+    using interaction_type = mjolnir::GlobalPairInteraction<traits, potential_type>;
+
+    constexpr std::size_t N = 64;
+    std::vector<std::pair<std::size_t, parameter_type>> params;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        params.emplace_back(i, parameter_type(1.0, 1.2));
+    }
+    potential_type potential(potential_type::default_cutoff(), params, {},
+        typename potential_type::ignore_molecule_type("Nothing"),
+        typename potential_type::ignore_group_type   ({}));
+
+    interaction_type interaction(potential_type{potential},
+        mjolnir::SpatialPartition<traits, potential_type>(
+            mjolnir::make_unique<partition_type>()));
+
+    // particles on a slightly distorted lattice far from the origin
+    std::mt19937 rng(123456789);
+    std::uniform_real_distribution<real_type> uni(-0.05, 0.05);
+    const coordinate_type origin(1.0e3, -1.0e3, 1.0e3);
+
+    system_type sys(N, boundary_type{});
+    topology_type topol(N);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.mass(i)     = 1.0;
+        sys.rmass(i)    = 1.0;
+        sys.position(i) = origin + coordinate_type(
+            1.1 * (i % 4) + uni(rng), 1.1 * ((i / 4) % 4) + uni(rng),
+            1.1 * (i / 16) + uni(rng));
+        sys.velocity(i) = coordinate_type(0.0, 0.0, 0.0);
+        sys.force(i)    = coordinate_type(0.0, 0.0, 0.0);
+        sys.name(i)     = "X";
+        sys.group(i)    = "NONE";
+    }
+    topol.construct_molecules();
+    interaction.initialize(sys, topol);
+
+    system_type ref_sys = sys;
+    sys.mixed_precision() = true;
+    BOOST_TEST_REQUIRE(!ref_sys.mixed_precision());
+
+    const auto energy     = interaction.calc_force_and_energy(sys);
+    const auto ref_energy = interaction.calc_force_and_energy(ref_sys);
+
+    // the kernel runs in float, but the results are in double.
+    constexpr real_type tol = 1e-4;
+    BOOST_TEST(energy == ref_energy, boost::test_tools::tolerance(tol));
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const auto df = sys.force(i) - ref_sys.force(i);
+        BOOST_TEST(mjolnir::math::length(df) <=
+                   tol * (1.0 + mjolnir::math::length(ref_sys.force(i))));
+    }
+    for(std::size_t i=0; i<9; ++i)
+    {
+        BOOST_TEST(std::abs(sys.virial()[i] - ref_sys.virial()[i]) <=
+                   tol * (1.0 + std::abs(ref_sys.virial()[i])));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GlobalPairLennardJonesInteraction_reorder)
+{
+    mjolnir::LoggerManager::set_default_logger("test_global_pair_lennard_jones_interaction.log");
+    using traits = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+
+    using real_type        = traits::real_type;
+    using coordinate_type  = traits::coordinate_type;
+    using boundary_type    = traits::boundary_type;
+    using system_type      = mjolnir::System<traits>;
+    using topology_type    = mjolnir::Topology;
+    using potential_type   = mjolnir::LennardJonesPotential<traits>;
+    using parameter_type   = typename potential_type::parameter_type;
+    using partition_type   = mjolnir::NaivePairCalculation<traits, potential_type>;
+    using interaction_type = mjolnir::GlobalPairInteraction<traits, potential_type>;
+
+    constexpr std::size_t N = 512;
+    std::vector<std::pair<std::size_t, parameter_type>> params;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        params.emplace_back(i, parameter_type(1.0, 1.2));
+    }
+    potential_type potential(potential_type::default_cutoff(), params, {},
+        typename potential_type::ignore_molecule_type("Nothing"),
+        typename potential_type::ignore_group_type   ({}));
+
+    interaction_type ordered(potential_type{potential},
+        mjolnir::SpatialPartition<traits, potential_type>(
+            mjolnir::make_unique<partition_type>()));
+    interaction_type reordered(potential_type{potential},
+        mjolnir::SpatialPartition<traits, potential_type>(
+            mjolnir::make_unique<partition_type>(), /* reorder = */ true));
+
+    // particles on a lattice, but the indices are shuffled
+    std::mt19937 rng(123456789);
+    std::uniform_real_distribution<real_type> uni(-0.05, 0.05);
+    std::vector<std::size_t> lattice(N);
+    std::iota(lattice.begin(), lattice.end(), 0);
+    std::shuffle(lattice.begin(), lattice.end(), rng);
+
+    system_type sys(N, boundary_type{});
+    topology_type topol(N);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const auto l = lattice.at(i);
+        sys.mass(i)     = 1.0;
+        sys.rmass(i)    = 1.0;
+        sys.position(i) = coordinate_type(1.1 * (l % 8) + uni(rng),
+            1.1 * ((l / 8) % 8) + uni(rng), 1.1 * (l / 64) + uni(rng));
+        sys.velocity(i) = coordinate_type(0.0, 0.0, 0.0);
+        sys.force(i)    = coordinate_type(0.0, 0.0, 0.0);
+        sys.name(i)     = "X";
+        sys.group(i)    = "NONE";
+    }
+    topol.construct_molecules();
+    ordered  .initialize(sys, topol);
+    reordered.initialize(sys, topol);
+
+    // the traversal order is a permutation of the leading participants
+    {
+        potential.initialize(sys, topol);
+        mjolnir::SpatialPartition<traits, potential_type> partition0(
+                mjolnir::make_unique<partition_type>());
+        mjolnir::SpatialPartition<traits, potential_type> partition1(
+                mjolnir::make_unique<partition_type>(), /* reorder = */ true);
+        partition0.initialize(sys, potential);
+        partition1.initialize(sys, potential);
+
+        const auto  leading = potential.leading_participants();
+        const auto& order0  = partition0.leading_participants();
+        const auto& order1  = partition1.leading_participants();
+        BOOST_TEST_REQUIRE(order0.size() == leading.size());
+        BOOST_TEST_REQUIRE(order1.size() == leading.size());
+        BOOST_TEST(std::equal(order0.begin(), order0.end(), leading.begin()));
+
+        std::vector<std::size_t> sorted(order1);
+        std::sort(sorted.begin(), sorted.end());
+        BOOST_TEST(std::equal(sorted.begin(), sorted.end(), leading.begin()));
+
+        // particles visited successively are closer in z-order
+        real_type dist0 = 0.0, dist1 = 0.0;
+        for(std::size_t idx=1; idx<order0.size(); ++idx)
+        {
+            dist0 += mjolnir::math::length(
+                sys.position(order0[idx]) - sys.position(order0[idx-1]));
+            dist1 += mjolnir::math::length(
+                sys.position(order1[idx]) - sys.position(order1[idx-1]));
+        }
+        BOOST_TEST(dist1 < 0.5 * dist0);
+    }
+
+    // the result does not depend on the order
+    system_type ref_sys = sys;
+    const auto energy     = reordered.calc_force_and_energy(sys);
+    const auto ref_energy = ordered  .calc_force_and_energy(ref_sys);
+
+    constexpr real_type tol = 1e-10;
+    BOOST_TEST(energy == ref_energy, boost::test_tools::tolerance(tol));
+    BOOST_TEST(reordered.calc_energy(sys) == ordered.calc_energy(ref_sys),
+               boost::test_tools::tolerance(tol));
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const auto df = sys.force(i) - ref_sys.force(i);
+        BOOST_TEST(mjolnir::math::length(df) <=
+                   tol * (1.0 + mjolnir::math::length(ref_sys.force(i))));
+    }
+    for(std::size_t i=0; i<9; ++i)
+    {
+        BOOST_TEST(std::abs(sys.virial()[i] - ref_sys.virial()[i]) <=
+                   tol * (1.0 + std::abs(ref_sys.virial()[i])));
+    }
+}
@@ -21,7 +21,7 @@ BOOST_AUTO_TEST_CASE(test_NeighborList_no_parameter)
     using neighbor_type =
         typename mjolnir::NeighborList<parameter_type>::neighbor_type;
 
-    static_assert(sizeof(neighbor_type) == sizeof(std::size_t), "");
+    static_assert(sizeof(neighbor_type) == sizeof(std::uint32_t), "");
 
     // construct dummy neighbor list
     const std::size_t N = 100;
@@ -89,3 +89,40 @@ BOOST_AUTO_TEST_CASE(test_NeighborList_with_parameter)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_NeighborList_with_type_pair_id)
+{
+    mjolnir::LoggerManager::set_default_logger("test_neighbor_list.log");
+    // a 32-bit id that points an element of a parameter matrix
+    using parameter_type  = std::uint32_t;
+
+    mjolnir::NeighborList<parameter_type> nlist;
+    using neighbor_type =
+        typename mjolnir::NeighborList<parameter_type>::neighbor_type;
+
+    static_assert(sizeof(neighbor_type) == 8, "");
+
+    const std::size_t N = 100;
+    const std::size_t M =  10;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        std::vector<neighbor_type> partner;
+        for(std::size_t j = i + 1; j < i + 1 + M; ++j)
+        {
+            partner.emplace_back(j, static_cast<parameter_type>((i % 2) * 2 + (j % 2)));
+        }
+        nlist.add_list_for(i, partner.begin(), partner.end());
+    }
+
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const auto partners = nlist.at(i);
+        BOOST_TEST(partners.size() == M);
+        for(std::size_t k=0; k<M; ++k)
+        {
+            const std::size_t j = i + 1 + k;
+            BOOST_TEST(partners.at(k).index       == j);
+            BOOST_TEST(partners.at(k).parameter() == (i % 2) * 2 + (j % 2));
+        }
+    }
+}
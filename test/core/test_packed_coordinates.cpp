@@ -0,0 +1,85 @@
+#define BOOST_TEST_MODULE "test_packed_coordinates"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/math/Vector.hpp>
+#include <mjolnir/util/packed_coordinates.hpp>
+#include <cstdint>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_packed_coordinates_layout)
+{
+    using coordinate_type = mjolnir::math::Vector<double, 3>;
+    using packed_type     = mjolnir::packed_coordinates<double, coordinate_type>;
+
+    for(std::size_t N : {0u, 1u, 7u, 8u, 9u, 100u})
+    {
+        packed_type pc(N);
+        BOOST_TEST(pc.size() == N);
+        BOOST_TEST(pc.padded_size() >= N);
+        BOOST_TEST(pc.padded_size() % packed_type::lanes == 0u);
+        BOOST_TEST(pc.padded_size() <  N + packed_type::lanes);
+
+        if(N == 0) {continue;}
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(pc.x()) % packed_type::alignment == 0u);
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(pc.y()) % packed_type::alignment == 0u);
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(pc.z()) % packed_type::alignment == 0u);
+
+        // padded region should be zero
+        for(std::size_t i=0; i<pc.padded_size(); ++i)
+        {
+            BOOST_TEST(pc.x()[i] == 0.0);
+            BOOST_TEST(pc.y()[i] == 0.0);
+            BOOST_TEST(pc.z()[i] == 0.0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_coordinates_pack_and_accumulate)
+{
+    using coordinate_type = mjolnir::math::Vector<float, 3>;
+    using packed_type     = mjolnir::packed_coordinates<float, coordinate_type>;
+
+    constexpr std::size_t N = 37;
+    std::vector<coordinate_type> aos(N);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        aos[i] = coordinate_type(1.0f * i, 2.0f * i, 3.0f * i);
+    }
+
+    packed_type pc(N);
+    pc.pack(aos);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        BOOST_TEST(pc.x()[i] == 1.0f * i);
+        BOOST_TEST(pc.y()[i] == 2.0f * i);
+        BOOST_TEST(pc.z()[i] == 3.0f * i);
+
+        const auto v = pc.load(i);
+        BOOST_TEST(mjolnir::math::X(v) == mjolnir::math::X(aos[i]));
+        BOOST_TEST(mjolnir::math::Y(v) == mjolnir::math::Y(aos[i]));
+        BOOST_TEST(mjolnir::math::Z(v) == mjolnir::math::Z(aos[i]));
+    }
+
+    pc.add(3, coordinate_type(1.0f, 1.0f, 1.0f));
+    BOOST_TEST(pc.x()[3] == 4.0f);
+    BOOST_TEST(pc.y()[3] == 7.0f);
+    BOOST_TEST(pc.z()[3] == 10.0f);
+
+    pc.accumulate_to(aos);
+    BOOST_TEST(mjolnir::math::X(aos[3]) ==  7.0f);
+    BOOST_TEST(mjolnir::math::Y(aos[3]) == 13.0f);
+    BOOST_TEST(mjolnir::math::Z(aos[3]) == 19.0f);
+
+    pc.fill_zero();
+    for(std::size_t i=0; i<pc.padded_size(); ++i)
+    {
+        BOOST_TEST(pc.x()[i] == 0.0f);
+        BOOST_TEST(pc.y()[i] == 0.0f);
+        BOOST_TEST(pc.z()[i] == 0.0f);
+    }
+}
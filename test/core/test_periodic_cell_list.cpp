@@ -365,3 +365,83 @@ BOOST_AUTO_TEST_CASE(test_PeriodicGridCellList_clone)
 
     BOOST_TEST(vlist.margin() == vlist2.margin());
 }
+
+BOOST_AUTO_TEST_CASE(test_PeriodicGridCellList_half_shell)
+{
+    mjolnir::LoggerManager::set_default_logger("test_periodic_grid_cell_list.log");
+    using traits_type     = mjolnir::SimulatorTraits<double, mjolnir::CuboidalPeriodicBoundary>;
+    using real_type       = typename traits_type::real_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using potential_type  = dummy_potential<real_type>;
+
+    constexpr std::size_t N = 1000;
+    constexpr double      L = 10.0;
+    constexpr double cutoff = 1.0;
+    constexpr double margin = 0.5;
+
+    const auto distribute_particle = [](std::mt19937& mt, double l) -> coordinate_type
+    {
+        return coordinate_type(
+            l * std::generate_canonical<real_type, std::numeric_limits<real_type>::digits>(mt),
+            l * std::generate_canonical<real_type, std::numeric_limits<real_type>::digits>(mt),
+            l * std::generate_canonical<real_type, std::numeric_limits<real_type>::digits>(mt)
+        );
+    };
+
+    std::vector<std::size_t> participants; participants.reserve(500);
+    for(std::size_t i=0; i<500; ++i)
+    {
+        participants.push_back(i * 2);
+    }
+    dummy_potential<real_type> pot(cutoff, participants);
+
+    mjolnir::System<traits_type> sys(N, boundary_type(coordinate_type(0.0, 0.0, 0.0), coordinate_type(L, L, L)));
+
+    std::mt19937 mt(123456789);
+    for(std::size_t i=0; i < N; ++i)
+    {
+        sys.at(i).mass     = 1.0;
+        sys.at(i).position = distribute_particle(mt, L);
+    }
+
+    mjolnir::SpatialPartition<traits_type, potential_type> full(mjolnir::make_unique<
+            mjolnir::PeriodicGridCellList<traits_type, potential_type>>(margin,
+                mjolnir::CellListStencil::Full));
+    mjolnir::SpatialPartition<traits_type, potential_type> half(mjolnir::make_unique<
+            mjolnir::PeriodicGridCellList<traits_type, potential_type>>(margin,
+                mjolnir::CellListStencil::Half));
+
+    full.initialize(sys, pot);
+    half.initialize(sys, pot);
+
+    // move some of the particles and rebuild the list
+    for(std::size_t step=0; step<3; ++step)
+    {
+        for(std::size_t i=0; i<N; i+=7)
+        {
+            sys.position(i) = distribute_particle(mt, L);
+        }
+        full.make(sys, pot);
+        half.make(sys, pot);
+
+        for(const auto i : pot.leading_participants())
+        {
+            const auto partners_full = full.partners(i);
+            const auto partners_half = half.partners(i);
+            BOOST_TEST_REQUIRE(partners_full.size() == partners_half.size());
+            for(std::size_t k=0; k<partners_full.size(); ++k)
+            {
+                BOOST_TEST(partners_full[k].index == partners_half[k].index);
+            }
+        }
+    }
+
+    // clone keeps the stencil
+    mjolnir::SpatialPartition<traits_type, potential_type> half2(half);
+    half2.initialize(sys, pot);
+    for(const auto i : pot.leading_participants())
+    {
+        BOOST_TEST(half2.partners(i).size() == half.partners(i).size());
+    }
+}
@@ -0,0 +1,99 @@
+#define BOOST_TEST_MODULE "test_philox"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/util/philox.hpp>
+#include <cstdint>
+#include <cmath>
+
+// known answers taken from Random123 (kat_vectors)
+BOOST_AUTO_TEST_CASE(test_philox4x32_known_answer)
+{
+    using philox = mjolnir::philox4x32;
+    {
+        const auto r = philox::generate(philox::counter_type{{0u, 0u, 0u, 0u}},
+                                        philox::key_type{{0u, 0u}});
+        BOOST_TEST(r[0] == 0x6627e8d5u);
+        BOOST_TEST(r[1] == 0xe169c58du);
+        BOOST_TEST(r[2] == 0xbc57ac4cu);
+        BOOST_TEST(r[3] == 0x9b00dbd8u);
+    }
+    {
+        const auto r = philox::generate(philox::counter_type{{
+                0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}},
+                philox::key_type{{0xffffffffu, 0xffffffffu}});
+        BOOST_TEST(r[0] == 0x408f276du);
+        BOOST_TEST(r[1] == 0x41c83b0eu);
+        BOOST_TEST(r[2] == 0xa20bc7c6u);
+        BOOST_TEST(r[3] == 0x6d5451fdu);
+    }
+    {
+        const auto r = philox::generate(philox::counter_type{{
+                0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}},
+                philox::key_type{{0xa4093822u, 0x299f31d0u}});
+        BOOST_TEST(r[0] == 0xd16cfe09u);
+        BOOST_TEST(r[1] == 0x94fdccebu);
+        BOOST_TEST(r[2] == 0x5001e420u);
+        BOOST_TEST(r[3] == 0x24126ea1u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_philox_uniform)
+{
+    BOOST_TEST(mjolnir::philox_uniform<double>::invoke(0u, 0u) == 0.0);
+    BOOST_TEST(mjolnir::philox_uniform<float >::invoke(0u, 0u) == 0.0f);
+    BOOST_TEST(mjolnir::philox_uniform<double>::invoke(0xffffffffu, 0xffffffffu) < 1.0);
+    BOOST_TEST(mjolnir::philox_uniform<float >::invoke(0xffffffffu, 0xffffffffu) < 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(test_philox_box_muller)
+{
+    using philox = mjolnir::philox4x32;
+
+    // extreme inputs should be finite
+    {
+        double z0, z1;
+        mjolnir::philox_box_muller<double>(0u, 0u, z0, z1);
+        BOOST_TEST(std::isfinite(z0));
+        BOOST_TEST(std::isfinite(z1));
+        mjolnir::philox_box_muller<double>(0xffffffffu, 0xffffffffu, z0, z1);
+        BOOST_TEST(std::isfinite(z0));
+        BOOST_TEST(std::isfinite(z1));
+
+        float f0, f1;
+        mjolnir::philox_box_muller<float>(0u, 0u, f0, f1);
+        BOOST_TEST(std::isfinite(f0));
+        BOOST_TEST(std::isfinite(f1));
+        mjolnir::philox_box_muller<float>(0xffffffffu, 0xffffffffu, f0, f1);
+        BOOST_TEST(std::isfinite(f0));
+        BOOST_TEST(std::isfinite(f1));
+    }
+
+    // moments of the standard normal distribution
+    const std::size_t N = 100000;
+    double m1 = 0.0, m2 = 0.0, m4 = 0.0;
+    for(std::uint32_t i=0; i<N; ++i)
+    {
+        const auto r = philox::generate(philox::counter_type{{i, 0u, 0u, 0u}},
+                                        philox::key_type{{123456789u, 0u}});
+        double z[4];
+        mjolnir::philox_box_muller<double>(r[0], r[1], z[0], z[1]);
+        mjolnir::philox_box_muller<double>(r[2], r[3], z[2], z[3]);
+        for(const double x : z)
+        {
+            m1 += x;
+            m2 += x * x;
+            m4 += x * x * x * x;
+        }
+    }
+    m1 /= (4 * N);
+    m2 /= (4 * N);
+    m4 /= (4 * N);
+    BOOST_TEST(m1 == 0.0, boost::test_tools::tolerance(0.01));
+    BOOST_TEST(m2 == 1.0, boost::test_tools::tolerance(0.01));
+    BOOST_TEST(m4 == 3.0, boost::test_tools::tolerance(0.03));
+}
@@ -0,0 +1,68 @@
+#define BOOST_TEST_MODULE "test_profiler"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+// enable the timers regardless of the cmake option
+#ifndef MJOLNIR_WITH_PROFILER
+#define MJOLNIR_WITH_PROFILER
+#endif
+#include <mjolnir/util/profiler.hpp>
+#include <thread>
+#include <chrono>
+
+BOOST_AUTO_TEST_CASE(ProfileManager_counter)
+{
+    auto* a = mjolnir::ProfileManager::get_counter("test:a");
+    auto* b = mjolnir::ProfileManager::get_counter("test:b");
+
+    BOOST_TEST(a != b);
+    BOOST_TEST(a == mjolnir::ProfileManager::get_counter("test:a"));
+    BOOST_TEST(a->name  == "test:a");
+    BOOST_TEST(a->ticks == 0u);
+    BOOST_TEST(a->calls == 0u);
+
+    const auto& counters = mjolnir::ProfileManager::counters();
+    BOOST_TEST_REQUIRE(counters.size() == 2u);
+    BOOST_TEST(counters.at(0) == a);
+    BOOST_TEST(counters.at(1) == b);
+}
+
+BOOST_AUTO_TEST_CASE(ProfileManager_scope)
+{
+    auto* counter = mjolnir::ProfileManager::get_counter("test:sleep");
+    mjolnir::ProfileManager::reset();
+
+    for(std::size_t i=0; i<3; ++i)
+    {
+        MJOLNIR_PROFILE_SCOPE(counter);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_TEST(counter->calls == 3u);
+
+    const double sec = counter->ticks * mjolnir::ProfileManager::seconds_per_tick();
+    BOOST_TEST(sec >= 0.025);
+    BOOST_TEST(sec <= 1.0);
+
+    // conditional stop
+    {
+        MJOLNIR_PROFILE_START(start);
+        if(false) {MJOLNIR_PROFILE_STOP(counter, start);}
+    }
+    BOOST_TEST(counter->calls == 3u);
+    {
+        MJOLNIR_PROFILE_START(start);
+        if(true) {MJOLNIR_PROFILE_STOP(counter, start);}
+    }
+    BOOST_TEST(counter->calls == 4u);
+
+    const auto summary = mjolnir::ProfileManager::summary();
+    BOOST_TEST(summary.find("test:sleep") != std::string::npos);
+
+    mjolnir::ProfileManager::reset();
+    BOOST_TEST(counter->calls == 0u);
+    BOOST_TEST(counter->ticks == 0u);
+}
@@ -0,0 +1,68 @@
+#define BOOST_TEST_MODULE "test_read_fire_simulator"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+#include <test/util/make_empty_input.hpp>
+#include <mjolnir/input/read_simulator.hpp>
+
+BOOST_AUTO_TEST_CASE(read_fire_simulator)
+{
+    mjolnir::LoggerManager::set_default_logger("test_read_fire_simulator.log");
+
+    using real_type = double;
+    using traits_type = mjolnir::SimulatorTraits<real_type, mjolnir::UnlimitedBoundary>;
+    auto root = mjolnir::test::make_empty_input();
+
+    using namespace toml::literals;
+    const auto v = u8R"(
+        type            = "FIRE"
+        precision       = "double"
+        boundary_type   = "Unlimited"
+        delta_t         = 0.01
+        delta_t_max     = 0.1
+        step_limit      = 100
+        save_step       = 10
+        threshold       = 0.0
+    )"_toml;
+    root.as_table()["simulator"] = v;
+
+    {
+        const auto sim = mjolnir::read_integrator_type<traits_type>(root, v);
+        BOOST_TEST(static_cast<bool>(sim));
+
+        const auto firesim = dynamic_cast<
+            mjolnir::FIRESimulator<traits_type>*>(sim.get());
+        BOOST_TEST(static_cast<bool>(firesim));
+
+        sim->initialize();
+        for(std::size_t i=0; i<99; ++i)
+        {
+            BOOST_TEST(sim->step()); // check it can step
+        }
+        // at the last (100-th) step, it returns false to stop the simulation.
+        BOOST_TEST(!sim->step());
+        sim->finalize();
+    }
+    {
+        const auto sim = mjolnir::read_simulator<traits_type,
+              mjolnir::VelocityVerletIntegrator<traits_type>>(root, v);
+        BOOST_TEST(static_cast<bool>(sim));
+
+        const auto firesim = dynamic_cast<
+            mjolnir::FIRESimulator<traits_type>*>(sim.get());
+        BOOST_TEST(static_cast<bool>(firesim));
+
+        sim->initialize();
+        for(std::size_t i=0; i<99; ++i)
+        {
+            BOOST_TEST(sim->step()); // check it can step
+        }
+        // at the last (100-th) step, it returns false to stop the simulation.
+        BOOST_TEST(!sim->step());
+        sim->finalize();
+    }
+
+}
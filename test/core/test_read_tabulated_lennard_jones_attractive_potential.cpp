@@ -70,18 +70,18 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(read_tabulated_lennard_jones_attractive_noenv, T,
         BOOST_TEST(pot.participants().at(5)  ==   7u);
         BOOST_TEST(pot.participants().at(6)  == 100u);
 
-        BOOST_TEST(pot.parameters().at(  0)  == "A", tolerance<real_type>());
-        BOOST_TEST(pot.parameters().at(  1)  == "B", tolerance<real_type>());
-        BOOST_TEST(pot.parameters().at(  2)  == "A", tolerance<real_type>());
-        BOOST_TEST(pot.parameters().at(  3)  == "B", tolerance<real_type>());
-        BOOST_TEST(pot.parameters().at(  5)  == "A", tolerance<real_type>());
-        BOOST_TEST(pot.parameters().at(  7)  == "B", tolerance<real_type>());
-        BOOST_TEST(pot.parameters().at(100)  == "A", tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  0) == "A", tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  1) == "B", tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  2) == "A", tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  3) == "B", tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  5) == "A", tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  7) == "B", tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(100) == "A", tolerance<real_type>());
 
-        const auto para_AA = pot.prepare_params(0, 2);
-        const auto para_AB = pot.prepare_params(0, 1);
-        const auto para_BA = pot.prepare_params(1, 2);
-        const auto para_BB = pot.prepare_params(1, 3);
+        const auto para_AA = pot.parameter_matrix().at(pot.prepare_params(0, 2));
+        const auto para_AB = pot.parameter_matrix().at(pot.prepare_params(0, 1));
+        const auto para_BA = pot.parameter_matrix().at(pot.prepare_params(1, 2));
+        const auto para_BB = pot.parameter_matrix().at(pot.prepare_params(1, 3));
 
         BOOST_TEST(para_AA.first  == 1.0, tolerance<real_type>());
         BOOST_TEST(para_AA.second == 0.5, tolerance<real_type>());
@@ -70,23 +70,23 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(read_tabulated_wca_noenv, T, test_types)
         BOOST_TEST(pot.participants().at(5)  ==   7u);
         BOOST_TEST(pot.participants().at(6)  == 100u);
 
-        BOOST_TEST(pot.parameters().at(  0)  == "A");
-        BOOST_TEST(pot.parameters().at(  1)  == "B");
-        BOOST_TEST(pot.parameters().at(  2)  == "A");
-        BOOST_TEST(pot.parameters().at(  3)  == "B");
-        BOOST_TEST(pot.parameters().at(  5)  == "A");
-        BOOST_TEST(pot.parameters().at(  7)  == "B");
-        BOOST_TEST(pot.parameters().at(100)  == "A");
-
-        BOOST_TEST(pot.prepare_params(0, 1).first == real_type(  5.0), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(0, 2).first == real_type(  2.0), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(1, 2).first == real_type(  5.0), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(1, 3).first == real_type(100.0), tolerance<real_type>());
-
-        BOOST_TEST(pot.prepare_params(0, 1).second == real_type(  0.5), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(0, 2).second == real_type(  1.5), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(1, 2).second == real_type(  0.5), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(1, 3).second == real_type(  0.1), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  0) == "A");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  1) == "B");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  2) == "A");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  3) == "B");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  5) == "A");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  7) == "B");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(100) == "A");
+
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(0, 1)).first == real_type(  5.0), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(0, 2)).first == real_type(  2.0), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(1, 2)).first == real_type(  5.0), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(1, 3)).first == real_type(100.0), tolerance<real_type>());
+
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(0, 1)).second == real_type(  0.5), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(0, 2)).second == real_type(  1.5), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(1, 2)).second == real_type(  0.5), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(1, 3)).second == real_type(  0.1), tolerance<real_type>());
 
     }
 }
@@ -147,23 +147,23 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(read_tabulated_wca_env, T, test_types)
         BOOST_TEST(pot.participants().at(5)  ==   7u);
         BOOST_TEST(pot.participants().at(6)  == 100u);
 
-        BOOST_TEST(pot.parameters().at(  0)  == "A");
-        BOOST_TEST(pot.parameters().at(  1)  == "B");
-        BOOST_TEST(pot.parameters().at(  2)  == "A");
-        BOOST_TEST(pot.parameters().at(  3)  == "B");
-        BOOST_TEST(pot.parameters().at(  5)  == "A");
-        BOOST_TEST(pot.parameters().at(  7)  == "B");
-        BOOST_TEST(pot.parameters().at(100)  == "A");
-
-        BOOST_TEST(pot.prepare_params(0, 1).first == real_type(  5.0), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(0, 2).first == real_type(  2.0), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(1, 2).first == real_type(  5.0), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(1, 3).first == real_type(100.0), tolerance<real_type>());
-
-        BOOST_TEST(pot.prepare_params(0, 1).second == real_type(  0.5), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(0, 2).second == real_type(  1.5), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(1, 2).second == real_type(  0.5), tolerance<real_type>());
-        BOOST_TEST(pot.prepare_params(1, 3).second == real_type(  0.1), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  0) == "A");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  1) == "B");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  2) == "A");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  3) == "B");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  5) == "A");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(  7) == "B");
+        BOOST_TEST(pot.parameter_matrix().type_name_of(100) == "A");
+
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(0, 1)).first == real_type(  5.0), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(0, 2)).first == real_type(  2.0), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(1, 2)).first == real_type(  5.0), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(1, 3)).first == real_type(100.0), tolerance<real_type>());
+
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(0, 1)).second == real_type(  0.5), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(0, 2)).second == real_type(  1.5), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(1, 2)).second == real_type(  0.5), tolerance<real_type>());
+        BOOST_TEST(pot.parameter_matrix().at(pot.prepare_params(1, 3)).second == real_type(  0.1), tolerance<real_type>());
 
 
     }
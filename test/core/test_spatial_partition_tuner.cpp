@@ -0,0 +1,237 @@
+#define BOOST_TEST_MODULE "test_spatial_partition_tuner"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/util/empty.hpp>
+#include <mjolnir/util/logger.hpp>
+#include <mjolnir/util/range.hpp>
+#include <mjolnir/util/make_unique.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/SpatialPartitionTuner.hpp>
+#include <mjolnir/core/VerletList.hpp>
+#include <mjolnir/core/UnlimitedGridCellList.hpp>
+#include <mjolnir/core/System.hpp>
+#include <mjolnir/core/Topology.hpp>
+#include <numeric>
+#include <chrono>
+#include <map>
+#include <cstdint>
+
+template<typename T>
+struct dummy_potential
+{
+    using real_type      = T;
+    using parameter_type = mjolnir::empty_t;
+    using pair_parameter_type = parameter_type;
+
+    using topology_type        = mjolnir::Topology;
+    using molecule_id_type     = typename topology_type::molecule_id_type;
+    using connection_kind_type = typename topology_type::connection_kind_type;
+
+    explicit dummy_potential(const real_type cutoff,
+                             const std::vector<std::size_t>& participants)
+        : cutoff_(cutoff), participants_(participants)
+    {}
+
+    real_type max_cutoff_length() const noexcept {return this->cutoff_;}
+
+    pair_parameter_type prepare_params(std::size_t, std::size_t) const noexcept
+    {
+        return pair_parameter_type{};
+    }
+
+    bool is_ignored_molecule(std::size_t, std::size_t) const {return false;}
+    bool is_ignored_group   (std::string, std::string) const {return false;}
+
+    std::vector<std::pair<connection_kind_type, std::size_t>> ignore_within() const
+    {
+        return std::vector<std::pair<connection_kind_type, std::size_t>>{};
+    }
+
+    std::vector<std::size_t> const& participants() const noexcept
+    {
+        return this->participants_;
+    }
+    mjolnir::range<typename std::vector<std::size_t>::const_iterator>
+    leading_participants() const noexcept
+    {
+        return mjolnir::make_range(participants_.begin(), std::prev(participants_.end()));
+    }
+    mjolnir::range<typename std::vector<std::size_t>::const_iterator>
+    possible_partners_of(const std::size_t participant_idx,
+                         const std::size_t /*particle_idx*/) const noexcept
+    {
+        return mjolnir::make_range(participants_.begin() + participant_idx + 1,
+                                   participants_.end());
+    }
+    bool has_interaction(const std::size_t i, const std::size_t j) const noexcept
+    {
+        return (i < j);
+    }
+
+    std::string name() const {return "dummy potential";}
+
+    real_type cutoff_;
+    std::vector<std::size_t> participants_;
+};
+
+// the time advances only when it is told to.
+struct fake_clock
+{
+    using rep        = std::int64_t;
+    using period     = std::micro;
+    using duration   = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<fake_clock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {return time_point(duration(current));}
+    static void advance(const rep us) noexcept {current += us;}
+
+    static rep current;
+};
+fake_clock::rep fake_clock::current = 0;
+
+BOOST_AUTO_TEST_CASE(test_SpatialPartitionTuner_chooses_fastest)
+{
+    mjolnir::LoggerManager::set_default_logger("test_spatial_partition_tuner.log");
+    using traits_type     = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using real_type       = typename traits_type::real_type;
+    using potential_type  = dummy_potential<real_type>;
+    using base_type       = mjolnir::SpatialPartitionBase<traits_type, potential_type>;
+    using tuner_type      = mjolnir::SpatialPartitionTuner<base_type, fake_clock>;
+    using candidate_type  = typename tuner_type::candidate_type;
+
+    std::vector<candidate_type> candidates;
+    candidates.emplace_back("VerletList", mjolnir::make_unique<
+        mjolnir::VerletList<traits_type, potential_type>>(0.5));
+    candidates.emplace_back("CellList", mjolnir::make_unique<
+        mjolnir::UnlimitedGridCellList<traits_type, potential_type>>(0.25));
+    candidates.emplace_back("slow VerletList", mjolnir::make_unique<
+        mjolnir::VerletList<traits_type, potential_type>>(0.1));
+
+    // [us] spent by the interaction in each step with each candidate
+    const std::map<std::string, fake_clock::rep> costs = {
+        {"VerletList", 300}, {"CellList", 100}, {"slow VerletList", 500}
+    };
+
+    constexpr std::size_t trial_steps = 3;
+    tuner_type tuner(std::move(candidates), trial_steps, 0);
+    auto partition = tuner.start();
+    BOOST_TEST(tuner.tuning());
+    BOOST_TEST(tuner.current() == "VerletList");
+    BOOST_TEST(partition->margin() == 0.5);
+
+    std::size_t switched = 0;
+    for(std::size_t step=0; step < 3 * (trial_steps + 1) + 10; ++step)
+    {
+        if(auto next = tuner.step())
+        {
+            partition = std::move(next);
+            switched += 1;
+        }
+        {
+            const auto timer = tuner.timer();
+            fake_clock::advance(costs.at(tuner.current()));
+        }
+        // time outside of the timer (e.g. other interactions) is not counted
+        fake_clock::advance(10000);
+    }
+    BOOST_TEST(switched == 3u); // to CellList, to slow VerletList, and to the best
+    BOOST_TEST(!tuner.tuning());
+    BOOST_TEST(tuner.current() == "CellList");
+    BOOST_TEST(partition->margin() == 0.25);
+
+    BOOST_TEST(tuner.elapsed().at(0) == 300e-6, boost::test_tools::tolerance(1e-8));
+    BOOST_TEST(tuner.elapsed().at(1) == 100e-6, boost::test_tools::tolerance(1e-8));
+    BOOST_TEST(tuner.elapsed().at(2) == 500e-6, boost::test_tools::tolerance(1e-8));
+
+    // after tuning, the timer does not count.
+    {
+        const auto timer = tuner.timer();
+        fake_clock::advance(1000);
+    }
+    BOOST_TEST(!tuner.tuning());
+}
+
+BOOST_AUTO_TEST_CASE(test_SpatialPartition_with_tuner)
+{
+    mjolnir::LoggerManager::set_default_logger("test_spatial_partition_tuner.log");
+    using traits_type     = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using real_type       = typename traits_type::real_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using potential_type  = dummy_potential<real_type>;
+    using partition_type  = mjolnir::SpatialPartition<traits_type, potential_type>;
+    using tuner_type      = typename partition_type::tuner_type;
+    using candidate_type  = typename tuner_type::candidate_type;
+
+    constexpr std::size_t N = 64;
+    constexpr double cutoff = 2.0;
+
+    std::vector<std::size_t> participants(N);
+    std::iota(participants.begin(), participants.end(), 0);
+    potential_type pot(cutoff, participants);
+
+    mjolnir::System<traits_type> sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.at(i).mass     = 1.0;
+        sys.at(i).position = coordinate_type(1.0 * (i % 4), 1.0 * ((i / 4) % 4), 1.0 * (i / 16));
+    }
+
+    std::vector<candidate_type> candidates;
+    candidates.emplace_back("VerletList", mjolnir::make_unique<
+        mjolnir::VerletList<traits_type, potential_type>>(0.5));
+    candidates.emplace_back("CellList", mjolnir::make_unique<
+        mjolnir::UnlimitedGridCellList<traits_type, potential_type>>(0.25));
+
+    constexpr std::size_t trial_steps = 3;
+    partition_type partition(mjolnir::make_unique<tuner_type>(
+                std::move(candidates), trial_steps, 0));
+    partition.initialize(sys, pot);
+
+    BOOST_TEST_REQUIRE(partition.tuner() != nullptr);
+    BOOST_TEST(partition.tuner()->tuning());
+    BOOST_TEST(partition.tuner()->current() == "VerletList");
+
+    std::size_t switched = 0;
+    for(std::size_t step=0; step < 2 * (trial_steps + 1) + 10; ++step)
+    {
+        if(partition.reduce_margin(0.0, sys, pot))
+        {
+            switched += 1;
+        }
+    }
+    BOOST_TEST(switched == 2u); // to CellList, and to the best
+    BOOST_TEST(!partition.tuner()->tuning());
+
+    // the neighbor list is constructed by the chosen one.
+    for(const auto i : pot.leading_participants())
+    {
+        const auto partners = partition.partners(i);
+        for(std::size_t j=i+1; j<N; ++j)
+        {
+            const auto dist = mjolnir::math::length(sys.adjust_direction(
+                        sys.position(i), sys.position(j)));
+            const bool found = std::find_if(partners.begin(), partners.end(),
+                [=](const typename partition_type::neighbor_type& elem) -> bool {
+                    return elem.index == j;
+                }) != partners.end();
+            if(dist < cutoff)
+            {
+                BOOST_TEST(found);
+            }
+        }
+    }
+
+    // copy keeps the state of the tuner
+    partition_type copied(partition);
+    BOOST_TEST_REQUIRE(copied.tuner() != nullptr);
+    BOOST_TEST(copied.tuner()->current() == partition.tuner()->current());
+    BOOST_TEST(copied.margin() == partition.margin());
+}
@@ -0,0 +1,262 @@
+#define BOOST_TEST_MODULE "test_spline_pair_table"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/forcefield/global/SplinePairTable.hpp>
+#include <mjolnir/forcefield/global/DebyeHuckelPotential.hpp>
+#include <mjolnir/forcefield/global/GlobalPairInteraction.hpp>
+#include <mjolnir/forcefield/iSoLF/iSoLFAttractivePotential.hpp>
+#include <mjolnir/core/NaivePairCalculation.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/util/make_unique.hpp>
+#include <mjolnir/util/logger.hpp>
+#include <random>
+
+using traits_type      = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+using real_type        = typename traits_type::real_type;
+using coordinate_type  = typename traits_type::coordinate_type;
+using boundary_type    = typename traits_type::boundary_type;
+using system_type      = mjolnir::System<traits_type>;
+using molecule_id_type = mjolnir::Topology::molecule_id_type;
+using group_id_type    = mjolnir::Topology::group_id_type;
+
+// all the pairs of participants are partners.
+template<typename potentialT>
+struct all_pairs
+{
+    using neighbor_type = mjolnir::neighbor_element<
+        typename potentialT::pair_parameter_type>;
+
+    explicit all_pairs(const potentialT& pot)
+        : leading(pot.participants()), partners_(pot.participants().size())
+    {
+        const auto& ps = pot.participants();
+        for(std::size_t i=0; i<ps.size(); ++i)
+        {
+            for(std::size_t j=i+1; j<ps.size(); ++j)
+            {
+                partners_[ps[i]].emplace_back(ps[j], pot.prepare_params(ps[i], ps[j]));
+            }
+        }
+    }
+    std::vector<std::size_t> const& leading_participants() const noexcept {return leading;}
+    std::vector<neighbor_type> const& partners(std::size_t i) const noexcept {return partners_[i];}
+
+    std::vector<std::size_t>                leading;
+    std::vector<std::vector<neighbor_type>> partners_;
+};
+
+void set_unit_system()
+{
+    using phys_type = mjolnir::physics::constants<real_type>;
+    using unit_type = mjolnir::unit::constants<real_type>;
+
+    phys_type::set_kB(unit_type::boltzmann_constant() *
+                      1e-3 * unit_type::J_to_cal() * unit_type::avogadro_constant());
+    phys_type::set_NA(unit_type::avogadro_constant());
+    phys_type::set_eps0((unit_type::vacuum_permittivity() /
+        unit_type::elementary_charge()) / unit_type::elementary_charge() *
+        (1e+3 / unit_type::J_to_cal() / unit_type::avogadro_constant()) *
+        (1.0 / unit_type::m_to_angstrom()));
+
+    phys_type::set_m_to_length(1e-10);
+    phys_type::set_length_to_m(1e+10);
+    phys_type::set_L_to_volume(1e+27);
+    phys_type::set_volume_to_L(1e-27);
+    return;
+}
+
+// compare the table with the analytic potential in [r_min, 1.2 rc]. The error
+// is relative to the largest absolute value in the range.
+template<typename potentialT, typename partitionT>
+void check_table(const potentialT& pot, const partitionT& partition,
+                 const mjolnir::SplinePairTable<potentialT>& table,
+                 const real_type tolerance)
+{
+    constexpr std::size_t N = 10000;
+    const real_type r_min = table.min_distance();
+    const real_type r_max = 1.2 * pot.max_cutoff_length();
+    const real_type dr    = (r_max - r_min) / N;
+
+    for(const auto i : partition.leading_participants())
+    {
+        for(const auto& ptnr : partition.partners(i))
+        {
+            const auto& p  = ptnr.parameter();
+            const auto idx = table.parameter(p);
+
+            real_type max_e = 0.0, max_f = 0.0, err_e = 0.0, err_f = 0.0;
+            for(std::size_t k=0; k<N; ++k)
+            {
+                const real_type r = r_min + k * dr;
+                const real_type e = pot.potential (r, p);
+                const real_type f = pot.derivative(r, p) / r;
+                max_e = std::max(max_e, std::abs(e));
+                max_f = std::max(max_f, std::abs(f));
+                err_e = std::max(err_e, std::abs(table.energy(r * r, idx) - e));
+                err_f = std::max(err_f, std::abs(table.force (r * r, idx) - f));
+            }
+            BOOST_TEST(err_e <= 2 * tolerance * max_e);
+            BOOST_TEST(err_f <= 2 * tolerance * max_f);
+        }
+    }
+    return;
+}
+
+BOOST_AUTO_TEST_CASE(SplinePairTable_DebyeHuckel)
+{
+    mjolnir::LoggerManager::set_default_logger("test_spline_pair_table.log");
+    using potential_type = mjolnir::DebyeHuckelPotential<traits_type>;
+    set_unit_system();
+
+    system_type sys(4, boundary_type{});
+    sys.attribute("temperature")    = 300.0;
+    sys.attribute("ionic_strength") =   0.1;
+
+    mjolnir::Topology top(4);
+    top.construct_molecules();
+
+    potential_type dh(potential_type::default_cutoff(),
+        {{0u, 1.0}, {1u, -1.0}, {2u, -0.6}, {3u, -0.6}}, {},
+        mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+        mjolnir::IgnoreGroup   <group_id_type   >({}));
+    dh.initialize(sys, top);
+
+    const real_type tolerance = 1e-6;
+    mjolnir::SplinePairTable<potential_type> table(2.0, tolerance);
+    BOOST_TEST(table.enabled());
+
+    all_pairs<potential_type> partition(dh);
+    table.make(dh, partition);
+
+    // (+1, -1), (+1, -0.6), (-1, -0.6), (-0.6, -0.6)
+    BOOST_TEST(table.num_tables() == 4u);
+    check_table(dh, partition, table, tolerance);
+
+    // the ionic strength changes the debye length and the cutoff.
+    sys.attribute("ionic_strength") = 0.2;
+    dh.update(sys, top);
+    all_pairs<potential_type> updated(dh);
+    table.make(dh, updated);
+    BOOST_TEST(table.num_tables() == 4u);
+    check_table(dh, updated, table, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(SplinePairTable_iSoLF)
+{
+    mjolnir::LoggerManager::set_default_logger("test_spline_pair_table.log");
+    using potential_type = mjolnir::iSoLFAttractivePotential<traits_type>;
+    using parameter_type = potential_type::parameter_type;
+
+    system_type sys(3, boundary_type{});
+    mjolnir::Topology top(3);
+    top.construct_molecules();
+
+    potential_type isolf{
+        {{0, parameter_type{3.0, 1.0, 1.0}},
+         {1, parameter_type{3.0, 1.0, 1.0}},
+         {2, parameter_type{4.0, 0.8, 1.5}}}, {},
+        mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+        mjolnir::IgnoreGroup   <group_id_type   >({})
+    };
+    isolf.initialize(sys, top);
+
+    // the force has a kink at r = 2^(1/6) sigma, so the error decreases
+    // only linearly with the number of intervals.
+    const real_type tolerance = 1e-4;
+    mjolnir::SplinePairTable<potential_type> table(1.0, tolerance);
+
+    all_pairs<potential_type> partition(isolf);
+    table.make(isolf, partition);
+    BOOST_TEST(table.num_tables() == 2u);
+    check_table(isolf, partition, table, tolerance);
+}
+
+// GlobalPairInteraction with a table gives the same forces within the tolerance.
+BOOST_AUTO_TEST_CASE(SplinePairTable_GlobalPairInteraction)
+{
+    mjolnir::LoggerManager::set_default_logger("test_spline_pair_table.log");
+    using potential_type   = mjolnir::DebyeHuckelPotential<traits_type>;
+    using partition_type   = mjolnir::NaivePairCalculation<traits_type, potential_type>;
+    using interaction_type = mjolnir::GlobalPairInteraction<traits_type, potential_type>;
+    set_unit_system();
+
+    constexpr std::size_t N = 64;
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(0.0, 30.0);
+
+    system_type sys(N, boundary_type{});
+    sys.attribute("temperature")    = 300.0;
+    sys.attribute("ionic_strength") =   0.1;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        // keep particles apart by more than min_distance
+        bool too_close = true;
+        while(too_close)
+        {
+            sys.position(i) = coordinate_type(uni(mt), uni(mt), uni(mt));
+            too_close = false;
+            for(std::size_t j=0; j<i; ++j)
+            {
+                too_close = too_close || mjolnir::math::length(
+                    sys.position(i) - sys.position(j)) < 3.0;
+            }
+        }
+        sys.mass(i)  = 1.0;
+        sys.rmass(i) = 1.0;
+        sys.name(i)  = "X";
+        sys.group(i) = "NONE";
+    }
+    system_type sys_ref(sys);
+
+    mjolnir::Topology top(N);
+    top.construct_molecules();
+
+    std::vector<std::pair<std::size_t, real_type>> charges;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        charges.emplace_back(i, (i % 3 == 0) ? 1.0 : -0.6);
+    }
+    const auto make_potential = [&charges]() {
+        return potential_type(potential_type::default_cutoff(), charges, {},
+            mjolnir::IgnoreMolecule<molecule_id_type>("Nothing"),
+            mjolnir::IgnoreGroup   <group_id_type   >({}));
+    };
+
+    interaction_type interaction_ref(make_potential(),
+        mjolnir::SpatialPartition<traits_type, potential_type>(
+            mjolnir::make_unique<partition_type>()));
+    interaction_type interaction(make_potential(),
+        mjolnir::SpatialPartition<traits_type, potential_type>(
+            mjolnir::make_unique<partition_type>()),
+        mjolnir::SplinePairTable<potential_type>(2.0, 1e-7));
+
+    interaction_ref.initialize(sys_ref, top);
+    interaction    .initialize(sys,     top);
+
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys    .force(i) = coordinate_type(0.0, 0.0, 0.0);
+        sys_ref.force(i) = coordinate_type(0.0, 0.0, 0.0);
+    }
+    const real_type energy_ref = interaction_ref.calc_force_and_energy(sys_ref);
+    const real_type energy     = interaction    .calc_force_and_energy(sys);
+
+    BOOST_TEST(energy == energy_ref, boost::test_tools::tolerance(1e-5));
+
+    real_type fmax = 0.0;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        fmax = std::max(fmax, mjolnir::math::length(sys_ref.force(i)));
+    }
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const auto df = sys.force(i) - sys_ref.force(i);
+        BOOST_TEST(mjolnir::math::length(df) <= 1e-5 * fmax);
+    }
+}
@@ -17,7 +17,7 @@ BOOST_AUTO_TEST_CASE(WCA_double)
     using molecule_id_type = mjolnir::Topology::molecule_id_type;
     using group_id_type    = mjolnir::Topology::group_id_type;
     using potential_type   = mjolnir::TabulatedWCAPotential<traits_type>;
-    using parameter_type   = potential_type::pair_parameter_type;
+    using parameter_type   = potential_type::table_value_type;
 
     constexpr static std::size_t N = 10000;
     constexpr static real_type   h = 1e-6;
@@ -0,0 +1,87 @@
+#define BOOST_TEST_MODULE "test_type_pair_parameter_matrix"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/forcefield/global/TypePairParameterMatrix.hpp>
+
+BOOST_AUTO_TEST_CASE(TypePairParameterMatrix_build)
+{
+    using value_type  = std::pair<double, double>;
+    using matrix_type = mjolnir::TypePairParameterMatrix<value_type>;
+
+    const std::vector<std::string> names{"A", "B", "A", "C", "B"};
+    matrix_type::table_type table;
+    table["A:A"] = value_type(1.0, 0.1);
+    table["A:B"] = value_type(2.0, 0.2);
+    table["B:A"] = value_type(2.0, 0.2);
+    table["B:B"] = value_type(3.0, 0.3);
+
+    matrix_type matrix;
+    matrix.build(names, table);
+
+    BOOST_TEST(matrix.number_of_types() == 3u);
+    BOOST_TEST(matrix.type_ids().at(0) == 0u);
+    BOOST_TEST(matrix.type_ids().at(1) == 1u);
+    BOOST_TEST(matrix.type_ids().at(2) == 0u);
+    BOOST_TEST(matrix.type_ids().at(3) == 2u);
+    BOOST_TEST(matrix.type_ids().at(4) == 1u);
+
+    BOOST_TEST(matrix.pair_id(0, 2) == matrix.pair_id(2, 0));
+    BOOST_TEST(matrix.pair_id(1, 4) == matrix.pair_id(4, 1));
+
+    BOOST_TEST(matrix.at(matrix.pair_id(0, 2)).first  == 1.0);
+    BOOST_TEST(matrix.at(matrix.pair_id(0, 1)).first  == 2.0);
+    BOOST_TEST(matrix.at(matrix.pair_id(4, 2)).first  == 2.0);
+    BOOST_TEST(matrix.at(matrix.pair_id(1, 4)).second == 0.3);
+    BOOST_TEST(matrix[matrix.pair_id(1, 4)].second    == 0.3);
+
+    // C is not in the table
+    BOOST_TEST(!matrix.is_defined(matrix.pair_id(0, 3)));
+    BOOST_TEST(matrix.pair_name(matrix.pair_id(0, 3)) == "A:C");
+    BOOST_CHECK_THROW(matrix.at(matrix.pair_id(3, 3)), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(TypePairParameterMatrix_intern)
+{
+    using value_type  = std::pair<double, double>;
+    using matrix_type = mjolnir::TypePairParameterMatrix<value_type>;
+
+    // types are interned incrementally, as the input reader does.
+    matrix_type matrix;
+    const auto A = matrix.add_type("A");
+    matrix.set(A, A, value_type(1.0, 0.1));
+    const auto B = matrix.add_type("B");
+    matrix.set(A, B, value_type(2.0, 0.2));
+    matrix.set(B, A, value_type(2.0, 0.2));
+    const auto C = matrix.add_type("C");
+    matrix.set(C, C, value_type(4.0, 0.4));
+
+    BOOST_TEST(matrix.add_type("B") == B);
+    BOOST_TEST(matrix.number_of_types() == 3u);
+    BOOST_TEST(matrix.size() == 9u);
+    BOOST_TEST( matrix.has_type("C"));
+    BOOST_TEST(!matrix.has_type("D"));
+    BOOST_TEST(matrix.type_id("C") == C);
+    BOOST_CHECK_THROW(matrix.type_id("D"), std::out_of_range);
+    BOOST_CHECK_THROW(matrix.set(A, 3, value_type(0.0, 0.0)), std::out_of_range);
+
+    matrix.set_particle_type(0, B);
+    matrix.set_particle_type(3, A);
+    matrix.set_particle_type(1, C);
+    BOOST_TEST(matrix.type_ids().size() == 4u);
+    BOOST_TEST(matrix.type_of(3) == A);
+    BOOST_TEST(matrix.type_name_of(1) == "C");
+
+    // values set before adding a type are kept
+    BOOST_TEST(matrix.pair_id(0, 3) == matrix.pair_id_of_types(B, A));
+    BOOST_TEST(matrix.at(matrix.pair_id_of_types(A, A)).first == 1.0);
+    BOOST_TEST(matrix.at(matrix.pair_id(0, 3)).first          == 2.0);
+    BOOST_TEST(matrix.at(matrix.pair_id(3, 0)).second         == 0.2);
+    BOOST_TEST(matrix.at(matrix.pair_id(1, 1)).first          == 4.0);
+    BOOST_TEST(!matrix.is_defined(matrix.pair_id(0, 0)));
+    BOOST_TEST(!matrix.is_defined(matrix.pair_id(1, 3)));
+}
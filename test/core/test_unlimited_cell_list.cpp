@@ -369,3 +369,164 @@ BOOST_AUTO_TEST_CASE(test_CellList_UnlimitedBoundary_clone)
 
     BOOST_TEST(vlist.margin() == vlist2.margin());
 }
+
+BOOST_AUTO_TEST_CASE(test_UnlimitedGridCellList_half_shell)
+{
+    mjolnir::LoggerManager::set_default_logger("test_cell_list.log");
+    using traits_type     = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using real_type       = typename traits_type::real_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using potential_type  = dummy_potential<real_type>;
+
+    constexpr std::size_t N = 1000;
+    constexpr double      L = 10.0;
+    constexpr double cutoff = 1.0;
+    constexpr double margin = 0.5;
+
+    const auto distribute_particle = [](std::mt19937& mt, double l) -> coordinate_type
+    {
+        return coordinate_type(
+            l * std::generate_canonical<real_type, std::numeric_limits<real_type>::digits>(mt),
+            l * std::generate_canonical<real_type, std::numeric_limits<real_type>::digits>(mt),
+            l * std::generate_canonical<real_type, std::numeric_limits<real_type>::digits>(mt)
+        );
+    };
+
+    std::vector<std::size_t> participants; participants.reserve(500);
+    for(std::size_t i=0; i<500; ++i)
+    {
+        participants.push_back(i * 2);
+    }
+    dummy_potential<real_type> pot(cutoff, participants);
+
+    mjolnir::System<traits_type> sys(N, boundary_type{});
+
+    std::mt19937 mt(123456789);
+    for(std::size_t i=0; i < N; ++i)
+    {
+        sys.at(i).mass     = 1.0;
+        sys.at(i).position = distribute_particle(mt, L);
+    }
+
+    mjolnir::SpatialPartition<traits_type, potential_type> full(mjolnir::make_unique<
+            mjolnir::UnlimitedGridCellList<traits_type, potential_type>>(margin,
+                mjolnir::CellListStencil::Full));
+    mjolnir::SpatialPartition<traits_type, potential_type> half(mjolnir::make_unique<
+            mjolnir::UnlimitedGridCellList<traits_type, potential_type>>(margin,
+                mjolnir::CellListStencil::Half));
+
+    full.initialize(sys, pot);
+    half.initialize(sys, pot);
+
+    // move some of the particles and rebuild the list
+    for(std::size_t step=0; step<3; ++step)
+    {
+        for(std::size_t i=0; i<N; i+=7)
+        {
+            sys.position(i) = distribute_particle(mt, L);
+        }
+        full.make(sys, pot);
+        half.make(sys, pot);
+
+        for(const auto i : pot.leading_participants())
+        {
+            const auto partners_full = full.partners(i);
+            const auto partners_half = half.partners(i);
+            BOOST_TEST_REQUIRE(partners_full.size() == partners_half.size());
+            for(std::size_t k=0; k<partners_full.size(); ++k)
+            {
+                BOOST_TEST(partners_full[k].index == partners_half[k].index);
+            }
+        }
+    }
+
+    // clone keeps the stencil
+    mjolnir::SpatialPartition<traits_type, potential_type> half2(half);
+    half2.initialize(sys, pot);
+    for(const auto i : pot.leading_participants())
+    {
+        BOOST_TEST(half2.partners(i).size() == half.partners(i).size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_UnlimitedGridCellList_sparse)
+{
+    mjolnir::LoggerManager::set_default_logger("test_cell_list.log");
+    using traits_type     = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using real_type       = typename traits_type::real_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using potential_type  = dummy_potential<real_type>;
+    using partition_type  = mjolnir::UnlimitedGridCellList<traits_type, potential_type>;
+
+    constexpr std::size_t N = 1000;
+    constexpr double cutoff = 2.0;
+    constexpr double margin = 0.25;
+    constexpr double threshold = cutoff * (1.0 + margin);
+
+    // small clusters scattered in a region that spans hundreds of cutoffs.
+    // the clusters are placed so that some of them are exactly 8 cells away.
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(-3.0, 3.0);
+    std::uniform_int_distribution<int> lattice(-50, 50);
+
+    std::vector<coordinate_type> centers;
+    for(std::size_t c=0; c<N/10; ++c)
+    {
+        centers.push_back(coordinate_type(
+            8 * threshold * lattice(mt), 8 * threshold * lattice(mt),
+            8 * threshold * lattice(mt)));
+    }
+
+    std::vector<std::size_t> participants(N);
+    std::iota(participants.begin(), participants.end(), 0u);
+    potential_type pot(cutoff, participants);
+
+    mjolnir::System<traits_type> sys(N, boundary_type{});
+    for(std::size_t i=0; i < N; ++i)
+    {
+        sys.at(i).mass     = 1.0;
+        sys.at(i).position = centers.at(i / 10) +
+                             coordinate_type(uni(mt), uni(mt), uni(mt));
+    }
+    // a particle that is extremely far away
+    sys.position(N-1) = coordinate_type(1e10, -1e10, 1e10);
+
+    for(const auto stencil : {mjolnir::CellListStencil::Full,
+                              mjolnir::CellListStencil::Half})
+    {
+        auto partition = mjolnir::make_unique<partition_type>(margin, stencil);
+        const auto& cells = *partition;
+        mjolnir::SpatialPartition<traits_type, potential_type> vlist(std::move(partition));
+        vlist.initialize(sys, pot);
+
+        // the system expands and rebuild the list
+        for(std::size_t step=0; step<2; ++step)
+        {
+            BOOST_TEST(cells.num_cells() <= N);
+            for(const auto i : pot.leading_participants())
+            {
+                const auto partners = vlist.partners(i);
+                std::size_t num_partners = 0;
+                for(std::size_t j=i+1; j<N; ++j)
+                {
+                    const auto dist = mjolnir::math::length(sys.adjust_direction(
+                                sys.position(i), sys.position(j)));
+                    if(dist < threshold) {++num_partners;}
+                }
+                BOOST_TEST(partners.size() == num_partners);
+                for(const auto& p : partners)
+                {
+                    BOOST_TEST(mjolnir::math::length(sys.adjust_direction(
+                        sys.position(i), sys.position(p.index))) < threshold);
+                }
+            }
+            for(std::size_t i=0; i+1<N; ++i)
+            {
+                sys.position(i) *= 3.0;
+            }
+            vlist.make(sys, pot);
+        }
+    }
+}
@@ -0,0 +1,214 @@
+#define BOOST_TEST_MODULE "test_velocity_verlet_integrator"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/ForceField.hpp>
+#include <mjolnir/core/VerletList.hpp>
+#include <mjolnir/core/NaivePairCalculation.hpp>
+#include <mjolnir/core/VelocityVerletIntegrator.hpp>
+#include <mjolnir/forcefield/local/HarmonicPotential.hpp>
+#include <mjolnir/forcefield/local/BondLengthInteraction.hpp>
+#include <mjolnir/forcefield/global/GlobalPairLennardJonesInteraction.hpp>
+#include <mjolnir/util/make_unique.hpp>
+
+#include <random>
+
+using traits_type      = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+using real_type        = typename traits_type::real_type;
+using coordinate_type  = typename traits_type::coordinate_type;
+using boundary_type    = typename traits_type::boundary_type;
+using system_type      = mjolnir::System<traits_type>;
+using forcefield_type  = std::unique_ptr<mjolnir::ForceFieldBase<traits_type>>;
+using rng_type         = mjolnir::RandomNumberGenerator<traits_type>;
+using remover_type     = mjolnir::SystemMotionRemover<traits_type>;
+using integrator_type  = mjolnir::VelocityVerletIntegrator<traits_type>;
+
+namespace test
+{
+// a chain of harmonic bonds (local) with Lennard-Jones (global).
+// If `use_verlet_list` is false, it uses NaivePairCalculation as a reference.
+forcefield_type make_forcefield(const std::size_t N, const bool with_global,
+                                const bool use_verlet_list = true)
+{
+    using bond_potential_type = mjolnir::HarmonicPotential<real_type>;
+    using bond_type           = mjolnir::BondLengthInteraction<traits_type, bond_potential_type>;
+    using lj_potential_type   = mjolnir::LennardJonesPotential<traits_type>;
+    using lj_type             = mjolnir::GlobalPairInteraction<traits_type, lj_potential_type>;
+    using parameter_type      = typename lj_potential_type::parameter_type;
+
+    mjolnir::LocalForceField<traits_type> loc;
+    std::vector<std::pair<std::array<std::size_t, 2>, bond_potential_type>> bonds;
+    for(std::size_t i=0; i+1<N; ++i)
+    {
+        bonds.emplace_back(std::array<std::size_t, 2>{{i, i+1}},
+                           bond_potential_type(100.0, 1.0));
+    }
+    loc.emplace(mjolnir::make_unique<bond_type>("bond", std::move(bonds)));
+
+    mjolnir::GlobalForceField<traits_type> glo;
+    if(with_global)
+    {
+        std::vector<std::pair<std::size_t, parameter_type>> params;
+        for(std::size_t i=0; i<N; ++i)
+        {
+            params.emplace_back(i, parameter_type(1.0, 0.2));
+        }
+        lj_potential_type potential(lj_potential_type::default_cutoff(),
+            params, {}, typename lj_potential_type::ignore_molecule_type("Nothing"),
+                        typename lj_potential_type::ignore_group_type   ({}));
+
+        if(use_verlet_list)
+        {
+            glo.emplace(mjolnir::make_unique<lj_type>(std::move(potential),
+                mjolnir::SpatialPartition<traits_type, lj_potential_type>(
+                    mjolnir::make_unique<mjolnir::VerletList<traits_type,
+                        lj_potential_type>>(0.3))));
+        }
+        else
+        {
+            glo.emplace(mjolnir::make_unique<lj_type>(std::move(potential),
+                mjolnir::SpatialPartition<traits_type, lj_potential_type>(
+                    mjolnir::make_unique<mjolnir::NaivePairCalculation<traits_type,
+                        lj_potential_type>>())));
+        }
+    }
+    return mjolnir::make_unique<mjolnir::ForceField<traits_type>>(
+            std::move(loc), std::move(glo),
+            mjolnir::ExternalForceField<traits_type>{},
+            mjolnir::ConstraintForceField<traits_type>{});
+}
+
+system_type make_system(const std::size_t N)
+{
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> uni(-0.1, 0.1);
+    std::normal_distribution<real_type> gauss(0.0, 0.5);
+
+    // a zigzag chain so that non-bonded particles interact
+    system_type sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.mass(i)     = 1.0 + 0.1 * (i % 3);
+        sys.rmass(i)    = 1.0 / sys.mass(i);
+        sys.position(i) = coordinate_type(0.7 * i + uni(mt),
+                (i % 2 == 0 ? 0.0 : 0.7) + uni(mt), uni(mt));
+        sys.velocity(i) = coordinate_type(gauss(mt), gauss(mt), gauss(mt));
+        sys.force(i)    = coordinate_type(0.0, 0.0, 0.0);
+        sys.name(i)     = "X";
+        sys.group(i)    = "NONE";
+    }
+    return sys;
+}
+
+real_type total_energy(const system_type& sys, const forcefield_type& ff)
+{
+    real_type E = ff->calc_energy(sys);
+    for(std::size_t i=0; i<sys.size(); ++i)
+    {
+        E += 0.5 * sys.mass(i) * mjolnir::math::length_sq(sys.velocity(i));
+    }
+    return E;
+}
+} // test
+
+// without global forcefields, r-RESPA is the same as the normal Velocity Verlet.
+BOOST_AUTO_TEST_CASE(VelocityVerlet_multiple_time_step_local_only)
+{
+    mjolnir::LoggerManager::set_default_logger("test_velocity_verlet_integrator.log");
+    constexpr std::size_t N = 20;
+
+    auto sys1 = test::make_system(N);
+    auto sys3 = test::make_system(N);
+    auto ff1  = test::make_forcefield(N, false);
+    auto ff3  = test::make_forcefield(N, false);
+    rng_type rng(123456789);
+
+    integrator_type integrator1(0.005, remover_type(false, false, false));
+    integrator_type integrator3(0.005, remover_type(false, false, false), 3);
+    BOOST_TEST(integrator1.global_interval() == 1u);
+    BOOST_TEST(integrator3.global_interval() == 3u);
+
+    ff1->initialize(sys1);
+    ff3->initialize(sys3);
+    integrator1.initialize(sys1, ff1, rng);
+    integrator3.initialize(sys3, ff3, rng);
+
+    real_type t1 = 0.0, t3 = 0.0;
+    for(std::size_t step=0; step<300; ++step)
+    {
+        t1 = integrator1.step(t1, sys1, ff1, rng);
+        t3 = integrator3.step(t3, sys3, ff3, rng);
+    }
+    BOOST_TEST(t1 == t3, boost::test_tools::tolerance(1e-12));
+    for(std::size_t i=0; i<N; ++i)
+    {
+        for(std::size_t d=0; d<3; ++d)
+        {
+            BOOST_TEST(sys1.position(i)[d] == sys3.position(i)[d],
+                       boost::test_tools::tolerance(1e-10));
+            BOOST_TEST(sys1.velocity(i)[d] == sys3.velocity(i)[d],
+                       boost::test_tools::tolerance(1e-10));
+        }
+    }
+}
+
+// with global forcefields, it conserves energy and keeps the neighbor list
+// valid while the global forces are not calculated.
+BOOST_AUTO_TEST_CASE(VelocityVerlet_multiple_time_step_global)
+{
+    mjolnir::LoggerManager::set_default_logger("test_velocity_verlet_integrator.log");
+    constexpr std::size_t N = 20;
+    constexpr std::size_t k = 2;
+
+    auto sys    = test::make_system(N);
+    auto ff     = test::make_forcefield(N, true);
+    auto ref_ff = test::make_forcefield(N, true, /* verlet list = */ false);
+    rng_type rng(123456789);
+
+    integrator_type integrator(0.002, remover_type(false, false, false), k);
+    ff    ->initialize(sys);
+    ref_ff->initialize(sys);
+    integrator.initialize(sys, ff, rng);
+
+    const real_type E0 = test::total_energy(sys, ref_ff);
+
+    // force(i) contains the total force just after the slow forces are updated
+    {
+        auto ref_sys = sys;
+        for(std::size_t i=0; i<N; ++i)
+        {
+            ref_sys.force(i) = coordinate_type(0.0, 0.0, 0.0);
+        }
+        ref_ff->calc_force(ref_sys);
+        for(std::size_t i=0; i<N; ++i)
+        {
+            for(std::size_t d=0; d<3; ++d)
+            {
+                BOOST_TEST(sys.force(i)[d] == ref_sys.force(i)[d],
+                           boost::test_tools::tolerance(1e-10));
+            }
+        }
+    }
+
+    real_type t = 0.0;
+    real_type max_drift = 0.0;
+    for(std::size_t step=1; step<=2000; ++step)
+    {
+        t = integrator.step(t, sys, ff, rng);
+        if(step % k == 0)
+        {
+            BOOST_TEST(ff->calc_energy(sys) == ref_ff->calc_energy(sys),
+                       boost::test_tools::tolerance(1e-10));
+            max_drift = std::max(max_drift,
+                    std::abs(test::total_energy(sys, ref_ff) - E0));
+        }
+    }
+    BOOST_TEST(t == 2000 * 0.002, boost::test_tools::tolerance(1e-10));
+    BOOST_TEST(max_drift < 1e-2 * std::abs(E0));
+}
@@ -0,0 +1,234 @@
+#define BOOST_TEST_MODULE "test_omp_force_reduction"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/math/math.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/RandomNumberGenerator.hpp>
+#include <mjolnir/omp/UnlimitedGridCellList.hpp>
+#include <mjolnir/omp/GlobalPairLennardJonesInteraction.hpp>
+#include <mjolnir/util/make_unique.hpp>
+
+BOOST_AUTO_TEST_CASE(omp_force_reduction_thread_local_forces)
+{
+    mjolnir::LoggerManager::set_default_logger("test_omp_force_reduction.log");
+
+    using traits_type     = mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using system_type     = mjolnir::System<traits_type>;
+
+    const std::size_t N = 1000; // 4 blocks, the last one is partially used
+
+    for(const auto reduction : {mjolnir::ForceReduction::ThreadLocal,
+                                mjolnir::ForceReduction::BlockSparse})
+    {
+        system_type sys(N, boundary_type{}, reduction);
+        BOOST_TEST(sys.force_reduction() == reduction);
+        for(std::size_t i=0; i<N; ++i)
+        {
+            sys.force(i) = mjolnir::math::make_coordinate<coordinate_type>(1.0, 0, 0);
+        }
+
+        // each thread adds (thread_id + 1) to every 3rd particle. With
+        // BlockSparse, the blocks for the other particles are still touched.
+#pragma omp parallel for
+        for(std::size_t i=0; i<N; i+=3)
+        {
+            const auto thread_id = omp_get_thread_num();
+            sys.force_thread(thread_id, i) +=
+                mjolnir::math::make_coordinate<coordinate_type>(0, 1.0, 2.0);
+        }
+        sys.postprocess_forces();
+
+        for(std::size_t i=0; i<N; ++i)
+        {
+            const double expected = (i % 3 == 0) ? 1.0 : 0.0;
+            BOOST_TEST(mjolnir::math::X(sys.force(i)) == 1.0);
+            BOOST_TEST(mjolnir::math::Y(sys.force(i)) == expected);
+            BOOST_TEST(mjolnir::math::Z(sys.force(i)) == expected * 2);
+        }
+
+        // thread-local forces are cleared after merging
+        for(int thread_id=0; thread_id<omp_get_max_threads(); ++thread_id)
+        {
+            for(std::size_t i=0; i<N; ++i)
+            {
+                const auto& f = static_cast<const system_type&>(sys).force_thread(thread_id, i);
+                BOOST_TEST(mjolnir::math::X(f) == 0.0);
+                BOOST_TEST(mjolnir::math::Y(f) == 0.0);
+                BOOST_TEST(mjolnir::math::Z(f) == 0.0);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(omp_force_reduction_release_idle_blocks)
+{
+    mjolnir::LoggerManager::set_default_logger("test_omp_force_reduction.log");
+
+    using traits_type     = mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using system_type     = mjolnir::System<traits_type>;
+
+    const std::size_t N = 1000; // 4 blocks
+    system_type sys(N, boundary_type{}, mjolnir::ForceReduction::BlockSparse);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.force(i) = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+    }
+
+    // thread 0 writes to all the blocks once, and then only to the first one.
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.force_thread(0, i) += mjolnir::math::make_coordinate<coordinate_type>(1.0, 0, 0);
+    }
+    sys.postprocess_forces();
+    BOOST_TEST(sys.num_force_blocks(0) == 4u);
+
+    for(std::size_t step=0; step<system_type::force_block_max_idle; ++step)
+    {
+        sys.force_thread(0, 0) += mjolnir::math::make_coordinate<coordinate_type>(1.0, 0, 0);
+        sys.postprocess_forces();
+    }
+    BOOST_TEST(sys.num_force_blocks(0) == 1u);
+
+    // released blocks can be used again
+    sys.force_thread(0, N-1) += mjolnir::math::make_coordinate<coordinate_type>(1.0, 0, 0);
+    sys.postprocess_forces();
+    BOOST_TEST(sys.num_force_blocks(0) == 2u);
+
+    const auto n0 = 1.0 + system_type::force_block_max_idle;
+    BOOST_TEST(mjolnir::math::X(sys.force(0))   == n0);
+    BOOST_TEST(mjolnir::math::X(sys.force(1))   == 1.0);
+    BOOST_TEST(mjolnir::math::X(sys.force(N-1)) == 2.0);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        const auto& f = static_cast<const system_type&>(sys).force_thread(0, i);
+        BOOST_TEST(mjolnir::math::X(f) == 0.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(omp_force_reduction_global_pair_interaction)
+{
+    constexpr double tol = 1e-8;
+    mjolnir::LoggerManager::set_default_logger("test_omp_force_reduction.log");
+
+    using traits_type      = mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using coordinate_type  = typename traits_type::coordinate_type;
+    using boundary_type    = typename traits_type::boundary_type;
+    using system_type      = mjolnir::System<traits_type>;
+    using topology_type    = mjolnir::Topology;
+    using potential_type   = mjolnir::LennardJonesPotential<traits_type>;
+    using parameter_type   = typename potential_type::parameter_type;
+    using partition_type   = mjolnir::UnlimitedGridCellList<traits_type, potential_type>;
+    using interaction_type = mjolnir::GlobalPairInteraction<traits_type, potential_type>;
+    using rng_type         = mjolnir::RandomNumberGenerator<traits_type>;
+
+    const std::size_t N_particle = 1000;
+
+    std::vector<std::pair<std::size_t, parameter_type>> parameters(N_particle);
+    for(std::size_t i=0; i<N_particle; ++i)
+    {
+        parameters[i] = std::make_pair(i, parameter_type{1.0, 1.0});
+    }
+
+    rng_type      rng(123456789);
+    topology_type topol(N_particle);
+    topol.construct_molecules();
+
+    system_type sys_ref(N_particle, boundary_type{}, mjolnir::ForceReduction::ThreadLocal);
+    system_type sys    (N_particle, boundary_type{}, mjolnir::ForceReduction::BlockSparse);
+    for(std::size_t i=0; i<N_particle; ++i)
+    {
+        const auto i_x = i % 10;
+        const auto i_y = i / 10 % 10;
+        const auto i_z = i / 100;
+
+        sys_ref.mass(i)     = 1.0;
+        sys_ref.position(i) = mjolnir::math::make_coordinate<coordinate_type>(
+                i_x * 1.2 + rng.uniform_real(-0.1, 0.1),
+                i_y * 1.2 + rng.uniform_real(-0.1, 0.1),
+                i_z * 1.2 + rng.uniform_real(-0.1, 0.1));
+        sys_ref.velocity(i) = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys_ref.force(i)    = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys_ref.name(i)     = "X";
+        sys_ref.group(i)    = "TEST";
+
+        sys.mass(i)     = sys_ref.mass(i);
+        sys.position(i) = sys_ref.position(i);
+        sys.velocity(i) = sys_ref.velocity(i);
+        sys.force(i)    = sys_ref.force(i);
+        sys.name(i)     = sys_ref.name(i);
+        sys.group(i)    = sys_ref.group(i);
+    }
+
+    const auto make_interaction = [&]() {
+        return interaction_type(potential_type(potential_type::default_cutoff(),
+                parameters, {},
+                typename potential_type::ignore_molecule_type("Nothing"),
+                typename potential_type::ignore_group_type({})),
+            mjolnir::SpatialPartition<traits_type, potential_type>(
+                mjolnir::make_unique<partition_type>()));
+    };
+    auto interaction_ref = make_interaction();
+    auto interaction     = make_interaction();
+    interaction_ref.initialize(sys_ref, topol);
+    interaction    .initialize(sys,     topol);
+
+    // run twice to check the blocks are re-used correctly
+    for(std::size_t step=0; step<2; ++step)
+    {
+        for(std::size_t i=0; i<N_particle; ++i)
+        {
+            sys_ref.force(i) = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+            sys    .force(i) = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        }
+        sys_ref.virial() = typename traits_type::matrix33_type(0,0,0, 0,0,0, 0,0,0);
+        sys    .virial() = typename traits_type::matrix33_type(0,0,0, 0,0,0, 0,0,0);
+
+        interaction_ref.calc_force(sys_ref);
+        sys_ref.postprocess_forces();
+        interaction.calc_force(sys);
+        sys.postprocess_forces();
+
+        for(std::size_t i=0; i<N_particle; ++i)
+        {
+            BOOST_TEST(mjolnir::math::X(sys_ref.force(i)) == mjolnir::math::X(sys.force(i)),
+                       boost::test_tools::tolerance(tol));
+            BOOST_TEST(mjolnir::math::Y(sys_ref.force(i)) == mjolnir::math::Y(sys.force(i)),
+                       boost::test_tools::tolerance(tol));
+            BOOST_TEST(mjolnir::math::Z(sys_ref.force(i)) == mjolnir::math::Z(sys.force(i)),
+                       boost::test_tools::tolerance(tol));
+        }
+        for(std::size_t i=0; i<9; ++i)
+        {
+            BOOST_TEST(sys.virial()[i] == sys_ref.virial()[i], boost::test_tools::tolerance(tol));
+        }
+    }
+
+    // switching the scheme keeps the results
+    sys.set_force_reduction(mjolnir::ForceReduction::ThreadLocal);
+    BOOST_TEST(sys.force_reduction() == mjolnir::ForceReduction::ThreadLocal);
+    for(std::size_t i=0; i<N_particle; ++i)
+    {
+        sys.force(i) = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+    }
+    interaction.calc_force(sys);
+    sys.postprocess_forces();
+    for(std::size_t i=0; i<N_particle; ++i)
+    {
+        BOOST_TEST(mjolnir::math::X(sys_ref.force(i)) == mjolnir::math::X(sys.force(i)),
+                   boost::test_tools::tolerance(tol));
+        BOOST_TEST(mjolnir::math::Y(sys_ref.force(i)) == mjolnir::math::Y(sys.force(i)),
+                   boost::test_tools::tolerance(tol));
+        BOOST_TEST(mjolnir::math::Z(sys_ref.force(i)) == mjolnir::math::Z(sys.force(i)),
+                   boost::test_tools::tolerance(tol));
+    }
+}
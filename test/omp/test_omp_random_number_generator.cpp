@@ -59,3 +59,129 @@ BOOST_AUTO_TEST_CASE(test_omp_random_number_generator)
         }
     }
 }
+
+// It tests that RandomNumberGenerator<OpenMPSimulatorTraits> generates the
+// same per-particle random vectors regardless of the number of threads.
+BOOST_AUTO_TEST_CASE(test_omp_random_number_generator_gaussian_vector)
+{
+    const int max_number_of_threads = omp_get_max_threads();
+    BOOST_TEST_WARN(max_number_of_threads > 2);
+    BOOST_TEST_MESSAGE("maximum number of threads = " << omp_get_max_threads());
+
+    mjolnir::LoggerManager::set_default_logger("test_omp_random_number_generator.log");
+
+    using traits_type     = mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using rng_type        = mjolnir::RandomNumberGenerator<traits_type>;
+
+    const std::uint32_t seed = 123456789;
+    const std::size_t   N    = 1000;
+    const std::size_t   M    = 3;
+
+    // reference, generated by a single thread
+    std::vector<std::vector<coordinate_type>> ref(M, std::vector<coordinate_type>(N));
+    {
+        omp_set_num_threads(1);
+        rng_type rng(seed);
+        for(std::size_t m=0; m<M; ++m)
+        {
+            rng.next_block();
+            for(std::size_t i=0; i<N; ++i)
+            {
+                ref[m][i] = rng.gaussian_vector(i);
+            }
+        }
+    }
+    for(std::size_t m=1; m<M; ++m) // different blocks give different vectors
+    {
+        BOOST_TEST(mjolnir::math::X(ref[m][0]) != mjolnir::math::X(ref[0][0]));
+    }
+
+    for(int num_thread=1; num_thread<=max_number_of_threads; ++num_thread)
+    {
+        omp_set_num_threads(num_thread);
+        rng_type rng(seed);
+        for(std::size_t m=0; m<M; ++m)
+        {
+            rng.next_block();
+
+            std::vector<coordinate_type> vs(N);
+#pragma omp parallel for schedule(dynamic, 7)
+            for(std::size_t i=0; i<N; ++i)
+            {
+                vs[i] = rng.gaussian_vector(i);
+            }
+            // the vectorized version may use a different math library
+            std::vector<coordinate_type> bs(N);
+            rng.gaussian_vectors(0, N, bs.data());
+            const auto tol = boost::test_tools::tolerance(1e-10);
+
+            for(std::size_t i=0; i<N; ++i)
+            {
+                BOOST_TEST(mjolnir::math::X(vs[i]) == mjolnir::math::X(ref[m][i]));
+                BOOST_TEST(mjolnir::math::Y(vs[i]) == mjolnir::math::Y(ref[m][i]));
+                BOOST_TEST(mjolnir::math::Z(vs[i]) == mjolnir::math::Z(ref[m][i]));
+                BOOST_TEST(mjolnir::math::X(bs[i]) == mjolnir::math::X(ref[m][i]), tol);
+                BOOST_TEST(mjolnir::math::Y(bs[i]) == mjolnir::math::Y(ref[m][i]), tol);
+                BOOST_TEST(mjolnir::math::Z(bs[i]) == mjolnir::math::Z(ref[m][i]), tol);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_omp_random_number_generator_internal_state)
+{
+    mjolnir::LoggerManager::set_default_logger("test_omp_random_number_generator.log");
+
+    using traits_type = mjolnir::OpenMPSimulatorTraits<float, mjolnir::UnlimitedBoundary>;
+    using rng_type    = mjolnir::RandomNumberGenerator<traits_type>;
+
+    rng_type rng(123456789);
+    rng.next_block();
+#pragma omp parallel for
+    for(std::size_t i=0; i<1000; ++i)
+    {
+        rng.gaussian();
+    }
+
+    const rng_type restored(rng.internal_state());
+    BOOST_TEST(restored.seed()  == rng.seed());
+    BOOST_TEST(restored.block() == rng.block());
+    BOOST_TEST((restored == rng));
+
+    // they generate the same sequence
+    rng_type restored2(rng.internal_state());
+    for(std::size_t i=0; i<100; ++i)
+    {
+        BOOST_TEST(restored2.gaussian()       == rng.gaussian());
+        BOOST_TEST(restored2.uniform_real01() == rng.uniform_real01());
+    }
+}
+
+// gaussian() returns both of the Box-Muller pair. The cached one is restored
+// from the internal state.
+BOOST_AUTO_TEST_CASE(test_omp_random_number_generator_gaussian_pair)
+{
+    mjolnir::LoggerManager::set_default_logger("test_omp_random_number_generator.log");
+
+    using traits_type = mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using rng_type    = mjolnir::RandomNumberGenerator<traits_type>;
+
+    rng_type rng(123456789);
+    const double z0 = rng.gaussian(); // z1 is cached
+    const std::string state = rng.internal_state();
+    const double z1 = rng.gaussian();
+    BOOST_TEST(z0 != z1);
+
+    rng_type restored(state);
+    BOOST_TEST(restored.gaussian() == z1);
+    for(std::size_t i=0; i<11; ++i)
+    {
+        BOOST_TEST(restored.gaussian() == rng.gaussian());
+    }
+
+    // a state without the flags (older format) is still accepted.
+    rng_type old_format(std::to_string(123456789) + " 0 1 0");
+    rng_type fresh(123456789);
+    BOOST_TEST(old_format.gaussian() == fresh.gaussian());
+}
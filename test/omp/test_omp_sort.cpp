@@ -133,3 +133,88 @@ BOOST_AUTO_TEST_CASE(test_omp_sort_cmp_small)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_omp_counting_sort)
+{
+    const int max_number_of_threads = omp_get_max_threads();
+    BOOST_TEST_WARN(max_number_of_threads > 2);
+    BOOST_TEST_MESSAGE("maximum number of threads = " << omp_get_max_threads());
+
+    const std::size_t N = 10000;
+    const std::size_t num_keys = 997;
+    const auto key = [](const std::pair<std::size_t, std::size_t>& item)
+        -> std::size_t {return item.second;};
+
+    for(int num_thread=1; num_thread<=max_number_of_threads; ++num_thread)
+    {
+        omp_set_num_threads(num_thread);
+        for(std::size_t i=0, e=omp_get_max_threads(); i<e; ++i)
+        {
+            std::mt19937 mt(123456789);
+            std::uniform_int_distribution<std::size_t> dist(0, num_keys-1);
+
+            std::vector<std::pair<std::size_t, std::size_t>> vec(N+i);
+            std::vector<std::pair<std::size_t, std::size_t>> buf;
+            for(std::size_t j=0; j<vec.size(); ++j)
+            {
+                vec.at(j) = std::make_pair(j, dist(mt));
+            }
+            const auto ref = vec;
+
+            std::vector<std::size_t> offsets;
+            mjolnir::omp::counting_sort(vec, buf, offsets, num_keys, key);
+
+            BOOST_TEST_REQUIRE(vec.size()     == ref.size());
+            BOOST_TEST_REQUIRE(offsets.size() == num_keys + 1);
+            BOOST_TEST(offsets.front() == 0u);
+            BOOST_TEST(offsets.back()  == vec.size());
+            for(std::size_t k=0; k<num_keys; ++k)
+            {
+                for(std::size_t j=offsets.at(k); j<offsets.at(k+1); ++j)
+                {
+                    BOOST_TEST(vec.at(j).second == k);
+                }
+            }
+            // the same set of elements
+            std::sort(vec.begin(), vec.end());
+            BOOST_TEST(std::equal(vec.begin(), vec.end(), ref.begin()));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_counting_sort_stable)
+{
+    const std::size_t N = 1000;
+    const std::size_t num_keys = 37;
+    const auto key = [](const std::pair<std::size_t, std::size_t>& item)
+        -> std::size_t {return item.second;};
+
+    std::mt19937 mt(123456789);
+    std::uniform_int_distribution<std::size_t> dist(0, num_keys-1);
+
+    std::vector<std::pair<std::size_t, std::size_t>> vec(N);
+    std::vector<std::pair<std::size_t, std::size_t>> buf;
+    for(std::size_t j=0; j<vec.size(); ++j)
+    {
+        vec.at(j) = std::make_pair(j, dist(mt));
+    }
+    auto ref = vec;
+    std::stable_sort(ref.begin(), ref.end(),
+        [](const std::pair<std::size_t, std::size_t>& lhs,
+           const std::pair<std::size_t, std::size_t>& rhs) -> bool {
+            return lhs.second < rhs.second;
+        });
+
+    std::vector<std::size_t> offsets;
+    mjolnir::counting_sort(vec, buf, offsets, num_keys, key);
+
+    BOOST_TEST_REQUIRE(vec.size() == ref.size());
+    BOOST_TEST(std::equal(vec.begin(), vec.end(), ref.begin()));
+    for(std::size_t k=0; k<num_keys; ++k)
+    {
+        BOOST_TEST(std::count_if(vec.begin(), vec.end(),
+            [k](const std::pair<std::size_t, std::size_t>& item) {
+                return item.second == k;
+            }) == static_cast<std::ptrdiff_t>(offsets.at(k+1) - offsets.at(k)));
+    }
+}
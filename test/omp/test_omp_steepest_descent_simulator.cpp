@@ -0,0 +1,127 @@
+#define BOOST_TEST_MODULE "test_omp_steepest_descent_simulator"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/ForceField.hpp>
+#include <mjolnir/core/EnergyObserver.hpp>
+#include <mjolnir/forcefield/local/HarmonicPotential.hpp>
+#include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/BondLengthInteraction.hpp>
+#include <mjolnir/omp/SteepestDescentSimulator.hpp>
+#include <mjolnir/util/make_unique.hpp>
+
+#include <random>
+
+namespace test
+{
+template<typename traitsT>
+std::unique_ptr<mjolnir::ForceFieldBase<traitsT>>
+make_chain_forcefield(const std::size_t N)
+{
+    using real_type      = typename traitsT::real_type;
+    using potential_type = mjolnir::HarmonicPotential<real_type>;
+    using bond_type      = mjolnir::BondLengthInteraction<traitsT, potential_type>;
+
+    mjolnir::LocalForceField<traitsT> loc;
+    std::vector<std::pair<std::array<std::size_t, 2>, potential_type>> bonds;
+    for(std::size_t i=0; i+1<N; ++i)
+    {
+        bonds.emplace_back(std::array<std::size_t, 2>{{i, i+1}},
+                           potential_type(10.0, 1.0));
+    }
+    loc.emplace(mjolnir::make_unique<bond_type>("none", std::move(bonds)));
+
+    return mjolnir::make_unique<mjolnir::ForceField<traitsT>>(std::move(loc),
+            mjolnir::GlobalForceField<traitsT>{},
+            mjolnir::ExternalForceField<traitsT>{},
+            mjolnir::ConstraintForceField<traitsT>{});
+}
+
+template<typename traitsT>
+mjolnir::ObserverContainer<traitsT> make_observer(const std::string& prefix)
+{
+    mjolnir::ObserverContainer<traitsT> obs;
+    obs.push_back(mjolnir::make_unique<mjolnir::EnergyObserver<traitsT>>(prefix));
+    return obs;
+}
+} // test
+
+BOOST_AUTO_TEST_CASE(omp_SteepestDescent)
+{
+    constexpr double tol = 1e-8;
+    mjolnir::LoggerManager::set_default_logger("test_omp_steepest_descent_simulator.log");
+
+    using traits_type      = mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using coordinate_type  = typename traits_type::coordinate_type;
+    using boundary_type    = typename traits_type::boundary_type;
+    using system_type      = mjolnir::System<traits_type>;
+    using simulator_type   = mjolnir::SteepestDescentSimulator<traits_type>;
+
+    using sequencial_traits_type    = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using sequencial_system_type    = mjolnir::System<sequencial_traits_type>;
+    using sequencial_simulator_type = mjolnir::SteepestDescentSimulator<sequencial_traits_type>;
+
+    constexpr std::size_t N = 1000;
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<double> uni(-0.1, 0.1);
+
+    system_type            sys    (N, boundary_type{});
+    sequencial_system_type seq_sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.mass(i)     = 1.0;
+        sys.rmass(i)    = 1.0;
+        sys.position(i) = mjolnir::math::make_coordinate<coordinate_type>(
+                1.0 * i + uni(mt), uni(mt), uni(mt));
+        sys.velocity(i) = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys.force(i)    = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys.name(i)     = "X";
+        sys.group(i)    = "NONE";
+
+        seq_sys.mass(i)     = sys.mass(i);
+        seq_sys.rmass(i)    = sys.rmass(i);
+        seq_sys.position(i) = sys.position(i);
+        seq_sys.velocity(i) = sys.velocity(i);
+        seq_sys.force(i)    = sys.force(i);
+        seq_sys.name(i)     = sys.name(i);
+        seq_sys.group(i)    = sys.group(i);
+    }
+
+    simulator_type sim(0.01, 1e-4, 50, 50, 50, std::move(sys),
+            test::make_chain_forcefield<traits_type>(N),
+            test::make_observer<traits_type>("test_omp_steepest_descent_simulator"));
+    sequencial_simulator_type seq_sim(0.01, 1e-4, 50, 50, 50, std::move(seq_sys),
+            test::make_chain_forcefield<sequencial_traits_type>(N),
+            test::make_observer<sequencial_traits_type>("test_omp_steepest_descent_simulator_seq"));
+
+    sim    .initialize();
+    seq_sim.initialize();
+    while(true)
+    {
+        const bool cont     = sim.step();
+        const bool seq_cont = seq_sim.step();
+        BOOST_TEST_REQUIRE(cont == seq_cont);
+        if(!cont) {break;}
+    }
+    sim    .finalize();
+    seq_sim.finalize();
+
+    for(std::size_t i=0; i<N; ++i)
+    {
+        using mjolnir::math::X;
+        using mjolnir::math::Y;
+        using mjolnir::math::Z;
+        const auto& p1 = sim.system().position(i);
+        const auto& p2 = seq_sim.system().position(i);
+        BOOST_TEST(X(p1) == X(p2), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Y(p1) == Y(p2), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Z(p1) == Z(p2), boost::test_tools::tolerance(tol));
+    }
+}
@@ -0,0 +1,240 @@
+#define BOOST_TEST_MODULE "test_omp_velocity_verlet_integrator"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/SimulatorTraits.hpp>
+#include <mjolnir/core/ForceField.hpp>
+#include <mjolnir/forcefield/local/HarmonicPotential.hpp>
+#include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/RandomNumberGenerator.hpp>
+#include <mjolnir/omp/SystemMotionRemover.hpp>
+#include <mjolnir/omp/BondLengthInteraction.hpp>
+#include <mjolnir/omp/VelocityVerletIntegrator.hpp>
+#include <mjolnir/omp/UnlimitedGridCellList.hpp>
+#include <mjolnir/omp/GlobalPairLennardJonesInteraction.hpp>
+#include <mjolnir/util/make_unique.hpp>
+
+#include <random>
+
+namespace test
+{
+template<typename traitsT>
+std::unique_ptr<mjolnir::ForceFieldBase<traitsT>>
+make_chain_forcefield(const std::size_t N, const bool with_global = false)
+{
+    using real_type      = typename traitsT::real_type;
+    using potential_type = mjolnir::HarmonicPotential<real_type>;
+    using bond_type      = mjolnir::BondLengthInteraction<traitsT, potential_type>;
+    using lj_potential_type = mjolnir::LennardJonesPotential<traitsT>;
+    using lj_parameter_type = typename lj_potential_type::parameter_type;
+    using lj_type           = mjolnir::GlobalPairInteraction<traitsT, lj_potential_type>;
+    using partition_type    = mjolnir::UnlimitedGridCellList<traitsT, lj_potential_type>;
+
+    mjolnir::LocalForceField<traitsT> loc;
+    std::vector<std::pair<std::array<std::size_t, 2>, potential_type>> bonds;
+    for(std::size_t i=0; i+1<N; ++i)
+    {
+        bonds.emplace_back(std::array<std::size_t, 2>{{i, i+1}},
+                           potential_type(10.0, 1.0));
+    }
+    loc.emplace(mjolnir::make_unique<bond_type>("none", std::move(bonds)));
+
+    mjolnir::GlobalForceField<traitsT> glo;
+    if(with_global)
+    {
+        std::vector<std::pair<std::size_t, lj_parameter_type>> params;
+        for(std::size_t i=0; i<N; ++i)
+        {
+            params.emplace_back(i, lj_parameter_type(0.9, 0.5));
+        }
+        lj_potential_type potential(lj_potential_type::default_cutoff(),
+            params, {}, typename lj_potential_type::ignore_molecule_type("Nothing"),
+                        typename lj_potential_type::ignore_group_type   ({}));
+        glo.emplace(mjolnir::make_unique<lj_type>(std::move(potential),
+            mjolnir::SpatialPartition<traitsT, lj_potential_type>(
+                mjolnir::make_unique<partition_type>())));
+    }
+
+    return mjolnir::make_unique<mjolnir::ForceField<traitsT>>(std::move(loc),
+            std::move(glo),
+            mjolnir::ExternalForceField<traitsT>{},
+            mjolnir::ConstraintForceField<traitsT>{});
+}
+} // test
+
+BOOST_AUTO_TEST_CASE(omp_VelocityVerlet)
+{
+    constexpr double tol = 1e-8;
+    mjolnir::LoggerManager::set_default_logger("test_omp_velocity_verlet_integrator.log");
+
+    using traits_type      = mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using coordinate_type  = typename traits_type::coordinate_type;
+    using boundary_type    = typename traits_type::boundary_type;
+    using system_type      = mjolnir::System<traits_type>;
+    using rng_type         = mjolnir::RandomNumberGenerator<traits_type>;
+    using remover_type     = mjolnir::SystemMotionRemover<traits_type>;
+    using integrator_type  = mjolnir::VelocityVerletIntegrator<traits_type>;
+
+    using sequencial_traits_type     = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using sequencial_system_type     = mjolnir::System<sequencial_traits_type>;
+    using sequencial_rng_type        = mjolnir::RandomNumberGenerator<sequencial_traits_type>;
+    using sequencial_remover_type    = mjolnir::SystemMotionRemover<sequencial_traits_type>;
+    using sequencial_integrator_type = mjolnir::VelocityVerletIntegrator<sequencial_traits_type>;
+
+    constexpr std::size_t N = 1000;
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<double> uni(-0.1, 0.1);
+
+    system_type            sys    (N, boundary_type{});
+    sequencial_system_type seq_sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.mass(i)     = 1.0 + 0.01 * (i % 7);
+        sys.rmass(i)    = 1.0 / sys.mass(i);
+        sys.position(i) = mjolnir::math::make_coordinate<coordinate_type>(
+                1.0 * i + uni(mt), uni(mt), uni(mt));
+        sys.velocity(i) = mjolnir::math::make_coordinate<coordinate_type>(
+                uni(mt), uni(mt), uni(mt));
+        sys.force(i)    = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys.name(i)     = "X";
+        sys.group(i)    = "NONE";
+
+        seq_sys.mass(i)     = sys.mass(i);
+        seq_sys.rmass(i)    = sys.rmass(i);
+        seq_sys.position(i) = sys.position(i);
+        seq_sys.velocity(i) = sys.velocity(i);
+        seq_sys.force(i)    = sys.force(i);
+        seq_sys.name(i)     = sys.name(i);
+        seq_sys.group(i)    = sys.group(i);
+    }
+
+    auto ff     = test::make_chain_forcefield<traits_type>(N);
+    auto seq_ff = test::make_chain_forcefield<sequencial_traits_type>(N);
+    ff    ->initialize(sys);
+    seq_ff->initialize(seq_sys);
+
+    rng_type            rng(123456789);
+    sequencial_rng_type seq_rng(123456789);
+
+    integrator_type            integrator    (0.01, remover_type(true, true, false));
+    sequencial_integrator_type seq_integrator(0.01, sequencial_remover_type(true, true, false));
+    integrator    .initialize(sys,     ff,     rng);
+    seq_integrator.initialize(seq_sys, seq_ff, seq_rng);
+
+    double t = 0.0, seq_t = 0.0;
+    for(std::size_t step=0; step<100; ++step)
+    {
+        t     = integrator    .step(t,     sys,     ff,     rng);
+        seq_t = seq_integrator.step(seq_t, seq_sys, seq_ff, seq_rng);
+        BOOST_TEST(t == seq_t, boost::test_tools::tolerance(tol));
+    }
+
+    for(std::size_t i=0; i<N; ++i)
+    {
+        using mjolnir::math::X;
+        using mjolnir::math::Y;
+        using mjolnir::math::Z;
+        BOOST_TEST(X(sys.position(i)) == X(seq_sys.position(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Y(sys.position(i)) == Y(seq_sys.position(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Z(sys.position(i)) == Z(seq_sys.position(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(X(sys.velocity(i)) == X(seq_sys.velocity(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Y(sys.velocity(i)) == Y(seq_sys.velocity(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Z(sys.velocity(i)) == Z(seq_sys.velocity(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(X(sys.force(i))    == X(seq_sys.force(i)),    boost::test_tools::tolerance(tol));
+        BOOST_TEST(Y(sys.force(i))    == Y(seq_sys.force(i)),    boost::test_tools::tolerance(tol));
+        BOOST_TEST(Z(sys.force(i))    == Z(seq_sys.force(i)),    boost::test_tools::tolerance(tol));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(omp_VelocityVerlet_multiple_time_step)
+{
+    constexpr double tol = 1e-8;
+    mjolnir::LoggerManager::set_default_logger("test_omp_velocity_verlet_integrator.log");
+
+    using traits_type      = mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using coordinate_type  = typename traits_type::coordinate_type;
+    using boundary_type    = typename traits_type::boundary_type;
+    using system_type      = mjolnir::System<traits_type>;
+    using rng_type         = mjolnir::RandomNumberGenerator<traits_type>;
+    using remover_type     = mjolnir::SystemMotionRemover<traits_type>;
+    using integrator_type  = mjolnir::VelocityVerletIntegrator<traits_type>;
+
+    using sequencial_traits_type     = mjolnir::SimulatorTraits<double, mjolnir::UnlimitedBoundary>;
+    using sequencial_system_type     = mjolnir::System<sequencial_traits_type>;
+    using sequencial_rng_type        = mjolnir::RandomNumberGenerator<sequencial_traits_type>;
+    using sequencial_remover_type    = mjolnir::SystemMotionRemover<sequencial_traits_type>;
+    using sequencial_integrator_type = mjolnir::VelocityVerletIntegrator<sequencial_traits_type>;
+
+    constexpr std::size_t N = 1000;
+    constexpr std::size_t k = 3;
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<double> uni(-0.1, 0.1);
+
+    // a zigzag chain so that i and i+2 interact via the global forcefield
+    system_type            sys    (N, boundary_type{});
+    sequencial_system_type seq_sys(N, boundary_type{});
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.mass(i)     = 1.0 + 0.01 * (i % 7);
+        sys.rmass(i)    = 1.0 / sys.mass(i);
+        sys.position(i) = mjolnir::math::make_coordinate<coordinate_type>(
+                0.7 * i + uni(mt), (i % 2 == 0 ? 0.0 : 0.7) + uni(mt), uni(mt));
+        sys.velocity(i) = mjolnir::math::make_coordinate<coordinate_type>(
+                uni(mt), uni(mt), uni(mt));
+        sys.force(i)    = mjolnir::math::make_coordinate<coordinate_type>(0, 0, 0);
+        sys.name(i)     = "X";
+        sys.group(i)    = "NONE";
+
+        seq_sys.mass(i)     = sys.mass(i);
+        seq_sys.rmass(i)    = sys.rmass(i);
+        seq_sys.position(i) = sys.position(i);
+        seq_sys.velocity(i) = sys.velocity(i);
+        seq_sys.force(i)    = sys.force(i);
+        seq_sys.name(i)     = sys.name(i);
+        seq_sys.group(i)    = sys.group(i);
+    }
+
+    auto ff     = test::make_chain_forcefield<traits_type>(N, true);
+    auto seq_ff = test::make_chain_forcefield<sequencial_traits_type>(N, true);
+    ff    ->initialize(sys);
+    seq_ff->initialize(seq_sys);
+
+    rng_type            rng(123456789);
+    sequencial_rng_type seq_rng(123456789);
+
+    integrator_type            integrator    (0.005, remover_type(false, false, false), k);
+    sequencial_integrator_type seq_integrator(0.005, sequencial_remover_type(false, false, false), k);
+    integrator    .initialize(sys,     ff,     rng);
+    seq_integrator.initialize(seq_sys, seq_ff, seq_rng);
+
+    double t = 0.0, seq_t = 0.0;
+    for(std::size_t step=0; step<100; ++step)
+    {
+        t     = integrator    .step(t,     sys,     ff,     rng);
+        seq_t = seq_integrator.step(seq_t, seq_sys, seq_ff, seq_rng);
+        BOOST_TEST(t == seq_t, boost::test_tools::tolerance(tol));
+    }
+
+    for(std::size_t i=0; i<N; ++i)
+    {
+        using mjolnir::math::X;
+        using mjolnir::math::Y;
+        using mjolnir::math::Z;
+        BOOST_TEST(X(sys.position(i)) == X(seq_sys.position(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Y(sys.position(i)) == Y(seq_sys.position(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Z(sys.position(i)) == Z(seq_sys.position(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(X(sys.velocity(i)) == X(seq_sys.velocity(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Y(sys.velocity(i)) == Y(seq_sys.velocity(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(Z(sys.velocity(i)) == Z(seq_sys.velocity(i)), boost::test_tools::tolerance(tol));
+        BOOST_TEST(X(sys.force(i))    == X(seq_sys.force(i)),    boost::test_tools::tolerance(tol));
+        BOOST_TEST(Y(sys.force(i))    == Y(seq_sys.force(i)),    boost::test_tools::tolerance(tol));
+        BOOST_TEST(Z(sys.force(i))    == Z(seq_sys.force(i)),    boost::test_tools::tolerance(tol));
+    }
+}
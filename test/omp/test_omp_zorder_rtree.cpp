@@ -0,0 +1,161 @@
+#define BOOST_TEST_MODULE "test_omp_zorder_rtree"
+
+#ifdef BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include <mjolnir/util/empty.hpp>
+#include <mjolnir/util/logger.hpp>
+#include <mjolnir/util/range.hpp>
+#include <mjolnir/util/make_unique.hpp>
+#include <mjolnir/core/BoundaryCondition.hpp>
+#include <mjolnir/core/Topology.hpp>
+#include <mjolnir/omp/System.hpp>
+#include <mjolnir/omp/ZorderRTree.hpp>
+#include <numeric>
+#include <random>
+
+template<typename T>
+struct dummy_potential
+{
+    using real_type      = T;
+    using parameter_type = mjolnir::empty_t;
+    using pair_parameter_type = parameter_type;
+
+    explicit dummy_potential(const real_type cutoff,
+                             const std::vector<std::size_t>& participants)
+        : cutoff_(cutoff), participants_(participants)
+    {}
+
+    real_type max_cutoff_length() const noexcept {return this->cutoff_;}
+
+    parameter_type prepare_params(std::size_t, std::size_t) const noexcept
+    {
+        return parameter_type{};
+    }
+
+    std::vector<std::size_t> const& participants() const noexcept
+    {
+        return this->participants_;
+    }
+    mjolnir::range<typename std::vector<std::size_t>::const_iterator>
+    leading_participants() const noexcept
+    {
+        return mjolnir::make_range(participants_.begin(), std::prev(participants_.end()));
+    }
+    bool has_interaction(const std::size_t i, const std::size_t j) const noexcept
+    {
+        return (i < j);
+    }
+
+    std::string name() const {return "dummy potential";}
+
+    real_type cutoff_;
+    std::vector<std::size_t> participants_;
+};
+
+template<typename Boundary, typename Coordinate>
+typename std::enable_if<mjolnir::is_unlimited_boundary<Boundary>::value, Boundary>::type
+get_boundary(const Coordinate&, const Coordinate&) noexcept
+{
+    return Boundary{};
+}
+template<typename Boundary, typename Coordinate>
+typename std::enable_if<mjolnir::is_cuboidal_periodic_boundary<Boundary>::value, Boundary>::type
+get_boundary(const Coordinate& lower, const Coordinate& higher) noexcept
+{
+    return Boundary{lower, higher};
+}
+
+using traits_to_be_tested = std::tuple<
+    mjolnir::OpenMPSimulatorTraits<double, mjolnir::UnlimitedBoundary>,
+    mjolnir::OpenMPSimulatorTraits<double, mjolnir::CuboidalPeriodicBoundary>
+>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_omp_ZorderRTree, traits_type, traits_to_be_tested)
+{
+    mjolnir::LoggerManager::set_default_logger("test_omp_zorder_rtree.log");
+    using real_type       = typename traits_type::real_type;
+    using boundary_type   = typename traits_type::boundary_type;
+    using coordinate_type = typename traits_type::coordinate_type;
+    using potential_type  = dummy_potential<real_type>;
+    using partition_type  = mjolnir::ZorderRTree<traits_type, potential_type>;
+
+    constexpr std::size_t N = 2000;
+    constexpr double      L = 20.0;
+    constexpr double cutoff = 1.0;
+    constexpr double margin = 0.5;
+    constexpr double threshold = cutoff * (1.0 + margin);
+
+    // a dense cluster in a large, almost empty box
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<real_type> dense (0.4 * L, 0.6 * L);
+    std::uniform_real_distribution<real_type> sparse(0.0, L);
+    std::uniform_real_distribution<real_type> noise(-0.05, 0.05);
+
+    std::vector<std::size_t> participants(N / 2);
+    std::iota(participants.begin(), participants.end(), N / 4);
+    potential_type pot(cutoff, participants);
+
+    mjolnir::System<traits_type> sys(N, get_boundary<boundary_type>(
+                coordinate_type(0.0, 0.0, 0.0), coordinate_type(L, L, L)));
+    for(std::size_t i=0; i < N; ++i)
+    {
+        sys.mass(i)     = 1.0;
+        sys.position(i) = (i % 10 == 0) ?
+            coordinate_type(sparse(mt), sparse(mt), sparse(mt)) :
+            coordinate_type(dense (mt), dense (mt), dense (mt));
+    }
+
+    auto partition = mjolnir::make_unique<partition_type>(margin);
+    const auto& tree = *partition;
+    mjolnir::SpatialPartition<traits_type, potential_type> vlist(std::move(partition));
+
+    BOOST_TEST(!vlist.valid());
+    vlist.initialize(sys, pot);
+    BOOST_TEST(vlist.valid());
+    BOOST_TEST(tree.num_rebuild() == 1u);
+
+    const auto check_partners = [&]() {
+        for(const auto i : pot.leading_participants())
+        {
+            const auto partners = vlist.partners(i);
+            std::vector<std::size_t> expected;
+            for(const auto j : participants)
+            {
+                if(j <= i) {continue;}
+                const auto dist = mjolnir::math::length(sys.adjust_direction(
+                            sys.position(i), sys.position(j)));
+                if(dist < threshold) {expected.push_back(j);}
+            }
+            BOOST_TEST_REQUIRE(partners.size() == expected.size());
+            for(std::size_t k=0; k<expected.size(); ++k)
+            {
+                BOOST_TEST(partners.at(k).index == expected.at(k));
+            }
+        }
+    };
+    check_partners();
+
+    // small displacements keep the z-order. only the boxes are refitted.
+    for(std::size_t i=0; i<N; i+=3)
+    {
+        sys.position(i) = sys.adjust_position(sys.position(i) +
+                coordinate_type(noise(mt), noise(mt), noise(mt)));
+    }
+    vlist.make(sys, pot);
+    BOOST_TEST(tree.num_rebuild() == 1u);
+    BOOST_TEST(tree.num_refit()   == 1u);
+    check_partners();
+
+    // shuffle the particles. the tree is rebuilt.
+    for(std::size_t i=0; i<N; ++i)
+    {
+        sys.position(i) = coordinate_type(sparse(mt), sparse(mt), sparse(mt));
+    }
+    vlist.make(sys, pot);
+    BOOST_TEST(tree.num_rebuild() == 2u);
+    check_partners();
+}